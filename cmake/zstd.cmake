@@ -0,0 +1,28 @@
+include(ExternalProject)
+
+set(ZSTD_SOURCES_DIR ${THIRD_PARTY_PATH}/zstd)
+set(ZSTD_INSTALL_DIR ${THIRD_PARTY_PATH}/install/zstd)
+
+add_library(zstd STATIC IMPORTED GLOBAL)
+if (NOT WITH_DEPS)
+    ExternalProject_Add(
+            extern_zstd
+            ${EXTERNAL_PROJECT_LOG_ARGS}
+            GIT_REPOSITORY "https://github.com/facebook/zstd.git"
+            GIT_TAG "v1.5.5"
+            PREFIX ${ZSTD_SOURCES_DIR}
+            BUILD_IN_SOURCE ON
+            UPDATE_COMMAND ""
+            CONFIGURE_COMMAND ""
+            BUILD_COMMAND $(MAKE) -C lib -j${NUM_OF_PROCESSOR} libzstd.a
+            INSTALL_COMMAND mkdir -p ${ZSTD_INSTALL_DIR} COMMAND cp -r ${ZSTD_SOURCES_DIR}/src/extern_zstd/lib ${ZSTD_INSTALL_DIR}/
+    )
+
+    if (NOT EXISTS ${ZSTD_INSTALL_DIR}/lib)
+        execute_process(COMMAND mkdir -p ${ZSTD_INSTALL_DIR}/lib COMMAND_ERROR_IS_FATAL ANY)
+    endif ()
+    add_dependencies(zstd extern_zstd)
+endif ()
+
+set_target_properties(zstd PROPERTIES IMPORTED_LOCATION ${ZSTD_INSTALL_DIR}/lib/libzstd.a)
+target_include_directories(zstd INTERFACE ${ZSTD_INSTALL_DIR}/lib)
\ No newline at end of file
@@ -1,5 +1,10 @@
 #!/bin/bash
 
+# mysql-bin.index is a binary file, print it as tab separated lines: binlog index current before checkpoint pos
+function dump_index_file() {
+  LD_LIBRARY_PATH=/home/ds/oblogproxy/deps/lib:${LD_LIBRARY_PATH} /home/ds/oblogproxy/bin/logproxy --dump_binlog_index ${1}
+}
+
 tenant_file="standby_tenant.txt"
 tenant_create_sql_file="tenant_create_sql.txt"
 rm -f ${tenant_create_sql_file}
@@ -14,10 +19,11 @@ while read -r cluster tenant ; do
       cluster_url=$(jq -r ".OblogConfig.configs.cluster_url" ${tenant_conf_file})
 
       index_file="/home/ds/oblogproxy/run/${cluster}/${tenant}/data/mysql-bin.index"
-      current=$(cat ${index_file} | tail -n 1 | awk '{print $3}')
+      last_record=$(dump_index_file ${index_file} | tail -n 1)
+      current=$(echo "${last_record}" | awk -F$'\t' '{print $3}')
       xid=${current%=*}
       gtid=${current#*=}
-      start_timestamp=$(cat ${index_file} | tail -n 1 | awk '{print $5}')
+      start_timestamp=$(echo "${last_record}" | awk -F$'\t' '{print $5}')
       if [[ xid != '' ]]; then
         create_sql="CREATE BINLOG IF NOT EXISTS FOR TENANT \`${cluster}\`.\`${tenant}\` FROM ${start_timestamp} WITH CLUSTER URL \`${cluster_url}\`, INITIAL_TRX_XID \`${xid}\`,INITIAL_TRX_GTID_SEQ \`${gtid}\`;"
         echo ${create_sql} | tee -a ${tenant_create_sql_file}
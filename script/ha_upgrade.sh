@@ -5,6 +5,11 @@ port=2983
 max_delay_threshold=180000
 instance_num=1
 
+# mysql-bin.index is a binary file, print it as tab separated lines: binlog index current before checkpoint pos
+function dump_index_file() {
+  LD_LIBRARY_PATH=/home/ds/oblogproxy/deps/lib:${LD_LIBRARY_PATH} /home/ds/oblogproxy/bin/logproxy --dump_binlog_index ${1}
+}
+
 function exec_sql() {
   sql=${1}
   echo -e "EXEC SQL: ${sql} ...         \c"
@@ -206,8 +211,8 @@ function check_min_dump_checkpoint() {
       return 1
    else
       index_file="/home/ds/oblogproxy/run/${instance}/data/mysql-bin.index"
-      min_checkpoint=$(cat ${index_file} | head -n 1 | awk -F$'\t' '{print $5}')
-      max_checkpoint=$(cat ${index_file} | tail -n 1 | awk -F$'\t' '{print $5}')
+      min_checkpoint=$(dump_index_file ${index_file} | head -n 1 | awk -F$'\t' '{print $5}')
+      max_checkpoint=$(dump_index_file ${index_file} | tail -n 1 | awk -F$'\t' '{print $5}')
       if [[ ${min_checkpoint} == ${max_checkpoint} ]]; then
         echo "!!! Only 1 binlog file, please manually evaluate whether it meets the min dump checkpoint: ${checkpoint}"
         return 1
@@ -313,8 +318,9 @@ function check_gtid_consistency() {
      server_uuid_sql="SHOW VARIABLES LIKE 'MASTER_SERVER_UUID' for instance '${instance}'"
      server_uuid=$(mysql -h127.0.0.1 -P${port} -sNe "${server_uuid_sql}" | awk '{print $2}')
 
-     echo "$(cat /home/ds/oblogproxy/run/${instance}/data/mysql-bin.index | tail -n 1)"
-     recent=$(cat /home/ds/oblogproxy/run/${instance}/data/mysql-bin.index | tail -n 1 | awk -F'\t' '{print $1, "|", $3}')
+     last_record=$(dump_index_file /home/ds/oblogproxy/run/${instance}/data/mysql-bin.index | tail -n 1)
+     echo "${last_record}"
+     recent=$(echo "${last_record}" | awk -F'\t' '{print $1, "|", $3}')
      binlog_file=$(echo ${recent} | awk -F'|' '{print $1}')
      gtid=$(echo ${recent} | awk -F'|' '{print $2}' | awk -F'=' '{print $2}')
 
@@ -1,6 +1,12 @@
 #!/bin/bash
 
 # standalone_upgrade.sh
+
+# mysql-bin.index is a binary file, print it as tab separated lines: binlog index current before checkpoint pos
+function dump_index_file() {
+  LD_LIBRARY_PATH=/home/ds/oblogproxy/deps/lib:${LD_LIBRARY_PATH} /home/ds/oblogproxy/bin/logproxy --dump_binlog_index ${1}
+}
+
 function parse_index_file() {
   index_file=${1};
   max_timestamp=${2}
@@ -18,7 +24,7 @@ function parse_index_file() {
       max_checkpoint=${checkpoint}
       break
     fi
-  done < ${index_file}
+  done < <(dump_index_file ${index_file})
 
   if [[ ${max_current} == '' ]]; then
     echo "!! Notice: Not matched binlog file with checkpoint greater than timestamp: ${max_timestamp}, and using latest binlog: ${curr_binlog}, current_mapping: ${curr_mapping}, current_checkpoint: ${curr_checkpoint}"
@@ -77,7 +83,7 @@ function generate_create_binlog_sql() {
   echo "cluster_url: ${cluster_url}, cluster_user: ${cluster_user}"
 
   index_file="/home/ds/oblogproxy/run/${cluster}/${tenant}/data/mysql-bin.index"
-  first_timestamp=$(awk -F$'\t' 'NR=1 {print $5}' ${index_file} | head -n 1)
+  first_timestamp=$(dump_index_file ${index_file} | awk -F$'\t' 'NR=1 {print $5}' | head -n 1)
   echo "index_file: ${index_file}, first_timestamp: ${first_timestamp}"
   get_min_clog_timestamp ${cluster_url} ${cluster_user} ${cluster_password}
   max_timestamp=$(echo -e "${first_timestamp}\n${min_clog_timestamp}" | bc | sort -nr | head -n 1)
@@ -240,7 +246,7 @@ function match_checkpoint() {
     else
        min_checkpoint=${checkpoint}
     fi
-  done < ${index_file}
+  done < <(dump_index_file ${index_file})
 
   if [[ ${min_checkpoint} == '' ]]; then
     echo "Not matched min dump binlog file: ${binlog_file}"
@@ -314,7 +320,7 @@ function check_gtid_consistency() {
       binlog_file=${binlog}
       gtid=$(echo ${current} | awk -F'=' '{print $2}')
     fi
-  done < ${index_file}
+  done < <(dump_index_file ${index_file})
 
   if [[ -z ${event_cmd} ]]; then
     event_cmd="/home/ds/switch/mysql/bin/mysqlbinlog  --base64-output=decode-rows --include-gtids '${server_uuid}:${s_gtid}' ${binlog_file} > 222.binlog"
@@ -14,8 +14,10 @@
 #include <arpa/inet.h>
 #include <csignal>
 #include <cmath>
+#include <algorithm>
 #include "log.h"
 #include "file_gc.h"
+#include "table_rules.h"
 #include "source_invoke.h"
 #include "arranger.h"
 #include "communication/channel_factory.h"
@@ -28,6 +30,42 @@
 namespace oceanbase::logproxy {
 static Config& _s_conf = Config::instance();
 
+// the options of each client, the clients sharing an oblogreader may differ in, the table white list of a client is to
+// be covered by the one of the oblogreader
+static const std::set<std::string> _s_client_options{
+    "id", "first_start_timestamp", "first_start_timestamp_us", "compress_type", "tb_white_list"};
+
+/*
+ * Make up the key of the shared oblogreader out of the options but the ones of each client
+ */
+static void shared_source_key(const ObcdcConfig& config, std::string& key)
+{
+  std::map<std::string, std::string> configs;
+  config.generate_configs(configs);
+  key.clear();
+  for (const auto& entry : configs) {
+    if (_s_client_options.count(entry.first) == 0) {
+      key.append(entry.first).append("=").append(entry.second).append(" ");
+    }
+  }
+}
+
+/*
+ * Whether every table of the client is one of the shared oblogreader, obcdc taking the white list it starts with
+ */
+static bool covers(const std::vector<TablePattern>& source_whites, const std::vector<TablePattern>& client_whites)
+{
+  for (const TablePattern& client_white : client_whites) {
+    auto iter = std::find_if(source_whites.begin(), source_whites.end(), [&client_white](const TablePattern& white) {
+      return white.covers(client_white);
+    });
+    if (iter == source_whites.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 int Arranger::init()
 {
   if (!localhostip(_localhost, _localip) || _localhost.empty() || _localip.empty()) {
@@ -158,6 +196,17 @@ int Arranger::resolve(ObcdcConfig& hs_config, std::string& errmsg)
     return OMS_FAILED;
   }
 
+  std::vector<TableColumns> table_columns;
+  if (parse_table_columns(hs_config.table_columns.val(), table_columns) != OMS_OK) {
+    errmsg = "Refuse connection caused by invalid tb_column_list";
+    return OMS_FAILED;
+  }
+  std::vector<TableRowFilter> row_filters;
+  if (parse_row_filters(hs_config.row_filters.val(), row_filters) != OMS_OK) {
+    errmsg = "Refuse connection caused by invalid tb_row_filter";
+    return OMS_FAILED;
+  }
+
   return OMS_OK;
 }
 
@@ -212,6 +261,8 @@ int Arranger::check_quota()
 int Arranger::create(ClientMeta& client, ObcdcConfig& oblog_config)
 {
   OMS_STREAM_INFO << "Client connecting: " << client.to_string();
+  // a client reconnecting finds its last session gone
+  poll_shared_sources();
 
   const std::string& client_id = client.id;
   const auto& fd_entry = _client_peers.find(client_id);
@@ -222,7 +273,9 @@ int Arranger::create(ClientMeta& client, ObcdcConfig& oblog_config)
     //    close_client_force(fd_entry->second, "Duplication exist client_id");
   }
 
-  int ret = SourceInvoke::invoke(_accepter, client, oblog_config);
+  int ret = _s_conf.oblogreader_fanout.val() && client.type == OCEANBASE
+                ? create_shared(client, oblog_config)
+                : SourceInvoke::invoke(_accepter, client, oblog_config);
   if (ret <= 0) {
     OMS_STREAM_ERROR << "Failed to start source of client:" << client.to_string();
     return OMS_FAILED;
@@ -238,6 +291,95 @@ int Arranger::create(ClientMeta& client, ObcdcConfig& oblog_config)
   return OMS_OK;
 }
 
+int Arranger::create_shared(ClientMeta& client, ObcdcConfig& oblog_config)
+{
+  std::string key;
+  shared_source_key(oblog_config, key);
+  std::vector<TablePattern> table_whites;
+  if (parse_table_patterns(oblog_config.table_whites.val(), table_whites) != OMS_OK) {
+    return OMS_FAILED;
+  }
+
+  for (auto& entry : _shared_sources) {
+    SharedSourceMeta& source = entry.second;
+    if (source.key != key || source.control_fd < 0 || !covers(source.table_whites, table_whites)) {
+      continue;
+    }
+
+    std::vector<std::string> detached;
+    int ret = SourceInvoke::attach(source.control_fd, client, detached);
+    on_detached(source, detached);
+    if (ret == OMS_OK) {
+      source.client_ids.insert(client.id);
+      OMS_STREAM_INFO << "Client: " << client.id << " attached to shared oblogreader of pid: " << source.pid;
+      return source.pid;
+    }
+    if (ret == OMS_TIMEOUT) {
+      // the oblogreader may take the client later on, shut the connection down not to serve it twice
+      shutdown(client.peer.fd, SHUT_RDWR);
+      return OMS_FAILED;
+    }
+    if (ret == OMS_CLIENT_CLOSED) {
+      OMS_STREAM_WARN << "Shared oblogreader of pid: " << source.pid << " stopped answering";
+      close(source.control_fd);
+      source.control_fd = -1;
+    }
+    // refused, as the records the client asks for have gone from the shared oblogreader, try the next one
+  }
+
+  int control_fd = -1;
+  int pid = SourceInvoke::invoke(_accepter, client, oblog_config, &control_fd);
+  if (pid <= 0) {
+    return OMS_FAILED;
+  }
+  SharedSourceMeta& source = _shared_sources[pid];
+  source.pid = pid;
+  source.control_fd = control_fd;
+  source.key = std::move(key);
+  source.table_whites = std::move(table_whites);
+  source.client_ids.insert(client.id);
+  return pid;
+}
+
+void Arranger::poll_shared_sources()
+{
+  for (auto iter = _shared_sources.begin(); iter != _shared_sources.end();) {
+    SharedSourceMeta& source = iter->second;
+    // the clients of an exited oblogreader are left to gc_pid_routine
+    if (kill(source.pid, 0) != 0) {
+      OMS_STREAM_WARN << "Exited shared oblogreader of pid: " << source.pid;
+      if (source.control_fd >= 0) {
+        close(source.control_fd);
+      }
+      iter = _shared_sources.erase(iter);
+      continue;
+    }
+
+    if (source.control_fd >= 0) {
+      std::vector<std::string> detached;
+      if (SourceInvoke::poll_detached(source.control_fd, detached) != OMS_OK) {
+        close(source.control_fd);
+        source.control_fd = -1;
+      }
+      on_detached(source, detached);
+    }
+    ++iter;
+  }
+}
+
+void Arranger::on_detached(SharedSourceMeta& source, const std::vector<std::string>& client_ids)
+{
+  for (const std::string& client_id : client_ids) {
+    auto entry = _client_peers.find(client_id);
+    // the client may have come back to another oblogreader already
+    if (entry != _client_peers.end() && entry->second.pid == source.pid) {
+      OMS_STREAM_INFO << "Client: " << client_id << " detached from shared oblogreader of pid: " << source.pid;
+      _client_peers.erase(entry);
+    }
+    source.client_ids.erase(client_id);
+  }
+}
+
 void Arranger::response_error(const Peer& peer, MessageVersion version, ErrorCode code, const std::string& errmsg)
 {
   ErrorMessage error(code, errmsg);
@@ -299,6 +441,7 @@ int Arranger::close_client_force(const ClientMeta& client, const std::string& ms
 
 void Arranger::gc_pid_routine()
 {
+  poll_shared_sources();
   for (auto iter = _client_peers.begin(); iter != _client_peers.end();) {
     int pid = iter->second.pid;
     // detect if oblogreader still alive
@@ -14,6 +14,7 @@
 
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 #include "common.h"
 #include "source_meta.h"
 #include "client_meta.h"
@@ -50,6 +51,19 @@ private:
 
   int create(ClientMeta&, ObcdcConfig&);
 
+  /*!
+   * @brief Hand the client over to a shared oblogreader covering its tables, or start one
+   * @return pid of the oblogreader serving the client, or OMS_FAILED
+   */
+  int create_shared(ClientMeta&, ObcdcConfig&);
+
+  /*!
+   * @brief Forget the clients the shared oblogreaders are done with, and the shared oblogreaders exited
+   */
+  void poll_shared_sources();
+
+  void on_detached(SharedSourceMeta& source, const std::vector<std::string>& client_ids);
+
   void response_error(const Peer&, MessageVersion version, ErrorCode code, const std::string&);
 
   int close_client_force(const ClientMeta& client, const std::string& msg = "");
@@ -64,6 +78,11 @@ private:
    */
   std::unordered_map<std::string, ClientMeta> _client_peers;
 
+  /**
+   * <pid, shared oblogreader>
+   */
+  std::unordered_map<int, SharedSourceMeta> _shared_sources;
+
   std::string _localhost;
   std::string _localip;
 
@@ -10,7 +10,9 @@
  * See the Mulan PubL v2 for more details.
  */
 
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/socket.h>
 #ifdef linux
 #include <sys/prctl.h>
 #endif
@@ -18,12 +20,14 @@
 #include "log.h"
 #include "config.h"
 #include "fs_util.h"
+#include "timer.h"
 #include "obaccess/ob_access.h"
+#include "communication/io.h"
 #include "source_invoke.h"
 
 namespace oceanbase::logproxy {
 
-int SourceInvoke::start_oblogreader(Comm& comm, const ClientMeta& client, ObcdcConfig& config)
+int SourceInvoke::start_oblogreader(Comm& comm, const ClientMeta& client, ObcdcConfig& config, int* control_fd)
 {
   std::string oblogreader_work_path = Config::instance().oblogreader_path.val() + std::string("/") + client.id;
   FsUtil::mkdir(oblogreader_work_path);
@@ -34,9 +38,21 @@ int SourceInvoke::start_oblogreader(Comm& comm, const ClientMeta& client, ObcdcC
     return OMS_FAILED;
   }
 
+  // the control socket of a shared oblogreader, close on exec not to leak into the other oblogreaders
+  int control_fds[2] = {-1, -1};
+  if (control_fd != nullptr && socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, control_fds) != 0) {
+    OMS_ERROR("Failed to create control socket of shared oblogreader: {}({})", errno, strerror(errno));
+    return OMS_FAILED;
+  }
+  std::string control_fd_arg = std::to_string(control_fds[1]);
+
   int pid = fork();
   if (pid == -1) {
     OMS_ERROR("Failed to fork: {}({})", errno, strerror(errno));
+    if (control_fd != nullptr) {
+      close(control_fds[0]);
+      close(control_fds[1]);
+    }
     return OMS_FAILED;
   }
 
@@ -49,12 +65,21 @@ int SourceInvoke::start_oblogreader(Comm& comm, const ClientMeta& client, ObcdcC
     char* argv[] = {const_cast<char*>("./oblogreader"),
         const_cast<char*>(config_name.c_str()),
         const_cast<char*>(oblogreader_work_path.c_str()),
+        nullptr,
         nullptr};
+    if (control_fd != nullptr) {
+      fcntl(control_fds[1], F_SETFD, 0);
+      argv[3] = const_cast<char*>(control_fd_arg.c_str());
+    }
     execv(oblogreader_bin_file.c_str(), argv);
     ::exit(-1);
   }
 
-  OMS_INFO("+++ Created oblogreader with pid: {}", pid);
+  if (control_fd != nullptr) {
+    close(control_fds[1]);
+    *control_fd = control_fds[0];
+  }
+  OMS_INFO("+++ Created {}oblogreader with pid: {}", control_fd != nullptr ? "shared " : "", pid);
   return pid;
 }
 
@@ -77,11 +102,11 @@ int SourceInvoke::serialize_configs(const ClientMeta& client, const ObcdcConfig&
 /**
  * @return pid of childern process or -1 failurs, childern process never return
  */
-int SourceInvoke::invoke(Comm& comm, const ClientMeta& client, ObcdcConfig& config)
+int SourceInvoke::invoke(Comm& comm, const ClientMeta& client, ObcdcConfig& config, int* control_fd)
 {
   switch (client.type) {
     case OCEANBASE:
-      return start_oblogreader(comm, client, config);
+      return start_oblogreader(comm, client, config, control_fd);
 
     default:
       OMS_ERROR("Unsupported invoke log type: {}", client.type);
@@ -89,4 +114,93 @@ int SourceInvoke::invoke(Comm& comm, const ClientMeta& client, ObcdcConfig& conf
   }
 }
 
+int SourceInvoke::attach(int control_fd, const ClientMeta& client, std::vector<std::string>& detached)
+{
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  client.to_json(writer);
+  writer.EndObject();
+  if (send_with_fd(control_fd, buffer.GetString(), client.peer.fd) != OMS_OK) {
+    return OMS_CLIENT_CLOSED;
+  }
+
+  // the answer comes after the notices of the clients gone before
+  Timer timer;
+  int64_t timeout_ms = Config::instance().oblogreader_fanout_attach_timeout_ms.val();
+  while (true) {
+    int64_t remain_ms = timeout_ms - timer.elapsed() / 1000;
+    if (remain_ms <= 0) {
+      OMS_ERROR("Timeout to wait shared oblogreader to take client: {}", client.id);
+      return OMS_TIMEOUT;
+    }
+
+    std::string payload;
+    int fd = -1;
+    int ret = recv_with_fd(control_fd, payload, fd, static_cast<int>(remain_ms));
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (ret == OMS_TIMEOUT) {
+      continue;
+    }
+    if (ret != OMS_OK) {
+      return OMS_CLIENT_CLOSED;
+    }
+
+    std::string event;
+    std::string id;
+    if (parse_event(payload, event, id) != OMS_OK) {
+      continue;
+    }
+    if (event == CLIENT_EVENT_DETACHED) {
+      detached.push_back(id);
+      continue;
+    }
+    if (id != client.id) {
+      OMS_WARN("Ignored answer of shared oblogreader about client: {}, expected: {}", id, client.id);
+      continue;
+    }
+    return event == CLIENT_EVENT_ATTACHED ? OMS_OK : OMS_FAILED;
+  }
+}
+
+int SourceInvoke::poll_detached(int control_fd, std::vector<std::string>& detached)
+{
+  while (true) {
+    std::string payload;
+    int fd = -1;
+    int ret = recv_with_fd(control_fd, payload, fd, 0);
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (ret == OMS_TIMEOUT) {
+      return OMS_OK;
+    }
+    if (ret != OMS_OK) {
+      return OMS_CLIENT_CLOSED;
+    }
+
+    std::string event;
+    std::string id;
+    if (parse_event(payload, event, id) == OMS_OK && event == CLIENT_EVENT_DETACHED) {
+      detached.push_back(id);
+    }
+  }
+}
+
+int SourceInvoke::parse_event(const std::string& payload, std::string& event, std::string& id)
+{
+  rapidjson::Document doc;
+  doc.Parse(payload.c_str());
+  if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember(CLIENT_EVENT) || !doc[CLIENT_EVENT].IsString() ||
+      !doc.HasMember("id") || !doc["id"].IsString()) {
+    OMS_ERROR("Invalid event from shared oblogreader: {}", payload);
+    return OMS_FAILED;
+  }
+  event = doc[CLIENT_EVENT].GetString();
+  id = doc["id"].GetString();
+  return OMS_OK;
+}
+
 }  // namespace oceanbase::logproxy
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
 #include "config.h"
 #include "thread.h"
 #include "client_meta.h"
@@ -21,12 +23,35 @@ namespace oceanbase::logproxy {
 
 class SourceInvoke {
 public:
-  static int invoke(Comm&, const ClientMeta&, ObcdcConfig&);
+  /**
+   * @param control_fd[out] if not null, start an oblogreader to be shared with the clients coming later, and take the
+   * arranger end of the socket the clients are handed over to it through
+   */
+  static int invoke(Comm&, const ClientMeta&, ObcdcConfig&, int* control_fd = nullptr);
+
+  /**
+   * hand the client over to the shared oblogreader behind control_fd, and wait for its answer
+   * @param detached[out] the ids of the clients the oblogreader told gone meanwhile
+   * @return OMS_OK if the oblogreader took the client, OMS_FAILED if it refused, e.g. the records the client asks for
+   *         are not kept anymore, OMS_TIMEOUT if it did not answer in time, OMS_CLIENT_CLOSED if it is gone
+   */
+  static int attach(int control_fd, const ClientMeta& client, std::vector<std::string>& detached);
+
+  /**
+   * collect the ids of the clients the shared oblogreader behind control_fd told gone, without waiting
+   * @return OMS_OK, or OMS_CLIENT_CLOSED if the oblogreader is gone
+   */
+  static int poll_detached(int control_fd, std::vector<std::string>& detached);
 
 private:
   static int serialize_configs(const ClientMeta& client, const ObcdcConfig& config, const std::string& config_file);
 
-  static int start_oblogreader(Comm& comm, const ClientMeta& client, ObcdcConfig& config);
+  static int start_oblogreader(Comm& comm, const ClientMeta& client, ObcdcConfig& config, int* control_fd);
+
+  /**
+   * @param id[out] the client the event is about
+   */
+  static int parse_event(const std::string& payload, std::string& event, std::string& id);
 };
 
 }  // namespace oceanbase::logproxy
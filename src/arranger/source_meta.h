@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <set>
 #include <string>
+#include <vector>
 #include "client_meta.h"
+#include "table_rules.h"
 
 namespace oceanbase {
 namespace logproxy {
@@ -48,5 +51,30 @@ private:
   std::string id_str;
 };
 
+/**
+ * an oblogreader shared by the clients subscribing the same tenants of the same cluster
+ */
+struct SharedSourceMeta {
+  int pid = 0;
+
+  /**
+   * arranger end of the socket the clients are handed over through, -1 once the oblogreader stopped answering
+   */
+  int control_fd = -1;
+
+  /**
+   * obcdc configs the oblogreader runs with, but the ones of each client
+   */
+  std::string key;
+
+  /**
+   * tb_white_list the oblogreader runs with, the one of the client it was started for, covering the clients handed
+   * over later on
+   */
+  std::vector<TablePattern> table_whites;
+
+  std::set<std::string> client_ids;
+};
+
 }  // namespace logproxy
 }  // namespace oceanbase
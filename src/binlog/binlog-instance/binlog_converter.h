@@ -58,8 +58,8 @@ private:
 
 private:
   IObCdcAccess* _obcdc = nullptr;
-  BlockingQueue<ILogRecord*> _queue{s_meta.binlog_config()->record_queue_size()};
-  BlockingQueue<ObLogEvent*> _event_queue{s_meta.binlog_config()->record_queue_size()};
+  RingQueue<ILogRecord*> _queue{s_meta.binlog_config()->record_queue_size()};
+  RingQueue<ObLogEvent*> _event_queue{s_meta.binlog_config()->record_queue_size()};
   ClogReaderRoutine _reader{*this, _queue};
   ParallelConvert _convert{*this, _queue, _event_queue};
   BinlogStorage _storage{*this, _event_queue};
@@ -0,0 +1,381 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "binlog_dump_scheduler.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "env.h"
+#include "log.h"
+#include "timer.h"
+#include "config.h"
+#include "common_util.h"
+
+namespace oceanbase::binlog {
+
+static constexpr int EPOLL_MAX_EVENTS = 256;
+// upper bound of the loop timeout, kills are noticed within it even when no session waits for events
+static constexpr int MAX_LOOP_TIMEOUT_MS = 1000;
+
+DumpEventLoop::DumpEventLoop(uint32_t id) : Thread("DumpEventLoop"), _id(id)
+{}
+
+DumpEventLoop::~DumpEventLoop()
+{
+  if (_listener_id >= 0) {
+    g_index_manager->remove_commit_listener(_listener_id);
+    _listener_id = -1;
+  }
+  if (_event_fd >= 0) {
+    close(_event_fd);
+    _event_fd = -1;
+  }
+  if (_epoll_fd >= 0) {
+    close(_epoll_fd);
+    _epoll_fd = -1;
+  }
+}
+
+int DumpEventLoop::init()
+{
+  _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (_epoll_fd < 0) {
+    OMS_ERROR("Failed to create epoll of dump event loop {}, error: {}", _id, logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  _event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (_event_fd < 0) {
+    OMS_ERROR("Failed to create eventfd of dump event loop {}, error: {}", _id, logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  struct epoll_event event {};
+  event.events = EPOLLIN;
+  event.data.fd = _event_fd;
+  if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event) != 0) {
+    OMS_ERROR("Failed to watch eventfd of dump event loop {}, error: {}", _id, logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  _listener_id = g_index_manager->add_commit_listener(_event_fd);
+  if (_listener_id < 0) {
+    OMS_ERROR("Failed to listen to committed binlog positions in dump event loop {}", _id);
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
+void DumpEventLoop::submit(BinlogDumper* dumper)
+{
+  // the dumper never runs a thread of its own, its run flag is only cleared by stop()
+  dumper->set_run(true);
+  _nof_sessions.fetch_add(1, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _submitted.push_back(dumper);
+  }
+  wake_up();
+}
+
+void DumpEventLoop::stop()
+{
+  if (is_run()) {
+    Thread::stop();
+  }
+  wake_up();
+}
+
+void DumpEventLoop::wake_up()
+{
+  uint64_t one = 1;
+  ssize_t ret = ::write(_event_fd, &one, sizeof(one));
+  (void)ret;
+}
+
+void DumpEventLoop::run()
+{
+  OMS_INFO("Dump event loop {} started", _id);
+  struct epoll_event events[EPOLL_MAX_EVENTS];
+  while (is_run()) {
+    // 1. resume the runnable sessions, each one until its output buffer is full
+    uint64_t now_us = Timer::now();
+    for (auto iter = _sessions.begin(); iter != _sessions.end();) {
+      DumpSession& session = (iter++)->second;
+      if (!session.dumper->is_run() || session.dumper->get_connection()->killed()) {
+        close_session(session.fd);
+        continue;
+      }
+      report_session(session, now_us);
+      if (is_runnable(session) && session.dumper->resume_at_us() <= now_us) {
+        resume_session(session);
+      }
+    }
+
+    // 2. arm the listener before looking at the committed position, a commit in between still wakes the loop up
+    now_us = Timer::now();
+    bool armed = false;
+    for (auto iter = _sessions.begin(); iter != _sessions.end();) {
+      DumpSession& session = (iter++)->second;
+      if (!session.waiting) {
+        continue;
+      }
+      if (!armed) {
+        g_index_manager->arm_commit_listener(_listener_id);
+        armed = true;
+      }
+      check_waiting_session(session, now_us);
+    }
+
+    // 3. wait for sockets, commits, submitted dumpers or the next heartbeat
+    int nof_events = epoll_wait(_epoll_fd, events, EPOLL_MAX_EVENTS, next_timeout_ms(now_us));
+    if (nof_events < 0 && errno != EINTR) {
+      OMS_ERROR("Failed to wait for events in dump event loop {}, error: {}", _id, logproxy::system_err(errno));
+      break;
+    }
+    for (int i = 0; i < nof_events; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == _event_fd) {
+        uint64_t count = 0;
+        ssize_t ret = ::read(_event_fd, &count, sizeof(count));
+        (void)ret;
+        continue;
+      }
+      auto iter = _sessions.find(fd);
+      if (iter == _sessions.end()) {
+        continue;
+      }
+      DumpSession& session = iter->second;
+      if (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+        OMS_INFO("{}: The downstream connection has been closed", session.dumper->get_connection()->trace_id());
+        close_session(fd);
+        continue;
+      }
+      if (events[i].events & EPOLLOUT) {
+        write_session(session);
+      }
+    }
+
+    // only after the events, so that an event of a closed socket cannot hit a new session reusing the fd
+    accept_submitted();
+  }
+
+  for (auto iter = _sessions.begin(); iter != _sessions.end();) {
+    close_session((iter++)->first);
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (BinlogDumper* dumper : _submitted) {
+    delete dumper;
+  }
+  _submitted.clear();
+  OMS_INFO("Dump event loop {} stopped", _id);
+}
+
+void DumpEventLoop::accept_submitted()
+{
+  std::vector<BinlogDumper*> submitted;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    submitted.swap(_submitted);
+  }
+
+  for (BinlogDumper* dumper : submitted) {
+    int fd = dumper->get_connection()->get_sock_fd();
+    struct epoll_event event {};
+    event.events = EPOLLRDHUP;
+    event.data.fd = fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+      OMS_ERROR("{}: Failed to add binlog dump to event loop {}, error: {}",
+          dumper->get_connection()->trace_id(),
+          _id,
+          logproxy::system_err(errno));
+      g_dumper_manager->mark_dump_error_count();
+      _nof_sessions.fetch_sub(1, std::memory_order_relaxed);
+      delete dumper;
+      continue;
+    }
+    DumpSession& session = _sessions[fd];
+    session.dumper = dumper;
+    session.fd = fd;
+    if (Config::instance().metric_enable.val()) {
+      session.next_report_us = Timer::now() + Config::instance().counter_interval_s.val() * 1000000ULL;
+    }
+    OMS_INFO("{}: Binlog dump is scheduled on event loop {}", dumper->get_connection()->trace_id(), _id);
+  }
+}
+
+void DumpEventLoop::resume_session(DumpSession& session)
+{
+  int ret = session.dumper->resume();
+  // a throttled dumper, or one waiting for the next binlog file, stays runnable and is resumed on the loop timeout
+  if (ret == OMS_AGAIN && session.dumper->resume_at_us() == 0) {
+    session.waiting = true;
+    session.dumper->enter_wait();
+    session.next_heartbeat_us = Timer::now() + session.dumper->wait_interval_us();
+  } else if (ret != OMS_OK) {
+    session.finished = true;
+  }
+  write_session(session);
+}
+
+bool DumpEventLoop::write_session(DumpSession& session)
+{
+  bool drained = false;
+  Connection* conn = session.dumper->get_connection();
+  if (conn->write_pending_output(drained) != IoResult::SUCCESS) {
+    OMS_ERROR("{}: Failed to send binlog events, error: {}", conn->trace_id(), logproxy::system_err(errno));
+    if (!session.finished) {
+      g_dumper_manager->mark_dump_error_count();
+    }
+    close_session(session.fd);
+    return false;
+  }
+  if (drained && session.finished) {
+    close_session(session.fd);
+    return false;
+  }
+
+  if (session.want_write == drained) {
+    struct epoll_event event {};
+    event.events = drained ? EPOLLRDHUP : (EPOLLRDHUP | EPOLLOUT);
+    event.data.fd = session.fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, session.fd, &event) != 0) {
+      OMS_ERROR("{}: Failed to update binlog dump in event loop {}, error: {}",
+          conn->trace_id(),
+          _id,
+          logproxy::system_err(errno));
+      close_session(session.fd);
+      return false;
+    }
+    session.want_write = !drained;
+  }
+  return true;
+}
+
+void DumpEventLoop::check_waiting_session(DumpSession& session, uint64_t now_us)
+{
+  BinlogDumper* dumper = session.dumper;
+  if (dumper->has_new_events()) {
+    session.waiting = false;
+    return;
+  }
+  if (now_us < session.next_heartbeat_us) {
+    return;
+  }
+  session.next_heartbeat_us = now_us + dumper->wait_interval_us();
+  // a client that has not taken the previous heartbeat yet does not need another one
+  if (session.want_write) {
+    return;
+  }
+  if (dumper->send_wait_heartbeat(dumper->get_checkpoint().second) != IoResult::SUCCESS) {
+    OMS_ERROR("Failed to send heartbeat: {}", dumper->get_connection()->trace_id());
+    close_session(session.fd);
+    return;
+  }
+  write_session(session);
+}
+
+void DumpEventLoop::report_session(DumpSession& session, uint64_t now_us)
+{
+  // the gauges are registered by the first resume()
+  if (session.next_report_us == 0 || now_us < session.next_report_us) {
+    return;
+  }
+  session.next_report_us = now_us + Config::instance().counter_interval_s.val() * 1000000ULL;
+  session.dumper->report_metrics();
+}
+
+void DumpEventLoop::close_session(int fd)
+{
+  auto iter = _sessions.find(fd);
+  if (iter == _sessions.end()) {
+    return;
+  }
+  epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+  BinlogDumper* dumper = iter->second.dumper;
+  _sessions.erase(iter);
+  _nof_sessions.fetch_sub(1, std::memory_order_relaxed);
+  // releases the connection and closes the socket
+  delete dumper;
+}
+
+int DumpEventLoop::next_timeout_ms(uint64_t now_us)
+{
+  uint64_t timeout_us = MAX_LOOP_TIMEOUT_MS * 1000ULL;
+  for (const auto& session_pair : _sessions) {
+    const DumpSession& session = session_pair.second;
+    uint64_t due_us = session.waiting ? session.next_heartbeat_us : 0;
+    if (is_runnable(session)) {
+      due_us = session.dumper->resume_at_us();
+      if (due_us <= now_us) {
+        return 0;
+      }
+    }
+    for (uint64_t next_us : {due_us, session.next_report_us}) {
+      if (next_us != 0) {
+        uint64_t remaining_us = next_us > now_us ? next_us - now_us : 0;
+        timeout_us = remaining_us < timeout_us ? remaining_us : timeout_us;
+      }
+    }
+  }
+  // round up, waking up early would only spin until the heartbeat or the resumption is due
+  return static_cast<int>((timeout_us + 999) / 1000);
+}
+
+BinlogDumpScheduler::BinlogDumpScheduler(uint32_t nof_loops) : _nof_loops(nof_loops)
+{}
+
+BinlogDumpScheduler::~BinlogDumpScheduler()
+{
+  stop();
+  for (DumpEventLoop* loop : _loops) {
+    delete loop;
+  }
+  _loops.clear();
+}
+
+int BinlogDumpScheduler::start()
+{
+  for (uint32_t i = 0; i < _nof_loops; ++i) {
+    auto* loop = new DumpEventLoop(i);
+    if (loop->init() != OMS_OK) {
+      delete loop;
+      return OMS_FAILED;
+    }
+    _loops.push_back(loop);
+    loop->start();
+  }
+  OMS_INFO("Started binlog dump scheduler with {} event loops", _nof_loops);
+  return OMS_OK;
+}
+
+void BinlogDumpScheduler::stop()
+{
+  for (DumpEventLoop* loop : _loops) {
+    loop->stop();
+  }
+  for (DumpEventLoop* loop : _loops) {
+    loop->join();
+  }
+}
+
+void BinlogDumpScheduler::submit(BinlogDumper* dumper)
+{
+  DumpEventLoop* target = _loops.front();
+  for (DumpEventLoop* loop : _loops) {
+    if (loop->session_num() < target->session_num()) {
+      target = loop;
+    }
+  }
+  target->submit(dumper);
+}
+
+}  // namespace oceanbase::binlog
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "thread.h"
+#include "binlog_dumper.h"
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief One event loop of the BinlogDumpScheduler, multiplexing the dump sessions assigned to it over epoll.
+ *
+ * A session is runnable, waiting for new events or finishing. Runnable sessions are resumed in turn, each one until
+ * its output buffer is full, so the sessions of a loop share it fairly. The output is written out without blocking;
+ * a session whose socket does not take it all is not resumed before EPOLLOUT, which is the backpressure towards slow
+ * clients. A runnable session throttled, or waiting for the next binlog file, is resumed from the time its dumper
+ * asks for, nothing sleeps on the loop. Waiting sessions are woken by the committed position listener of the loop and
+ * send their heartbeats from the loop timeout, and the gauges of all sessions are reported from the loop as well.
+ */
+class DumpEventLoop : public Thread {
+public:
+  explicit DumpEventLoop(uint32_t id);
+
+  ~DumpEventLoop() override;
+
+  int init();
+
+  /*!
+   * @brief Take over the dumper, thread-safe
+   */
+  void submit(BinlogDumper* dumper);
+
+  void stop() override;
+
+  uint32_t session_num() const
+  {
+    return _nof_sessions.load(std::memory_order_relaxed);
+  }
+
+protected:
+  void run() override;
+
+private:
+  struct DumpSession {
+    BinlogDumper* dumper = nullptr;
+    int fd = -1;
+    bool waiting = false;
+    // the dump has ended, the session is closed once its output has been written out
+    bool finished = false;
+    // EPOLLOUT is armed, the socket does not take more output for now
+    bool want_write = false;
+    uint64_t next_heartbeat_us = 0;
+    // when to report the dumper gauges, 0 if metrics are disabled
+    uint64_t next_report_us = 0;
+  };
+
+  static bool is_runnable(const DumpSession& session)
+  {
+    return !session.waiting && !session.finished && !session.want_write;
+  }
+
+  void accept_submitted();
+
+  void resume_session(DumpSession& session);
+
+  /*!
+   * @return false if the session has been closed
+   */
+  bool write_session(DumpSession& session);
+
+  void check_waiting_session(DumpSession& session, uint64_t now_us);
+
+  void report_session(DumpSession& session, uint64_t now_us);
+
+  void close_session(int fd);
+
+  void wake_up();
+
+  int next_timeout_ms(uint64_t now_us);
+
+private:
+  uint32_t _id;
+  int _epoll_fd = -1;
+  int _event_fd = -1;
+  int _listener_id = -1;
+
+  std::mutex _mutex;
+  std::vector<BinlogDumper*> _submitted;
+
+  // owned by the loop thread, keyed by socket
+  std::map<int, DumpSession> _sessions;
+  std::atomic<uint32_t> _nof_sessions{0};
+};
+
+/*!
+ * @brief Dump engine that runs all binlog dump sessions on a few event loops rather than on a thread each, enabled by
+ * binlog_dump_scheduler_threads.
+ */
+class BinlogDumpScheduler {
+public:
+  explicit BinlogDumpScheduler(uint32_t nof_loops);
+
+  ~BinlogDumpScheduler();
+
+  BinlogDumpScheduler(const BinlogDumpScheduler&) = delete;
+  BinlogDumpScheduler& operator=(const BinlogDumpScheduler&) = delete;
+
+  int start();
+
+  void stop();
+
+  /*!
+   * @brief Hand the dumper over to the loop with the fewest sessions, which also releases it once the dump ends
+   */
+  void submit(BinlogDumper* dumper);
+
+private:
+  uint32_t _nof_loops;
+  std::vector<DumpEventLoop*> _loops;
+};
+
+}  // namespace oceanbase::binlog
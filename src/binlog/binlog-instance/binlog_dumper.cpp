@@ -11,6 +11,7 @@
  */
 
 #include <mutex>
+#include <tuple>
 
 #include "env.h"
 #include "binlog_dumper.h"
@@ -20,9 +21,30 @@
 #include "guard.hpp"
 #include "common_util.h"
 #include "counter.h"
+#include "checksum.h"
+#include "pipeline_latency.h"
 #include "metric/prometheus.h"
 
 namespace oceanbase::binlog {
+// how often and how many times the dumper checks for the file rotated to, which the storage may not have created yet
+static constexpr uint64_t ROTATE_READY_RETRY_INTERVAL_US = 10000;
+static constexpr int ROTATE_READY_RETRIES = 100;
+
+/*!
+ * @brief Whether the client reads Transaction_payload events: the MySQL client library since 8.0.20, which replicas
+ * and mysqlbinlog are built on. Other clients cannot be told apart by their version and get the events decompressed.
+ */
+static bool understands_transaction_payload(const std::string& client_name, const std::string& client_version)
+{
+  unsigned int major = 0;
+  unsigned int minor = 0;
+  unsigned int patch = 0;
+  if (client_name != "libmysql" || sscanf(client_version.c_str(), "%u.%u.%u", &major, &minor, &patch) != 3) {
+    return false;
+  }
+  return std::make_tuple(major, minor, patch) >= std::make_tuple(8U, 0U, 20U);
+}
+
 void BinlogDumper::stop()
 {
   if (is_run()) {
@@ -31,6 +53,52 @@ void BinlogDumper::stop()
 }
 
 void BinlogDumper::run()
+{
+  if (prepare() != OMS_OK) {
+    g_dumper_manager->mark_dump_error_count();
+    return;
+  }
+
+  // Coalesce binlog events into large writes, they are flushed after each batch read from the binlog file and
+  // whenever the dumper goes idle
+  _connection->set_output_batching(true);
+  defer(_connection->set_output_batching(false));
+
+  while (is_run() && !_connection->killed()) {
+    if (open_binlog_file() != OMS_OK) {
+      g_dumper_manager->mark_dump_error_count();
+      break;
+    }
+
+    // 3.send binlog file
+    IoResult io_ret = send_binlog(_checkpoint.first, _checkpoint.second);
+    if (io_ret != IoResult::SUCCESS) {
+      OMS_ERROR("{}: Failed to send binlog: {}, IoResult: {}",
+          _connection->trace_id(),
+          _relative_file,
+          static_cast<uint8_t>(io_ret));
+      g_dumper_manager->mark_dump_error_count();
+      return;
+    }
+
+    if (_flag == BINLOG_DUMP_NON_BLOCK) {
+      OMS_INFO("{}: Send eof packet", _connection->trace_id());
+      // Clear and send cached data
+      send_packet();
+      _connection->send_eof_packet();
+      break;
+    }
+
+    // 4. rotate binlog file
+    if (rotate_binlog_file() != OMS_OK) {
+      g_dumper_manager->mark_dump_error_count();
+      break;
+    }
+    wait_rotate_ready(_file);
+  }
+}
+
+int BinlogDumper::prepare()
 {
   /*!
    * @brief 注册
@@ -43,13 +111,11 @@ void BinlogDumper::run()
   if (is_gtid_mod()) {
     if (seek_first_binlog_file() != OMS_OK) {
       // In GTID mode, the binlog file that meets the conditions cannot be found
-      g_dumper_manager->mark_dump_error_count();
-      return;
+      return OMS_FAILED;
     }
   }
   if (OMS_OK != check_start_file()) {
-    g_dumper_manager->mark_dump_error_count();
-    return;
+    return OMS_FAILED;
   }
 
   /*!
@@ -58,96 +124,224 @@ void BinlogDumper::run()
    */
   init_binlog_checksum();
 
-  while (is_run() && !_connection->killed()) {
-    OMS_INFO("{}: Begin send fake rotate event", _connection->trace_id());
-    if (_relative_file.empty()) {
-      vector<BinlogIndexRecord*> index_records;
-      defer(release_vector(index_records));
-      g_index_manager->fetch_index_vector(index_records);
-      if (!index_records.empty()) {
-        set_file(binlog::CommonUtils::fill_binlog_file_name(index_records.front()->get_index()));
-        OMS_INFO("{}: Find the first binlog file that is not included in the executed gtid,binlog file:{}",
-            _connection->trace_id(),
-            binlog::CommonUtils::fill_binlog_file_name(index_records.front()->get_index()));
-      }
+  _client_reads_payload = understands_transaction_payload(
+      _connection->get_connect_attr("_client_name"), _connection->get_connect_attr("_client_version"));
+  _decompress_payload = !_client_reads_payload;
+  OMS_INFO("{}: Transaction payloads are sent {}",
+      _connection->trace_id(),
+      _decompress_payload ? "decompressed" : "as they are");
+  return OMS_OK;
+}
+
+int BinlogDumper::open_binlog_file()
+{
+  OMS_INFO("{}: Begin send fake rotate event", _connection->trace_id());
+  if (_relative_file.empty()) {
+    vector<BinlogIndexRecord*> index_records;
+    defer(release_vector(index_records));
+    g_index_manager->fetch_index_vector(index_records);
+    if (!index_records.empty()) {
+      set_file(binlog::CommonUtils::fill_binlog_file_name(index_records.front()->get_index()));
+      OMS_INFO("{}: Find the first binlog file that is not included in the executed gtid,binlog file:{}",
+          _connection->trace_id(),
+          binlog::CommonUtils::fill_binlog_file_name(index_records.front()->get_index()));
     }
-    _connection->conn_info().state = ProcessState::SEND_EVENT;
-    // 1.send fake rotate event
-    if (send_fake_rotate_event(_relative_file, _start_pos) != IoResult::SUCCESS) {
-      OMS_ERROR("{}: {}", _connection->trace_id(), "Failed to send fake rotate event");
+  }
+  _connection->conn_info().state = ProcessState::SEND_EVENT;
+  // 1.send fake rotate event
+  if (send_fake_rotate_event(_relative_file, _start_pos) != IoResult::SUCCESS) {
+    OMS_ERROR("{}: {}", _connection->trace_id(), "Failed to send fake rotate event");
+    return OMS_FAILED;
+  }
+
+  if (_start_pos < BINLOG_MAGIC_SIZE) {
+    OMS_ERROR("{}: The file offset is invalid.", _connection->trace_id());
+    binlog::ErrPacket error_packet{
+        BINLOG_FATAL_ERROR, "Client requested master to start replication from position < 4.", "HY000"};
+    _connection->send(error_packet);
+    return OMS_FAILED;
+  }
+
+  // 2. check binlog file
+  unsigned char magic[BINLOG_MAGIC_SIZE];
+  OMS_INFO("{}: Start open binlog file: {}", _connection->trace_id(), _file.c_str());
+  if (this->_fp != nullptr) {
+    fclose(this->_fp);
+    this->_fp = nullptr;
+  }
+  this->_fp = fopen(_file.c_str(), "rb+");
+  if (this->_fp == nullptr) {
+    OMS_INFO(
+        "{}: Failed to open binlog file: {},reason:{}", _connection->trace_id(), _file, logproxy::system_err(errno));
+    binlog::ErrPacket error_packet{BINLOG_FATAL_ERROR, "failed to open binlog file", "HY000"};
+    _connection->send(error_packet);
+    return OMS_FAILED;
+  }
+  _reader.reset(fileno(this->_fp));
+  // read magic number
+  FsUtil::read_file(this->_fp, magic, 0, sizeof(magic));
+
+  if (memcmp(magic, binlog_magic, sizeof(magic)) != 0) {
+    OMS_INFO("{}: The file format is invalid.", _connection->trace_id());
+    binlog::ErrPacket error_packet{BINLOG_FATAL_ERROR,
+        "Binlog has bad magic number;  It's not a binary log file that can be used by this version of MySQL.",
+        "HY000"};
+    _connection->send(error_packet);
+    return OMS_FAILED;
+  }
+  _checkpoint.first = _file;
+  _checkpoint.second = _start_pos;
+  return OMS_OK;
+}
+
+int BinlogDumper::rotate_binlog_file()
+{
+  if (seek_next_binlog() != OMS_OK) {
+    binlog::ErrPacket error_packet{BINLOG_FATAL_ERROR, "could not find next log.", "HY000"};
+    _connection->send(error_packet);
+    return OMS_FAILED;
+  }
+  _file = _checkpoint.first;
+  _start_pos = BINLOG_MAGIC_SIZE;
+  return OMS_OK;
+}
+
+bool BinlogDumper::check_rotate_ready()
+{
+  if (_rotate_deadline_us == 0) {
+    return true;
+  }
+  uint64_t now_us = Timer::now();
+  if (FsUtil::exist(_file)) {
+    _rotate_deadline_us = 0;
+    return true;
+  }
+  if (now_us >= _rotate_deadline_us) {
+    // opening it fails then
+    OMS_ERROR("{}: The currently rotated file {} is not exist", _connection->trace_id(), _file);
+    _rotate_deadline_us = 0;
+    return true;
+  }
+  OMS_WARN("{}: The currently rotated file {} is not ready", _connection->trace_id(), _file);
+  _resume_at_us = now_us + ROTATE_READY_RETRY_INTERVAL_US;
+  return false;
+}
+
+int BinlogDumper::resume()
+{
+  _resume_at_us = 0;
+  if (_phase == DumpPhase::PREPARE) {
+    // the event loop owns the socket from now on, and sendfile would block it on a full socket
+    _zero_copy_min_bytes = 0;
+    _nonblocking = true;
+    if (_connection->set_output_deferred() != OMS_OK || prepare() != OMS_OK) {
       g_dumper_manager->mark_dump_error_count();
-      break;
+      return OMS_FAILED;
     }
+    _phase = DumpPhase::OPEN_FILE;
+  }
 
-    if (_start_pos < BINLOG_MAGIC_SIZE) {
-      OMS_ERROR("{}: The file offset is invalid.", _connection->trace_id());
-      binlog::ErrPacket error_packet{
-          BINLOG_FATAL_ERROR, "Client requested master to start replication from position < 4.", "HY000"};
-      _connection->send(error_packet);
-      g_dumper_manager->mark_dump_error_count();
-      break;
+  _connection->conn_info().state = ProcessState::SEND_EVENT;
+  while (is_run() && !_connection->killed() && !_connection->output_full() && _resume_at_us == 0) {
+    if (_phase == DumpPhase::OPEN_FILE) {
+      if (!check_rotate_ready()) {
+        return OMS_AGAIN;
+      }
+      if (open_binlog_file() != OMS_OK || send_format_description_event(this->_fp, _file) != IoResult::SUCCESS) {
+        g_dumper_manager->mark_dump_error_count();
+        return OMS_FAILED;
+      }
+      OMS_INFO("{}: Send format description event", _connection->trace_id());
+      if (_start_pos > _checkpoint.second) {
+        _checkpoint.second = _start_pos;
+      }
+      _phase = DumpPhase::SEND_EVENTS;
+      continue;
     }
 
-    // 2. check binlog file
-    unsigned char magic[BINLOG_MAGIC_SIZE];
-    OMS_INFO("{}: Start open binlog file: {}", _connection->trace_id(), _file.c_str());
-    if (this->_fp != nullptr) {
-      fclose(this->_fp);
-      this->_fp = nullptr;
+    uint64_t end_pos = 0;
+    int ret = peek_binlog_end_pos(_checkpoint.first, end_pos);
+    if (ret == OMS_AGAIN) {
+      return OMS_AGAIN;
     }
-    this->_fp = fopen(_file.c_str(), "rb+");
-    if (this->_fp == nullptr) {
-      OMS_INFO(
-          "{}: Failed to open binlog file: {},reason:{}", _connection->trace_id(), _file, logproxy::system_err(errno));
-      binlog::ErrPacket error_packet{BINLOG_FATAL_ERROR, "failed to open binlog file", "HY000"};
-      _connection->send(error_packet);
+    if (ret == OMS_FAILED) {
+      OMS_ERROR("The subscribed site [{},{}] is incorrect and exceeds the maximum value of the BINLOG file.",
+          _checkpoint.first,
+          _checkpoint.second);
       g_dumper_manager->mark_dump_error_count();
-      break;
+      return OMS_FAILED;
     }
-    // read magic number
-    FsUtil::read_file(this->_fp, magic, 0, sizeof(magic));
-
-    if (memcmp(magic, binlog_magic, sizeof(magic)) != 0) {
-      OMS_INFO("{}: The file format is invalid.", _connection->trace_id());
-      binlog::ErrPacket error_packet{BINLOG_FATAL_ERROR,
-          "Binlog has bad magic number;  It's not a binary log file that can be used by this version of MySQL.",
-          "HY000"};
-      _connection->send(error_packet);
-      g_dumper_manager->mark_dump_error_count();
-      break;
+    if (ret == OMS_BINLOG_SKIP) {
+      OMS_INFO("{}: The current Binlog file has been sent,binlog file:{},offset:{}",
+          _connection->trace_id(),
+          _checkpoint.first,
+          _checkpoint.second);
+      if (_flag == BINLOG_DUMP_NON_BLOCK) {
+        OMS_INFO("{}: Send eof packet", _connection->trace_id());
+        _connection->send_eof_packet();
+        return OMS_BINLOG_SKIP;
+      }
+      if (rotate_binlog_file() != OMS_OK) {
+        g_dumper_manager->mark_dump_error_count();
+        return OMS_FAILED;
+      }
+      _rotate_deadline_us = Timer::now() + ROTATE_READY_RETRIES * ROTATE_READY_RETRY_INTERVAL_US;
+      _phase = DumpPhase::OPEN_FILE;
+      continue;
     }
-    _checkpoint.first = _file;
-    _checkpoint.second = _start_pos;
 
-    // 3.send binlog file
-    IoResult io_ret = send_binlog(_checkpoint.first, _checkpoint.second);
-    if (io_ret != IoResult::SUCCESS) {
-      OMS_ERROR("{}: Failed to send binlog: {}, IoResult: {}",
-          _connection->trace_id(),
-          _relative_file,
-          static_cast<uint8_t>(io_ret));
+    uint64_t start_pos = _checkpoint.second;
+    if (send_events(start_pos, end_pos) != IoResult::SUCCESS) {
+      OMS_ERROR("{}: Failed to send events", _connection->trace_id());
       g_dumper_manager->mark_dump_error_count();
-      return;
+      return OMS_FAILED;
     }
-
-    if (_flag == BINLOG_DUMP_NON_BLOCK) {
-      OMS_INFO("{}: Send eof packet", _connection->trace_id());
-      // Clear and send cached data
-      send_packet();
-      _connection->send_eof_packet();
-      break;
+    if (_checkpoint.second == start_pos) {
+      // the last event is incomplete on disk, wait for the storage to commit it
+      return OMS_AGAIN;
     }
+  }
+  if (!is_run() || _connection->killed()) {
+    return OMS_FAILED;
+  }
+  // throttled, the events sent are paid for by waiting before the next ones
+  return _resume_at_us != 0 ? OMS_AGAIN : OMS_OK;
+}
 
-    // 4. rotate binlog file
-    if (seek_next_binlog() != OMS_OK) {
-      binlog::ErrPacket error_packet{BINLOG_FATAL_ERROR, "could not find next log.", "HY000"};
-      _connection->send(error_packet);
-      g_dumper_manager->mark_dump_error_count();
-      break;
-    }
-    _file = _checkpoint.first;
-    _start_pos = BINLOG_MAGIC_SIZE;
+void BinlogDumper::enter_wait()
+{
+  _connection->conn_info().state = ProcessState::WAIT_EVENT;
+  _nof_heartbeat_send = 0;
+  _need_log_heartbeat = false;
+}
+
+bool BinlogDumper::has_new_events() const
+{
+  uint64_t committed_index = 0;
+  uint64_t committed_pos = 0;
+  if (!g_index_manager->get_committed_position(committed_index, committed_pos)) {
+    return false;
+  }
+  uint64_t file_index = CommonUtils::get_binlog_index(_checkpoint.first);
+  return committed_index > file_index || (committed_index == file_index && committed_pos > _checkpoint.second);
+}
+
+uint64_t BinlogDumper::wait_interval_us()
+{
+  uint64_t heartbeat_period_us = get_heartbeat_period_us();
+  return heartbeat_period_us == 0 ? s_config.binlog_heartbeat_interval_us.val() : heartbeat_period_us;
+}
+
+IoResult BinlogDumper::send_wait_heartbeat(uint64_t pos)
+{
+  uint64_t heartbeat_period_us = get_heartbeat_period_us();
+  if (0 == heartbeat_period_us) {
+    return IoResult::SUCCESS;
   }
+  _nof_heartbeat_send = _need_log_heartbeat ? 1 : _nof_heartbeat_send + 1;
+  _need_log_heartbeat = (_nof_heartbeat_send >= s_config.binlog_log_heartbeat_interval_times.val()) ||
+                        (heartbeat_period_us >= 1 * 1000000);
+  return send_heartbeat_event(pos, _need_log_heartbeat);
 }
 
 int BinlogDumper::seek_first_binlog_file()
@@ -279,7 +473,6 @@ int BinlogDumper::seek_next_binlog()
       _checkpoint.first = index->get_file_name();
       _relative_file = binlog::CommonUtils::fill_binlog_file_name(index->get_index());
       _checkpoint.second = BINLOG_MAGIC_SIZE;
-      wait_rotate_ready(_checkpoint.first);
       break;
     }
     if (strcmp(index->get_file_name().c_str(), _file.c_str()) == 0) {
@@ -409,32 +602,78 @@ int BinlogDumper::seek_event(FILE* stream, MsgBuf& msg_buf, bool& skip_record)
     return OMS_FAILED;
   }
 
+  if (!accept_event(header, event_buf + 1, skip_record)) {
+    return UNKNOWN_EVENT;
+  }
+  msg_buf.push_back(reinterpret_cast<char*>(event_buf), event_len + 1);
+  release = false;
+  return header.get_type_code();
+}
+
+bool BinlogDumper::is_zero_copy_event(OblogEventHeader& header) const
+{
+  if (_zero_copy_min_bytes == 0 || header.get_event_length() < _zero_copy_min_bytes) {
+    return false;
+  }
+  // the body of these events is inspected before sending
+  switch (header.get_type_code()) {
+    case FORMAT_DESCRIPTION_EVENT:
+    case GTID_LOG_EVENT:
+    case ROTATE_EVENT:
+      return false;
+    case TRANSACTION_PAYLOAD_EVENT:
+      return !_decompress_payload;
+    default:
+      return true;
+  }
+}
+
+bool BinlogDumper::accept_event(OblogEventHeader& header, unsigned char* event, bool& skip_record)
+{
   /*!
    * @brief For each FORMAT_DESCRIPTION_EVENT, the checksum parameter needs to be updated
    */
   if (header.get_type_code() == EventType::FORMAT_DESCRIPTION_EVENT) {
     FormatDescriptionEvent fd_event = FormatDescriptionEvent();
-    fd_event.deserialize(event_buf + 1);
+    fd_event.deserialize(event);
     set_binlog_checksum(static_cast<enum_checksum_flag>(fd_event.get_checksum_flag()));
+    // the payloads are passed through only when the file declares them to the client
+    size_t event_types = fd_event.get_event_type_header_len().size();
+    _decompress_payload = !_client_reads_payload || event_types < static_cast<size_t>(PAYLOAD_LOG_EVENT_TYPES);
   }
-  skip_record = skip_event(header, event_buf, skip_record);
+  uint32_t event_len = header.get_event_length();
+  skip_record = skip_event(header, event, skip_record);
   _checkpoint.second += event_len;
   if (skip_record) {
-    return UNKNOWN_EVENT;
+    return false;
+  }
+  if (_nonblocking) {
+    uint64_t micros_to_wait = _rate_limiter.reserve_event(event_len);
+    if (micros_to_wait > 0) {
+      _resume_at_us = Timer::now() + micros_to_wait;
+    }
+  } else {
+    _rate_limiter.in_event_with_alarm(event_len);
   }
-  msg_buf.push_back(reinterpret_cast<char*>(event_buf), event_len + 1);
-  release = false;
-  _rate_limiter.in_event_with_alarm(event_len);
 
   // mark the latest checkpoint where the event is sent currently
   mark_metrics(header.get_timestamp(),
       event_len,
       header.get_type_code() != EventType::FORMAT_DESCRIPTION_EVENT &&
           header.get_type_code() != EventType::PREVIOUS_GTIDS_LOG_EVENT);
-  return header.get_type_code();
+  return true;
 }
 
 int BinlogDumper::seek_binlog_end_pos(const std::string& file, uint64_t& end_pos)
+{
+  int ret = peek_binlog_end_pos(file, end_pos);
+  if (ret != OMS_AGAIN) {
+    return ret;
+  }
+  return wait_event(file, _checkpoint.second, end_pos);
+}
+
+int BinlogDumper::peek_binlog_end_pos(const std::string& file, uint64_t& end_pos)
 {
   if (!g_index_manager->is_active(file)) {
     uint64_t file_end_pos = FsUtil::file_size(file);
@@ -469,39 +708,40 @@ int BinlogDumper::seek_binlog_end_pos(const std::string& file, uint64_t& end_pos
     return OMS_BINLOG_SKIP;
   }
 
-  return wait_event(file, _checkpoint.second, end_pos);
+  return OMS_AGAIN;
 }
 
 int BinlogDumper::wait_event(const std::string& file, uint64_t pos, uint64_t& new_pos)
 {
-  uint8_t nof_heartbeat_send = 0;
-  bool need_log_heartbeat = false;
-
-  _connection->conn_info().state = ProcessState::WAIT_EVENT;
+  enter_wait();
   while (is_run() && !_connection->killed()) {
-    uint64_t heartbeat_period_us = get_heartbeat_period_us();
-    uint64_t wait_time_us =
-        heartbeat_period_us == 0 ? s_config.binlog_heartbeat_interval_us.val() : heartbeat_period_us;
+    // nothing may stay buffered while waiting, this also pushes out the heartbeat of the previous round
+    if (_connection->flush_output() != IoResult::SUCCESS) {
+      OMS_ERROR("{}: Failed to flush binlog events", _connection->trace_id());
+      return OMS_FAILED;
+    }
+    uint64_t wait_time_us = wait_interval_us();
     bool new_events_coming = g_index_manager->is_behind_current_pos(file, pos, wait_time_us);
     OMS_DEBUG("{}: new_events_coming: {}, wait time(us): {}", _connection->trace_id(), new_events_coming, wait_time_us);
     if (new_events_coming) {
-      struct stat file_stat {};
-      int ret = stat(file.c_str(), &file_stat);
-      new_pos = (ret == 0 ? file_stat.st_size : 0);
+      // the committed position is the end of the file unless the storage has rotated meanwhile
+      uint64_t committed_index = 0;
+      uint64_t committed_pos = 0;
+      if (g_index_manager->get_committed_position(committed_index, committed_pos) &&
+          committed_index == CommonUtils::get_binlog_index(file)) {
+        new_pos = committed_pos;
+      } else {
+        struct stat file_stat {};
+        int ret = stat(file.c_str(), &file_stat);
+        new_pos = (ret == 0 ? file_stat.st_size : 0);
+      }
       _connection->conn_info().state = ProcessState::SEND_EVENT;
       OMS_DEBUG(
           "{}: Discover new events: {}, [from pos, new pos]: {} -> {}", _connection->trace_id(), file, pos, new_pos);
       return OMS_OK;
-    } else {
-      if (0 != heartbeat_period_us) {
-        nof_heartbeat_send = need_log_heartbeat ? 1 : nof_heartbeat_send + 1;
-        need_log_heartbeat = (nof_heartbeat_send >= s_config.binlog_log_heartbeat_interval_times.val()) ||
-                             (heartbeat_period_us >= 1 * 1000000);
-        if (send_heartbeat_event(pos, need_log_heartbeat) != IoResult::SUCCESS) {
-          OMS_ERROR("Failed to send heartbeat: {}", _connection->trace_id());
-          return OMS_FAILED;
-        }
-      }
+    } else if (send_wait_heartbeat(pos) != IoResult::SUCCESS) {
+      OMS_ERROR("Failed to send heartbeat: {}", _connection->trace_id());
+      return OMS_FAILED;
     }
   }
   return OMS_OK;
@@ -513,28 +753,59 @@ IoResult BinlogDumper::send_events(uint64_t start_pos, uint64_t end_pos)
   bool skip_record = false;
   _checkpoint.second = start_pos;
   OMS_DEBUG("{}: send events from offset: {}, end pos: {}", _connection->trace_id(), _checkpoint.second, end_pos);
-  while (!_connection->killed() && _checkpoint.second < end_pos &&
-         is_legal_event(this->_fp, _checkpoint.second, end_pos)) {
+  // events are walked in place in the read-ahead buffer and sent from there
+  while (!_connection->killed() && !_connection->output_full() && _resume_at_us == 0 && _checkpoint.second < end_pos) {
     _stage_timer.reset();
-    int result = seek_event(this->_fp, _packet, skip_record);
-
-    if (result == OMS_FAILED) {
+    uint64_t offset = _checkpoint.second;
+    unsigned char* event = nullptr;
+    uint32_t event_len = 0;
+    int read_ret = _reader.read_header(offset, end_pos, event, event_len);
+    OblogEventHeader header = OblogEventHeader();
+    bool zero_copy = false;
+    if (read_ret == OMS_OK) {
+      header.deserialize(event);
+      zero_copy = is_zero_copy_event(header);
+      if (!zero_copy) {
+        read_ret = _reader.read_event(offset, end_pos, event, event_len);
+      }
+    }
+    if (read_ret == OMS_AGAIN) {
+      OMS_WARN("{}: The content of the current binlog event is incomplete, offset: {}, end pos: {}",
+          _connection->trace_id(),
+          _checkpoint.second,
+          end_pos);
+      break;
+    }
+    if (read_ret != OMS_OK) {
       _connection->send_err_packet(BINLOG_FATAL_ERROR, "I/O error reading log event", "HY000");
       return IoResult::FAIL;
     }
 
-    if (result != UNKNOWN_EVENT) {
-      OMS_DEBUG("{}: sending events,checkpoint:[{}, {}][buff size: {}]",
-          _checkpoint.first,
-          _checkpoint.second,
-          _packet.byte_size());
-      ret = send_packet();
+    // only the header of a zero-copy event is in memory, which is all accept_event needs for such events
+    if (!accept_event(header, event, skip_record)) {
+      continue;
+    }
+    if (_decompress_payload && header.get_type_code() == TRANSACTION_PAYLOAD_EVENT) {
+      ret = send_payload_events(header, event);
       if (ret != IoResult::SUCCESS) {
-        OMS_ERROR("{}: Failed to send packet", _connection->trace_id());
+        OMS_ERROR("{}: Failed to send transaction payload at offset: {}", _connection->trace_id(), offset);
         return ret;
       }
+      continue;
     }
-    if (result == ROTATE_EVENT) {
+    OMS_DEBUG("{}: sending events,checkpoint:[{}, {}][event size: {}][zero copy: {}]",
+        _connection->trace_id(),
+        _checkpoint.first,
+        _checkpoint.second,
+        event_len,
+        zero_copy);
+    ret = zero_copy ? _connection->send_binlog_event_file(_reader.fd(), offset, event_len)
+                    : _connection->send_binlog_event_slice(event, event_len);
+    if (ret != IoResult::SUCCESS) {
+      OMS_ERROR("{}: Failed to send packet, error: {}", _connection->trace_id(), logproxy::system_err(errno));
+      return ret;
+    }
+    if (header.get_type_code() == ROTATE_EVENT) {
       _rotate_file = _checkpoint.first;
       OMS_INFO("{}: sending rotate event,checkpoint:[{},{}]",
           _connection->trace_id(),
@@ -543,6 +814,41 @@ IoResult BinlogDumper::send_events(uint64_t start_pos, uint64_t end_pos)
       break;
     }
   }
+  PipelineLatency::instance().mark_sent(_checkpoint.first, _checkpoint.second);
+  return IoResult::SUCCESS;
+}
+
+IoResult BinlogDumper::send_payload_events(OblogEventHeader& header, unsigned char* event)
+{
+  TransactionPayloadEvent payload_event;
+  payload_event.set_checksum_flag(_checksum_flag);
+  payload_event.deserialize(event);
+  if (payload_event.decompress(_payload_events) != OMS_OK) {
+    _connection->send_err_packet(BINLOG_FATAL_ERROR, "Failed to decompress transaction payload", "HY000");
+    return IoResult::FAIL;
+  }
+
+  for (size_t offset = 0; offset < _payload_events.size();) {
+    unsigned char* inner_event = _payload_events.data() + offset;
+    uint32_t event_len = offset + COMMON_HEADER_LENGTH <= _payload_events.size()
+                             ? int4load(inner_event + EVENT_LEN_OFFSET)
+                             : 0;
+    if (event_len < COMMON_HEADER_LENGTH + payload_event.get_checksum_len() || offset + event_len > _payload_events.size()) {
+      OMS_ERROR("{}: Corrupted event at offset {} of transaction payload", _connection->trace_id(), offset);
+      _connection->send_err_packet(BINLOG_FATAL_ERROR, "Corrupted transaction payload", "HY000");
+      return IoResult::FAIL;
+    }
+    int4store(inner_event + LOG_POS_OFFSET, header.get_next_position());
+    if (_checksum_flag == CRC32) {
+      uint32_t checksummed = event_len - COMMON_CHECKSUM_LENGTH;
+      int4store(inner_event + checksummed, crc32_of(inner_event, checksummed));
+    }
+    IoResult ret = _connection->send_binlog_event_slice(inner_event, event_len);
+    if (ret != IoResult::SUCCESS) {
+      return ret;
+    }
+    offset += event_len;
+  }
   return IoResult::SUCCESS;
 }
 
@@ -598,7 +904,8 @@ IoResult BinlogDumper::send_binlog(const string& file, uint64_t start_pos)
 
 int BinlogDumper::conn_liveness()
 {
-  if (send_heartbeat_event(_checkpoint.second, false) != IoResult::SUCCESS) {
+  if (send_heartbeat_event(_checkpoint.second, false) != IoResult::SUCCESS ||
+      _connection->flush_output() != IoResult::SUCCESS) {
     OMS_ERROR("{}: Failed to send heartbeat", _connection->trace_id());
     return OMS_FAILED;
   }
@@ -623,7 +930,7 @@ bool BinlogDumper::skip_event(OblogEventHeader& header, unsigned char* buff, boo
 bool BinlogDumper::handle_gtid_event(unsigned char* buff)
 {
   GtidLogEvent gtid_log_event = GtidLogEvent();
-  gtid_log_event.deserialize(buff + 1);
+  gtid_log_event.deserialize(buff);
   uint64_t g_no = gtid_log_event.get_gtid_txn_id();
   for (const auto& gtid : _exclude_gtid) {
     string exclude_uuid;
@@ -710,7 +1017,10 @@ void BinlogDumper::set_heartbeat_interval_us(uint64_t heartbeat_interval_us)
   _heartbeat_interval_us = heartbeat_interval_us;
 }
 
-BinlogDumper::BinlogDumper(Connection* conn) : Thread("BinlogDumper")
+BinlogDumper::BinlogDumper(Connection* conn)
+    : Thread("BinlogDumper"),
+      _reader(s_config.binlog_dump_read_buffer_bytes.val()),
+      _zero_copy_min_bytes(s_config.binlog_dump_zero_copy_min_bytes.val())
 {
   _connection = conn;
   _rate_limiter.update_throttle_rps(s_meta.binlog_config()->throttle_dump_rps());
@@ -730,9 +1040,17 @@ void BinlogDumper::register_latency()
   _counter.register_gauge("iops", [this]() { return this->_metric.iops(); });
   _counter.register_gauge("position", [this]() { return this->_metric.send_position_str(); });
   /*!
-   * @brief Turn on indicator monitoring
+   * @brief Turn on indicator monitoring, a dumper driven by resume() is reported by its event loop instead
    */
-  _counter.start();
+  if (!_nonblocking) {
+    _counter.start();
+  }
+}
+
+void BinlogDumper::report_metrics()
+{
+  _counter.report(_report_timer.elapsed() / 1000);
+  _report_timer.reset();
 }
 
 const std::map<std::string, GtidMessage*>& BinlogDumper::get_exclude_gtid() const
@@ -863,9 +1181,9 @@ bool BinlogDumper::is_legal_event(FILE* stream, uint64_t offset, uint64_t end_po
 void BinlogDumper::wait_rotate_ready(std::string const& file) const
 {
   int retry = 0;
-  while (!FsUtil::exist(file) && retry < 100) {
+  while (!FsUtil::exist(file) && retry < ROTATE_READY_RETRIES) {
     OMS_WARN("{}: The currently rotated file {} is not ready", _connection->trace_id(), file);
-    usleep(10000);
+    usleep(ROTATE_READY_RETRY_INTERVAL_US);
     retry++;
   }
 
@@ -1021,31 +1339,31 @@ void DumperMetric::mark_send_position(std::pair<std::string, uint64_t> position)
 
 void DumperMetric::count_send(uint64_t count)
 {
-  _send_count.fetch_add(count);
-  _accumulate_send_count.fetch_add(count);
+  _send_count.add(count);
+  _accumulate_send_count.add(count);
 }
 
 void DumperMetric::count_send_io(uint64_t bytes)
 {
-  _send_io.fetch_add(bytes);
-  _accumulate_send_io.fetch_add(bytes);
+  _send_io.add(bytes);
+  _accumulate_send_io.add(bytes);
 }
 
 void DumperMetric::count_fake_rotate_event_send(uint64_t count)
 {
-  _accumulate_fake_rotate_event_send_count.fetch_add(count);
+  _accumulate_fake_rotate_event_send_count.add(count);
 }
 
 void DumperMetric::count_hb_event_send(uint64_t count)
 {
-  _accumulate_hb_event_send_count.fetch_add(count);
+  _accumulate_hb_event_send_count.add(count);
 }
 
 std::uint64_t DumperMetric::rps()
 {
   uint64_t count = _send_count.load();
   _eps_within_interval = interval_s == 0 ? count : (count / interval_s);
-  _send_count.fetch_sub(count);
+  _send_count.sub(count);
   return _eps_within_interval;
 }
 
@@ -1053,7 +1371,7 @@ std::uint64_t DumperMetric::iops()
 {
   uint64_t io = _send_io.load();
   _iops_within_interval = interval_s == 0 ? io : (io / interval_s);
-  _send_io.fetch_sub(_send_io);
+  _send_io.sub(io);
   return _iops_within_interval;
 }
 
@@ -1081,12 +1399,12 @@ std::string DumperMetric::send_position_str()
 
 std::uint64_t DumperMetric::accumulated_events_send()
 {
-  return _accumulate_send_count;
+  return _accumulate_send_count.load();
 }
 
 std::uint64_t DumperMetric::accumulated_bytes_send()
 {
-  return _accumulate_send_io;
+  return _accumulate_send_io.load();
 }
 
 std::uint64_t DumperMetric::eps_within_interval() const
@@ -1101,11 +1419,11 @@ std::uint64_t DumperMetric::iops_within_interval() const
 
 std::uint64_t DumperMetric::accumulated_fake_rotate_events_send()
 {
-  return _accumulate_fake_rotate_event_send_count;
+  return _accumulate_fake_rotate_event_send_count.load();
 }
 
 std::uint64_t DumperMetric::accumulated_hb_events_send()
 {
-  return _accumulate_hb_event_send_count;
+  return _accumulate_hb_event_send_count.load();
 }
 }  // namespace oceanbase::binlog
@@ -27,8 +27,10 @@
 #include "timer.h"
 #include "binlog/binlog_index.h"
 #include "counter.h"
+#include "sharded_counter.h"
 #include "cluster/instance_meta.h"
 #include "binlog/rate_limiter.h"
+#include "event_block_reader.h"
 
 namespace oceanbase::binlog {
 typedef void (*process_binlog_event)(MsgBuf, void*);
@@ -96,13 +98,13 @@ public:
 private:
   std::pair<std::string, uint64_t> _send_position;
   std::shared_mutex _shared_mutex;
-  std::atomic<uint64_t> _accumulate_send_count{0};
-  std::atomic<uint64_t> _send_count{0};
+  ShardedCounter _accumulate_send_count;
+  ShardedCounter _send_count;
   std::uint64_t _eps_within_interval = 0;
-  std::atomic<uint64_t> _accumulate_send_io{0};
-  std::atomic<uint64_t> _send_io{0};
-  std::atomic<uint64_t> _accumulate_fake_rotate_event_send_count{0};
-  std::atomic<uint64_t> _accumulate_hb_event_send_count{0};
+  ShardedCounter _accumulate_send_io;
+  ShardedCounter _send_io;
+  ShardedCounter _accumulate_fake_rotate_event_send_count;
+  ShardedCounter _accumulate_hb_event_send_count;
   std::uint64_t _iops_within_interval = 0;
   volatile uint64_t _checkpoint_ts = 0;
   int64_t interval_s = Config::instance().counter_interval_s.val();
@@ -120,6 +122,48 @@ public:
 
   void run() override;
 
+  /*!
+   * @brief Continue the dump on an event loop of the BinlogDumpScheduler instead of a thread of its own. Events are
+   * appended to the deferred output of the connection until it is full or the dumper has caught up, nothing blocks.
+   * @return OMS_OK if there is more to send once the output has been written out, OMS_AGAIN if the dumper has caught
+   * up and waits for new events, OMS_BINLOG_SKIP if the dump has completed and OMS_FAILED on error
+   */
+  int resume();
+
+  /*!
+   * @brief When resume() returned OMS_AGAIN as the dumper is throttled or the next binlog file is not there yet, the
+   * time(us) to resume it at instead of on new events, 0 otherwise
+   */
+  uint64_t resume_at_us() const
+  {
+    return _resume_at_us;
+  }
+
+  /*!
+   * @brief Called by the event loop when resume() returned OMS_AGAIN to wait for new events
+   */
+  void enter_wait();
+
+  /*!
+   * @brief Whether data has been committed beyond the checkpoint since the dumper went waiting, lock-free
+   */
+  bool has_new_events() const;
+
+  /*!
+   * @brief Log the dumper gauges, called by the event loop every counter_interval_s in place of a counter thread
+   */
+  void report_metrics();
+
+  /*!
+   * @brief How long to wait for new events before sending a heartbeat
+   */
+  uint64_t wait_interval_us();
+
+  /*!
+   * @brief Send the heartbeat of one wait interval without new events, if heartbeats are enabled
+   */
+  IoResult send_wait_heartbeat(uint64_t pos);
+
   /*
    * @params
    * @returns
@@ -152,6 +196,27 @@ public:
    */
   int seek_event(FILE* stream, MsgBuf& msg_buf, bool& skip_record);
 
+  /*!
+   * @brief Book-keeping for the event at the current checkpoint: the checksum of format description events, gtid
+   * filtering, the checkpoint itself, rate limiting and metrics
+   * @param event the event without the leading OK byte
+   * @return false if the event is skipped
+   */
+  bool accept_event(OblogEventHeader& header, unsigned char* event, bool& skip_record);
+
+  /*!
+   * @brief Whether the event is sent straight from the binlog file with sendfile rather than from the read buffer.
+   * Binlog files are sent as they are stored, so this only depends on the size and the type of the event.
+   */
+  bool is_zero_copy_event(OblogEventHeader& header) const;
+
+  /*!
+   * @brief Send the events wrapped by a transaction payload one by one, for clients that do not understand payloads.
+   * They all end where the payload does, as for a MySQL replica applying it.
+   * @param event the payload event, without the leading OK byte
+   */
+  IoResult send_payload_events(OblogEventHeader& header, unsigned char* event);
+
   /*
    * @params
    * @returns
@@ -168,6 +233,11 @@ public:
    */
   int seek_binlog_end_pos(const std::string& file, uint64_t& end_pos);
 
+  /*!
+   * @brief Like seek_binlog_end_pos, but returns OMS_AGAIN instead of waiting for new events
+   */
+  int peek_binlog_end_pos(const std::string& file, uint64_t& end_pos);
+
   /*
    * @params
    * @returns
@@ -312,7 +382,7 @@ public:
   /*!
    * @brief Compare the gtid event to determine
    * whether the transaction data corresponding to the gtid should be skipped
-   * @param buff
+   * @param buff the gtid event, without the leading OK byte
    * @return
    */
   bool handle_gtid_event(unsigned char* buff);
@@ -331,10 +401,33 @@ public:
   }
 
 private:
+  enum class DumpPhase { PREPARE, OPEN_FILE, SEND_EVENTS };
+
   void serialize_dump_payload();
 
   int check_start_file();
 
+  /*!
+   * @brief Locate the first binlog file and verify the start position, before anything is sent
+   */
+  int prepare();
+
+  /*!
+   * @brief Send the fake rotate event of the current file and open it
+   */
+  int open_binlog_file();
+
+  /*!
+   * @brief Move on to the binlog file after the current one
+   */
+  int rotate_binlog_file();
+
+  /*!
+   * @brief Like wait_rotate_ready, but schedules resume() to check again instead of sleeping
+   * @return false if the file rotated to is not there yet
+   */
+  bool check_rotate_ready();
+
 private:
   std::string _file;
   std::string _relative_file;
@@ -350,15 +443,35 @@ private:
   std::ifstream _stream;
   std::string _error_message;
   FILE* _fp = nullptr;
+  EventBlockReader _reader;
+  uint32_t _zero_copy_min_bytes;
   binlog::Connection* _connection;
   Timer _stage_timer;
   CounterStatistics _counter;
+  // span of the gauges reported by the event loop
+  Timer _report_timer;
   DumperMetric _metric;
   int64_t _checkpoint_ts = 0;
   uint64_t _event_ts = 0;
   enum_checksum_flag _checksum_flag = UNDEF;
+  // the client reads transaction payloads as they are
+  bool _client_reads_payload = false;
+  // the client predates transaction payloads or the format description event of the current file does not declare
+  // them, so they are decompressed before sending
+  bool _decompress_payload = false;
+  std::vector<unsigned char> _payload_events;
   std::string _payload_json;
   std::string _rotate_file;
+  // only used when driven by resume()
+  DumpPhase _phase = DumpPhase::PREPARE;
+  // driven by resume(), throttling and rotation wait on a timer of the event loop rather than sleep
+  bool _nonblocking = false;
+  uint64_t _resume_at_us = 0;
+  // when to give up waiting for the file rotated to, 0 once it is there
+  uint64_t _rotate_deadline_us = 0;
+  // heartbeats sent since the dumper went waiting
+  uint8_t _nof_heartbeat_send = 0;
+  bool _need_log_heartbeat = false;
 
   EventRateLimiter _rate_limiter;
 };
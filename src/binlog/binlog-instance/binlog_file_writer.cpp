@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "binlog_file_writer.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "log.h"
+#include "timer.h"
+#include "counter.h"
+
+namespace oceanbase::binlog {
+using namespace oceanbase::logproxy;
+
+BinlogFileWriter::~BinlogFileWriter()
+{
+  close();
+}
+
+int BinlogFileWriter::parse_policy(const std::string& value, BinlogSyncPolicy& policy)
+{
+  if (value == "none") {
+    policy = BinlogSyncPolicy::NONE;
+  } else if (value == "interval") {
+    policy = BinlogSyncPolicy::INTERVAL;
+  } else if (value == "batch") {
+    policy = BinlogSyncPolicy::BATCH;
+  } else {
+    OMS_ERROR("Unknown binlog sync policy: {}, expected none, interval or batch", value);
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
+void BinlogFileWriter::set_sync_policy(BinlogSyncPolicy policy, uint32_t sync_interval_ms)
+{
+  _policy = policy;
+  _sync_interval_us = sync_interval_ms * 1000ULL;
+}
+
+int BinlogFileWriter::open(const std::string& file_name)
+{
+  if (close() != OMS_OK) {
+    return OMS_FAILED;
+  }
+
+  int fd = ::open(file_name.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    OMS_ERROR("Failed to open binlog file: {}, error: {}", file_name, system_err(errno));
+    return OMS_FAILED;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    OMS_ERROR("Failed to stat binlog file: {}, error: {}", file_name, system_err(errno));
+    ::close(fd);
+    return OMS_FAILED;
+  }
+
+  _fd = fd;
+  _file_name = file_name;
+  _offset = st.st_size;
+  _dirty = false;
+  _last_sync_us = Timer::now();
+  OMS_INFO("Open binlog file: {} for appending, offset: {}", _file_name, _offset);
+  return OMS_OK;
+}
+
+int BinlogFileWriter::append(const unsigned char* data, size_t size)
+{
+  size_t written = 0;
+  while (written < size) {
+    ssize_t ret = ::write(_fd, data + written, size - written);
+    if (ret > 0) {
+      written += ret;
+      continue;
+    }
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    OMS_ERROR("Failed to append {} bytes to binlog file: {}, error: {}", size, _file_name, system_err(errno));
+    return OMS_FAILED;
+  }
+  _offset += size;
+  _dirty = _dirty || size > 0;
+  return OMS_OK;
+}
+
+int BinlogFileWriter::sync()
+{
+  switch (_policy) {
+    case BinlogSyncPolicy::BATCH:
+      return sync_now();
+    case BinlogSyncPolicy::INTERVAL:
+      return Timer::now() - _last_sync_us >= _sync_interval_us ? sync_now() : OMS_OK;
+    default:
+      return OMS_OK;
+  }
+}
+
+int BinlogFileWriter::sync_now()
+{
+  if (!_dirty || _fd < 0) {
+    return OMS_OK;
+  }
+  uint64_t start_us = Timer::now();
+  if (fdatasync(_fd) != 0) {
+    OMS_ERROR("Failed to sync binlog file: {}, error: {}", _file_name, system_err(errno));
+    return OMS_FAILED;
+  }
+  _last_sync_us = Timer::now();
+  _dirty = false;
+  Counter::instance().count_key(Counter::BINLOG_SYNC_US, _last_sync_us - start_us);
+  return OMS_OK;
+}
+
+int BinlogFileWriter::close()
+{
+  if (_fd < 0) {
+    return OMS_OK;
+  }
+  int ret = _policy == BinlogSyncPolicy::NONE ? OMS_OK : sync_now();
+  ::close(_fd);
+  _fd = -1;
+  _file_name.clear();
+  _offset = 0;
+  _dirty = false;
+  return ret;
+}
+
+}  // namespace oceanbase::binlog
@@ -18,6 +18,8 @@
 #include "counter.h"
 #include "env.h"
 #include "binlog_converter.h"
+#include "event_arena.h"
+#include "pipeline_latency.h"
 
 #include <ThreadPerTaskScheduler.h>
 
@@ -26,6 +28,7 @@ namespace oceanbase::binlog {
 void SerializeEvent::reset()
 {
   buffer.reset_offset();
+  commit_us.clear();
 }
 
 void SerializeEvent::update_index_record(const BinlogIndexRecord& index_record)
@@ -48,11 +51,16 @@ void SerializeHandler::onEvent(SerializeEvent& data, std::int64_t sequence)
   }
 
   int index = 0;
+  uint64_t written = 0;
   for (const auto event : data.events) {
     if (event->is_filter()) {
       continue;
     }
-    Counter::instance().count_write(1);
+    ++written;
+    EventType type = event->get_header()->get_type_code();
+    if (type == XID_EVENT || type == TRANSACTION_PAYLOAD_EVENT) {
+      data.commit_us.push_back(event->get_checkpoint());
+    }
     if (data.is_rotation && data.rotate_events.size() > index &&
         event->get_header()->get_next_position() == data.rotate_offsets[index]) {
       const auto len =
@@ -72,19 +80,116 @@ void SerializeHandler::onEvent(SerializeEvent& data, std::int64_t sequence)
     data.buffer.publish(len);
   }
 
-  auto seq = g_disruptor->ringBuffer()->next();
-  auto ringBuffer = g_disruptor->ringBuffer();
-  (*ringBuffer)[seq].events.swap(data.events);
-  ringBuffer->publish(seq);
+  // the events are fully encoded into the batch buffer, release them (and their arenas) right here
+  release_events(data.events);
+  Counter::instance().count_write(written);
+
+  uint64_t serialized_us = Timer::now();
+  for (uint64_t commit_us : data.commit_us) {
+    PipelineLatency::instance().record(PIPELINE_SERIALIZE, commit_us, serialized_us);
+  }
+}
+
+static bool is_type(ObLogEvent* event, EventType type)
+{
+  return event != nullptr && event->get_header()->get_type_code() == type;
+}
+
+static bool is_begin_event(ObLogEvent* event)
+{
+  return is_type(event, QUERY_EVENT) && !dynamic_cast<QueryEvent*>(event)->is_ddl();
+}
+
+/*!
+ * @brief The end of the transaction whose gtid event is events[gtid], past its xid event, or gtid if it is not a
+ * whole DML transaction of this batch
+ */
+static size_t whole_transaction_end(const std::vector<ObLogEvent*>& events, size_t gtid)
+{
+  if (!is_type(events[gtid], GTID_LOG_EVENT) || gtid + 1 >= events.size() || !is_begin_event(events[gtid + 1])) {
+    return gtid;
+  }
+  for (size_t i = gtid + 2; i < events.size(); ++i) {
+    if (events[i] == nullptr) {
+      return gtid;
+    }
+    switch (events[i]->get_header()->get_type_code()) {
+      case TABLE_MAP_EVENT:
+      case ROWS_QUERY_LOG_EVENT:
+      case WRITE_ROWS_EVENT:
+      case UPDATE_ROWS_EVENT:
+      case PARTIAL_UPDATE_ROWS_EVENT:
+      case DELETE_ROWS_EVENT:
+        break;
+      case XID_EVENT:
+        return i + 1;
+      default:
+        return gtid;
+    }
+  }
+  return gtid;
+}
+
+void CompressHandler::onEvent(SerializeEvent& data, std::int64_t sequence)
+{
+  std::vector<ObLogEvent*> events;
+  std::vector<ObLogEvent*> wrapped;
+  events.reserve(data.events.size());
+  uint64_t raw_bytes = 0;
+  uint64_t payload_bytes = 0;
+
+  size_t i = 0;
+  while (i < data.events.size()) {
+    size_t end = whole_transaction_end(data.events, i);
+    if (end == i) {
+      events.push_back(data.events[i++]);
+      continue;
+    }
+    // the gtid event stays outside, the payload wraps from BEGIN to the xid event
+    events.push_back(data.events[i]);
+    ObLogEvent* xid_event = data.events[end - 1];
+    auto* payload_event = new TransactionPayloadEvent();
+    if (payload_event->compress(data.events, i + 1, end, _level) != OMS_OK ||
+        payload_event->get_header()->get_event_length() >= payload_event->get_uncompressed_size()) {
+      // not worth it, the transaction is stored as it is
+      delete payload_event;
+      events.insert(events.end(), data.events.begin() + i + 1, data.events.begin() + end);
+      i = end;
+      continue;
+    }
+    payload_event->set_ob_txn(xid_event->get_ob_txn());
+    payload_event->set_checkpoint(xid_event->get_checkpoint());
+    raw_bytes += payload_event->get_uncompressed_size();
+    payload_bytes += payload_event->get_header()->get_event_length();
+    events.push_back(payload_event);
+    wrapped.insert(wrapped.end(), data.events.begin() + i + 1, data.events.begin() + end);
+    i = end;
+  }
+
+  data.events.swap(events);
+  release_events(wrapped);
+  _binlog_storage->count_compression(raw_bytes, payload_bytes);
 }
 
 void AllocateHandler::onEvent(SerializeEvent& data, std::int64_t sequence, bool endOfBatch)
 {
+  if (data.sync_only) {
+    return;
+  }
   _binlog_storage->global_allocation_of_backfill_events(data);
 }
 
 void StorageHandler::onEvent(SerializeEvent& data, std::int64_t sequence, bool endOfBatch)
 {
+  if (data.sync_only) {
+    data.sync_only = false;
+    if (_binlog_storage->commit_binlog(false) != OMS_OK) {
+      OMS_FATAL("Failed to sync binlog file");
+      throw std::runtime_error("Failed to sync binlog file");
+    }
+    return;
+  }
+
   if (data.is_rotation) {
     uint64_t cur_offset = 0;
     uint64_t index = 0;
@@ -96,6 +201,10 @@ void StorageHandler::onEvent(SerializeEvent& data, std::int64_t sequence, bool e
         throw std::runtime_error("placement failed !!!");
       }
       cur_offset = rotate_index;
+      if (_binlog_storage->commit_binlog(true) != OMS_OK) {
+        OMS_FATAL("Failed to commit binlog file before rotation");
+        throw std::runtime_error("Failed to commit binlog file before rotation");
+      }
       if (_binlog_storage->init_next_binlog_file(
               dynamic_cast<RotateEvent*>(data.rotate_events[index]), data.index_records[index]) != OMS_OK) {
         OMS_ERROR("Failed to initialize next binlog file");
@@ -131,6 +240,22 @@ void StorageHandler::onEvent(SerializeEvent& data, std::int64_t sequence, bool e
     }
   }
 
+  // group commit of all the batches the storage handler got at once
+  if (endOfBatch && _binlog_storage->commit_binlog(false) != OMS_OK) {
+    OMS_FATAL("Failed to commit binlog file");
+    throw std::runtime_error("Failed to commit binlog file");
+  }
+
+  if (!data.commit_us.empty()) {
+    uint64_t persisted_us = Timer::now();
+    for (uint64_t commit_us : data.commit_us) {
+      PipelineLatency::instance().record(PIPELINE_PERSIST, commit_us, persisted_us);
+    }
+    const BinlogIndexRecord& last_index_record = data.index_records.back();
+    PipelineLatency::instance().mark_persisted(
+        last_index_record.get_file_name(), last_index_record.get_position(), data.commit_us.back());
+  }
+
   release_vector(data.rotate_events);
   data.rotate_offsets.clear();
   data.index_pos = 0;
@@ -166,6 +291,12 @@ void SerializeExceptionHandler::handleOnTimeoutException(const std::exception& e
 
 int BinlogStorage::init()
 {
+  BinlogSyncPolicy sync_policy = BinlogSyncPolicy::NONE;
+  if (BinlogFileWriter::parse_policy(s_meta.binlog_config()->binlog_storage_sync_policy(), sync_policy) != OMS_OK) {
+    return OMS_FAILED;
+  }
+  _writer.set_sync_policy(sync_policy, s_meta.binlog_config()->binlog_storage_sync_interval_ms());
+
   _serialize_task_scheduler = std::make_shared<Disruptor::RoundRobinThreadAffinedTaskScheduler>();
 
   if (s_meta.binlog_config()->binlog_serialize_ring_buffer_size() < 1) {
@@ -187,12 +318,30 @@ int BinlogStorage::init()
   }
   auto exception_handle = std::make_shared<SerializeExceptionHandler>(this);
   _serialize_disruptor->handleExceptionsWith(exception_handle);
-  _serialize_disruptor->handleEventsWith(_allocate_handler)
-      ->thenHandleEventsWithWorkerPool(_serialize_handlers)
-      ->then(_storage_handler);
-
   auto number_of_threads = std::max(s_meta.binlog_config()->binlog_serialize_thread_size(),
       s_meta.binlog_config()->binlog_serialize_parallel_size() + 2);
+  if (s_meta.binlog_config()->binlog_transaction_compression()) {
+    int level = s_meta.binlog_config()->binlog_transaction_compression_level_zstd();
+    for (int i = 0; i < s_meta.binlog_config()->binlog_serialize_parallel_size(); ++i) {
+      _compress_handlers.emplace_back(std::make_shared<CompressHandler>(this, level));
+    }
+    _serialize_disruptor->handleEventsWithWorkerPool(_compress_handlers)
+        ->then(_allocate_handler)
+        ->thenHandleEventsWithWorkerPool(_serialize_handlers)
+        ->then(_storage_handler);
+    number_of_threads += s_meta.binlog_config()->binlog_serialize_parallel_size();
+    OMS_INFO("Binlog transaction compression is enabled with zstd level {}", level);
+
+    // payload bytes per 100 bytes of the transactions compressed so far
+    Counter::instance().register_gauge("TrxCompressPct", [this]() -> int64_t {
+      uint64_t raw_bytes = _compress_raw_bytes.load(std::memory_order_relaxed);
+      return raw_bytes == 0 ? 100 : _compress_payload_bytes.load(std::memory_order_relaxed) * 100 / raw_bytes;
+    });
+  } else {
+    _serialize_disruptor->handleEventsWith(_allocate_handler)
+        ->thenHandleEventsWithWorkerPool(_serialize_handlers)
+        ->then(_storage_handler);
+  }
   _serialize_task_scheduler->start(number_of_threads);
   _serialize_disruptor->start();
 
@@ -200,9 +349,6 @@ int BinlogStorage::init()
     return _serialize_disruptor->bufferSize() - _serialize_disruptor->ringBuffer()->getRemainingCapacity();
   });
 
-  Counter::instance().register_gauge("ReleaseRingBufferQ",
-      [this]() { return g_disruptor->bufferSize() - g_disruptor->ringBuffer()->getRemainingCapacity(); });
-
   int file_index = 0;
   string binlog_dir = string(".") + BINLOG_DATA_DIR;
 
@@ -262,12 +408,38 @@ void BinlogStorage::run()
         OMS_ERROR("Binlog storage thread has been stopped.");
         break;
       }
+      publish_due_sync();
       OMS_DEBUG("Empty log event queue put by convert thread, retry...");
     }
+    if (!_compress_handlers.empty() && !events.empty()) {
+      // only whole transactions are compressed, the one still open goes with the next batch
+      size_t open = events.size();
+      for (size_t i = events.size(); i-- > 0;) {
+        ObLogEvent* event = events[i];
+        if (event == nullptr || is_type(event, XID_EVENT) || is_type(event, HEARTBEAT_LOG_EVENT) ||
+            (is_type(event, QUERY_EVENT) && !is_begin_event(event))) {
+          break;
+        }
+        if (is_type(event, GTID_LOG_EVENT)) {
+          open = i;
+          break;
+        }
+      }
+      if (open == 0 && events.size() < s_meta.binlog_config()->storage_wait_num()) {
+        continue;
+      }
+      if (open > 0 && open < events.size()) {
+        _open_trx_events.assign(events.begin() + open, events.end());
+        events.resize(open);
+      }
+    }
+
     auto seq = _serialize_disruptor->ringBuffer()->next();
     auto ringBuffer = _serialize_disruptor->ringBuffer();
     (*ringBuffer)[seq].events.swap(events);
     ringBuffer->publish(seq);
+    events.insert(events.end(), _open_trx_events.begin(), _open_trx_events.end());
+    _open_trx_events.clear();
   }
   OMS_ERROR("Storage thread exits");
   _converter.stop_converter();
@@ -290,7 +462,7 @@ void BinlogStorage::stop()
   OMS_INFO("Begin to stop binlog storage thread...");
 }
 
-BinlogStorage::BinlogStorage(BinlogConverter& reader, BlockingQueue<ObLogEvent*>& event_queue)
+BinlogStorage::BinlogStorage(BinlogConverter& reader, RingQueue<ObLogEvent*>& event_queue)
     : _event_queue(event_queue), _converter(reader)
 {
   _rate_limiter.update_throttle_rps(s_meta.binlog_config()->throttle_convert_rps());
@@ -309,7 +481,8 @@ int64_t BinlogStorage::init_binlog_file(RotateEvent* rotate_event)
   buff_pos += BINLOG_MAGIC_SIZE;
 
   // add FormatDescriptionEvent
-  FormatDescriptionEvent format_description_event = FormatDescriptionEvent(rotate_event->get_header()->get_timestamp());
+  FormatDescriptionEvent format_description_event =
+      FormatDescriptionEvent(rotate_event->get_header()->get_timestamp(), format_description_event_types());
   buff_pos += format_description_event.flush_to_buff(event_data + buff_pos);
   // add PreviousGtidsLogEvent
   std::vector<GtidMessage*> gtid_messages;
@@ -353,7 +526,8 @@ int64_t BinlogStorage::init_next_binlog_file(RotateEvent* rotate_event, BinlogIn
   buff_pos += BINLOG_MAGIC_SIZE;
 
   // add FormatDescriptionEvent
-  FormatDescriptionEvent format_description_event = FormatDescriptionEvent(rotate_event->get_header()->get_timestamp());
+  FormatDescriptionEvent format_description_event =
+      FormatDescriptionEvent(rotate_event->get_header()->get_timestamp(), format_description_event_types());
   buff_pos += format_description_event.flush_to_buff(event_data + buff_pos);
   // add PreviousGtidsLogEvent
   std::vector<GtidMessage*> gtid_messages;
@@ -465,7 +639,8 @@ int BinlogStorage::global_allocation_of_backfill_events(SerializeEvent& event_ba
             _index_record.get_checkpoint());
         break;
       }
-      case XID_EVENT: {
+      case XID_EVENT:
+      case TRANSACTION_PAYLOAD_EVENT: {
         if (_filter_util_checkpoint_trx) {
           if (!_meet_initial_trx) {
             continue;
@@ -475,9 +650,13 @@ int BinlogStorage::global_allocation_of_backfill_events(SerializeEvent& event_ba
               "No longer skip record due to meet commit record for checkpoint transaction: {}", _txn_mapping.first);
           continue;
         }
-        auto xid_event = dynamic_cast<XidEvent*>(event);
+        // only the transactions past the checkpoint are numbered, compressed ones in the xid slot of their payload
         OMS_ATOMIC_INC(this->_xid);
-        xid_event->set_xid(this->_xid);
+        if (event->get_header()->get_type_code() == XID_EVENT) {
+          dynamic_cast<XidEvent*>(event)->set_xid(this->_xid);
+        } else {
+          dynamic_cast<TransactionPayloadEvent*>(event)->set_xid(this->_xid);
+        }
         if (this->_cur_pos + event->get_header()->get_event_length() > s_meta.binlog_config()->max_binlog_size()) {
           is_rotate = true;
         }
@@ -519,12 +698,55 @@ int BinlogStorage::global_allocation_of_backfill_events(SerializeEvent& event_ba
   return OMS_OK;
 }
 
+void BinlogStorage::count_compression(uint64_t raw_bytes, uint64_t payload_bytes)
+{
+  _compress_raw_bytes.fetch_add(raw_bytes, std::memory_order_relaxed);
+  _compress_payload_bytes.fetch_add(payload_bytes, std::memory_order_relaxed);
+}
+
 int64_t BinlogStorage::persistent_binlog(unsigned char* buffer, size_t size, BinlogIndexRecord& index_record)
 {
-  if (FsUtil::append_file(_file_name, buffer, size) == OMS_FAILED) {
+  if (_writer.file_name() != _file_name && _writer.open(_file_name) != OMS_OK) {
+    return OMS_FAILED;
+  }
+  if (_writer.append(buffer, size) != OMS_OK) {
     return OMS_FAILED;
   }
-  update_index_record(index_record);
+  _offset = _writer.offset();
+  index_record.set_position(_offset);
+  if (_writer.policy() == BinlogSyncPolicy::BATCH) {
+    _pending_index_record = index_record;
+    _has_pending_index = true;
+    return OMS_OK;
+  }
+  publish_index_record(index_record);
+  return OMS_OK;
+}
+
+void BinlogStorage::publish_due_sync()
+{
+  uint64_t sync_due_us = _sync_due_us.load(std::memory_order_relaxed);
+  if (sync_due_us == 0 || Timer::now() < sync_due_us) {
+    return;
+  }
+  // set again by the storage handler if the sync is still not due by then
+  _sync_due_us.store(0, std::memory_order_relaxed);
+  auto ringBuffer = _serialize_disruptor->ringBuffer();
+  auto seq = ringBuffer->next();
+  (*ringBuffer)[seq].sync_only = true;
+  ringBuffer->publish(seq);
+}
+
+int BinlogStorage::commit_binlog(bool close_file)
+{
+  if ((close_file ? _writer.close() : _writer.sync()) != OMS_OK) {
+    return OMS_FAILED;
+  }
+  _sync_due_us.store(_writer.sync_due_us(), std::memory_order_relaxed);
+  if (_has_pending_index) {
+    _has_pending_index = false;
+    publish_index_record(_pending_index_record);
+  }
   return OMS_OK;
 }
 
@@ -601,6 +823,11 @@ void BinlogStorage::update_index_record(BinlogIndexRecord& index_record)
 {
   _offset = FsUtil::file_size(_file_name);
   index_record.set_position(_offset);
+  publish_index_record(index_record);
+}
+
+void BinlogStorage::publish_index_record(const BinlogIndexRecord& index_record)
+{
   g_index_manager->update_index(index_record);
   g_gtid_manager->compress_and_save_gtid_seq(index_record.get_current_mapping());
 
@@ -964,13 +1191,19 @@ void BinlogStorage::merge_previous_gtids(uint64_t last_gtid, std::vector<GtidMes
     previous_gtids.emplace_back(gtid_msg);
   }
 }
+
+int BinlogStorage::format_description_event_types() const
+{
+  return _compress_handlers.empty() ? LOG_EVENT_TYPES : PAYLOAD_LOG_EVENT_TYPES;
+}
+
 void BinlogStorage::set_start_pos(const std::vector<GtidMessage*>& previous_gtids)
 {
   std::uint32_t checksum = 0;
   if (Config::instance().binlog_checksum.val()) {
     checksum = COMMON_CHECKSUM_LENGTH;
   }
-  _cur_pos = BINLOG_START_FIXED_POS + checksum;
+  _cur_pos = BINLOG_START_FIXED_POS + checksum + format_description_event_types() - LOG_EVENT_TYPES;
   for (auto pre_gtid : previous_gtids) {
     _cur_pos += pre_gtid->get_gtid_length();
   }
@@ -15,19 +15,21 @@
 #ifndef OMS_LOGPROXY_BINLOG_STORAGE_H
 #define OMS_LOGPROXY_BINLOG_STORAGE_H
 
+#include <atomic>
 #include <cassert>
 
 #include "thread.h"
 #include "timer.h"
 #include "log.h"
 #include "ob_log_event.h"
-#include "blocking_queue.hpp"
+#include "ring_queue.hpp"
 #include "obcdcaccess/obcdc/obcdc_entry.h"
 #include "binlog_index.h"
 #include "data_type.h"
 #include "obcdc_config.h"
 #include "gtid_manager.h"
 #include "rate_limiter.h"
+#include "binlog_file_writer.h"
 #include "common/buffer_manager.hpp"
 
 #include <Disruptor.h>
@@ -49,6 +51,10 @@ struct SerializeEvent {
   // records.
   uint32_t index_pos = 0;
   std::vector<BinlogIndexRecord> index_records;
+  // commit timestamps of the transactions ending in this batch, for the pipeline latency
+  std::vector<uint64_t> commit_us;
+  // no events, only asks the storage handler to sync the binlog file while no batch comes
+  bool sync_only = false;
 
 public:
   explicit SerializeEvent() : events(), buffer(2 * 1024 * 1024, 8 * 1024), rotate_offsets(), rotate_events()
@@ -76,6 +82,19 @@ public:
   explicit SerializeHandler() = default;
 };
 
+// compresses the whole transactions of a batch into Transaction_payload events, in parallel ahead of allocation since
+// the positions depend on the compressed sizes
+struct CompressHandler final : Disruptor::IWorkHandler<SerializeEvent> {
+  void onEvent(SerializeEvent& data, std::int64_t sequence) override;
+
+public:
+  explicit CompressHandler(BinlogStorage* binlog_storage, int level) : _binlog_storage(binlog_storage), _level(level)
+  {}
+
+  BinlogStorage* _binlog_storage;
+  int _level;
+};
+
 // Used for serial allocation of global gtid and backfill event position
 struct AllocateHandler : Disruptor::IEventHandler<SerializeEvent> {
   void onEvent(SerializeEvent& data, std::int64_t sequence, bool endOfBatch) override;
@@ -119,7 +138,7 @@ public:
 
   void run() override;
 
-  BinlogStorage(BinlogConverter& reader, BlockingQueue<ObLogEvent*>& event_queue);
+  BinlogStorage(BinlogConverter& reader, RingQueue<ObLogEvent*>& event_queue);
 
   int64_t rotate(ObLogEvent* event, MsgBuf& content, std::size_t size, BinlogIndexRecord& index_record);
 
@@ -140,8 +159,20 @@ public:
 
   int global_allocation_of_backfill_events(SerializeEvent& event_batch);
 
+  /*!
+   * @brief Account the bytes of the transactions compressed into payloads, for the compression ratio gauge
+   */
+  void count_compression(uint64_t raw_bytes, uint64_t payload_bytes);
+
   int64_t persistent_binlog(unsigned char* buffer, size_t size, BinlogIndexRecord& index_record);
 
+  /*!
+   * @brief Sync the binlog file as the sync policy requires and publish the index record held back for group commit.
+   * Called at the end of each storage batch and before rotating to the next file.
+   * @param close_file close the current binlog file as well
+   */
+  int commit_binlog(bool close_file);
+
 public:
   EventRateLimiter& get_rate_limiter()
   {
@@ -153,6 +184,8 @@ public:
 private:
   void update_index_record(BinlogIndexRecord& index_record);
 
+  void publish_index_record(const BinlogIndexRecord& index_record);
+
   int init_restart_point(const BinlogIndexRecord& index_record, GtidLogEvent* event);
 
   int recover_safely();
@@ -161,11 +194,29 @@ private:
 
   void merge_previous_gtids(uint64_t last_gtid, std::vector<GtidMessage*>& previous_gtids);
 
+  /*!
+   * @brief The entries of the post-header table in the format description events of new binlog files, which declares
+   * TRANSACTION_PAYLOAD_EVENT when transactions are compressed
+   */
+  int format_description_event_types() const;
+
   void set_start_pos(const std::vector<GtidMessage*>& previous_gtids);
 
+  /*!
+   * @brief Publish a sync_only batch if the data of the last batches is due to be synced, called while idle. With the
+   * interval policy the writer only syncs at the end of a batch, the last one would never be synced otherwise.
+   */
+  void publish_due_sync();
+
 private:
-  BlockingQueue<ObLogEvent*>& _event_queue;
+  RingQueue<ObLogEvent*>& _event_queue;
   std::string _file_name;
+  BinlogFileWriter _writer;
+  // with the batch sync policy, the index is updated once the batch is synced
+  BinlogIndexRecord _pending_index_record;
+  bool _has_pending_index = false;
+  // BinlogFileWriter::sync_due_us() after the last commit, read by the thread publishing batches
+  std::atomic<uint64_t> _sync_due_us{0};
   Timer _stage_timer;
   BinlogConverter& _converter;
   uint64_t _offset{};
@@ -186,7 +237,12 @@ private:
   uint64_t _first_gtid_seq = 1;
   std::vector<GtidMessage*> _previous_gtid_messages;
   uint64_t _last_record_ts = 0;
+  // the events of the transaction still open at the end of the last batch, published with the next one
+  std::vector<ObLogEvent*> _open_trx_events;
+  std::atomic<uint64_t> _compress_raw_bytes{0};
+  std::atomic<uint64_t> _compress_payload_bytes{0};
   shared_ptr<Disruptor::disruptor<SerializeEvent>> _serialize_disruptor;
+  std::vector<shared_ptr<Disruptor::IWorkHandler<SerializeEvent>>> _compress_handlers;
   shared_ptr<AllocateHandler> _allocate_handler;
   shared_ptr<StorageHandler> _storage_handler;
   std::vector<shared_ptr<Disruptor::IWorkHandler<SerializeEvent>>> _serialize_handlers;
@@ -14,6 +14,8 @@
 
 #include "counter.h"
 #include "trace_log.h"
+#include "common_util.h"
+#include "pipeline_latency.h"
 #include "binlog_converter.h"
 
 #include <env.h>
@@ -22,7 +24,7 @@ namespace oceanbase::binlog {
 
 static Config& _s_config = Config::instance();
 
-ClogReaderRoutine::ClogReaderRoutine(BinlogConverter& converter, BlockingQueue<ILogRecord*>& queue)
+ClogReaderRoutine::ClogReaderRoutine(BinlogConverter& converter, RingQueue<ILogRecord*>& queue)
     : Thread("Clog Reader Routine"), _converter(converter), _obcdc(nullptr), _queue(queue)
 {}
 
@@ -66,7 +68,8 @@ void ClogReaderRoutine::run()
     stage_tm.reset();
     ILogRecord* record = nullptr;
     int ret = _obcdc->fetch(record, _s_config.read_timeout_us.val());
-    int64_t fetch_us = stage_tm.elapsed();
+    uint64_t fetched_us = Timer::now();
+    int64_t fetch_us = stage_tm.elapsed(fetched_us);
 
     if (ret == OB_TIMEOUT && record == nullptr) {
       OMS_DEBUG("Fetch libobcdc timeout, nothing coming...");
@@ -82,6 +85,10 @@ void ClogReaderRoutine::run()
       TraceLog::info(record);
     }
 
+    if (record->recordType() == ECOMMIT) {
+      PipelineLatency::instance().record(PIPELINE_FETCH, CommonUtils::get_checkpoint_usec(record), fetched_us);
+    }
+
     stage_tm.reset();
     counter.count_read_io(record->getRealSize());
     counter.count_read(1);
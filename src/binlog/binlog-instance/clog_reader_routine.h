@@ -14,7 +14,7 @@
 
 #include "thread.h"
 #include "log.h"
-#include "blocking_queue.hpp"
+#include "ring_queue.hpp"
 #include "obcdcaccess/obcdc/obcdc_entry.h"
 #include "obcdc_config.h"
 
@@ -25,7 +25,7 @@ class BinlogConverter;
 
 class ClogReaderRoutine : public Thread {
 public:
-  ClogReaderRoutine(BinlogConverter&, BlockingQueue<ILogRecord*>&);
+  ClogReaderRoutine(BinlogConverter&, RingQueue<ILogRecord*>&);
 
   int init(const ObcdcConfig& config, IObCdcAccess* obcdc);
 
@@ -37,7 +37,7 @@ private:
   BinlogConverter& _converter;
   IObCdcAccess* _obcdc;
 
-  BlockingQueue<ILogRecord*>& _queue;
+  RingQueue<ILogRecord*>& _queue;
 };
 
 }  // namespace oceanbase::binlog
@@ -0,0 +1,483 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "column_encoder.h"
+
+#include <cassert>
+#include <cerrno>
+#include <string>
+
+#include "jsonb_encoder.h"
+#include "numeric_codec.h"
+#include "temporal_codec.h"
+
+namespace oceanbase::binlog {
+
+// rows up to this size keep the scratch row image of a convert worker allocated
+static constexpr size_t MAX_IDLE_ROW_IMAGE_CAPACITY = 1024 * 1024;
+
+static const std::string EMPTY_TABLE_NAME;
+
+void RowImageBuffer::grow(size_t min_capacity)
+{
+  size_t capacity = _capacity == 0 ? 256 : _capacity;
+  while (capacity < min_capacity) {
+    capacity *= 2;
+  }
+  auto* data = static_cast<unsigned char*>(realloc(_data, capacity));
+  assert(data != nullptr);
+  _data = data;
+  _capacity = capacity;
+}
+
+void RowImageBuffer::shrink(size_t max_capacity)
+{
+  if (_capacity > max_capacity) {
+    free(_data);
+    _data = nullptr;
+    _size = 0;
+    _capacity = 0;
+  }
+}
+
+/*!
+ * @brief Parse a floating point number the way std::stod does, from a stack copy instead of a heap one.
+ * @return false for values too long for the copy or rejected by std::stod, which then reports them itself
+ */
+static bool parse_double(const char* data, size_t data_len, double& value)
+{
+  char buf[64];
+  if (data_len == 0 || data_len >= sizeof(buf)) {
+    return false;
+  }
+  memcpy(buf, data, data_len);
+  buf[data_len] = '\0';
+
+  char* end = nullptr;
+  errno = 0;
+  value = strtod(buf, &end);
+  return end != buf && errno != ERANGE;
+}
+
+static bool parse_digits(const char* begin, const char* end, int64_t& value)
+{
+  // atoi stays exact up to 9 digits
+  if (begin == end || end - begin > 9) {
+    return false;
+  }
+  value = 0;
+  for (const char* pos = begin; pos < end; ++pos) {
+    unsigned digit = static_cast<unsigned char>(*pos) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  return true;
+}
+
+static size_t encode_integer(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  uint64_t value = 0;
+  if (!parse_int_two_complement(data, data_len, value)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  int_variable_store(row.append(encoder.width), value, encoder.width);
+  return encoder.width;
+}
+
+static size_t encode_floating(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  double value = 0;
+  if (!parse_double(data, data_len, value)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  if (encoder.width == sizeof(double)) {
+    row.append(&value, sizeof(double));
+  } else {
+    auto float_value = static_cast<float>(value);
+    row.append(&float_value, sizeof(float));
+  }
+  return encoder.width;
+}
+
+static size_t encode_length_prefixed(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data,
+    size_t data_len, RowImageBuffer& row, bool is_json_diff)
+{
+  int_variable_store(row.append(encoder.width), data_len, encoder.width);
+  row.append(data, data_len);
+  return encoder.width + data_len;
+}
+
+static size_t encode_year(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  int64_t year = 0;
+  if (!parse_digits(data, data + data_len, year)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  // years like '0000' are kept as 0
+  int1store(row.append(1), year == 0 ? 0 : year - 1900);
+  return 1;
+}
+
+static size_t encode_date(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  unsigned char bin[3];
+  if (!date_to_bin(data, data_len, bin)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  row.append(bin, sizeof(bin));
+  return sizeof(bin);
+}
+
+// the widest temporal value, a DATETIME(6), takes 8 bytes
+static size_t encode_datetime(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  unsigned char bin[8];
+  if (!datetime_to_bin(data, data_len, encoder.scale, bin)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  row.append(bin, encoder.width);
+  return encoder.width;
+}
+
+static size_t encode_time(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  unsigned char bin[8];
+  if (!time_to_bin(data, data_len, encoder.scale, bin)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  row.append(bin, encoder.width);
+  return encoder.width;
+}
+
+static size_t encode_timestamp(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  unsigned char bin[8];
+  if (!timestamp_to_bin(data, data_len, encoder.scale, bin)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  row.append(bin, encoder.width);
+  return encoder.width;
+}
+
+static size_t encode_decimal(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  // the widest decimal, DECIMAL(65, 30), takes 30 bytes
+  unsigned char bin[32];
+  if (!decimal_to_bin(data, data_len, encoder.precision, encoder.scale, bin)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  row.append(bin, encoder.width);
+  return encoder.width;
+}
+
+static size_t encode_bit(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  uint64_t value = 0;
+  if (!parse_int_two_complement(data, data_len, value)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  // the low bytes of the value, big-endian
+  unsigned char* pos = row.append(encoder.width);
+  for (uint32_t i = 0; i < encoder.width; ++i) {
+    pos[i] = static_cast<unsigned char>(value >> (8 * (encoder.width - 1 - i)));
+  }
+  return encoder.width;
+}
+
+static size_t encode_json(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+    RowImageBuffer& row, bool is_json_diff)
+{
+  // JsonParser reads the value up to its first NUL
+  thread_local JsonbEncoder json;
+  if (!json.encode(data, strnlen(data, data_len), is_json_diff)) {
+    return ColumnEncoderPlan::encode_generic(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+  size_t byte_size = json.size();
+  unsigned char* pos = row.append(4 + byte_size);
+  int4store(pos, byte_size);
+  json.write(pos + 4);
+  return 4 + byte_size;
+}
+
+size_t ColumnEncoderPlan::encode_generic(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data,
+    size_t data_len, RowImageBuffer& row, bool is_json_diff)
+{
+  // the conversions of data_type.cpp need NUL terminated values
+  thread_local std::string value;
+  thread_local MsgBuf decoded;
+  value.assign(data, data_len);
+  size_t ret = get_column_val_bytes(col_meta, data_len, value.data(), decoded, EMPTY_TABLE_NAME, is_json_diff);
+  for (const auto& chunk : decoded.get_chunks()) {
+    row.append(chunk.buffer(), chunk.size());
+  }
+  decoded.reset();
+  return ret;
+}
+
+std::shared_ptr<const ColumnEncoderPlan> ColumnEncoderPlan::compile(ITableMeta* table_meta, uint64_t schema_signature)
+{
+  auto plan = std::make_shared<ColumnEncoderPlan>(schema_signature);
+  int col_count = table_meta->getColCount();
+  plan->_encoders.reserve(col_count);
+  for (int i = 0; i < col_count; ++i) {
+    plan->add_column(*table_meta->getCol(i));
+  }
+  return plan;
+}
+
+void ColumnEncoderPlan::add_column(IColMeta& col_meta)
+{
+  ColumnEncoder encoder;
+  encoder.type = col_meta.getType();
+  encoder.encode = encode_generic;
+  switch (encoder.type) {
+    case OB_TYPE_TINY:
+      encoder.encode = encode_integer;
+      encoder.width = 1;
+      break;
+    case OB_TYPE_SHORT:
+      encoder.encode = encode_integer;
+      encoder.width = 2;
+      break;
+    case OB_TYPE_INT24:
+      encoder.encode = encode_integer;
+      encoder.width = 3;
+      break;
+    case OB_TYPE_LONG:
+      encoder.encode = encode_integer;
+      encoder.width = 4;
+      break;
+    case OB_TYPE_LONGLONG:
+      encoder.encode = encode_integer;
+      encoder.width = 8;
+      break;
+    case OB_TYPE_FLOAT:
+      // a float with a precision above 24 is stored as a double, see convert_binlog_float
+      encoder.encode = encode_floating;
+      encoder.width = col_meta.getPrecision() > 24 ? sizeof(double) : sizeof(float);
+      break;
+    case OB_TYPE_DOUBLE:
+      encoder.encode = encode_floating;
+      encoder.width = sizeof(double);
+      break;
+    case OB_TYPE_STRING:
+    case OB_TYPE_VAR_STRING:
+    case OB_TYPE_VARCHAR: {
+      size_t col_len = col_meta.getLength();
+      col_len *= charset_encoding_bytes(col_meta.getEncoding());
+      encoder.encode = encode_length_prefixed;
+      encoder.width = col_len > 255 ? 2 : 1;
+      break;
+    }
+    case OB_TYPE_TINY_BLOB:
+      encoder.encode = encode_length_prefixed;
+      encoder.width = 1;
+      break;
+    case OB_TYPE_BLOB:
+      encoder.encode = encode_length_prefixed;
+      encoder.width = 2;
+      break;
+    case OB_TYPE_MEDIUM_BLOB:
+      encoder.encode = encode_length_prefixed;
+      encoder.width = 3;
+      break;
+    case OB_TYPE_LONG_BLOB:
+      encoder.encode = encode_length_prefixed;
+      encoder.width = 4;
+      break;
+    case OB_TYPE_YEAR:
+      encoder.encode = encode_year;
+      encoder.width = 1;
+      break;
+    case OB_TYPE_DATE:
+    case OB_TYPE_NEWDATE:
+      encoder.encode = encode_date;
+      encoder.width = 3;
+      break;
+    case OB_TYPE_DATETIME:
+    case OB_TYPE_TIME:
+    case OB_TYPE_TIMESTAMP: {
+      // fractional seconds beyond microseconds are left to the conversions of data_type.cpp
+      int scale = col_meta.getScale();
+      if (scale >= 0 && scale <= 6) {
+        encoder.scale = scale;
+        encoder.width = remainder_bytes(scale);
+        if (encoder.type == OB_TYPE_DATETIME) {
+          encoder.encode = encode_datetime;
+          encoder.width += 5;
+        } else if (encoder.type == OB_TYPE_TIME) {
+          encoder.encode = encode_time;
+          encoder.width += 3;
+        } else {
+          encoder.encode = encode_timestamp;
+          encoder.width += 4;
+        }
+      }
+      break;
+    }
+    case OB_TYPE_DECIMAL:
+    case OB_TYPE_NEWDECIMAL: {
+      // the same defaults as convert_binlog_decimal
+      int precision = col_meta.getPrecision() >= 0 ? col_meta.getPrecision() : 10;
+      int scale = col_meta.getScale() >= 0 ? col_meta.getScale() : 0;
+      if (scale <= precision && decimal_bin_size(precision, scale) <= 32) {
+        encoder.encode = encode_decimal;
+        encoder.precision = precision;
+        encoder.scale = scale;
+        encoder.width = decimal_bin_size(precision, scale);
+      }
+      break;
+    }
+    case OB_TYPE_BIT: {
+      // without a precision the width follows the value, which is left to convert_binlog_bit
+      size_t precision = col_meta.getPrecision();
+      if (precision > 0 && (precision + 7) / 8 <= sizeof(uint64_t)) {
+        encoder.encode = encode_bit;
+        encoder.width = (precision + 7) / 8;
+      }
+      break;
+    }
+    case OB_TYPE_JSON:
+      encoder.encode = encode_json;
+      _json_col_count++;
+      break;
+    default:
+      break;
+  }
+  _encoders.push_back(encoder);
+}
+
+void ColumnEncoderPlan::encode_before(ILogRecord* record, ITableMeta* table_meta, RowImageBuffer& row,
+    size_t& before_pos, unsigned char* before_bitmap) const
+{
+  size_t data_len = 0;
+  bool is_parsed = record->isParsedRecord();
+  StrArray* old_str_buf = record->parsedOldCols();
+  unsigned int old_col_count;
+  BinLogBuf* old_bin_log_buf = record->oldCols(old_col_count);
+  int col_count = this->col_count();
+  for (int i = 0; i < col_count; ++i) {
+    const char* data;
+    if (is_parsed) {
+      old_str_buf->elementAt(i, data, data_len);
+    } else {
+      data = old_bin_log_buf[i].buf;
+      data_len = old_bin_log_buf[i].buf_used_size;
+    }
+    if (data_len <= 0 && data == nullptr) {
+      before_bitmap[i / 8] |= (0x01 << ((i % 8)));
+      continue;
+    }
+    before_pos += encode(i, *table_meta->getCol(i), data, data_len, row);
+  }
+}
+
+void ColumnEncoderPlan::encode_after(ILogRecord* record, ITableMeta* table_meta, RowImageBuffer& row,
+    size_t& after_pos, RowsEventType rows_event_type, unsigned char* after_bitmap, unsigned char* partial_cols_bitmap,
+    bool& has_any_json_diff) const
+{
+  size_t data_len = 0;
+  bool is_parsed = record->isParsedRecord();
+  StrArray* new_str_buf = record->parsedNewCols();
+  unsigned int new_col_count;
+  BinLogBuf* new_bin_log_buf = record->newCols(new_col_count);
+
+  int json_col_index = 0;
+  int col_count = this->col_count();
+  for (int i = 0; i < col_count; ++i) {
+    const char* data;
+    bool is_json_diff;
+    if (is_parsed) {
+      new_str_buf->elementAt(i, data, data_len);
+      size_t diff_col_size;
+      is_json_diff = record->parsedNewValueDiff(diff_col_size)[i];
+    } else {
+      data = new_bin_log_buf[i].buf;
+      data_len = new_bin_log_buf[i].buf_used_size;
+      is_json_diff = new_bin_log_buf[i].m_diff_val;
+    }
+
+    if (data_len <= 0 && data == nullptr) {
+      after_bitmap[i / 8] |= (0x01 << ((i % 8)));
+      is_json_diff = false;
+    } else {
+      is_json_diff = (rows_event_type == UPDATE) ? is_json_diff : false;
+      after_pos += encode(i, *table_meta->getCol(i), data, data_len, row, is_json_diff);
+    }
+
+    // only UPDATE_AFTER may have diff partial value
+    if (_encoders[i].type == OB_TYPE_JSON) {
+      if (is_json_diff && partial_cols_bitmap != nullptr) {
+        has_any_json_diff = true;
+        partial_cols_bitmap[json_col_index / 8] |= (0x01 << ((json_col_index % 8)));
+      }
+      json_col_index += 1;
+    }
+  }
+}
+
+static void push_row_image(RowImageBuffer& row, MsgBuf& row_val, EventArena& arena)
+{
+  if (row.size() > 0) {
+    unsigned char* image = arena.alloc_bytes(row.size());
+    memcpy(image, row.data(), row.size());
+    row_val.push_back(reinterpret_cast<char*>(image), row.size(), false);
+  }
+  row.clear();
+  row.shrink(MAX_IDLE_ROW_IMAGE_CAPACITY);
+}
+
+size_t ColumnEncoderPlan::encode_rows(ILogRecord* record, ITableMeta* table_meta, MsgBuf& before_val,
+    MsgBuf& after_val, size_t& before_pos, size_t& after_pos, RowsEventType rows_event_type,
+    unsigned char* before_bitmap, unsigned char* after_bitmap, unsigned char*& partial_cols_bitmap,
+    size_t& partial_cols_bytes, EventArena& arena) const
+{
+  thread_local RowImageBuffer row;
+  if (rows_event_type != RowsEventType::INSERT) {
+    encode_before(record, table_meta, row, before_pos, before_bitmap);
+    push_row_image(row, before_val, arena);
+  }
+
+  if (RowsEventType::UPDATE == rows_event_type && _json_col_count != 0) {
+    partial_cols_bytes = (_json_col_count + 7) / 8;
+    partial_cols_bitmap = static_cast<unsigned char*>(malloc(partial_cols_bytes));
+    fill_bitmap(_json_col_count, partial_cols_bytes, partial_cols_bitmap);
+  }
+
+  bool has_any_json_diff = false;
+  if (rows_event_type != DELETE) {
+    encode_after(record, table_meta, row, after_pos, rows_event_type, after_bitmap, partial_cols_bitmap,
+        has_any_json_diff);
+    push_row_image(row, after_val, arena);
+  }
+
+  // "partial_json" option is not enabled
+  if (!has_any_json_diff && partial_cols_bitmap != nullptr) {
+    free(partial_cols_bitmap);
+    partial_cols_bitmap = nullptr;
+    partial_cols_bytes = 0;
+  }
+  return before_pos + after_pos;
+}
+
+}  // namespace oceanbase::binlog
@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "ob_log_event.h"
+#include "data_type.h"
+#include "event_arena.h"
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief Growable scratch buffer a row image is encoded into, reused across rows so that encoding allocates nothing
+ * once it has grown to the widest row.
+ */
+class RowImageBuffer {
+public:
+  RowImageBuffer() = default;
+
+  ~RowImageBuffer()
+  {
+    free(_data);
+  }
+
+  RowImageBuffer(const RowImageBuffer&) = delete;
+  RowImageBuffer& operator=(const RowImageBuffer&) = delete;
+
+  /*!
+   * @brief Reserve size bytes at the end of the image and return them for writing
+   */
+  unsigned char* append(size_t size)
+  {
+    if (_size + size > _capacity) {
+      grow(_size + size);
+    }
+    unsigned char* pos = _data + _size;
+    _size += size;
+    return pos;
+  }
+
+  void append(const void* data, size_t size)
+  {
+    if (size > 0) {
+      memcpy(append(size), data, size);
+    }
+  }
+
+  void clear()
+  {
+    _size = 0;
+  }
+
+  /*!
+   * @brief Give the memory back if the buffer has grown beyond max_capacity, so a single huge row does not stay pinned
+   */
+  void shrink(size_t max_capacity);
+
+  const unsigned char* data() const
+  {
+    return _data;
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+private:
+  void grow(size_t min_capacity);
+
+private:
+  unsigned char* _data = nullptr;
+  size_t _size = 0;
+  size_t _capacity = 0;
+};
+
+struct ColumnEncoder;
+
+/*!
+ * @brief Appends the binlog encoding of one column value to the row image.
+ * @return the number of bytes the value adds to the row, as get_column_val_bytes counts them
+ */
+using ColumnEncodeFunc = size_t (*)(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data,
+    size_t data_len, RowImageBuffer& row, bool is_json_diff);
+
+/*!
+ * @brief Compiled encoder of one column: the value kind is resolved to a function once, together with everything the
+ * function would otherwise derive from the column meta on every value.
+ */
+struct ColumnEncoder {
+  ColumnEncodeFunc encode = nullptr;
+  int type = 0;
+  // bytes of a fixed-width value, or of the length prefix of a variable-width one
+  uint32_t width = 0;
+  // precision and scale of a decimal, or the fractional second digits of a temporal value
+  int precision = 0;
+  int scale = 0;
+};
+
+/*!
+ * @brief Encoder plan of one table schema version, compiled once from its ITableMeta by the convert worker.
+ *
+ * Integers, decimals, floating point numbers, strings, blobs, bits, temporal values and JSON documents are parsed
+ * straight from the value without a NUL terminated copy, and every column of a row is written into one RowImageBuffer
+ * instead of a malloc'ed MsgBuf chunk each. The remaining types go through get_column_val_bytes, as does any value a
+ * fast encoder does not accept verbatim, so the row images are byte for byte the ones of col_val_bytes.
+ *
+ * Like the cached table maps, a plan is identified by the table_schema_signature() of its table meta.
+ */
+class ColumnEncoderPlan {
+public:
+  explicit ColumnEncoderPlan(uint64_t schema_signature = 0) : _schema_signature(schema_signature)
+  {}
+
+  static std::shared_ptr<const ColumnEncoderPlan> compile(ITableMeta* table_meta, uint64_t schema_signature);
+
+  void add_column(IColMeta& col_meta);
+
+  uint64_t schema_signature() const
+  {
+    return _schema_signature;
+  }
+
+  int col_count() const
+  {
+    return static_cast<int>(_encoders.size());
+  }
+
+  bool matches(uint64_t schema_signature) const
+  {
+    return _schema_signature == schema_signature;
+  }
+
+  size_t encode(int index, IColMeta& col_meta, const char* data, size_t data_len, RowImageBuffer& row,
+      bool is_json_diff = false) const
+  {
+    const ColumnEncoder& encoder = _encoders[index];
+    return encoder.encode(encoder, col_meta, data, data_len, row, is_json_diff);
+  }
+
+  /*!
+   * @brief Same contract as col_val_bytes, except that each row image ends up as a single chunk allocated in the arena
+   * of the event.
+   */
+  size_t encode_rows(ILogRecord* record, ITableMeta* table_meta, MsgBuf& before_val, MsgBuf& after_val,
+      size_t& before_pos, size_t& after_pos, RowsEventType rows_event_type, unsigned char* before_bitmap,
+      unsigned char* after_bitmap, unsigned char*& partial_cols_bitmap, size_t& partial_cols_bytes,
+      EventArena& arena) const;
+
+  /*!
+   * @brief Fallback for the types without a compiled encoder, shared with the fast encoders for the values they
+   * cannot take verbatim.
+   */
+  static size_t encode_generic(const ColumnEncoder& encoder, IColMeta& col_meta, const char* data, size_t data_len,
+      RowImageBuffer& row, bool is_json_diff);
+
+private:
+  void encode_before(ILogRecord* record, ITableMeta* table_meta, RowImageBuffer& row, size_t& before_pos,
+      unsigned char* before_bitmap) const;
+
+  void encode_after(ILogRecord* record, ITableMeta* table_meta, RowImageBuffer& row, size_t& after_pos,
+      RowsEventType rows_event_type, unsigned char* after_bitmap, unsigned char* partial_cols_bitmap,
+      bool& has_any_json_diff) const;
+
+private:
+  uint64_t _schema_signature;
+  std::vector<ColumnEncoder> _encoders;
+  int _json_col_count = 0;
+};
+
+}  // namespace oceanbase::binlog
@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "event_block_reader.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "common.h"
+#include "log.h"
+#include "ob_log_event.h"
+
+namespace oceanbase::binlog {
+static constexpr size_t BLOCK_ALIGNMENT = 4096;
+static_assert(EVENT_HEADER_LENGTH == COMMON_HEADER_LENGTH, "mismatched binlog event header length");
+
+EventBlockReader::EventBlockReader(size_t block_size)
+    : _block_size((block_size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT)
+{}
+
+EventBlockReader::~EventBlockReader()
+{
+  free(_buf);
+}
+
+void EventBlockReader::reset(int fd)
+{
+  _fd = fd;
+  _window_offset = 0;
+  _window_len = 0;
+}
+
+int EventBlockReader::grow(size_t capacity)
+{
+  capacity = (capacity + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+  void* buf = nullptr;
+  if (posix_memalign(&buf, BLOCK_ALIGNMENT, capacity) != 0) {
+    OMS_ERROR("Failed to allocate binlog read buffer of {} bytes", capacity);
+    return OMS_FAILED;
+  }
+  free(_buf);
+  _buf = static_cast<unsigned char*>(buf);
+  _capacity = capacity;
+  _window_len = 0;
+  return OMS_OK;
+}
+
+int EventBlockReader::ensure(uint64_t offset, size_t len)
+{
+  if (offset >= _window_offset && offset + len <= _window_offset + _window_len) {
+    return OMS_OK;
+  }
+
+  // events larger than a block get a buffer of their own size
+  size_t capacity = len > _block_size ? len : _block_size;
+  if (_capacity < capacity && grow(capacity) != OMS_OK) {
+    return OMS_IO_ERROR;
+  }
+
+  _window_offset = offset;
+  _window_len = 0;
+  while (_window_len < _capacity) {
+    ssize_t ret = pread(_fd, _buf + _window_len, _capacity - _window_len, _window_offset + _window_len);
+    if (ret > 0) {
+      _window_len += ret;
+      continue;
+    }
+    if (ret == 0) {
+      // end of file for now
+      break;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    OMS_ERROR("Failed to read binlog file from offset {}: {}", _window_offset, strerror(errno));
+    _window_len = 0;
+    return OMS_IO_ERROR;
+  }
+  return _window_len >= len ? OMS_OK : OMS_AGAIN;
+}
+
+int EventBlockReader::read_event(uint64_t offset, uint64_t end_pos, unsigned char*& event, uint32_t& event_len)
+{
+  if (offset + COMMON_HEADER_LENGTH > end_pos) {
+    return OMS_AGAIN;
+  }
+  int ret = ensure(offset, COMMON_HEADER_LENGTH);
+  if (ret != OMS_OK) {
+    return ret;
+  }
+
+  unsigned char* header = _buf + (offset - _window_offset);
+  event_len = int4load(header + EVENT_LEN_OFFSET);
+  if (event_len < COMMON_HEADER_LENGTH) {
+    OMS_ERROR("Invalid binlog event length {} at offset {}", event_len, offset);
+    return OMS_IO_ERROR;
+  }
+  if (offset + event_len > end_pos) {
+    return OMS_AGAIN;
+  }
+  ret = ensure(offset, event_len);
+  if (ret != OMS_OK) {
+    return ret;
+  }
+  event = _buf + (offset - _window_offset);
+  return OMS_OK;
+}
+
+int EventBlockReader::read_header(uint64_t offset, uint64_t end_pos, unsigned char*& header, uint32_t& event_len)
+{
+  if (offset + COMMON_HEADER_LENGTH > end_pos) {
+    return OMS_AGAIN;
+  }
+  if (offset >= _window_offset && offset + COMMON_HEADER_LENGTH <= _window_offset + _window_len) {
+    header = _buf + (offset - _window_offset);
+  } else {
+    size_t len = 0;
+    while (len < COMMON_HEADER_LENGTH) {
+      ssize_t ret = pread(_fd, _header + len, COMMON_HEADER_LENGTH - len, offset + len);
+      if (ret > 0) {
+        len += ret;
+        continue;
+      }
+      if (ret == 0) {
+        return OMS_AGAIN;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      OMS_ERROR("Failed to read binlog event header at offset {}: {}", offset, strerror(errno));
+      return OMS_IO_ERROR;
+    }
+    header = _header;
+  }
+
+  event_len = int4load(header + EVENT_LEN_OFFSET);
+  if (event_len < COMMON_HEADER_LENGTH) {
+    OMS_ERROR("Invalid binlog event length {} at offset {}", event_len, offset);
+    return OMS_IO_ERROR;
+  }
+  return offset + event_len > end_pos ? OMS_AGAIN : OMS_OK;
+}
+
+}  // namespace oceanbase::binlog
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace oceanbase::binlog {
+// same as COMMON_HEADER_LENGTH of ob_log_event.h
+static constexpr size_t EVENT_HEADER_LENGTH = 19;
+
+/*!
+ * @brief Sequential read-ahead reader over a binlog file.
+ *
+ * The file is read in large blocks into a page-aligned buffer and events are handed out as slices of that buffer, so
+ * walking a file costs one pread per block instead of two reads and a malloc per event. A slice stays valid until the
+ * next call of read_event() or reset(). Binlog files are append-only, so bytes read ahead of end_pos never change and
+ * can be served later on.
+ */
+class EventBlockReader {
+public:
+  explicit EventBlockReader(size_t block_size);
+
+  ~EventBlockReader();
+
+  EventBlockReader(const EventBlockReader&) = delete;
+  EventBlockReader& operator=(const EventBlockReader&) = delete;
+
+  /*!
+   * @brief Switch to another file (descriptor), drops everything read ahead
+   */
+  void reset(int fd);
+
+  /*!
+   * @brief Get the event starting at offset
+   * @param offset file offset of the event
+   * @param end_pos end of the readable part of the file
+   * @param event[out] the event, from the common header to the checksum
+   * @param event_len[out] length of the event
+   * @return OMS_OK, OMS_AGAIN if the event does not end before end_pos yet, or OMS_IO_ERROR
+   */
+  int read_event(uint64_t offset, uint64_t end_pos, unsigned char*& event, uint32_t& event_len);
+
+  /*!
+   * @brief Like read_event(), but only the common header of the event is made available. If the header is not read
+   * ahead already, only the header is read, so the body can be sent straight from the file.
+   */
+  int read_header(uint64_t offset, uint64_t end_pos, unsigned char*& header, uint32_t& event_len);
+
+  int fd() const
+  {
+    return _fd;
+  }
+
+private:
+  /*!
+   * @brief Make [offset, offset + len) available in the buffer, reading a whole block from offset if needed
+   */
+  int ensure(uint64_t offset, size_t len);
+
+  int grow(size_t capacity);
+
+private:
+  int _fd = -1;
+  size_t _block_size;
+  unsigned char* _buf = nullptr;
+  size_t _capacity = 0;
+  // file offset of _buf[0] and number of valid bytes
+  uint64_t _window_offset = 0;
+  size_t _window_len = 0;
+  // common header of an event that is not read ahead
+  unsigned char _header[EVENT_HEADER_LENGTH] = {};
+};
+
+}  // namespace oceanbase::binlog
@@ -8,8 +8,16 @@
 #include <YieldingWaitStrategy.h>
 #include <binlog_converter.h>
 #include <env.h>
+#include "pipeline_latency.h"
 namespace oceanbase::binlog {
 
+// The tenant of an instance never changes, so read it once instead of copying it out of the meta for every record
+static const std::string& instance_tenant()
+{
+  static const std::string tenant = s_meta.tenant();
+  return tenant;
+}
+
 void BinlogEventHandler::onEvent(BinlogEvent& data, std::int64_t sequence, bool endOfBatch)
 {
   std::vector<ObLogEvent*> events = std::move(data.events);
@@ -21,44 +29,96 @@ void BinlogEventHandler::onEvent(BinlogEvent& data, std::int64_t sequence, bool
   events.clear();
 }
 
+/*!
+ * @brief Owns the arena of a batch until it is handed over to the events. If the conversion throws or returns before,
+ * the events converted so far are released, together with the arena, so that it goes back to the pool.
+ */
+class BatchArenaGuard {
+public:
+  explicit BatchArenaGuard(BinlogEvent& binlog_event) : _binlog_event(binlog_event)
+  {
+    _binlog_event.arena = EventArenaPool::instance().acquire();
+  }
+
+  ~BatchArenaGuard()
+  {
+    if (_binlog_event.arena == nullptr) {
+      return;
+    }
+    // the arena counts the events created in it, sealing then releasing all of them recycles it
+    _binlog_event.arena->seal();
+    _binlog_event.arena = nullptr;
+    release_events(_binlog_event.events);
+    _binlog_event.events.clear();
+  }
+
+  BatchArenaGuard(const BatchArenaGuard&) = delete;
+  BatchArenaGuard& operator=(const BatchArenaGuard&) = delete;
+
+  /*!
+   * @brief Hand the arena over to the events, it will be recycled after the last of them has been serialized
+   */
+  void seal()
+  {
+    _binlog_event.arena->seal();
+    _binlog_event.arena = nullptr;
+  }
+
+private:
+  BinlogEvent& _binlog_event;
+};
+
 void BinlogEventConvertHandler::onEvent(BinlogEvent& binlog_event, std::int64_t sequence)
 {
   const uint64_t record_count = binlog_event.records.size();
+  BatchArenaGuard arena_guard(binlog_event);
+  EventArena& arena = *binlog_event.arena;
   for (ILogRecord* record : binlog_event.records) {
-    switch (record->recordType()) {
+    int type = record->recordType();
+    // the schema of a row record is only walked when its table meta changed
+    uint64_t schema_signature = 0;
+    if (type == EINSERT || type == EDELETE || type == EUPDATE) {
+      schema_signature = table_cache.get_schema_signature(
+          CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant()),
+          record->tbname(),
+          record->getTableMeta());
+    }
+    switch (type) {
       case EBEGIN:
         // GTID_LOG_EVENT -> QUERY_EVENT
         // init GTID
-        parallel_convert_gtid_log_event(record, binlog_event.events, ddl_parser, table_cache);
+        parallel_convert_gtid_log_event(record, binlog_event.events, arena, table_cache);
         break;
       case ECOMMIT:
         // Xid Event
-        parallel_convert_xid_event(record, binlog_event.events);
+        parallel_convert_xid_event(record, binlog_event.events, arena);
         break;
-      case EDDL:
+      case EDDL: {
         // GTID_LOG_EVENT -> QUERY_EVENT
-        if (!parallel_ddl_need_to_be_stored(record, ddl_parser)) {
+        std::string ddl;
+        if (!parallel_ddl_need_to_be_stored(record, ddl_parser, ddl)) {
           break;
         }
-        parallel_convert_gtid_log_event(record, binlog_event.events, ddl_parser, table_cache);
+        parallel_convert_gtid_log_event(record, binlog_event.events, arena, table_cache, std::move(ddl));
         break;
+      }
       case EINSERT:
-        parallel_convert_table_map_event(record, binlog_event.events, table_cache);
-        parallel_convert_write_rows_event(record, binlog_event.events, table_cache);
+        parallel_convert_table_map_event(record, binlog_event.events, arena, table_cache, schema_signature);
+        parallel_convert_write_rows_event(record, binlog_event.events, arena, table_cache, schema_signature);
         break;
       case EDELETE:
-        parallel_convert_table_map_event(record, binlog_event.events, table_cache);
-        parallel_convert_delete_rows_event(record, binlog_event.events, table_cache);
+        parallel_convert_table_map_event(record, binlog_event.events, arena, table_cache, schema_signature);
+        parallel_convert_delete_rows_event(record, binlog_event.events, arena, table_cache, schema_signature);
         break;
       case EUPDATE:
-        parallel_convert_table_map_event(record, binlog_event.events, table_cache);
-        parallel_convert_update_rows_event(record, binlog_event.events, table_cache);
+        parallel_convert_table_map_event(record, binlog_event.events, arena, table_cache, schema_signature);
+        parallel_convert_update_rows_event(record, binlog_event.events, arena, table_cache, schema_signature);
         break;
       case HEARTBEAT:
         // // skip heartbeat
         logproxy::Counter::instance().mark_checkpoint(CommonUtils::get_checkpoint_usec(record));
         logproxy::Counter::instance().mark_timestamp(CommonUtils::get_timestamp_usec(record));
-        parallel_pass_heartbeat_checkpoint(record, binlog_event.events);
+        parallel_pass_heartbeat_checkpoint(record, binlog_event.events, arena);
         break;
       default:
         OMS_ERROR("Unsupported record type: {}", record->recordType());
@@ -69,6 +129,13 @@ void BinlogEventConvertHandler::onEvent(BinlogEvent& binlog_event, std::int64_t
     }
     obcdc_access->release(record);
   }
+  uint64_t converted_us = Timer::now();
+  for (ObLogEvent* event : binlog_event.events) {
+    if (event->get_header()->get_type_code() == XID_EVENT) {
+      PipelineLatency::instance().record(PIPELINE_CONVERT, event->get_checkpoint(), converted_us);
+    }
+  }
+  arena_guard.seal();
   Counter::instance().count_convert(record_count);
   binlog_event.records.clear();
 }
@@ -97,65 +164,45 @@ void ConvertExceptionHandler::handleOnTimeoutException(const std::exception& ex,
   converter.stop_converter();
 }
 
-inline bool parallel_convert_gtid_log_event(ILogRecord* record, std::vector<ObLogEvent*>& events,
-    binlog::DdlParser& ddl_parser, TableCache& table_cache, bool is_ddl)
+inline bool parallel_convert_gtid_log_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, std::string ddl)
 {
-  auto* gtid_log_event = new GtidLogEvent();
+  auto* gtid_log_event = arena.create_event<GtidLogEvent>();
   gtid_log_event->set_gtid_uuid(s_meta.binlog_config()->master_server_uuid());
 
   // set common _header
   uint32_t event_len = COMMON_HEADER_LENGTH + GTID_HEADER_LEN + gtid_log_event->get_checksum_len();
-  auto* common_header = new OblogEventHeader(GTID_LOG_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
+  auto* common_header =
+      arena.create<OblogEventHeader>(GTID_LOG_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
   gtid_log_event->set_header(common_header);
   gtid_log_event->set_ob_txn(CommonUtils::get_transaction_id(record));
   gtid_log_event->set_checkpoint(CommonUtils::get_checkpoint_usec(record));
   gtid_log_event->set_last_committed(record->getTimestamp());
   gtid_log_event->set_sequence_number(record->getRecordUsec());
   events.push_back(gtid_log_event);
-  parallel_convert_query_event(record, events, ddl_parser, table_cache);
+  parallel_convert_query_event(record, events, arena, table_cache, std::move(ddl));
   return true;
 }
 
-inline void parallel_convert_query_event(
-    ILogRecord* record, std::vector<ObLogEvent*>& events, binlog::DdlParser& ddl_parser, TableCache& table_cache)
+inline void parallel_convert_query_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, std::string ddl)
 {
-  char* sql = nullptr;
-  size_t sql_statment_len = 0;
   bool is_ddl_event = false;
   if (record->recordType() == EBEGIN) {
-    sql = static_cast<char*>(malloc(BEGIN_VAR_LEN));
-    write_string(sql, BEGIN_VAR_LEN, BEGIN_VAR, BEGIN_VAR_LEN);
-    sql_statment_len = BEGIN_VAR_LEN;
+    ddl.assign(BEGIN_VAR, BEGIN_VAR_LEN);
   } else {
     is_ddl_event = true;
-    unsigned int new_col_count = 0;
-    BinLogBuf* new_bin_log_buf = record->newCols(new_col_count);
-    sql_statment_len = new_bin_log_buf->buf_used_size;
-    sql = static_cast<char*>(malloc(new_bin_log_buf->buf_used_size));
-    write_string(sql, sql_statment_len, new_bin_log_buf->buf, sql_statment_len);
     if (s_config.binlog_ddl_convert.val()) {
-      std::string convert_sql;
-      std::string ddl = std::string{sql, sql_statment_len};
-      int convert_ret = ddl_parser.parse(ddl, convert_sql);
-      if (convert_ret != OMS_OK) {
-        convert_sql = std::string{sql, sql_statment_len};
-        // etransfer failed to convert incremental DDL, using untransformed DDL
-        OMS_WARN("Failed to convert incremental DDL, using untransformed DDL: {}", convert_sql);
-      }
-      free(sql);
-      sql = nullptr;
-      sql_statment_len = convert_sql.size();
-      sql = static_cast<char*>(malloc(sql_statment_len));
-      write_string(sql, sql_statment_len, convert_sql.c_str(), sql_statment_len);
       table_cache.refresh_table_id(
-          CommonUtils::get_dbname_without_tenant(record->dbname(), s_meta.tenant()), record->tbname());
+          CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant()), record->tbname());
+    } else {
+      table_cache.forget_schemas();
     }
   }
 
-  std::string dbname = CommonUtils::get_dbname_without_tenant(record->dbname(), s_meta.tenant());
-  std::string ddl = std::string{sql, sql_statment_len};
-  free(sql);
-  auto* event = new QueryEvent(dbname, ddl);
+  std::string dbname(CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant()));
+  size_t sql_statment_len = ddl.size();
+  auto* event = arena.create_event<QueryEvent>(dbname, std::move(ddl));
   event->set_sql_statment_len(sql_statment_len);
   event->set_query_exec_time(0);
   event->set_thread_id(record->getThreadId());
@@ -171,7 +218,8 @@ inline void parallel_convert_query_event(
 
   std::uint16_t status_var_len = status_vars_bitfield[Q_FLAGS2_CODE] + 1 + status_vars_bitfield[Q_CHARSET_CODE] + 1;
   event->set_status_var_len(status_var_len);
-  auto* status_vars = static_cast<char*>(malloc(status_var_len));
+  char status_vars[32];
+  assert(status_var_len <= sizeof(status_vars));
   std::uint16_t offset = 0;
   int1store(reinterpret_cast<unsigned char*>(status_vars + offset), Q_FLAGS2_CODE);
   offset += 1;
@@ -204,75 +252,84 @@ inline void parallel_convert_query_event(
   int2store(reinterpret_cast<unsigned char*>(status_vars + offset), 83);
   offset += 2;
 
-  std::string status_vars_str = std::string{status_vars, status_var_len};
-  event->set_status_vars(status_vars_str);
+  event->set_status_vars(std::string{status_vars, status_var_len});
   /********** status vars **********/
 
   // set common _header
   uint32_t event_len = COMMON_HEADER_LENGTH + QUERY_HEADER_LEN + event->get_status_var_len() + event->get_db_len() + 1 +
                        event->get_sql_statment_len() + event->get_checksum_len();
   uint64_t timestamp = CommonUtils::get_timestamp_sec(record);
-  auto* common_header = new OblogEventHeader(QUERY_EVENT, timestamp, event_len, 0);
+  auto* common_header = arena.create<OblogEventHeader>(QUERY_EVENT, timestamp, event_len, 0);
   event->set_header(common_header);
-  free(status_vars);
   events.push_back(event);
 }
 
-inline bool parallel_ddl_need_to_be_stored(ILogRecord* record, binlog::DdlParser& ddl_parser)
+inline bool parallel_ddl_need_to_be_stored(ILogRecord* record, binlog::DdlParser& ddl_parser, std::string& ddl)
 {
-  char* sql = nullptr;
-  defer(free(sql));
-  size_t sql_statment_len = 0;
   unsigned int new_col_count = 0;
   BinLogBuf* new_bin_log_buf = record->newCols(new_col_count);
-  sql_statment_len = new_bin_log_buf->buf_used_size;
-  sql = static_cast<char*>(malloc(new_bin_log_buf->buf_used_size));
-  write_string(sql, sql_statment_len, new_bin_log_buf->buf, sql_statment_len);
-  if (s_config.binlog_ddl_convert.val()) {
-    std::string convert_sql;
-    std::string ddl = std::string{sql, sql_statment_len};
-    int convert_ret = ddl_parser.parse(ddl, convert_sql);
-    if (s_config.binlog_ddl_convert_ignore_unsupported_ddl.val()) {
-      if (convert_ret != OMS_OK) {
-        OMS_INFO("A DDL event that is not supported by the downstream is encountered and is empty after "
-                 "conversion,original sql:{}",
-            ddl);
-        return false;
-      }
-    }
+  ddl.assign(new_bin_log_buf->buf, new_bin_log_buf->buf_used_size);
+  if (!s_config.binlog_ddl_convert.val()) {
     return true;
-  } else {
+  }
+
+  std::string convert_sql;
+  if (ddl_parser.parse(ddl, convert_sql) == OMS_OK) {
+    ddl = std::move(convert_sql);
     return true;
   }
+  if (s_config.binlog_ddl_convert_ignore_unsupported_ddl.val()) {
+    OMS_INFO("A DDL event that is not supported by the downstream is encountered and is empty after "
+             "conversion,original sql:{}",
+        ddl);
+    return false;
+  }
+  // etransfer failed to convert incremental DDL, using untransformed DDL
+  OMS_WARN("Failed to convert incremental DDL, using untransformed DDL: {}", ddl);
+  return true;
 }
 
-inline void parallel_convert_xid_event(ILogRecord* record, std::vector<ObLogEvent*>& events)
+inline void parallel_convert_xid_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena)
 {
-  auto* event = new XidEvent();
+  auto* event = arena.create_event<XidEvent>();
   // set common _header
   uint32_t xid_event_len = COMMON_HEADER_LENGTH + XID_HEADER_LEN + XID_LEN + event->get_checksum_len();
   // mysql 5.7 no _column_count
-  auto* common_header = new OblogEventHeader(XID_EVENT, CommonUtils::get_timestamp_sec(record), xid_event_len, 0);
+  auto* common_header =
+      arena.create<OblogEventHeader>(XID_EVENT, CommonUtils::get_timestamp_sec(record), xid_event_len, 0);
   event->set_header(common_header);
+  // the commit timestamp, which times the transaction through the pipeline
+  event->set_checkpoint(CommonUtils::get_checkpoint_usec(record));
   events.push_back(event);
 }
 
-inline void parallel_convert_table_map_event(
-    ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache)
+inline void parallel_convert_table_map_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature)
 {
-  auto* event = new TableMapEvent();
+  auto* event = arena.create_event<TableMapEvent>();
+  std::string_view tb_name = record->tbname();
+  std::string_view dbname = CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant());
+  ITableMeta* table_meta = record->getTableMeta();
+
+  // The table map only changes with the table schema, reuse the serialized one of the previous rows if possible
+  auto table_map = table_cache.get_table_map(dbname, tb_name, schema_signature);
+  if (table_map != nullptr) {
+    uint32_t event_len = COMMON_HEADER_LENGTH + table_map->body.size() + event->get_checksum_len();
+    event->set_definition(std::move(table_map));
+    auto* common_header =
+        arena.create<OblogEventHeader>(TABLE_MAP_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
+    event->set_header(common_header);
+    events.push_back(event);
+    return;
+  }
 
   // fix part
-  std::string tb_name = record->tbname();
   // TM_BIT_LEN_EXACT_F
   event->set_flags((1U << 0));
   // variable part
-
-  std::string dbname = CommonUtils::get_dbname_without_tenant(record->dbname(), s_meta.tenant());
-  event->set_db_name(dbname);
+  event->set_db_name(std::string(dbname));
   event->set_db_len(dbname.size());
 
-  ITableMeta* table_meta = record->getTableMeta();
   event->set_tb_name(table_meta->getName());
   event->set_tb_len(event->get_tb_name().size());
 
@@ -283,10 +340,10 @@ inline void parallel_convert_table_map_event(
   event->set_table_id(table_cache.get_table_id(dbname, tb_name));
   unsigned char cbuf[sizeof(col_count) + 1];
 
-  auto* col_type = static_cast<unsigned char*>(malloc(col_count));
-  auto* null_bits = static_cast<unsigned char*>(malloc((col_count + 7) / 8));
+  auto* col_type = arena.alloc_bytes(col_count);
+  auto* null_bits = arena.alloc_bytes((col_count + 7) / 8);
   memset(null_bits, 0, (col_count + 7) / 8);
-  auto* col_metadata = static_cast<unsigned char*>(malloc(col_count * 2));
+  auto* col_metadata = arena.alloc_bytes(col_count * 2);
   memset(col_metadata, 0, col_count * 2);
   int col_metadata_len = 0;
 
@@ -362,26 +419,28 @@ inline void parallel_convert_table_map_event(
   body_size += col_metadata_len;
   // set common _header
   uint32_t event_len = COMMON_HEADER_LENGTH + TABLE_MAP_HEADER_LEN + body_size + event->get_checksum_len();
-  auto* common_header = new OblogEventHeader(TABLE_MAP_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
+  auto* common_header =
+      arena.create<OblogEventHeader>(TABLE_MAP_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
   event->set_header(common_header);
+  table_cache.put_table_map(dbname, tb_name, event->make_definition(schema_signature));
   events.push_back(event);
 }
-inline void parallel_convert_write_rows_event(
-    ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache)
+inline void parallel_convert_write_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature)
 {
-  std::string tb_name = record->tbname();
+  std::string_view tb_name = record->tbname();
   // event body
   ITableMeta* table_meta = record->getTableMeta();
   int col_count = table_meta->getColCount();
-  std::string dbname = CommonUtils::get_dbname_without_tenant(record->dbname(), s_meta.tenant());
-  auto* event = new WriteRowsEvent(table_cache.get_table_id(dbname, tb_name), STMT_END_F);
+  std::string_view dbname = CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant());
+  auto* event = arena.create_event<WriteRowsEvent>(table_cache.get_table_id(dbname, tb_name), STMT_END_F);
   // event body
   event->set_var_header_len(2);
   size_t body_size = 0;
   int col_bytes = (col_count + 7) / 8;
   event->set_after_image_cols(col_bytes);
   body_size += col_bytes;
-  auto* bitmap = static_cast<unsigned char*>(malloc(col_bytes));
+  auto* bitmap = arena.alloc_bytes(col_bytes);
   fill_bitmap(col_count, col_bytes, bitmap);
   body_size += col_bytes;
   size_t before_pos = 0;
@@ -389,7 +448,8 @@ inline void parallel_convert_write_rows_event(
   // used for parameters placeholder
   unsigned char* partial_cols_bitmap = nullptr;
   size_t partial_cols_bytes = 0;
-  body_size += col_val_bytes(record,
+  const ColumnEncoderPlan& encoder_plan = table_cache.get_encoder_plan(dbname, tb_name, table_meta, schema_signature);
+  body_size += encoder_plan.encode_rows(record,
       table_meta,
       event->get_before_row(),
       event->get_after_row(),
@@ -399,7 +459,8 @@ inline void parallel_convert_write_rows_event(
       nullptr,
       bitmap,
       partial_cols_bitmap,
-      partial_cols_bytes);
+      partial_cols_bytes,
+      arena);
 
   event->set_before_pos(before_pos);
   event->set_after_pos(after_pos);
@@ -410,21 +471,22 @@ inline void parallel_convert_write_rows_event(
 
   // set common _header,no len(after_row)
   uint32_t event_len = COMMON_HEADER_LENGTH + ROWS_HEADER_LEN + VAR_HEADER_LEN + body_size + event->get_checksum_len();
-  auto* common_header = new OblogEventHeader(WRITE_ROWS_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
+  auto* common_header =
+      arena.create<OblogEventHeader>(WRITE_ROWS_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
   event->set_header(common_header);
   // set crc32
   event->set_ob_txn(CommonUtils::get_transaction_id(record));
   event->set_checkpoint(CommonUtils::get_checkpoint_usec(record));
   events.push_back(event);
 }
-inline void parallel_convert_delete_rows_event(
-    ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache)
+inline void parallel_convert_delete_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature)
 {
-  std::string tb_name = record->tbname();
+  std::string_view tb_name = record->tbname();
   ITableMeta* table_meta = record->getTableMeta();
   int col_count = table_meta->getColCount();
-  std::string dbname = CommonUtils::get_dbname_without_tenant(record->dbname(), s_meta.tenant());
-  auto* event = new DeleteRowsEvent(table_cache.get_table_id(dbname, tb_name), STMT_END_F);
+  std::string_view dbname = CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant());
+  auto* event = arena.create_event<DeleteRowsEvent>(table_cache.get_table_id(dbname, tb_name), STMT_END_F);
 
   // event body
   event->set_var_header_len(2);
@@ -432,7 +494,7 @@ inline void parallel_convert_delete_rows_event(
   int col_bytes = (col_count + 7) / 8;
   event->set_before_image_cols(col_bytes);
   body_size += col_bytes;
-  auto* bitmap = static_cast<unsigned char*>(malloc(col_bytes));
+  auto* bitmap = arena.alloc_bytes(col_bytes);
   fill_bitmap(col_count, col_bytes, bitmap);
   body_size += col_bytes;
 
@@ -441,7 +503,8 @@ inline void parallel_convert_delete_rows_event(
   // used for parameters placeholder
   unsigned char* partial_cols_bitmap = nullptr;
   size_t partial_cols_bytes = 0;
-  body_size += col_val_bytes(record,
+  const ColumnEncoderPlan& encoder_plan = table_cache.get_encoder_plan(dbname, tb_name, table_meta, schema_signature);
+  body_size += encoder_plan.encode_rows(record,
       table_meta,
       event->get_before_row(),
       event->get_after_row(),
@@ -451,7 +514,8 @@ inline void parallel_convert_delete_rows_event(
       bitmap,
       nullptr,
       partial_cols_bitmap,
-      partial_cols_bytes);
+      partial_cols_bytes,
+      arena);
 
   event->set_before_pos(before_pos);
   event->set_after_pos(after_pos);
@@ -464,7 +528,8 @@ inline void parallel_convert_delete_rows_event(
 
   // set common _header,no len(after_row)
   uint32_t event_len = COMMON_HEADER_LENGTH + ROWS_HEADER_LEN + VAR_HEADER_LEN + body_size + event->get_checksum_len();
-  auto* common_header = new OblogEventHeader(DELETE_ROWS_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
+  auto* common_header =
+      arena.create<OblogEventHeader>(DELETE_ROWS_EVENT, CommonUtils::get_timestamp_sec(record), event_len, 0);
   event->set_header(common_header);
   // set crc32
   event->set_ob_txn(CommonUtils::get_transaction_id(record));
@@ -472,24 +537,24 @@ inline void parallel_convert_delete_rows_event(
   events.push_back(event);
 }
 
-inline void parallel_pass_heartbeat_checkpoint(ILogRecord* record, std::vector<ObLogEvent*>& events)
+inline void parallel_pass_heartbeat_checkpoint(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena)
 {
-  auto* event = new HeartbeatEvent();
+  auto* event = arena.create_event<HeartbeatEvent>();
   event->set_checkpoint(CommonUtils::get_checkpoint_usec(record));
   events.push_back(event);
 }
 
-inline void parallel_convert_update_rows_event(
-    ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache)
+inline void parallel_convert_update_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature)
 {
-  std::string tb_name = record->tbname();
+  std::string_view tb_name = record->tbname();
   EventType update_type = UPDATE_ROWS_EVENT;
 
   // event body
   ITableMeta* table_meta = record->getTableMeta();
   int col_count = table_meta->getColCount();
-  std::string dbname = CommonUtils::get_dbname_without_tenant(record->dbname(), s_meta.tenant());
-  auto* event = new UpdateRowsEvent(table_cache.get_table_id(dbname, tb_name), STMT_END_F);
+  std::string_view dbname = CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant());
+  auto* event = arena.create_event<UpdateRowsEvent>(table_cache.get_table_id(dbname, tb_name), STMT_END_F);
 
   // event body
   event->set_var_header_len(2);
@@ -497,8 +562,8 @@ inline void parallel_convert_update_rows_event(
   int col_bytes = (col_count + 7) / 8;
   event->set_before_image_cols(col_bytes);
   event->set_after_image_cols(col_bytes);
-  auto* before_bitmap = static_cast<unsigned char*>(malloc(col_bytes));
-  auto* after_bitmap = static_cast<unsigned char*>(malloc(col_bytes));
+  auto* before_bitmap = arena.alloc_bytes(col_bytes);
+  auto* after_bitmap = arena.alloc_bytes(col_bytes);
   fill_bitmap(col_count, col_bytes, before_bitmap);
   fill_bitmap(col_count, col_bytes, after_bitmap);
 
@@ -506,7 +571,8 @@ inline void parallel_convert_update_rows_event(
   size_t after_pos = 0;
   unsigned char* partial_cols_bitmap = nullptr;
   size_t partial_cols_bytes = 0;
-  body_size += col_val_bytes(record,
+  const ColumnEncoderPlan& encoder_plan = table_cache.get_encoder_plan(dbname, tb_name, table_meta, schema_signature);
+  body_size += encoder_plan.encode_rows(record,
       table_meta,
       event->get_before_row(),
       event->get_after_row(),
@@ -516,7 +582,8 @@ inline void parallel_convert_update_rows_event(
       before_bitmap,
       after_bitmap,
       partial_cols_bitmap,
-      partial_cols_bytes);
+      partial_cols_bytes,
+      arena);
 
   event->set_before_pos(before_pos);
   event->set_after_pos(after_pos);
@@ -540,7 +607,8 @@ inline void parallel_convert_update_rows_event(
   body_size += get_packed_integer(col_count);
   // set common _header
   uint32_t event_len = COMMON_HEADER_LENGTH + ROWS_HEADER_LEN + VAR_HEADER_LEN + body_size + event->get_checksum_len();
-  auto* common_header = new OblogEventHeader(update_type, CommonUtils::get_timestamp_sec(record), event_len, 0);
+  auto* common_header =
+      arena.create<OblogEventHeader>(update_type, CommonUtils::get_timestamp_sec(record), event_len, 0);
   event->set_header(common_header);
   // set crc32
   event->set_ob_txn(CommonUtils::get_transaction_id(record));
@@ -550,47 +618,59 @@ inline void parallel_convert_update_rows_event(
 }
 
 inline void parallel_do_convert(int64_t seq, shared_ptr<Disruptor::disruptor<BinlogEvent>>& disruptor,
-    IObCdcAccess*& obcdc, DdlParser& ddl_parser, TableCache& table_cache)
+    IObCdcAccess*& obcdc, DdlParser& ddl_parser, LocalTableCache& table_cache)
 {
   auto ringBuffer = disruptor->ringBuffer();
   auto binlog_event = (*ringBuffer)[seq];
   const uint64_t record_count = binlog_event.records.size();
+  BatchArenaGuard arena_guard(binlog_event);
+  EventArena& arena = *binlog_event.arena;
   for (ILogRecord* record : binlog_event.records) {
     int type = record->recordType();
+    // the schema of a row record is only walked when its table meta changed
+    uint64_t schema_signature = 0;
+    if (type == EINSERT || type == EDELETE || type == EUPDATE) {
+      schema_signature = table_cache.get_schema_signature(
+          CommonUtils::get_dbname_view_without_tenant(record->dbname(), instance_tenant()),
+          record->tbname(),
+          record->getTableMeta());
+    }
     switch (type) {
       case EBEGIN:
         // GTID_LOG_EVENT -> QUERY_EVENT
         // init GTID
-        parallel_convert_gtid_log_event(record, binlog_event.events, ddl_parser, table_cache);
+        parallel_convert_gtid_log_event(record, binlog_event.events, arena, table_cache);
         break;
       case ECOMMIT:
         // Xid Event
-        parallel_convert_xid_event(record, binlog_event.events);
+        parallel_convert_xid_event(record, binlog_event.events, arena);
         break;
-      case EDDL:
+      case EDDL: {
         // GTID_LOG_EVENT -> QUERY_EVENT
-        if (!parallel_ddl_need_to_be_stored(record, ddl_parser)) {
+        std::string ddl;
+        if (!parallel_ddl_need_to_be_stored(record, ddl_parser, ddl)) {
           break;
         }
-        parallel_convert_gtid_log_event(record, binlog_event.events, ddl_parser, table_cache);
+        parallel_convert_gtid_log_event(record, binlog_event.events, arena, table_cache, std::move(ddl));
         break;
+      }
       case EINSERT:
-        parallel_convert_table_map_event(record, binlog_event.events, table_cache);
-        parallel_convert_write_rows_event(record, binlog_event.events, table_cache);
+        parallel_convert_table_map_event(record, binlog_event.events, arena, table_cache, schema_signature);
+        parallel_convert_write_rows_event(record, binlog_event.events, arena, table_cache, schema_signature);
         break;
       case EDELETE:
-        parallel_convert_table_map_event(record, binlog_event.events, table_cache);
-        parallel_convert_delete_rows_event(record, binlog_event.events, table_cache);
+        parallel_convert_table_map_event(record, binlog_event.events, arena, table_cache, schema_signature);
+        parallel_convert_delete_rows_event(record, binlog_event.events, arena, table_cache, schema_signature);
         break;
       case EUPDATE:
-        parallel_convert_table_map_event(record, binlog_event.events, table_cache);
-        parallel_convert_update_rows_event(record, binlog_event.events, table_cache);
+        parallel_convert_table_map_event(record, binlog_event.events, arena, table_cache, schema_signature);
+        parallel_convert_update_rows_event(record, binlog_event.events, arena, table_cache, schema_signature);
         break;
       case HEARTBEAT:
         // // skip heartbeat
         logproxy::Counter::instance().mark_checkpoint(CommonUtils::get_checkpoint_usec(record));
         logproxy::Counter::instance().mark_timestamp(CommonUtils::get_timestamp_usec(record));
-        parallel_pass_heartbeat_checkpoint(record, binlog_event.events);
+        parallel_pass_heartbeat_checkpoint(record, binlog_event.events, arena);
         break;
       default:
         OMS_ERROR("Unsupported record type: {}", record->recordType());
@@ -600,13 +680,14 @@ inline void parallel_do_convert(int64_t seq, shared_ptr<Disruptor::disruptor<Bin
     }
     obcdc->release(record);
   }
+  arena_guard.seal();
   Counter::instance().count_convert(record_count);
   binlog_event.records.clear();
   (*ringBuffer)[seq] = binlog_event;
   ringBuffer->publish(seq);
 }
 ParallelConvert::ParallelConvert(
-    BinlogConverter& converter, BlockingQueue<ILogRecord*>& rqueue, BlockingQueue<ObLogEvent*>& event_queue)
+    BinlogConverter& converter, RingQueue<ILogRecord*>& rqueue, RingQueue<ObLogEvent*>& event_queue)
     : Thread("BinlogConvert"), _converter(converter), _obcdc(nullptr), _rqueue(rqueue), _event_queue(event_queue)
 {}
 
@@ -623,6 +704,9 @@ int ParallelConvert::init(IObCdcAccess* obcdc)
     OMS_ERROR("binlog_convert_ring_buffer_size must be a power of 2");
     return OMS_FAILED;
   }
+  // keep about one idle arena per ring buffer slot, so a steady stream of batches never hits the allocator
+  EventArenaPool::instance().init(s_meta.binlog_config()->binlog_convert_arena_block_bytes(),
+      s_meta.binlog_config()->binlog_convert_ring_buffer_size());
   _disruptor = std::make_shared<Disruptor::disruptor<BinlogEvent>>(
       create_binlog_event, s_meta.binlog_config()->binlog_convert_ring_buffer_size(), _task_scheduler);
   _binlog_event_handler = std::make_shared<BinlogEventHandler>(_event_queue);
@@ -639,6 +723,7 @@ int ParallelConvert::init(IObCdcAccess* obcdc)
   Counter::instance().register_gauge("NEventQ", [this]() { return _event_queue.size(); });
   Counter::instance().register_gauge("ConvertRingBufferQ",
       [this]() { return _disruptor->bufferSize() - _disruptor->ringBuffer()->getRemainingCapacity(); });
+  Counter::instance().register_gauge("NEventArena", []() { return EventArenaPool::instance().total_size(); });
 
   if (s_config.binlog_ddl_convert.val()) {
     if (this->_ddl_parser.init() != OMS_OK) {
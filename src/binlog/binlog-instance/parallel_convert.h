@@ -5,7 +5,7 @@
 #ifndef PARALLEL_CONVERT_H
 #define PARALLEL_CONVERT_H
 
-#include "blocking_queue.hpp"
+#include "ring_queue.hpp"
 #include "disruptor/Disruptor.h"
 
 #include "thread.h"
@@ -18,6 +18,7 @@
 #include "binlog/ob_log_event.h"
 #include "binlog/binlog_index.h"
 #include "binlog/ddl-parser/ddl_parser.h"
+#include "binlog/event_arena.h"
 #include "table_cache.h"
 
 #include <RoundRobinThreadAffinedTaskScheduler.h>
@@ -30,6 +31,9 @@ struct BinlogEvent {
 
   // converted data
   std::vector<ObLogEvent*> events;
+
+  // converted events and their buffers of this batch are allocated from here
+  EventArena* arena = nullptr;
 };
 
 inline BinlogEvent create_binlog_event()
@@ -40,9 +44,9 @@ struct BinlogEventHandler final : Disruptor::IEventHandler<BinlogEvent> {
   void onEvent(BinlogEvent& data, std::int64_t sequence, bool endOfBatch) override;
 
 public:
-  explicit BinlogEventHandler(BlockingQueue<ObLogEvent*>& queue) : queue(queue)
+  explicit BinlogEventHandler(RingQueue<ObLogEvent*>& queue) : queue(queue)
   {}
-  BlockingQueue<ObLogEvent*>& queue;
+  RingQueue<ObLogEvent*>& queue;
 };
 
 struct BinlogEventConvertHandler final : Disruptor::IWorkHandler<BinlogEvent> {
@@ -53,7 +57,8 @@ public:
       : ddl_parser(ddl_parser), table_cache(table_cache), obcdc_access(obcdc_access)
   {}
   DdlParser& ddl_parser;
-  TableCache& table_cache;
+  // every worker of the pool runs on its own thread and reads table ids through its own view of the shared cache
+  LocalTableCache table_cache;
   IObCdcAccess*& obcdc_access;
 };
 
@@ -73,34 +78,49 @@ public:
   BinlogConverter& converter;
 };
 
-bool parallel_convert_gtid_log_event(ILogRecord* record, std::vector<ObLogEvent*>& events,
-    binlog::DdlParser& ddl_parser, TableCache& table_cache, bool is_ddl = false);
+/*!
+ * @brief GTID_LOG_EVENT and QUERY_EVENT of a BEGIN, or of a DDL already converted by parallel_ddl_need_to_be_stored
+ */
+bool parallel_convert_gtid_log_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, std::string ddl = "");
 
-void parallel_convert_query_event(
-    ILogRecord* record, std::vector<ObLogEvent*>& events, binlog::DdlParser& ddl_parser, TableCache& table_cache);
+void parallel_convert_query_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, std::string ddl);
 
-bool parallel_ddl_need_to_be_stored(ILogRecord* record, binlog::DdlParser& ddl_parser);
+/*!
+ * @brief Convert the DDL of a record once for the downstream
+ * @param ddl the DDL to store, converted unless etransfer failed to
+ * @return false if the DDL is not supported downstream and is to be dropped
+ */
+bool parallel_ddl_need_to_be_stored(ILogRecord* record, binlog::DdlParser& ddl_parser, std::string& ddl);
 
-void parallel_convert_xid_event(ILogRecord* record, std::vector<ObLogEvent*>& events);
+void parallel_convert_xid_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena);
 
-void parallel_convert_table_map_event(ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache);
+/*!
+ * @param schema_signature LocalTableCache::get_schema_signature() of the table meta of the record
+ */
+void parallel_convert_table_map_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature);
 
-void parallel_convert_write_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache);
+void parallel_convert_write_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature);
 
-void parallel_convert_delete_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache);
+void parallel_convert_delete_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature);
 
-void parallel_convert_update_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, TableCache& table_cache);
+void parallel_convert_update_rows_event(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena,
+    LocalTableCache& table_cache, uint64_t schema_signature);
 
-void parallel_pass_heartbeat_checkpoint(ILogRecord* record, std::vector<ObLogEvent*>& events);
+void parallel_pass_heartbeat_checkpoint(ILogRecord* record, std::vector<ObLogEvent*>& events, EventArena& arena);
 
 void parallel_do_convert(int64_t seq, shared_ptr<Disruptor::disruptor<BinlogEvent>>& disruptor, IObCdcAccess*& obcdc,
-    DdlParser& ddl_parser, TableCache& table_cache);
+    DdlParser& ddl_parser, LocalTableCache& table_cache);
 
 class BinlogConverter;
 class ParallelConvert : public Thread {
 public:
   ParallelConvert(
-      BinlogConverter& converter, BlockingQueue<ILogRecord*>& rqueue, BlockingQueue<ObLogEvent*>& event_queue);
+      BinlogConverter& converter, RingQueue<ILogRecord*>& rqueue, RingQueue<ObLogEvent*>& event_queue);
 
   int init(IObCdcAccess* obcdc);
 
@@ -115,8 +135,8 @@ private:
   shared_ptr<Disruptor::RoundRobinThreadAffinedTaskScheduler> _task_scheduler;
   BinlogConverter& _converter;
   IObCdcAccess* _obcdc;
-  BlockingQueue<ILogRecord*>& _rqueue;
-  BlockingQueue<ObLogEvent*>& _event_queue;
+  RingQueue<ILogRecord*>& _rqueue;
+  RingQueue<ObLogEvent*>& _event_queue;
   Timer _stage_timer;
   binlog::DdlParser _ddl_parser;
   TableCache _table_cache;
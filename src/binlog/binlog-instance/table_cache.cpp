@@ -11,36 +11,229 @@
  */
 #include "table_cache.h"
 namespace oceanbase::binlog {
+static inline uint64_t mix_signature(uint64_t signature, uint64_t value)
+{
+  // FNV-1a over 64 bit words
+  return (signature ^ value) * 0x100000001b3ULL;
+}
+
+uint64_t table_schema_signature(ITableMeta* table_meta)
+{
+  int col_count = table_meta->getColCount();
+  uint64_t signature = mix_signature(0xcbf29ce484222325ULL, col_count);
+  for (int i = 0; i < col_count; ++i) {
+    IColMeta* col_meta = table_meta->getCol(i);
+    int type = col_meta->getType();
+    signature = mix_signature(signature, type);
+    signature = mix_signature(signature, col_meta->isNotNull());
+    signature = mix_signature(signature, col_meta->getLength());
+    signature = mix_signature(signature, col_meta->getPrecision());
+    signature = mix_signature(signature, col_meta->getScale());
+    const char* encoding = col_meta->getEncoding();
+    signature = mix_signature(signature, std::hash<std::string_view>{}(encoding != nullptr ? encoding : ""));
+    if (type == OB_TYPE_ENUM || type == OB_TYPE_SET) {
+      StrArray* values = col_meta->getValuesOfEnumSet();
+      signature = mix_signature(signature, values != nullptr ? values->size() : 0);
+    }
+  }
+  return signature;
+}
+
+TableEntry* TableSlots::find(std::size_t hash, std::string_view db_name, std::string_view tb_name)
+{
+  auto it = _slots.find(hash);
+  if (it == _slots.end()) {
+    return nullptr;
+  }
+  for (auto& slot : it->second) {
+    if (slot.name.equals(db_name, tb_name)) {
+      return &slot.entry;
+    }
+  }
+  return nullptr;
+}
+
+TableEntry& TableSlots::insert_or_assign(
+    std::size_t hash, std::string_view db_name, std::string_view tb_name, TableEntry entry)
+{
+  TableEntry* existing = find(hash, db_name, tb_name);
+  if (existing != nullptr) {
+    *existing = std::move(entry);
+    return *existing;
+  }
+  auto& bucket = _slots[hash];
+  bucket.push_back(Slot{TableName{std::string(db_name), std::string(tb_name)}, std::move(entry)});
+  return bucket.back().entry;
+}
+
 uint64_t TableCache::assign_new_table_id()
 {
-  uint64_t table_id = last_table_id++;
-  if (table_id == 0) {
-    table_id = assign_new_table_id();
-    _cache.clear();
+  uint64_t table_id;
+  bool wrapped = false;
+  {
+    std::unique_lock<std::mutex> lock(_id_mutex);
+    table_id = _last_table_id++;
+    if (table_id == 0) {
+      table_id = _last_table_id++;
+      wrapped = true;
+    }
+  }
+
+  if (wrapped) {
+    // table ids are reused from now on, forget every table so that no two of them end up with the same id
+    for (auto& shard : _shards) {
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      shard.tables.clear();
+    }
+    _version.fetch_add(1, std::memory_order_release);
   }
   return table_id;
 }
 
-uint64_t TableCache::get_table_id(const std::string& db_name, const std::string& tb_name)
+uint64_t TableCache::get_table_id(std::string_view db_name, std::string_view tb_name)
 {
-  std::unique_lock<std::mutex> lock(_mutex);
-  TableName table_name = TableName{db_name, tb_name};
-  auto it = _cache.find(table_name);
-  if (it != _cache.end()) {
-    return it->second;
+  std::size_t hash = TableName::hash(db_name, tb_name);
+  Shard& shard = shard_of(hash);
+  {
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    TableEntry* entry = shard.tables.find(hash, db_name, tb_name);
+    if (entry != nullptr) {
+      return entry->table_id;
+    }
   }
+
+  // assigned outside the shard lock, if another worker registers the table meanwhile this id is just skipped
   auto table_id = assign_new_table_id();
-  _cache.insert({{db_name, tb_name}, table_id});
+  std::unique_lock<std::mutex> lock(shard.mutex);
+  TableEntry* entry = shard.tables.find(hash, db_name, tb_name);
+  if (entry != nullptr) {
+    return entry->table_id;
+  }
+  shard.tables.insert_or_assign(hash, db_name, tb_name, TableEntry{table_id, nullptr});
   return table_id;
 }
 
-void TableCache::refresh_table_id(const std::string& db_name, const std::string& tb_name)
+void TableCache::refresh_table_id(std::string_view db_name, std::string_view tb_name)
 {
   if (db_name.empty() || tb_name.empty()) {
     return;
   }
-  std::unique_lock<std::mutex> lock(_mutex);
   auto table_id = assign_new_table_id();
-  _cache.insert_or_assign({db_name, tb_name}, table_id);
+  std::size_t hash = TableName::hash(db_name, tb_name);
+  Shard& shard = shard_of(hash);
+  {
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    shard.tables.insert_or_assign(hash, db_name, tb_name, TableEntry{table_id, nullptr});
+  }
+  // published after the shard is updated, so a worker observing the new version also observes the new table id
+  _version.fetch_add(1, std::memory_order_release);
+}
+
+std::shared_ptr<const TableMapDefinition> TableCache::get_table_map(
+    std::string_view db_name, std::string_view tb_name, uint64_t schema_signature)
+{
+  std::size_t hash = TableName::hash(db_name, tb_name);
+  Shard& shard = shard_of(hash);
+  std::unique_lock<std::mutex> lock(shard.mutex);
+  TableEntry* entry = shard.tables.find(hash, db_name, tb_name);
+  if (entry == nullptr || entry->table_map == nullptr) {
+    return nullptr;
+  }
+  if (entry->table_map->table_id != entry->table_id || entry->table_map->schema_signature != schema_signature) {
+    return nullptr;
+  }
+  return entry->table_map;
+}
+
+void TableCache::put_table_map(
+    std::string_view db_name, std::string_view tb_name, std::shared_ptr<const TableMapDefinition> table_map)
+{
+  std::size_t hash = TableName::hash(db_name, tb_name);
+  Shard& shard = shard_of(hash);
+  std::unique_lock<std::mutex> lock(shard.mutex);
+  TableEntry* entry = shard.tables.find(hash, db_name, tb_name);
+  if (entry == nullptr || entry->table_id != table_map->table_id) {
+    return;
+  }
+  entry->table_map = std::move(table_map);
+}
+
+TableEntry& LocalTableCache::lookup(std::string_view db_name, std::string_view tb_name)
+{
+  // read the version before falling back to the shared cache, a concurrent refresh then invalidates the copied entry
+  uint64_t version = _shared.version();
+  if (version != _version) {
+    _tables.clear();
+    _version = version;
+  }
+
+  std::size_t hash = TableName::hash(db_name, tb_name);
+  TableEntry* entry = _tables.find(hash, db_name, tb_name);
+  if (entry != nullptr) {
+    return *entry;
+  }
+  uint64_t table_id = _shared.get_table_id(db_name, tb_name);
+  return _tables.insert_or_assign(hash, db_name, tb_name, TableEntry{table_id, nullptr});
+}
+
+uint64_t LocalTableCache::get_table_id(std::string_view db_name, std::string_view tb_name)
+{
+  return lookup(db_name, tb_name).table_id;
+}
+
+void LocalTableCache::refresh_table_id(std::string_view db_name, std::string_view tb_name)
+{
+  _shared.refresh_table_id(db_name, tb_name);
+}
+
+uint64_t LocalTableCache::get_schema_signature(
+    std::string_view db_name, std::string_view tb_name, ITableMeta* table_meta)
+{
+  TableEntry& entry = lookup(db_name, tb_name);
+  // obcdc frees table metas and may hand their addresses out again, the entry is the one of this table though
+  int col_count = table_meta->getColCount();
+  if (entry.table_meta != table_meta || entry.col_count != col_count) {
+    entry.schema_signature = table_schema_signature(table_meta);
+    entry.table_meta = table_meta;
+    entry.col_count = col_count;
+  }
+  return entry.schema_signature;
+}
+
+std::shared_ptr<const TableMapDefinition> LocalTableCache::get_table_map(
+    std::string_view db_name, std::string_view tb_name, uint64_t schema_signature)
+{
+  TableEntry& entry = lookup(db_name, tb_name);
+  if (entry.table_map != nullptr && entry.table_map->schema_signature == schema_signature &&
+      entry.table_map->table_id == entry.table_id) {
+    return entry.table_map;
+  }
+
+  auto table_map = _shared.get_table_map(db_name, tb_name, schema_signature);
+  if (table_map == nullptr || table_map->table_id != entry.table_id) {
+    return nullptr;
+  }
+  entry.table_map = table_map;
+  return table_map;
+}
+
+void LocalTableCache::put_table_map(
+    std::string_view db_name, std::string_view tb_name, std::shared_ptr<const TableMapDefinition> table_map)
+{
+  _shared.put_table_map(db_name, tb_name, table_map);
+  TableEntry& entry = lookup(db_name, tb_name);
+  if (entry.table_id == table_map->table_id) {
+    entry.table_map = std::move(table_map);
+  }
+}
+
+const ColumnEncoderPlan& LocalTableCache::get_encoder_plan(
+    std::string_view db_name, std::string_view tb_name, ITableMeta* table_meta, uint64_t schema_signature)
+{
+  TableEntry& entry = lookup(db_name, tb_name);
+  if (entry.encoder_plan == nullptr || !entry.encoder_plan->matches(schema_signature)) {
+    entry.encoder_plan = ColumnEncoderPlan::compile(table_meta, schema_signature);
+  }
+  return *entry.encoder_plan;
 }
 }  // namespace oceanbase::binlog
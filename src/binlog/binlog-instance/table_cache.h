@@ -10,9 +10,26 @@
  * See the Mulan PubL v2 for more details.
  */
 #pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 #include "log.h"
+#include "ob_log_event.h"
+#include "column_encoder.h"
 namespace oceanbase::binlog {
 
+/*!
+ * @brief Signature of the columns of a table schema: their types, nullability, lengths, precisions, scales, charsets
+ * and enum/set sizes, everything its table map and its row encoding depend on. Cached table maps are keyed by it
+ * rather than by the address of the ITableMeta, which obcdc frees and may hand out again for another schema version,
+ * and which stays the same meta across schema changes when DDLs are not converted.
+ */
+uint64_t table_schema_signature(ITableMeta* table_meta);
+
 class TableId {
 private:
   /* In table map event and rows events, table id is 6 bytes.*/
@@ -68,33 +85,165 @@ public:
     return id;
   }
 };
-static TableId last_table_id;
-
 struct TableName {
   std::string db_name;
   std::string tb_name;
 
-  std::size_t operator()(const TableName& table_name) const
+  static std::size_t hash(std::string_view db_name, std::string_view tb_name)
   {
-    std::size_t h1 = std::hash<std::string>{}(table_name.db_name);
-    std::size_t h2 = std::hash<std::string>{}(table_name.tb_name);
+    std::size_t h1 = std::hash<std::string_view>{}(db_name);
+    std::size_t h2 = std::hash<std::string_view>{}(tb_name);
     return h1 ^ (h2 << 1);
   }
-  bool operator==(const TableName& other) const
+  bool equals(std::string_view db, std::string_view tb) const
   {
-    return (db_name == other.db_name) && (tb_name == other.tb_name);
+    return db_name == db && tb_name == tb;
   }
 };
-class TableCache {
+
+struct TableEntry {
+  uint64_t table_id = 0;
+  // table map of the latest schema version seen under table_id
+  std::shared_ptr<const TableMapDefinition> table_map;
+  // encoder plan of the latest schema version, only kept by the per worker view
+  std::shared_ptr<const ColumnEncoderPlan> encoder_plan;
+  // table_schema_signature() of the table meta last seen, with its column count, only kept by the per worker view
+  const ITableMeta* table_meta = nullptr;
+  int col_count = 0;
+  uint64_t schema_signature = 0;
+};
+
+/*!
+ * @brief Tables bucketed by TableName::hash, so that lookups by string_view need no key allocation.
+ */
+class TableSlots {
+public:
+  TableEntry* find(std::size_t hash, std::string_view db_name, std::string_view tb_name);
+
+  TableEntry& insert_or_assign(std::size_t hash, std::string_view db_name, std::string_view tb_name, TableEntry entry);
+
+  void clear()
+  {
+    _slots.clear();
+  }
+
 private:
-  std::unordered_map<TableName, uint64_t, TableName> _cache;
-  std::mutex _mutex;
+  struct Slot {
+    TableName name;
+    TableEntry entry;
+  };
+  std::unordered_map<std::size_t, std::vector<Slot>> _slots;
+};
 
+/*!
+ * @brief Table ids (and cached table maps) shared by all convert workers.
+ *
+ * The map is split into shards with a mutex each, and every structural change (a refreshed table id on DDL, or the
+ * table id space wrapping around) bumps a version, as does any other DDL. Convert workers read through a
+ * LocalTableCache that only falls back to the shards on a miss, so steady-state lookups take no lock at all.
+ */
+class TableCache {
 public:
+  uint64_t get_table_id(std::string_view db_name, std::string_view tb_name);
+
+  /*!
+   * @brief Assign a new table id to the table and drop its cached table map, called on DDL.
+   */
+  void refresh_table_id(std::string_view db_name, std::string_view tb_name);
+
+  /*!
+   * @brief Get the cached table map of the table, or nullptr if there is none for the current table id and the given
+   * schema signature.
+   */
+  std::shared_ptr<const TableMapDefinition> get_table_map(
+      std::string_view db_name, std::string_view tb_name, uint64_t schema_signature);
+
+  /*!
+   * @brief Cache a table map, ignored if the table id was refreshed since the definition was built.
+   */
+  void put_table_map(
+      std::string_view db_name, std::string_view tb_name, std::shared_ptr<const TableMapDefinition> table_map);
+
+  /*!
+   * @brief Drop the schema signatures memoized by the per worker views, called on the DDLs that do not refresh a
+   * table id, as the schema may change under the same table meta then.
+   */
+  void forget_schemas()
+  {
+    _version.fetch_add(1, std::memory_order_release);
+  }
+
+  uint64_t version() const
+  {
+    return _version.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr std::size_t SHARD_COUNT = 16;
+
+  struct Shard {
+    std::mutex mutex;
+    TableSlots tables;
+  };
+
+  Shard& shard_of(std::size_t hash)
+  {
+    return _shards[hash % SHARD_COUNT];
+  }
+
   uint64_t assign_new_table_id();
 
-  uint64_t get_table_id(const std::string& db_name, const std::string& tb_name);
+private:
+  Shard _shards[SHARD_COUNT];
+  std::mutex _id_mutex;
+  TableId _last_table_id;
+  std::atomic<uint64_t> _version{0};
+};
+
+/*!
+ * @brief Per convert worker view of the TableCache, must only be used by one thread at a time.
+ *
+ * Entries copied from the shared cache stay valid as long as its version is unchanged; a version bump drops them all.
+ */
+class LocalTableCache {
+public:
+  explicit LocalTableCache(TableCache& shared) : _shared(shared)
+  {}
+
+  uint64_t get_table_id(std::string_view db_name, std::string_view tb_name);
+
+  void refresh_table_id(std::string_view db_name, std::string_view tb_name);
+
+  void forget_schemas()
+  {
+    _shared.forget_schemas();
+  }
+
+  /*!
+   * @brief Get table_schema_signature() of the table meta, walked again only if the table meta or its column count
+   * changed since the last record of the table, or a DDL was seen since.
+   */
+  uint64_t get_schema_signature(std::string_view db_name, std::string_view tb_name, ITableMeta* table_meta);
 
-  void refresh_table_id(const std::string& db_name, const std::string& tb_name);
+  std::shared_ptr<const TableMapDefinition> get_table_map(
+      std::string_view db_name, std::string_view tb_name, uint64_t schema_signature);
+
+  void put_table_map(
+      std::string_view db_name, std::string_view tb_name, std::shared_ptr<const TableMapDefinition> table_map);
+
+  /*!
+   * @brief Get the encoder plan for the rows of the table, compiled on first use of each schema signature.
+   * @param schema_signature get_schema_signature() of table_meta
+   */
+  const ColumnEncoderPlan& get_encoder_plan(
+      std::string_view db_name, std::string_view tb_name, ITableMeta* table_meta, uint64_t schema_signature);
+
+private:
+  TableEntry& lookup(std::string_view db_name, std::string_view tb_name);
+
+private:
+  TableCache& _shared;
+  TableSlots _tables;
+  uint64_t _version = 0;
 };
 }  // namespace oceanbase::binlog
@@ -1,70 +1,433 @@
-/**
- * Copyright (c) 2024 OceanBase
- * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
- * You can use this software according to the terms and conditions of the Mulan PubL v2.
- * You may obtain a copy of Mulan PubL v2 at:
- *          http://license.coscl.org.cn/MulanPubL-2.0
- * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
- * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
- * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
- * See the Mulan PubL v2 for more details.
- */
-
 #include "binlog_index.h"
 
+#include <algorithm>
+#include <climits>
+#include <fcntl.h>
+#include <fstream>
 #include <iterator>
+#include <linux/futex.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <utility>
 
 #include "env.h"
+#include "checksum.h"
 #include "log.h"
 #include "str.h"
 #include "common_util.h"
 #include "data_type.h"
 #include "guard.hpp"
 #include "file_lock.h"
+#include "codec/byte_decoder.h"
 
 namespace oceanbase::binlog {
 
 namespace fs = std::filesystem;
 using namespace oceanbase::logproxy;
 
+static const char INDEX_MAGIC[8] = {'O', 'B', 'B', 'I', 'N', 'I', 'D', 'X'};
+static constexpr uint32_t INDEX_VERSION = 1;
+// a slot holds two copies of a record, the first slot of the file is the header
+static constexpr size_t INDEX_COPY_SIZE = 1024;
+static constexpr size_t INDEX_SLOT_SIZE = 2 * INDEX_COPY_SIZE;
+// crc32 | sequence | payload length
+static constexpr size_t INDEX_COPY_HEADER_SIZE = 4 + 8 + 4;
+// index | checkpoint | position | gtid of the current and before mapping | length of the 3 strings
+static constexpr size_t INDEX_RECORD_FIXED_SIZE = 5 * 8 + 3 * 2;
+
+static int pread_full(int fd, unsigned char* buf, size_t len, uint64_t offset)
+{
+  size_t done = 0;
+  while (done < len) {
+    ssize_t ret = pread(fd, buf + done, len - done, offset + done);
+    if (ret > 0) {
+      done += ret;
+      continue;
+    }
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
+static int pwrite_full(int fd, const unsigned char* buf, size_t len, uint64_t offset)
+{
+  size_t done = 0;
+  while (done < len) {
+    ssize_t ret = pwrite(fd, buf + done, len - done, offset + done);
+    if (ret > 0) {
+      done += ret;
+      continue;
+    }
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
+static bool encode_index_copy(const BinlogIndexRecord& record, uint64_t seq, unsigned char* copy)
+{
+  const std::string& file_name = record.get_file_name();
+  const std::string& current_txn = record.get_current_mapping().first;
+  const std::string& before_txn = record.get_before_mapping().first;
+  size_t payload_len = INDEX_RECORD_FIXED_SIZE + file_name.size() + current_txn.size() + before_txn.size();
+  if (payload_len > INDEX_COPY_SIZE - INDEX_COPY_HEADER_SIZE) {
+    OMS_ERROR("Binlog index record too large: {}", record.to_string());
+    return false;
+  }
+
+  memset(copy, 0, INDEX_COPY_SIZE);
+  unsigned char* payload = copy + INDEX_COPY_HEADER_SIZE;
+  unsigned char* pos = payload;
+  int8store(pos, record.get_index());
+  int8store(pos + 8, record.get_checkpoint());
+  int8store(pos + 16, record.get_position());
+  int8store(pos + 24, record.get_current_mapping().second);
+  int8store(pos + 32, record.get_before_mapping().second);
+  pos += 40;
+  for (const std::string* str : {&file_name, &current_txn, &before_txn}) {
+    int2store(pos, str->size());
+    pos += 2;
+  }
+  for (const std::string* str : {&file_name, &current_txn, &before_txn}) {
+    memcpy(pos, str->data(), str->size());
+    pos += str->size();
+  }
+
+  int8store(copy + 4, seq);
+  int4store(copy + 12, payload_len);
+  int4store(copy, crc32_of(copy + 4, INDEX_COPY_HEADER_SIZE - 4 + payload_len));
+  return true;
+}
+
+static bool decode_index_copy(unsigned char* copy, BinlogIndexRecord& record, uint64_t& seq)
+{
+  uint32_t payload_len = int4load(copy + 12);
+  if (payload_len < INDEX_RECORD_FIXED_SIZE || payload_len > INDEX_COPY_SIZE - INDEX_COPY_HEADER_SIZE) {
+    return false;
+  }
+  if (int4load(copy) != crc32_of(copy + 4, INDEX_COPY_HEADER_SIZE - 4 + payload_len)) {
+    return false;
+  }
+  seq = int8load(copy + 4);
+
+  unsigned char* pos = copy + INDEX_COPY_HEADER_SIZE;
+  record.set_index(int8load(pos));
+  record.set_checkpoint(int8load(pos + 8));
+  record.set_position(int8load(pos + 16));
+  uint64_t current_gtid = int8load(pos + 24);
+  uint64_t before_gtid = int8load(pos + 32);
+  size_t lengths[3] = {int2load(pos + 40), int2load(pos + 42), int2load(pos + 44)};
+  if (INDEX_RECORD_FIXED_SIZE + lengths[0] + lengths[1] + lengths[2] != payload_len) {
+    return false;
+  }
+  pos += INDEX_RECORD_FIXED_SIZE;
+  std::string strs[3];
+  for (int i = 0; i < 3; ++i) {
+    strs[i].assign(reinterpret_cast<const char*>(pos), lengths[i]);
+    pos += lengths[i];
+  }
+  record.set_file_name(strs[0]);
+  record.set_current_mapping(std::make_pair(strs[1], current_gtid));
+  record.set_before_mapping(std::make_pair(strs[2], before_gtid));
+  return true;
+}
+
+/*!
+ * @brief Decode the latest valid copy of a slot
+ */
+static bool decode_index_slot(unsigned char* slot, BinlogIndexRecord& record, uint64_t& seq)
+{
+  BinlogIndexRecord copies[2];
+  uint64_t seqs[2] = {0, 0};
+  bool valid[2];
+  for (int c = 0; c < 2; ++c) {
+    valid[c] = decode_index_copy(slot + c * INDEX_COPY_SIZE, copies[c], seqs[c]);
+  }
+  if (!valid[0] && !valid[1]) {
+    return false;
+  }
+  int latest = (valid[0] && valid[1]) ? (seqs[0] > seqs[1] ? 0 : 1) : (valid[0] ? 0 : 1);
+  record = std::move(copies[latest]);
+  seq = seqs[latest];
+  return true;
+}
+
+static void encode_index_header(unsigned char* header)
+{
+  memset(header, 0, INDEX_SLOT_SIZE);
+  memcpy(header, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  int4store(header + 8, INDEX_VERSION);
+  int4store(header + 12, INDEX_SLOT_SIZE);
+  int4store(header + 16, crc32_of(header, 16));
+}
+
 BinlogIndexManager::BinlogIndexManager(std::string index_filename) : _index_filename(std::move(index_filename))
 {}
 
-void parse_index_record(FILE* fp, BinlogIndexRecord& record)
+BinlogIndexManager::~BinlogIndexManager()
 {
-  char* line = nullptr;
-  size_t len = 0;
-  getline(&line, &len, fp);
-  record.parse(line);
-  free(line);
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
 }
 
-int BinlogIndexManager::fetch_index_vector(std::vector<BinlogIndexRecord*>& index_records)
+int BinlogIndexManager::load_index(bool create)
 {
-  std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
-  FILE* fp = FsUtil::fopen_binary(_index_filename, "r+");
-  defer(FsUtil::fclose_binary(fp));
-  if (nullptr == fp) {
+  if (_fd >= 0) {
+    return OMS_OK;
+  }
+
+  int fd = open(_index_filename.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+  if (fd < 0) {
     OMS_ERROR("Failed to open index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
     return OMS_FAILED;
   }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    OMS_ERROR("Failed to stat index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+    close(fd);
+    return OMS_FAILED;
+  }
 
-  char* buffer = nullptr;
-  size_t buf_size = 0;
-  while (getline(&buffer, &buf_size, fp) != -1) {
-    auto* record = new BinlogIndexRecord();
-    record->parse(buffer);
-    if (record->get_index() > 0) {
-      index_records.emplace_back(record);
-    } else {
-      delete (record);
+  std::vector<unsigned char> buf(INDEX_SLOT_SIZE);
+  uint64_t file_size = st.st_size;
+  if (file_size == 0) {
+    encode_index_header(buf.data());
+    if (pwrite_full(fd, buf.data(), INDEX_SLOT_SIZE, 0) != OMS_OK) {
+      OMS_ERROR("Failed to init index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+      close(fd);
+      return OMS_FAILED;
     }
-    free(buffer);
-    buffer = nullptr;
+    _fd = fd;
+    _slots.clear();
+    return OMS_OK;
+  }
+
+  if (file_size < sizeof(INDEX_MAGIC) || pread_full(fd, buf.data(), sizeof(INDEX_MAGIC), 0) != OMS_OK ||
+      memcmp(buf.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+    close(fd);
+    return migrate_text_index();
+  }
+  if (file_size < INDEX_SLOT_SIZE || pread_full(fd, buf.data(), INDEX_SLOT_SIZE, 0) != OMS_OK ||
+      int4load(buf.data() + 16) != crc32_of(buf.data(), 16) ||
+      int4load(buf.data() + 8) != INDEX_VERSION || int4load(buf.data() + 12) != INDEX_SLOT_SIZE) {
+    OMS_ERROR("Invalid header of index file: {}", _index_filename);
+    close(fd);
+    return OMS_FAILED;
+  }
+
+  size_t nof_slots = (file_size - INDEX_SLOT_SIZE) / INDEX_SLOT_SIZE;
+  buf.resize(nof_slots * INDEX_SLOT_SIZE);
+  if (pread_full(fd, buf.data(), buf.size(), INDEX_SLOT_SIZE) != OMS_OK) {
+    OMS_ERROR("Failed to read index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+    close(fd);
+    return OMS_FAILED;
+  }
+
+  std::vector<IndexSlot> slots;
+  slots.reserve(nof_slots);
+  for (size_t i = 0; i < nof_slots; ++i) {
+    IndexSlot slot;
+    if (!decode_index_slot(buf.data() + i * INDEX_SLOT_SIZE, slot.record, slot.seq)) {
+      if (i + 1 == nof_slots) {
+        OMS_WARN("Drop the incomplete last record of index file: {}", _index_filename);
+        break;
+      }
+      OMS_ERROR("Corrupted record {} of index file: {}", i, _index_filename);
+      close(fd);
+      return OMS_FAILED;
+    }
+    slots.emplace_back(std::move(slot));
+  }
+
+  // cut off a torn append
+  uint64_t valid_size = (slots.size() + 1) * INDEX_SLOT_SIZE;
+  if (valid_size != file_size && ftruncate(fd, valid_size) != 0) {
+    OMS_ERROR("Failed to truncate index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+    close(fd);
+    return OMS_FAILED;
+  }
+  _fd = fd;
+  _slots = std::move(slots);
+  return OMS_OK;
+}
+
+int BinlogIndexManager::read_index_file(const std::string& index_filename, std::vector<BinlogIndexRecord>& records)
+{
+  records.clear();
+  std::ifstream ifs(index_filename, std::ios::binary);
+  if (!ifs.good()) {
+    OMS_ERROR("Failed to open index file: {}, errno: {}", index_filename, logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+  if (content.size() < sizeof(INDEX_MAGIC) || memcmp(content.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+    std::istringstream lines(content);
+    for (std::string line; std::getline(lines, line);) {
+      BinlogIndexRecord record;
+      record.parse(line);
+      if (record.get_index() > 0) {
+        records.emplace_back(std::move(record));
+      }
+    }
+    return OMS_OK;
+  }
+
+  auto* buf = reinterpret_cast<unsigned char*>(content.data());
+  if (content.size() < INDEX_SLOT_SIZE || int4load(buf + 16) != crc32_of(buf, 16) ||
+      int4load(buf + 8) != INDEX_VERSION || int4load(buf + 12) != INDEX_SLOT_SIZE) {
+    OMS_ERROR("Invalid header of index file: {}", index_filename);
+    return OMS_FAILED;
+  }
+  // the file is left as is, a torn last slot being written right now is skipped only
+  size_t nof_slots = (content.size() - INDEX_SLOT_SIZE) / INDEX_SLOT_SIZE;
+  for (size_t i = 0; i < nof_slots; ++i) {
+    BinlogIndexRecord record;
+    uint64_t seq = 0;
+    if (!decode_index_slot(buf + (i + 1) * INDEX_SLOT_SIZE, record, seq)) {
+      if (i + 1 == nof_slots) {
+        break;
+      }
+      OMS_ERROR("Corrupted record {} of index file: {}", i, index_filename);
+      return OMS_FAILED;
+    }
+    records.emplace_back(std::move(record));
+  }
+  return OMS_OK;
+}
+
+int BinlogIndexManager::write_text_index_file(
+    const std::string& text_filename, const std::vector<BinlogIndexRecord>& records)
+{
+  std::ofstream ofs(text_filename, std::ios::trunc);
+  if (!ofs.good()) {
+    OMS_ERROR("Failed to open file: {}, errno: {}", text_filename, logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  for (const BinlogIndexRecord& record : records) {
+    ofs << record.to_string();
+  }
+  ofs.flush();
+  if (!ofs.good()) {
+    OMS_ERROR("Failed to write file: {}, errno: {}", text_filename, logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
+int BinlogIndexManager::migrate_text_index()
+{
+  std::vector<BinlogIndexRecord> records;
+  {
+    std::ifstream ifs(_index_filename);
+    if (!ifs.good()) {
+      OMS_ERROR("Failed to open index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+      return OMS_FAILED;
+    }
+    for (std::string line; std::getline(ifs, line);) {
+      BinlogIndexRecord record;
+      record.parse(line);
+      if (record.get_index() > 0) {
+        records.emplace_back(std::move(record));
+      }
+    }
+  }
+
+  std::string text_index_file = _index_filename + ".text";
+  std::error_code err;
+  fs::copy(_index_filename, text_index_file, fs::copy_options::overwrite_existing, err);
+  if (err) {
+    OMS_ERROR("Failed to copy file: [{}] to [{}], error: {}", _index_filename, text_index_file, err.message());
+    return OMS_FAILED;
+  }
+  if (write_index_file(records) != OMS_OK) {
+    return OMS_FAILED;
+  }
+  OMS_INFO("Migrated {} records of text index file {} to the slotted format, the text file is kept as {}",
+      records.size(),
+      _index_filename,
+      text_index_file);
+  return OMS_OK;
+}
+
+int BinlogIndexManager::write_index_file(const std::vector<BinlogIndexRecord>& records)
+{
+  std::vector<unsigned char> buf((records.size() + 1) * INDEX_SLOT_SIZE, 0);
+  encode_index_header(buf.data());
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (!encode_index_copy(records[i], 0, buf.data() + (i + 1) * INDEX_SLOT_SIZE)) {
+      return OMS_FAILED;
+    }
+  }
+
+  std::string temp_index_file = _index_filename + ".tmp";
+  int fd = open(temp_index_file.c_str(), O_RDWR | O_CLOEXEC | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    OMS_ERROR("Failed to open file: {}, error: {}", temp_index_file, logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  if (pwrite_full(fd, buf.data(), buf.size(), 0) != OMS_OK || fdatasync(fd) != 0) {
+    OMS_ERROR("Failed to write file: {}, error: {}", temp_index_file, logproxy::system_err(errno));
+    close(fd);
+    return OMS_FAILED;
+  }
+
+  std::error_code err;
+  fs::rename(temp_index_file, _index_filename, err);
+  if (err) {
+    OMS_ERROR("Failed to rename file: {} to {}, error: {}", temp_index_file, _index_filename, err.message());
+    close(fd);
+    return OMS_FAILED;
+  }
+
+  if (_fd >= 0) {
+    close(_fd);
   }
-  if (nullptr != buffer) {
-    free(buffer);
+  _fd = fd;
+  _slots.clear();
+  _slots.reserve(records.size());
+  for (const auto& record : records) {
+    _slots.push_back({record, 0});
+  }
+  return OMS_OK;
+}
+
+int BinlogIndexManager::write_slot(size_t slot, uint64_t seq, const BinlogIndexRecord& record)
+{
+  unsigned char copy[INDEX_COPY_SIZE];
+  if (!encode_index_copy(record, seq, copy)) {
+    return OMS_FAILED;
+  }
+  uint64_t offset = (slot + 1) * INDEX_SLOT_SIZE + (seq % 2) * INDEX_COPY_SIZE;
+  if (pwrite_full(_fd, copy, INDEX_COPY_SIZE, offset) != OMS_OK) {
+    OMS_ERROR("Failed to write record {} of index file: {}, error: {}",
+        slot,
+        _index_filename,
+        logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
+int BinlogIndexManager::fetch_index_vector(std::vector<BinlogIndexRecord*>& index_records)
+{
+  std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
+  if (load_index(false) != OMS_OK) {
+    return OMS_FAILED;
+  }
+
+  index_records.reserve(index_records.size() + _slots.size());
+  for (const auto& slot : _slots) {
+    index_records.emplace_back(new BinlogIndexRecord(slot.record));
   }
   return OMS_OK;
 }
@@ -72,20 +435,26 @@ int BinlogIndexManager::fetch_index_vector(std::vector<BinlogIndexRecord*>& inde
 int BinlogIndexManager::get_index(const std::string& binlog_file, BinlogIndexRecord& record)
 {
   std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
-  // close will be called automatically when ifs is destroyed
-  std::ifstream ifs(_index_filename);
-  if (!ifs.good()) {
-    OMS_ERROR("Failed to open index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+  if (load_index(false) != OMS_OK) {
     return OMS_FAILED;
   }
 
-  for (std::string line; std::getline(ifs, line);) {
-    BinlogIndexRecord index_record;
-    index_record.parse(line);
-    if (index_record.get_index() > 0 &&
-        strcmp(binlog_file.c_str(), binlog::CommonUtils::fill_binlog_file_name(index_record.get_index()).c_str()) ==
-            0) {
-      record = index_record;
+  // records are in the order of binlog file indexes
+  if (binlog_file.size() >= g_file_name_width) {
+    uint64_t file_index = CommonUtils::get_binlog_index(binlog_file);
+    auto iter = std::lower_bound(_slots.begin(), _slots.end(), file_index, [](const IndexSlot& slot, uint64_t index) {
+      return slot.record.get_index() < index;
+    });
+    if (iter != _slots.end() && iter->record.get_index() == file_index &&
+        binlog_file == binlog::CommonUtils::fill_binlog_file_name(file_index)) {
+      record = iter->record;
+      return OMS_OK;
+    }
+  }
+  // file names wider than the configured width
+  for (const auto& slot : _slots) {
+    if (binlog_file == binlog::CommonUtils::fill_binlog_file_name(slot.record.get_index())) {
+      record = slot.record;
       return OMS_OK;
     }
   }
@@ -96,31 +465,27 @@ int BinlogIndexManager::get_index(const std::string& binlog_file, BinlogIndexRec
 int BinlogIndexManager::get_first_index(BinlogIndexRecord& record)
 {
   std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
-  // close will be called automatically when ifs is destroyed
-  std::ifstream ifs(_index_filename);
-  if (!ifs.good()) {
-    OMS_ERROR("Failed to open index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+  if (load_index(false) != OMS_OK) {
     return OMS_FAILED;
   }
 
-  std::string line;
-  std::getline(ifs, line);
-  record.parse(line);
+  if (!_slots.empty()) {
+    record = _slots.front().record;
+  }
   return OMS_OK;
 }
 
 int BinlogIndexManager::get_latest_index(BinlogIndexRecord& record, size_t index)
 {
   std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
-  FILE* fp = FsUtil::fopen_binary(_index_filename, "r+");
-  defer(FsUtil::fclose_binary(fp));
-  if (nullptr == fp) {
-    OMS_ERROR("Failed to open binlog index file: {}, error: {}", _index_filename, logproxy::system_err(errno));
+  if (load_index(false) != OMS_OK) {
+    OMS_ERROR("Failed to open binlog index file: {}", _index_filename);
     return OMS_FAILED;
   }
 
-  FsUtil::seekg_last_line(fp, index);
-  parse_index_record(fp, record);
+  if (!_slots.empty()) {
+    record = _slots.back().record;
+  }
   OMS_DEBUG("get binlog index file: {}, value: {}", record.get_file_name(), record.to_string());
   return OMS_OK;
 }
@@ -128,21 +493,32 @@ int BinlogIndexManager::get_latest_index(BinlogIndexRecord& record, size_t index
 int BinlogIndexManager::add_index(const BinlogIndexRecord& record)
 {
   std::unique_lock<std::recursive_mutex> op_lock(_op_mutex);
-  std::string record_str = record.to_string();
-  int64_t ret = FsUtil::append_file(_index_filename, record_str);
-  if (OMS_FAILED == ret) {
-    OMS_ERROR("Failed to add index: [{}] to index file {}", record_str, _index_filename);
+  if (load_index(true) != OMS_OK) {
+    OMS_ERROR("Failed to add index: [{}] to index file {}", record.to_string(), _index_filename);
     return OMS_FAILED;
   }
 
-  OMS_INFO("Add binlog index file: {}, value: {}", record.get_file_name(), record_str);
+  // the whole slot is written at once, its second copy stays empty until the first update
+  std::vector<unsigned char> slot(INDEX_SLOT_SIZE, 0);
+  if (!encode_index_copy(record, 0, slot.data()) ||
+      pwrite_full(_fd, slot.data(), INDEX_SLOT_SIZE, (_slots.size() + 1) * INDEX_SLOT_SIZE) != OMS_OK) {
+    OMS_ERROR("Failed to add index: [{}] to index file {}, error: {}",
+        record.to_string(),
+        _index_filename,
+        logproxy::system_err(errno));
+    return OMS_FAILED;
+  }
+  _slots.push_back({record, 0});
+
+  OMS_INFO("Add binlog index file: {}, value: {}", record.get_file_name(), record.to_string());
   return OMS_OK;
 }
 
 bool BinlogIndexManager::is_active(const std::string& file)
 {
-  std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
-  return _memory_index_record.get_file_name().empty() || _memory_index_record.get_file_name() == file;
+  uint64_t file_index = 0;
+  uint64_t position = 0;
+  return !_committed.load(file_index, position) || file_index == CommonUtils::get_binlog_index(file);
 }
 
 void BinlogIndexManager::get_memory_index(BinlogIndexRecord& record)
@@ -157,64 +533,56 @@ void BinlogIndexManager::get_memory_index(BinlogIndexRecord& record)
 
 bool BinlogIndexManager::is_behind_current_pos(const std::string& file, uint64_t pos, uint64_t wait_time_us)
 {
-  std::unique_lock<std::recursive_mutex> op_lock(_op_mutex);
-  uint64_t file_index = CommonUtils::get_binlog_index(file);
-  return _new_events.wait_for(op_lock, std::chrono::microseconds(wait_time_us), [&] {
-    return (_memory_index_record.get_index() > file_index) ||
-           (_memory_index_record.get_index() == file_index && _memory_index_record.get_position() > pos);
-  });
+  return _committed.wait_beyond(CommonUtils::get_binlog_index(file), pos, wait_time_us);
 }
 
-int BinlogIndexManager::update_index(const BinlogIndexRecord& record, size_t pos)
+bool BinlogIndexManager::get_committed_position(uint64_t& file_index, uint64_t& position) const
 {
-  std::unique_lock<std::recursive_mutex> op_lock(_op_mutex);
+  return _committed.load(file_index, position);
+}
 
-  // 1. copy original index file to tmp file
-  std::string temp_index_file = _index_filename + ".tmp";
-  std::error_code err;
-  fs::copy(_index_filename, temp_index_file, fs::copy_options::overwrite_existing, err);
-  if (err) {
-    OMS_ERROR("Failed to copy file: [{}] to [{}], error: {}", _index_filename, temp_index_file, err.message());
-    return OMS_FAILED;
-  }
+int BinlogIndexManager::add_commit_listener(int event_fd)
+{
+  return _committed.add_listener(event_fd);
+}
 
-  // 2. truncate last line
-  FILE* fp = FsUtil::fopen_binary(temp_index_file, "r+");
-  defer(FsUtil::fclose_binary(fp));
-  if (nullptr == fp) {
-    OMS_ERROR("Failed to open file: {}, error: {}", temp_index_file, logproxy::system_err(errno));
-    return OMS_FAILED;
-  }
+void BinlogIndexManager::remove_commit_listener(int listener_id)
+{
+  _committed.remove_listener(listener_id);
+}
 
-  FsUtil::seekg_last_line(fp, pos);
-  fs::resize_file(temp_index_file, pos, err);
-  if (err) {
-    OMS_ERROR("Failed to resize file:{} range[{},{}], error: {}", temp_index_file, 0, pos, logproxy::system_err(errno));
+void BinlogIndexManager::arm_commit_listener(int listener_id)
+{
+  _committed.arm_listener(listener_id);
+}
+
+int BinlogIndexManager::update_index(const BinlogIndexRecord& record)
+{
+  std::unique_lock<std::recursive_mutex> op_lock(_op_mutex);
+  if (load_index(true) != OMS_OK) {
     return OMS_FAILED;
   }
+  if (_slots.empty()) {
+    return add_index(record);
+  }
 
-  // 3. rewrite last line
-  std::string str = record.to_string();
-  FsUtil::rewrite(fp, (unsigned char*)str.c_str(), pos, str.size());
-  fs::rename(temp_index_file, _index_filename, err);
-  if (err) {
-    OMS_ERROR(
-        "Failed to rename file: {} to {}, error: {}", temp_index_file, temp_index_file, logproxy::system_err(errno));
+  // overwrite the older copy of the last record in place
+  IndexSlot& slot = _slots.back();
+  if (write_slot(_slots.size() - 1, slot.seq + 1, record) != OMS_OK) {
     return OMS_FAILED;
   }
+  slot.record = record;
+  slot.seq++;
 
   _memory_index_record = record;
-  _new_events.notify_all();
+  _committed.publish(record.get_index(), record.get_position());
   return OMS_OK;
 }
 
 int BinlogIndexManager::remove_binlog(const BinlogIndexRecord& index_record)
 {
   std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
-  // close will be called automatically when ifs is destroyed
-  std::ifstream ifs(_index_filename);
-  if (!ifs.good()) {
-    OMS_ERROR("Failed to open index file: {}, errno: {}", _index_filename, logproxy::system_err(errno));
+  if (load_index(false) != OMS_OK) {
     return OMS_FAILED;
   }
 
@@ -222,14 +590,11 @@ int BinlogIndexManager::remove_binlog(const BinlogIndexRecord& index_record)
   bool is_found = false;
   std::vector<BinlogIndexRecord*> index_records;
   defer(release_vector(index_records));
-  for (std::string line; std::getline(ifs, line);) {
-    auto* record = new BinlogIndexRecord();
-    record->parse(line);
-    if (!record->equal_to(index_record)) {
-      index_records.emplace_back(record);
+  for (const auto& slot : _slots) {
+    if (!slot.record.equal_to(index_record)) {
+      index_records.emplace_back(new BinlogIndexRecord(slot.record));
     } else {
       is_found = true;
-      delete record;
     }
   }
 
@@ -375,25 +740,14 @@ int BinlogIndexManager::purge_binlog_to_file(const std::string& to_binlog_index,
 int BinlogIndexManager::rewrite_index_file(std::string& error_msg, std::vector<BinlogIndexRecord*>& index_records)
 {
   std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
-  std::vector<BinlogIndexRecord*>::iterator it;
-  std::string temp_index_filename = _index_filename + ".remove";
-  std::stringstream records;
-  for (it = index_records.begin(); it != index_records.end(); ++it) {
-    records << (*it)->to_string();
+  std::vector<BinlogIndexRecord> records;
+  records.reserve(index_records.size());
+  for (auto* record : index_records) {
+    records.push_back(*record);
   }
 
-  int ret = FsUtil::write_file(temp_index_filename, records.str());
-  if (OMS_OK != ret) {
-    error_msg = "Failed to write file: " + temp_index_filename;
-    OMS_ERROR(error_msg);
-    return OMS_FAILED;
-  }
-
-  std::error_code err;
-  fs::rename(temp_index_filename, _index_filename, err);
-  if (err) {
-    error_msg = "Failed to rename file " + temp_index_filename + " to " + _index_filename +
-                ", error: " + logproxy::system_err(errno);
+  if (OMS_OK != write_index_file(records)) {
+    error_msg = "Failed to rewrite index file " + _index_filename;
     OMS_ERROR(error_msg);
     return OMS_FAILED;
   }
@@ -424,17 +778,140 @@ int BinlogIndexManager::backup_binlog(const BinlogIndexRecord& index_record)
     return OMS_FAILED;
   }
 
+  // backed up in the text format, readable by the scripts and by the earlier versions restoring it
   std::string backup_index = path + s_meta.instance_name() + "_" + "index" + "_" + ts;
   OMS_INFO("Begin to backup index [{}] to [{}]", _index_filename, backup_index);
-  fs::copy(_index_filename, backup_index, err);
-  if (err) {
-    OMS_ERROR("Failed to copy index file from [{}] to [{}], error: {}", _index_filename, backup_index, err.message());
+  std::vector<BinlogIndexRecord> records;
+  {
+    std::lock_guard<std::recursive_mutex> op_lock(_op_mutex);
+    if (load_index(false) != OMS_OK) {
+      return OMS_FAILED;
+    }
+    records.reserve(_slots.size());
+    for (const IndexSlot& slot : _slots) {
+      records.push_back(slot.record);
+    }
+  }
+  if (write_text_index_file(backup_index, records) != OMS_OK) {
+    OMS_ERROR("Failed to backup index file from [{}] to [{}]", _index_filename, backup_index);
     return OMS_FAILED;
   }
 
   return OMS_OK;
 }
 
+// <------------  CommittedPosition   ------------->
+void CommittedPosition::publish(uint64_t file_index, uint64_t position)
+{
+  _seq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  _file_index.store(file_index, std::memory_order_relaxed);
+  _position.store(position, std::memory_order_relaxed);
+  // pairs with the increment of _waiters in wait_beyond(), one of both sides sees the other
+  _seq.fetch_add(1, std::memory_order_seq_cst);
+  if (_waiters.load(std::memory_order_seq_cst) > 0) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&_seq), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+  }
+  if (_nof_listeners.load(std::memory_order_relaxed) > 0) {
+    signal_listeners();
+  }
+}
+
+void CommittedPosition::signal_listeners()
+{
+  int nof_listeners = _nof_listeners.load(std::memory_order_acquire);
+  for (int i = 0; i < nof_listeners; ++i) {
+    Listener& listener = _listeners[i];
+    // pairs with the store in arm_listener(), either the listener loads the new position or it is signaled
+    if (!listener.armed.load(std::memory_order_seq_cst) || !listener.armed.exchange(false, std::memory_order_seq_cst)) {
+      continue;
+    }
+    int event_fd = listener.event_fd.load(std::memory_order_relaxed);
+    if (event_fd >= 0) {
+      uint64_t one = 1;
+      ssize_t ret = ::write(event_fd, &one, sizeof(one));
+      (void)ret;
+    }
+  }
+}
+
+int CommittedPosition::add_listener(int event_fd)
+{
+  // listeners are registered by the few event loops on startup, slots are never reused
+  int listener_id = _nof_listeners.load(std::memory_order_relaxed);
+  while (listener_id < MAX_LISTENERS) {
+    if (_nof_listeners.compare_exchange_weak(listener_id, listener_id + 1, std::memory_order_acq_rel)) {
+      _listeners[listener_id].event_fd.store(event_fd, std::memory_order_release);
+      return listener_id;
+    }
+  }
+  return -1;
+}
+
+void CommittedPosition::remove_listener(int listener_id)
+{
+  if (listener_id < 0 || listener_id >= MAX_LISTENERS) {
+    return;
+  }
+  _listeners[listener_id].armed.store(false, std::memory_order_relaxed);
+  _listeners[listener_id].event_fd.store(-1, std::memory_order_release);
+}
+
+void CommittedPosition::arm_listener(int listener_id)
+{
+  _listeners[listener_id].armed.store(true, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+bool CommittedPosition::load(uint64_t& file_index, uint64_t& position, uint32_t& seq) const
+{
+  while (true) {
+    seq = _seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      continue;
+    }
+    file_index = _file_index.load(std::memory_order_relaxed);
+    position = _position.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_seq.load(std::memory_order_relaxed) == seq) {
+      return seq != 0;
+    }
+  }
+}
+
+bool CommittedPosition::load(uint64_t& file_index, uint64_t& position) const
+{
+  uint32_t seq = 0;
+  return load(file_index, position, seq);
+}
+
+bool CommittedPosition::wait_beyond(uint64_t file_index, uint64_t position, uint64_t timeout_us)
+{
+  uint64_t deadline_us = Timer::now() + timeout_us;
+  while (true) {
+    uint64_t committed_index = 0;
+    uint64_t committed_position = 0;
+    uint32_t seq = 0;
+    load(committed_index, committed_position, seq);
+    if (committed_index > file_index || (committed_index == file_index && committed_position > position)) {
+      return true;
+    }
+
+    uint64_t now_us = Timer::now();
+    if (now_us >= deadline_us) {
+      return false;
+    }
+    uint64_t remaining_us = deadline_us - now_us;
+    struct timespec timeout {
+      static_cast<time_t>(remaining_us / 1000000), static_cast<long>(remaining_us % 1000000 * 1000)
+    };
+    // sleeps only if nothing has been published since the load above
+    _waiters.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&_seq), FUTEX_WAIT_PRIVATE, seq, &timeout, nullptr, 0);
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
 // <------------  BinlogIndexRecord   ------------->
 BinlogIndexRecord::BinlogIndexRecord(std::string file_name, int index) : _file_name(std::move(file_name)), _index(index)
 {}
@@ -544,7 +1021,7 @@ std::pair<std::string, int64_t> BinlogIndexRecord::parse_mapping_str(const std::
   return mapping_pair;
 }
 
-bool BinlogIndexRecord::equal_to(const BinlogIndexRecord& index_record)
+bool BinlogIndexRecord::equal_to(const BinlogIndexRecord& index_record) const
 {
   return strcmp(_file_name.c_str(), index_record.get_file_name().c_str()) == 0 && _index == index_record.get_index();
 }
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <filesystem>
@@ -56,7 +57,7 @@ public:
 
   void parse(const std::string& content);
 
-  bool equal_to(const BinlogIndexRecord& index_record);
+  bool equal_to(const BinlogIndexRecord& index_record) const;
 
 private:
   static std::string get_mapping_str(const std::pair<std::string, int64_t>& mapping);
@@ -73,11 +74,85 @@ private:
   uint64_t _position = 0;
 };
 
+/*!
+ * @brief The latest committed binlog position (file index, position), readable without locks.
+ *
+ * The pair is published under a sequence lock by the single storage writer. The sequence number doubles as a futex
+ * word: dumpers that have caught up sleep on it and every publish wakes them, but only issues the wake syscall when
+ * someone actually waits. Event loops cannot sleep on a futex, they register an eventfd as listener instead and arm it
+ * before they go idle; the next publish signals each armed listener once.
+ */
+class CommittedPosition {
+public:
+  static constexpr int MAX_LISTENERS = 64;
+
+  void publish(uint64_t file_index, uint64_t position);
+
+  /*!
+   * @return false if nothing has been committed yet
+   */
+  bool load(uint64_t& file_index, uint64_t& position) const;
+
+  /*!
+   * @brief Wait until the committed position is beyond (file_index, position)
+   * @return false on timeout
+   */
+  bool wait_beyond(uint64_t file_index, uint64_t position, uint64_t timeout_us);
+
+  /*!
+   * @brief Register an eventfd to be signaled by publish() while armed
+   * @return the listener id, -1 if all listener slots are taken
+   */
+  int add_listener(int event_fd);
+
+  void remove_listener(int listener_id);
+
+  /*!
+   * @brief Request a signal on the next publish. Load the position after arming, so that a publish in between is
+   * either seen by the load or signaled.
+   */
+  void arm_listener(int listener_id);
+
+private:
+  bool load(uint64_t& file_index, uint64_t& position, uint32_t& seq) const;
+
+  void signal_listeners();
+
+private:
+  struct Listener {
+    std::atomic<int> event_fd{-1};
+    std::atomic<bool> armed{false};
+  };
+
+private:
+  // odd while the writer is publishing
+  std::atomic<uint32_t> _seq{0};
+  std::atomic<uint64_t> _file_index{0};
+  std::atomic<uint64_t> _position{0};
+  std::atomic<uint32_t> _waiters{0};
+  Listener _listeners[MAX_LISTENERS];
+  std::atomic<int> _nof_listeners{0};
+};
+
+/*!
+ * @brief Manager of the binlog index file.
+ *
+ * The index file is a sequence of fixed-size slots, one per binlog file, behind a header slot. Every slot holds two
+ * copies of the record, each with its own sequence number and crc32. An update writes the copy holding the older
+ * sequence in place, so a torn write can only damage that copy and the previous version of the record is used
+ * instead. A torn append leaves an invalid last slot, which is dropped on load. Removing records rewrites the whole
+ * file to a temporary file that is renamed over the index.
+ *
+ * All the records are also kept in memory in file order, which is the order of binlog file indexes. The text format of
+ * earlier versions is migrated on first access, the text file is kept next to the index with the suffix ".text".
+ * `logproxy --dump_binlog_index <file>` prints an index file of either format as text, for the scripts and for
+ * downgrades, and backups of the index are written as text.
+ */
 class BinlogIndexManager {
 public:
   explicit BinlogIndexManager(std::string index_filename);
 
-  ~BinlogIndexManager() = default;
+  ~BinlogIndexManager();
 
   int fetch_index_vector(std::vector<BinlogIndexRecord*>& index_records);
 
@@ -92,21 +167,70 @@ public:
   int purge_binlog_index(const std::string& base_name, const std::string& binlog_file,
       const std::string& before_purge_ts, std::string& error_msg, std::vector<std::string>& purge_binlog_files);
 
-  int update_index(const BinlogIndexRecord& record, size_t pos = 2);
+  int update_index(const BinlogIndexRecord& record);
 
   int remove_binlog(const BinlogIndexRecord& index_record);
 
+  /*!
+   * @brief Whether the file is the one being written, lock-free
+   */
   bool is_active(const std::string& file);
 
   void get_memory_index(BinlogIndexRecord& record);
 
+  /*!
+   * @brief Wait up to wait_time_us for data committed beyond (file, pos), lock-free
+   */
   bool is_behind_current_pos(const std::string& file, uint64_t pos, uint64_t wait_time_us);
 
+  /*!
+   * @brief The latest position published by update_index(), lock-free
+   * @return false if nothing has been published yet
+   */
+  bool get_committed_position(uint64_t& file_index, uint64_t& position) const;
+
+  /*!
+   * @brief See CommittedPosition::add_listener()
+   */
+  int add_commit_listener(int event_fd);
+
+  void remove_commit_listener(int listener_id);
+
+  void arm_commit_listener(int listener_id);
+
   int rewrite_index_file(std::string& error_msg, std::vector<BinlogIndexRecord*>& index_records);
 
   int backup_binlog(const BinlogIndexRecord& index_record);
 
+  /*!
+   * @brief Read the records of an index file of either format without modifying it, it may be in use by an instance
+   */
+  static int read_index_file(const std::string& index_filename, std::vector<BinlogIndexRecord>& records);
+
+  /*!
+   * @brief Write the records in the text format, one tab separated line per binlog file
+   */
+  static int write_text_index_file(const std::string& text_filename, const std::vector<BinlogIndexRecord>& records);
+
 private:
+  /*!
+   * @brief Open the index file and load the records, once
+   * @param create create an empty index file if it does not exist
+   */
+  int load_index(bool create);
+
+  int migrate_text_index();
+
+  /*!
+   * @brief Write a complete index file with the records and rename it to the index file
+   */
+  int write_index_file(const std::vector<BinlogIndexRecord>& records);
+
+  /*!
+   * @brief Write the copy of the slot selected by seq
+   */
+  int write_slot(size_t slot, uint64_t seq, const BinlogIndexRecord& record);
+
   int purge_binlog_before_ts(const std::string& before_purge_ts, std::vector<BinlogIndexRecord*>& index_records,
       std::string& error_msg, std::vector<std::string>& purge_binlog_files, uint64_t& last_gtid_seq);
 
@@ -118,12 +242,21 @@ private:
   // support for reentrant lock
   std::recursive_mutex _op_mutex;
 
-  // notify_all when add_index and update index
-  std::condition_variable_any _new_events;
-
   std::string _index_filename;
 
   // update when call update_index()
   BinlogIndexRecord _memory_index_record;
+
+  // published when call update_index(), for dumpers waiting for new events
+  CommittedPosition _committed;
+
+  struct IndexSlot {
+    BinlogIndexRecord record;
+    // sequence number of the latest copy
+    uint64_t seq;
+  };
+
+  int _fd = -1;
+  std::vector<IndexSlot> _slots;
 };
 }  // namespace oceanbase::binlog
@@ -85,6 +85,18 @@ IoResult QueryCmdProcessor::process(Connection* conn, PacketBuf& payload)
   return conn->send_ok_packet();
 }
 
+/*!
+ * @brief Run the dumper on the shared dump scheduler if enabled, otherwise on a thread of its own
+ */
+static void start_dumper(BinlogDumper* dumper)
+{
+  if (g_dump_scheduler != nullptr) {
+    g_dump_scheduler->submit(dumper);
+    return;
+  }
+  dumper->start();
+}
+
 IoResult BinlogDumpCmdProcessor::process(Connection* conn, PacketBuf& payload)
 {
   uint32_t binlog_pos = 0;
@@ -122,7 +134,7 @@ IoResult BinlogDumpCmdProcessor::process(Connection* conn, PacketBuf& payload)
   }
   bd->set_heartbeat_interval_us(heartbeat_period);
   conn->set_server_command(cmd_);
-  bd->start();
+  start_dumper(bd);
 
   return IoResult::BINLOG_DUMP;
 }
@@ -214,7 +226,7 @@ IoResult BinlogDumpGtidCmdProcessor::process(Connection* conn, PacketBuf& payloa
   bd->set_heartbeat_interval_us(heartbeat_period);
   conn->set_server_command(cmd_);
 
-  bd->start();
+  start_dumper(bd);
 
   return IoResult::BINLOG_DUMP;
 }
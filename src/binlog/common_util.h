@@ -13,6 +13,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <iomanip>
 #include <random>
 
@@ -161,6 +162,20 @@ public:
     }
   }
 
+  /*
+   * @description same as get_dbname_without_tenant, but returns a view into full_dbname instead of a copy
+   */
+  static std::string_view get_dbname_view_without_tenant(std::string_view full_dbname, std::string_view tenant_name)
+  {
+    if (full_dbname.empty() || tenant_name.empty()) {
+      return full_dbname;
+    }
+    if (full_dbname.size() > tenant_name.size() && full_dbname.compare(0, tenant_name.size(), tenant_name) == 0) {
+      return full_dbname.substr(tenant_name.size() + 1);
+    }
+    return full_dbname;
+  }
+
   static uint64_t get_timestamp_sec(ILogRecord* record)
   {
     return record->getTimestamp();
@@ -12,6 +12,7 @@
 
 #include "connection.h"
 
+#include <cstring>
 #include <utility>
 #include "connection_manager.h"
 
@@ -66,6 +67,7 @@ Connection::Connection(int sock_fd, std::string local_ip, std::string peer_ip, u
       ev_(nullptr),
       pkt_buf_(sys_var.net_buffer_length, sys_var.max_allowed_packet),
       seq_no_(0),
+      _output_buf_limit(logproxy::Config::instance().binlog_dump_output_buffer_bytes.val()),
       net_buffer_length_(sys_var.net_buffer_length),
       max_allowed_packet_(sys_var.max_allowed_packet),
       net_read_timeout_(sys_var.net_read_timeout),
@@ -183,15 +185,90 @@ IoResult Connection::send_data_packet()
 
 IoResult Connection::send_mysql_packet(const uint8_t* payload, uint32_t payload_length)
 {
-  assert(payload_length <= mysql_pkt_max_length);
-  uint8_t header[mysql_pkt_header_length];
+  return write_mysql_packet(payload, payload_length, true);
+}
+
+IoResult Connection::write_mysql_packet(const uint8_t* payload, uint32_t payload_length, bool flush, bool ok_marker)
+{
+  // with ok_marker, the payload is preceded by the 0x00 OK byte of the binlog network stream
+  uint32_t header_length = ok_marker ? mysql_pkt_header_length + 1 : mysql_pkt_header_length;
+  assert(payload_length + header_length - mysql_pkt_header_length <= mysql_pkt_max_length);
+  uint8_t header[mysql_pkt_header_length + 1];
   uint32_t write_index = 0;
-  write_htole24(header, write_index, payload_length);
+  write_htole24(header, write_index, payload_length + header_length - mysql_pkt_header_length);
   write_htole8(header, write_index, seq_no_++);
   assert(write_index == mysql_pkt_header_length);
-  if (logproxy::writen(sock_fd_, header, mysql_pkt_header_length) < 0 ||
-      logproxy::writen(sock_fd_, payload, static_cast<int>(payload_length)) < 0) {
-    return IoResult::FAIL;
+  header[mysql_pkt_header_length] = 0x00;
+
+  if (_output_deferred || (!flush && _output_buf.size() + header_length + payload_length <= _output_buf_limit)) {
+    _output_buf.insert(_output_buf.end(), header, header + header_length);
+    _output_buf.insert(_output_buf.end(), payload, payload + payload_length);
+    return IoResult::SUCCESS;
+  }
+
+  // the pending packets and this one go out in a single writev, without copying the payload
+  struct iovec iov[3];
+  int iovcnt = 0;
+  if (!_output_buf.empty()) {
+    iov[iovcnt++] = {_output_buf.data(), _output_buf.size()};
+  }
+  iov[iovcnt++] = {header, header_length};
+  iov[iovcnt++] = {const_cast<uint8_t*>(payload), payload_length};
+  int ret = logproxy::writevn(sock_fd_, iov, iovcnt);
+  _output_buf.clear();
+  return ret < 0 ? IoResult::FAIL : IoResult::SUCCESS;
+}
+
+IoResult Connection::set_output_batching(bool enable)
+{
+  _output_batching = enable;
+  return enable ? IoResult::SUCCESS : flush_output();
+}
+
+IoResult Connection::flush_output()
+{
+  if (_output_buf.empty() || _output_deferred) {
+    return IoResult::SUCCESS;
+  }
+  int ret = logproxy::writen(sock_fd_, _output_buf.data(), static_cast<int>(_output_buf.size()));
+  _output_buf.clear();
+  return ret < 0 ? IoResult::FAIL : IoResult::SUCCESS;
+}
+
+int Connection::set_output_deferred()
+{
+  if (logproxy::set_non_block(sock_fd_) != OMS_OK) {
+    return OMS_FAILED;
+  }
+  _output_deferred = true;
+  return OMS_OK;
+}
+
+IoResult Connection::write_pending_output(bool& drained)
+{
+  while (_output_sent < _output_buf.size()) {
+    ssize_t ret = ::write(sock_fd_, _output_buf.data() + _output_sent, _output_buf.size() - _output_sent);
+    if (ret >= 0) {
+      _output_sent += ret;
+      continue;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      return IoResult::FAIL;
+    }
+    break;
+  }
+
+  drained = _output_sent == _output_buf.size();
+  if (drained) {
+    _output_buf.clear();
+    _output_sent = 0;
+  } else if (_output_sent >= _output_buf_limit) {
+    // the socket is backed up, drop what has been written so that the buffer does not keep growing
+    _output_buf.erase(_output_buf.begin(), _output_buf.begin() + static_cast<ssize_t>(_output_sent));
+    _output_sent = 0;
   }
   return IoResult::SUCCESS;
 }
@@ -371,13 +448,66 @@ IoResult Connection::send_err_packet(uint16_t err_code, std::string err_msg, con
 IoResult Connection::send_binlog_event(const uint8_t* event_buf, uint32_t len)
 {
   while (len >= mysql_pkt_max_length) {
-    if (send_mysql_packet(event_buf, mysql_pkt_max_length) != IoResult::SUCCESS) {
+    if (write_mysql_packet(event_buf, mysql_pkt_max_length, !_output_batching) != IoResult::SUCCESS) {
       return IoResult::FAIL;
     }
     event_buf += mysql_pkt_max_length;
     len -= mysql_pkt_max_length;
   }
-  return send_mysql_packet(event_buf, len);
+  return write_mysql_packet(event_buf, len, !_output_batching);
+}
+
+IoResult Connection::send_binlog_event_slice(const uint8_t* event, uint32_t len)
+{
+  if (len + 1 >= mysql_pkt_max_length) {
+    // split over several packets, rare enough to go through a copy with the OK byte in front
+    std::vector<uint8_t> event_buf(len + 1);
+    event_buf[0] = 0x00;
+    memcpy(event_buf.data() + 1, event, len);
+    return send_binlog_event(event_buf.data(), event_buf.size());
+  }
+  return write_mysql_packet(event, len, !_output_batching, true);
+}
+
+IoResult Connection::send_binlog_event_file(int fd, uint64_t offset, uint32_t len)
+{
+  // sendfile would block the event loop that owns a deferred socket
+  assert(!_output_deferred);
+  // the OK byte counts towards the first packet, an event of max length or more is split like send_binlog_event does
+  uint64_t remaining = len + 1ULL;
+  bool ok_marker = true;
+  while (true) {
+    uint32_t payload_length = remaining >= mysql_pkt_max_length ? mysql_pkt_max_length : remaining;
+    uint32_t header_length = ok_marker ? mysql_pkt_header_length + 1 : mysql_pkt_header_length;
+    uint8_t header[mysql_pkt_header_length + 1];
+    uint32_t write_index = 0;
+    write_htole24(header, write_index, payload_length);
+    write_htole8(header, write_index, seq_no_++);
+    header[mysql_pkt_header_length] = 0x00;
+
+    struct iovec iov[2];
+    int iovcnt = 0;
+    if (!_output_buf.empty()) {
+      iov[iovcnt++] = {_output_buf.data(), _output_buf.size()};
+    }
+    iov[iovcnt++] = {header, header_length};
+    int ret = logproxy::writevn(sock_fd_, iov, iovcnt);
+    _output_buf.clear();
+    if (ret < 0) {
+      return IoResult::FAIL;
+    }
+
+    uint32_t file_bytes = payload_length - (header_length - mysql_pkt_header_length);
+    if (logproxy::sendfilen(sock_fd_, fd, offset, file_bytes) != OMS_OK) {
+      return IoResult::FAIL;
+    }
+    offset += file_bytes;
+    remaining -= payload_length;
+    ok_marker = false;
+    if (payload_length < mysql_pkt_max_length) {
+      return IoResult::SUCCESS;
+    }
+  }
 }
 
 std::string Connection::get_full_binlog_path() const
@@ -429,6 +559,12 @@ void Connection::set_session_var(const std::string& var_name, std::string var_va
   _session_vars[var_name] = std::move(var_value);
 }
 
+std::string Connection::get_connect_attr(const std::string& key) const
+{
+  auto iter = _connect_attrs.find(key);
+  return iter == _connect_attrs.end() ? "" : iter->second;
+}
+
 std::map<std::string, std::string>& Connection::get_session_var()
 {
   return _session_vars;
@@ -176,6 +176,11 @@ public:
 
   void set_session_var(const std::string& var_name, std::string var_value);
 
+  /*!
+   * @brief The connect attribute sent by the client in the handshake, such as _client_version, empty if not sent
+   */
+  std::string get_connect_attr(const std::string& key) const;
+
   const std::string& get_ob_user() const
   {
     return ob_user_;
@@ -280,6 +285,18 @@ public:
 
   IoResult send_binlog_event(const uint8_t* event_buf, uint32_t len);
 
+  /*!
+   * @brief Send an event exactly as it is stored in the binlog file, i.e. without the leading OK byte that
+   * send_binlog_event expects in event_buf. The OK byte is framed on the fly, so the event is not copied.
+   */
+  IoResult send_binlog_event_slice(const uint8_t* event, uint32_t len);
+
+  /*!
+   * @brief Send the event stored at [offset, offset + len) of the binlog file fd with sendfile. Only the packet
+   * header and the OK byte pass through user space, pending batched packets are flushed first.
+   */
+  IoResult send_binlog_event_file(int fd, uint64_t offset, uint32_t len);
+
   std::string get_full_binlog_path() const;
 
   void start_row()
@@ -316,6 +333,44 @@ public:
 
   IoResult send_mysql_packet(const uint8_t* payload, uint32_t payload_length);
 
+  /*!
+   * @brief While output batching is enabled, binlog events are buffered and written out together once
+   * binlog_dump_output_buffer_bytes is reached. Any other packet writes out the pending ones first, and so does
+   * disabling it.
+   */
+  IoResult set_output_batching(bool enable);
+
+  /*!
+   * @brief Write out the buffered binlog events, e.g. before waiting for new ones.
+   */
+  IoResult flush_output();
+
+  /*!
+   * @brief Hand the socket over to an event loop: it is switched to non-blocking mode and every packet is appended to
+   * the output buffer, which only write_pending_output() writes out.
+   */
+  int set_output_deferred();
+
+  bool output_deferred() const
+  {
+    return _output_deferred;
+  }
+
+  /*!
+   * @brief Whether the deferred output has reached binlog_dump_output_buffer_bytes, no more events should be produced
+   * until it has been written out.
+   */
+  bool output_full() const
+  {
+    return _output_deferred && _output_buf.size() - _output_sent >= _output_buf_limit;
+  }
+
+  /*!
+   * @brief Write as much of the deferred output as the socket accepts without blocking
+   * @param drained set if nothing is left to write
+   */
+  IoResult write_pending_output(bool& drained);
+
 private:
   IoResult read_data_packet();
 
@@ -323,6 +378,8 @@ private:
 
   IoResult read_mysql_packet(uint32_t& payload_length);
 
+  IoResult write_mysql_packet(const uint8_t* payload, uint32_t payload_length, bool flush, bool ok_marker = false);
+
   std::string connect_attrs_str() const
   {
     std::string attr_str;
@@ -370,6 +427,13 @@ private:
   PacketBuf pkt_buf_;
   uint8_t seq_no_;
 
+  bool _output_batching = false;
+  bool _output_deferred = false;
+  uint32_t _output_buf_limit;
+  std::vector<uint8_t> _output_buf;
+  // bytes at the front of _output_buf already written out, only with deferred output
+  size_t _output_sent = 0;
+
   std::string _trace_id;
 
   ServerCommand _server_command = ServerCommand::init;
@@ -17,6 +17,9 @@
 
 #include "log.h"
 #include "common.h"
+#include "numeric_codec.h"
+#include "temporal_codec.h"
+#include "jsonb_encoder.h"
 
 #include <env.h>
 
@@ -341,6 +344,24 @@ size_t convert_binlog_var_string(
 }
 
 size_t convert_binlog_decimal(IColMeta& col_meta, size_t data_len, const char* data, MsgBuf& data_decode)
+{
+  int precision = col_meta.getPrecision() >= 0 ? col_meta.getPrecision() : 10;
+  int scale = col_meta.getScale() >= 0 ? col_meta.getScale() : 0;
+  if (scale > precision) {
+    return convert_binlog_decimal_fallback(col_meta, data_len, data, data_decode);
+  }
+
+  int bin_size = decimal_bin_size(precision, scale);
+  auto* data_buff = static_cast<unsigned char*>(malloc(bin_size));
+  if (!decimal_to_bin(data, data_len, precision, scale, data_buff)) {
+    free(data_buff);
+    return convert_binlog_decimal_fallback(col_meta, data_len, data, data_decode);
+  }
+  data_decode.push_back(reinterpret_cast<char*>(data_buff), bin_size);
+  return bin_size;
+}
+
+size_t convert_binlog_decimal_fallback(IColMeta& col_meta, size_t data_len, const char* data, MsgBuf& data_decode)
 {
   // 1. get decimal and precision
   int precision = 10;
@@ -483,7 +504,7 @@ size_t convert_binlog_decimal(IColMeta& col_meta, size_t data_len, const char* d
     }
 
     uint32_t value = (std::stoi(frac_str)) ^ mask;
-    assert(offset + bytes_size < orig_isize0 + orig_fsize0);
+    assert(offset + bytes_size <= orig_isize0 + orig_fsize0);
     switch (bytes_size) {
       case 1:
         hf_int1store(data_buff + offset, value);
@@ -584,12 +605,17 @@ bool is_zero_date(const std::string& str)
 
 size_t convert_binlog_timestamp(IColMeta& col_meta, size_t data_len, const char* data, MsgBuf& data_decode)
 {
-  // set enable_convert_timestamp_to_unix_timestamp=1，1662034855.000000
-  std::string str(data, data_len);
-  IUnixTime unix_time = str_2_unix_time(str);
   int precision = col_meta.getScale();
   int64_t buff_len = 4 + remainder_bytes(precision);
   auto* buff = static_cast<unsigned char*>(malloc(buff_len));
+  if (timestamp_to_bin(data, data_len, precision, buff)) {
+    data_decode.push_back(reinterpret_cast<char*>(buff), buff_len);
+    return buff_len;
+  }
+
+  // set enable_convert_timestamp_to_unix_timestamp=1，1662034855.000000
+  std::string str(data, data_len);
+  IUnixTime unix_time = str_2_unix_time(str);
   int pos = 0;
   if (is_zero_date(str)) {
     be_int4store(buff + pos, 0);
@@ -624,10 +650,15 @@ size_t convert_binlog_timestamp(IColMeta& col_meta, size_t data_len, const char*
 
 size_t convert_binlog_time(IColMeta& col_meta, const char* data, MsgBuf& data_decode)
 {
-  IDate date = str_2_idate(data);
   int precision = col_meta.getScale();
   int64_t buff_len = 3 + remainder_bytes(precision);
   auto* buff = static_cast<unsigned char*>(malloc(buff_len));
+  if (time_to_bin(data, strlen(data), precision, buff)) {
+    data_decode.push_back(reinterpret_cast<char*>(buff), buff_len);
+    return buff_len;
+  }
+
+  IDate date = str_2_idate(data);
   int pos = 0;
   int sign = 1;
   int64_t time = (((date.month > 0 ? 0 : date.day * 24L) + date.hour) << 12) | (date.minute << 6) | date.second;
@@ -667,12 +698,17 @@ size_t convert_binlog_time(IColMeta& col_meta, const char* data, MsgBuf& data_de
 
 size_t convert_binlog_datetime(IColMeta& col_meta, size_t data_len, const char* data, MsgBuf& data_decode)
 {
-  std::string str(data, data_len);
-  IDate date = str_2_idate(str);
   //      int precision = date.precision;
   int precision = col_meta.getScale();
   int64_t buff_len = 5 + remainder_bytes(precision);
   auto* buff = static_cast<unsigned char*>(malloc(buff_len));
+  if (datetime_to_bin(data, data_len, precision, buff)) {
+    data_decode.push_back(reinterpret_cast<char*>(buff), buff_len);
+    return buff_len;
+  }
+
+  std::string str(data, data_len);
+  IDate date = str_2_idate(str);
   int pos = 0;
   uint64_t time = 0;
   time |= date.sign;
@@ -742,6 +778,16 @@ size_t convert_binlog_year(size_t data_len, const char* data, MsgBuf& data_decod
 
 size_t convert_binlog_json(const char* data, MsgBuf& data_decode, bool is_json_diff)
 {
+  thread_local JsonbEncoder encoder;
+  if (encoder.encode(data, strlen(data), is_json_diff)) {
+    size_t byte_size = encoder.size();
+    auto* buff = static_cast<unsigned char*>(malloc(4 + byte_size));
+    int4store(buff, byte_size);
+    encoder.write(buff + 4);
+    data_decode.push_back(reinterpret_cast<char*>(buff), 4 + byte_size);
+    return 4 + byte_size;
+  }
+
   MsgBuf json;
   if (is_json_diff) {
     JsonParser::parse_json_diff(data, json);
@@ -767,6 +813,11 @@ size_t convert_binlog_geometry(size_t data_len, const char* data, MsgBuf& data_d
 size_t convert_binlog_date(size_t data_len, const char* data, MsgBuf& data_decode)
 {
   auto* buff = static_cast<unsigned char*>(malloc(3));
+  if (date_to_bin(data, data_len, buff)) {
+    data_decode.push_back(reinterpret_cast<char*>(buff), 3);
+    return 3;
+  }
+
   std::string str(data, data_len);
   IDate i_date = str_2_idate(str);
   int64_t date = i_date.day + i_date.month * 32 + i_date.year * 16 * 32;
@@ -980,7 +1031,10 @@ size_t convert_binlog_tiny_blob(size_t data_len, const char* data, MsgBuf& data_
 
 size_t int_two_complement(unsigned char* val, size_t len, const char* data)
 {
-  const auto num = std::stoull(data);
+  uint64_t num = 0;
+  if (!parse_int_two_complement(data, strlen(data), num)) {
+    num = std::stoull(data);
+  }
   switch (len) {
     case 1:
       int1store(val, num);
@@ -196,6 +196,12 @@ size_t convert_binlog_enum(IColMeta& col_meta, const char* data, MsgBuf& data_de
 
 size_t convert_binlog_decimal(IColMeta& col_meta, size_t data_len, const char* data, MsgBuf& data_decode);
 
+/*!
+ * @brief The general decimal conversion, for the values decimal_to_bin does not accept, and the reference it is
+ * tested against.
+ */
+size_t convert_binlog_decimal_fallback(IColMeta& col_meta, size_t data_len, const char* data, MsgBuf& data_decode);
+
 size_t convert_binlog_var_string(
     IColMeta& col_meta, size_t data_len, const char* data, MsgBuf& data_decode, size_t& col_len);
 
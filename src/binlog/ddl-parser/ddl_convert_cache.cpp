@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "ddl_convert_cache.h"
+
+namespace oceanbase::binlog {
+
+static inline bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+void DdlConvertCache::set_capacity(size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _capacity = capacity;
+  evict(capacity);
+}
+
+std::string DdlConvertCache::normalize(const std::string& ddl)
+{
+  std::string key;
+  key.reserve(ddl.size());
+  size_t len = ddl.size();
+  size_t pos = 0;
+  while (pos < len) {
+    char c = ddl[pos];
+    if (is_space(c)) {
+      while (pos < len && is_space(ddl[pos])) {
+        ++pos;
+      }
+      if (!key.empty() && pos < len) {
+        key.push_back(' ');
+      }
+      continue;
+    }
+
+    // quoted names and literals, and comments, are kept verbatim
+    size_t end = pos + 1;
+    if (c == '\'' || c == '"' || c == '`') {
+      while (end < len && ddl[end] != c) {
+        end += (ddl[end] == '\\' && c != '`') ? 2 : 1;
+      }
+      end = end < len ? end + 1 : len;
+    } else if (c == '/' && pos + 1 < len && ddl[pos + 1] == '*') {
+      end = ddl.find("*/", pos + 2);
+      end = end == std::string::npos ? len : end + 2;
+    } else if ((c == '-' && pos + 1 < len && ddl[pos + 1] == '-') || c == '#') {
+      // up to and with the newline ending it
+      end = ddl.find('\n', pos);
+      end = end == std::string::npos ? len : end + 1;
+    }
+    key.append(ddl, pos, end - pos);
+    pos = end;
+  }
+  return key;
+}
+
+bool DdlConvertCache::get(const std::string& key, int& ret, std::string& result)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto iter = _index.find(key);
+  if (iter == _index.end()) {
+    return false;
+  }
+  _entries.splice(_entries.begin(), _entries, iter->second);
+  ret = iter->second->ret;
+  result = iter->second->result;
+  return true;
+}
+
+void DdlConvertCache::put(const std::string& key, int ret, const std::string& result)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_capacity == 0) {
+    return;
+  }
+  auto iter = _index.find(key);
+  if (iter != _index.end()) {
+    iter->second->ret = ret;
+    iter->second->result = result;
+    _entries.splice(_entries.begin(), _entries, iter->second);
+    return;
+  }
+  _entries.push_front(Entry{key, ret, result});
+  _index.emplace(_entries.front().key, _entries.begin());
+  evict(_capacity);
+}
+
+size_t DdlConvertCache::size() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _entries.size();
+}
+
+void DdlConvertCache::evict(size_t capacity)
+{
+  while (_entries.size() > capacity) {
+    _index.erase(_entries.back().key);
+    _entries.pop_back();
+  }
+}
+
+}  // namespace oceanbase::binlog
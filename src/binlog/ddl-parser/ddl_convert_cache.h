@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief Bounded LRU of the DDL conversions of etransfer, shared by the convert workers.
+ *
+ * Conversions are keyed by the normalized DDL text, so that statements differing only in their layout are converted
+ * once. Both outcomes are kept: the converted SQL, and the failure of a DDL the downstream does not support.
+ */
+class DdlConvertCache {
+public:
+  explicit DdlConvertCache(size_t capacity = 0) : _capacity(capacity)
+  {}
+
+  /*!
+   * @brief Change the number of conversions kept, 0 disabling the cache
+   */
+  void set_capacity(size_t capacity);
+
+  /*!
+   * @brief The DDL with each run of whitespace outside quotes and comments replaced by one space, and trimmed
+   */
+  static std::string normalize(const std::string& ddl);
+
+  /*!
+   * @brief Look up the conversion of a normalized DDL and mark it as the most recently used
+   * @return false if the DDL has not been converted yet, or has been evicted since
+   */
+  bool get(const std::string& key, int& ret, std::string& result);
+
+  /*!
+   * @brief Keep the conversion of a normalized DDL, evicting the least recently used one beyond the capacity
+   */
+  void put(const std::string& key, int ret, const std::string& result);
+
+  size_t size() const;
+
+private:
+  struct Entry {
+    std::string key;
+    int ret;
+    std::string result;
+  };
+
+  void evict(size_t capacity);
+
+private:
+  mutable std::mutex _mutex;
+  size_t _capacity;
+  // most recently used first, indexed by the key stored in the entry
+  std::list<Entry> _entries;
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> _index;
+};
+
+}  // namespace oceanbase::binlog
@@ -31,6 +31,7 @@ DdlParser::~DdlParser()
 
 int DdlParser::init()
 {
+  _cache.set_capacity(logproxy::Config::instance().binlog_ddl_convert_cache_size.val());
 #ifndef BUILD_OPENSOURCE
   JavaVMInitArgs vm_args;
   memset(&vm_args, 0, sizeof(vm_args));
@@ -88,6 +89,24 @@ int DdlParser::init()
 }
 
 int DdlParser::parse(std::string& origin, std::string& result)
+{
+  std::string key = DdlConvertCache::normalize(origin);
+  int ret = OMS_FAILED;
+  if (_cache.get(key, ret, result)) {
+    OMS_DEBUG("Reuse the conversion of ddl sql:[ {} ], result: [ {} ]", origin, result);
+    return ret;
+  }
+
+  ret = convert(origin, result);
+  if (ret == OMS_AGAIN) {
+    // etransfer could not be called, the ddl may well convert on the next attempt
+    return OMS_FAILED;
+  }
+  _cache.put(key, ret, result);
+  return ret;
+}
+
+int DdlParser::convert(std::string& origin, std::string& result)
 {
 #ifdef BUILD_OPENSOURCE
   std::string err_msg;
@@ -101,7 +120,7 @@ int DdlParser::parse(std::string& origin, std::string& result)
   std::lock_guard<std::mutex> lock(_jvm_mutex);
   if (JNI_OK != this->_jvm->AttachCurrentThread((void**)&_env, nullptr)) {
     OMS_STREAM_ERROR << "Failed to Attach thread";
-    return OMS_FAILED;
+    return OMS_AGAIN;
   }
   jstring sql = string_2_jstring(_env, origin);
   jstring default_schema = string_2_jstring(_env, "");
@@ -13,12 +13,13 @@
 #pragma once
 #include "common.h"
 #include "log.h"
+#include "config.h"
+#include "ddl_convert_cache.h"
 
 #ifdef BUILD_OPENSOURCE
 #include "convert/convert_tool.h"
 #else
 #include <jni.h>
-#include "config.h"
 #include <mutex>
 #endif
 
@@ -29,6 +30,10 @@ public:
 
   int init();
 
+  /*!
+   * @brief Convert an incremental DDL for the downstream, reusing the conversion of an earlier DDL with the same
+   * normalized text
+   */
   int parse(std::string& origin, std::string& result);
 
 #ifndef BUILD_OPENSOURCE
@@ -39,8 +44,18 @@ public:
   bool print_jni_exception_info();
 
   void jni_error_handler(jint ret) const;
+#endif
 
 private:
+  /*!
+   * @brief Run the conversion of etransfer
+   * @return OMS_AGAIN if etransfer could not be called at all
+   */
+  int convert(std::string& origin, std::string& result);
+
+private:
+  DdlConvertCache _cache;
+#ifndef BUILD_OPENSOURCE
   JavaVM* _jvm = nullptr; /* denotes a Java VM */
   JNIEnv* _env = nullptr; /* pointer to native method interface */
   jclass _cls = nullptr;
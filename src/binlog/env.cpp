@@ -20,19 +20,16 @@ BinlogDumperManager* g_dumper_manager = nullptr;
 ThreadPoolExecutor* g_executor = nullptr;
 ThreadPoolExecutor* g_purge_binlog_executor = nullptr;
 ThreadPoolExecutor* g_sql_executor = nullptr;
-shared_ptr<Disruptor::disruptor<ReleaseEvent>> g_disruptor = nullptr;
 SysVar* g_sys_var = nullptr;
 TcpPortPool* g_tcp_port_pool = nullptr;
 ClusterProtocol* g_cluster = nullptr;
 
 BinlogIndexManager* g_index_manager = nullptr;
+BinlogDumpScheduler* g_dump_scheduler = nullptr;
 GtidManager* g_gtid_manager = nullptr;
 
 GeometryConverter* g_gis_converter = nullptr;
 
-std::vector<shared_ptr<Disruptor::IWorkHandler<ReleaseEvent>>> g_release_event_handler;
-shared_ptr<Disruptor::RoundRobinThreadAffinedTaskScheduler> task_scheduler = nullptr;
-
 int init_cluster_config(ClusterConfig* cluster_config);
 
 int env_init(uint32_t nof_work_threads, uint32_t sql_work_threads, uint16_t start_tcp_port, uint16_t reserved_ports_num)
@@ -115,33 +112,21 @@ int instance_env_init(uint32_t nof_work_threads, uint32_t obi_convert_work_threa
   g_gtid_manager = new GtidManager(GTID_SEQ_FILENAME);
   g_gis_converter = new GeometryConverter{};
   g_purge_binlog_executor = new ThreadPoolExecutor{obi_purge_binlog_threads};
-
-  task_scheduler = std::make_shared<Disruptor::RoundRobinThreadAffinedTaskScheduler>();
-  for (int64_t i = 0; i < s_config.binlog_release_parallel_size.val(); i++) {
-    g_release_event_handler.push_back(std::make_shared<ReleaseEventHandler>());
-  }
-
-  if (s_config.binlog_release_ring_buffer_size.val() < 1) {
-    OMS_ERROR("binlog_release_ring_buffer_size must not be less than 1");
-    return OMS_FAILED;
-  }
-
-  if (!Disruptor::Util::isPowerOf2(s_config.binlog_release_ring_buffer_size.val())) {
-    OMS_ERROR("binlog_release_ring_buffer_size must be a power of 2");
-    return OMS_FAILED;
+  if (s_config.binlog_dump_scheduler_threads.val() > 0) {
+    g_dump_scheduler = new BinlogDumpScheduler(s_config.binlog_dump_scheduler_threads.val());
+    if (OMS_OK != g_dump_scheduler->start()) {
+      OMS_ERROR("Failed to start binlog dump scheduler");
+      return OMS_FAILED;
+    }
   }
-  g_disruptor = std::make_shared<Disruptor::disruptor<ReleaseEvent>>(
-      create_release_event, s_config.binlog_release_ring_buffer_size.val(), task_scheduler);
-  g_disruptor->handleEventsWithWorkerPool(g_release_event_handler);
-  task_scheduler->start(s_config.binlog_release_thread_size.val());
-  g_disruptor->start();
   return evthread_use_pthreads();
 }
 
 void instance_env_deInit()
 {
-  g_disruptor->shutdown();
-  task_scheduler->stop();
+  // dumpers still running on the scheduler release their connections and unregister from the dumper manager
+  delete g_dump_scheduler;
+  g_dump_scheduler = nullptr;
   delete g_connection_manager;
   delete g_dumper_manager;
   delete g_executor;
@@ -25,8 +25,8 @@
 #include "cluster/cluster_config.h"
 #include "cluster/cluster_protocol.h"
 #include "binlog-instance/binlog_dumper_manager.h"
+#include "binlog-instance/binlog_dump_scheduler.h"
 #include "common_util.h"
-#include "release_event_helper.h"
 
 namespace oceanbase::binlog {
 static logproxy::Config& s_config = logproxy::Config::instance();
@@ -35,7 +35,6 @@ extern BinlogDumperManager* g_dumper_manager;
 extern logproxy::ThreadPoolExecutor* g_executor;
 extern logproxy::ThreadPoolExecutor* g_purge_binlog_executor;
 extern logproxy::ThreadPoolExecutor* g_sql_executor;
-extern shared_ptr<Disruptor::disruptor<ReleaseEvent>> g_disruptor;
 extern SysVar* g_sys_var;
 extern TcpPortPool* g_tcp_port_pool;
 extern ClusterProtocol* g_cluster;
@@ -44,11 +43,11 @@ extern ClusterProtocol* g_cluster;
 static InstanceMeta& s_meta = InstanceMeta::instance();
 
 extern BinlogIndexManager* g_index_manager;
+// null unless binlog_dump_scheduler_threads is set
+extern BinlogDumpScheduler* g_dump_scheduler;
 extern GtidManager* g_gtid_manager;
 extern GeometryConverter* g_gis_converter;
 
-extern std::vector<shared_ptr<Disruptor::IWorkHandler<ReleaseEvent>>> g_release_event_handler;
-extern shared_ptr<Disruptor::RoundRobinThreadAffinedTaskScheduler> task_scheduler;
 int env_init(
     uint32_t nof_work_threads, uint32_t sql_work_threads, uint16_t start_tcp_port, uint16_t reserved_ports_num);
 
@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "event_arena.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace oceanbase::binlog {
+
+// Number of standard blocks an arena keeps across resets, the rest is returned to the allocator
+static constexpr size_t ARENA_RETAINED_BLOCKS = 16;
+
+EventArena::EventArena(size_t block_size) : _block_size(block_size)
+{
+  add_block(_block_size);
+}
+
+EventArena::~EventArena()
+{
+  for (auto& block : _blocks) {
+    free(block.data);
+  }
+  _blocks.clear();
+}
+
+void EventArena::add_block(size_t min_size)
+{
+  size_t size = min_size > _block_size ? min_size : _block_size;
+  auto* data = static_cast<unsigned char*>(malloc(size));
+  if (data == nullptr) {
+    throw std::runtime_error("Failed to allocate event arena block");
+  }
+  _blocks.push_back({data, size});
+  _reserved_bytes += size;
+}
+
+void* EventArena::allocate(size_t size, size_t align)
+{
+  while (true) {
+    Block& block = _blocks[_cur_block];
+    size_t offset = (_cur_offset + align - 1) & ~(align - 1);
+    if (offset + size <= block.size) {
+      _cur_offset = offset + size;
+      _used_bytes += size;
+      return block.data + offset;
+    }
+
+    // move on to the next retained block, or grow the arena
+    if (_cur_block + 1 >= _blocks.size()) {
+      add_block(size + align);
+    }
+    _cur_block++;
+    _cur_offset = 0;
+  }
+}
+
+void EventArena::seal()
+{
+  uint32_t nof_events = _nof_events;
+  _nof_events = 0;
+  if (nof_events == 0) {
+    EventArenaPool::instance().recycle(this);
+    return;
+  }
+  _refs.store(nof_events, std::memory_order_release);
+}
+
+void EventArena::release(uint32_t nof_events)
+{
+  uint32_t prev = _refs.fetch_sub(nof_events, std::memory_order_acq_rel);
+  assert(prev >= nof_events);
+  if (prev == nof_events) {
+    EventArenaPool::instance().recycle(this);
+  }
+}
+
+void EventArena::reset()
+{
+  size_t retained = 0;
+  for (auto iter = _blocks.begin(); iter != _blocks.end();) {
+    if (iter->size != _block_size || retained >= ARENA_RETAINED_BLOCKS) {
+      _reserved_bytes -= iter->size;
+      free(iter->data);
+      iter = _blocks.erase(iter);
+      continue;
+    }
+    retained++;
+    ++iter;
+  }
+  if (_blocks.empty()) {
+    add_block(_block_size);
+  }
+  _cur_block = 0;
+  _cur_offset = 0;
+  _used_bytes = 0;
+  _nof_events = 0;
+  _refs.store(0, std::memory_order_relaxed);
+}
+
+void EventArenaPool::init(size_t block_size, size_t max_idle_arenas)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _block_size = block_size;
+  _max_idle_arenas = max_idle_arenas;
+}
+
+EventArena* EventArenaPool::acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_idle.empty()) {
+      EventArena* arena = _idle.back();
+      _idle.pop_back();
+      return arena;
+    }
+  }
+  _total.fetch_add(1, std::memory_order_relaxed);
+  return new EventArena(_block_size);
+}
+
+void EventArenaPool::recycle(EventArena* arena)
+{
+  arena->reset();
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_idle.size() < _max_idle_arenas) {
+      _idle.push_back(arena);
+      return;
+    }
+  }
+  _total.fetch_sub(1, std::memory_order_relaxed);
+  delete arena;
+}
+
+size_t EventArenaPool::idle_size()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _idle.size();
+}
+
+EventArenaPool::~EventArenaPool()
+{
+  for (auto arena : _idle) {
+    delete arena;
+  }
+  _idle.clear();
+}
+
+void release_event(ObLogEvent* event)
+{
+  if (event == nullptr) {
+    return;
+  }
+  EventArena* arena = event->get_arena();
+  if (arena == nullptr) {
+    delete event;
+    return;
+  }
+  event->~ObLogEvent();
+  arena->release(1);
+}
+
+void release_events(std::vector<ObLogEvent*>& events)
+{
+  EventArena* run_arena = nullptr;
+  uint32_t run_len = 0;
+  for (auto& event : events) {
+    if (event == nullptr) {
+      continue;
+    }
+    EventArena* arena = event->get_arena();
+    if (arena == nullptr) {
+      delete event;
+      event = nullptr;
+      continue;
+    }
+    event->~ObLogEvent();
+    event = nullptr;
+    if (arena != run_arena) {
+      if (run_arena != nullptr) {
+        run_arena->release(run_len);
+      }
+      run_arena = arena;
+      run_len = 0;
+    }
+    run_len++;
+  }
+  if (run_arena != nullptr) {
+    run_arena->release(run_len);
+  }
+  events.clear();
+}
+
+}  // namespace oceanbase::binlog
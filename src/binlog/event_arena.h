@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "ob_log_event.h"
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief Bump allocator scoped to one convert batch (BinlogEvent).
+ *
+ * The convert worker places every ObLogEvent of the batch, its OblogEventHeader and its fixed-size sub-buffers
+ * (bitmaps, column types, metadata, null bits) in the arena. Events are handed over to the storage pipeline one by one,
+ * so the arena counts the live events once the batch is sealed and returns itself to the EventArenaPool when the last
+ * one has been serialized. All memory of the batch is then reclaimed by a single reset.
+ */
+class EventArena {
+public:
+  explicit EventArena(size_t block_size);
+
+  ~EventArena();
+
+  EventArena(const EventArena&) = delete;
+  EventArena& operator=(const EventArena&) = delete;
+
+  void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+  unsigned char* alloc_bytes(size_t size)
+  {
+    return static_cast<unsigned char*>(allocate(size, 1));
+  }
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args)
+  {
+    void* mem = allocate(sizeof(T), alignof(T));
+    return new (mem) T(std::forward<Args>(args)...);
+  }
+
+  /*!
+   * @brief Construct an event in the arena. The event is counted as live until it is handed to release_event().
+   */
+  template <typename T, typename... Args>
+  T* create_event(Args&&... args)
+  {
+    T* event = create<T>(std::forward<Args>(args)...);
+    event->set_arena(this);
+    _nof_events++;
+    return event;
+  }
+
+  /*!
+   * @brief Called by the owning convert worker once the batch is complete. From now on the arena may be released by
+   * any thread; if the batch produced no event it is recycled immediately.
+   */
+  void seal();
+
+  /*!
+   * @brief Drop nof_events references, the arena is recycled after the last one.
+   */
+  void release(uint32_t nof_events);
+
+  void reset();
+
+  size_t used_bytes() const
+  {
+    return _used_bytes;
+  }
+
+  size_t reserved_bytes() const
+  {
+    return _reserved_bytes;
+  }
+
+private:
+  struct Block {
+    unsigned char* data;
+    size_t size;
+  };
+
+  void add_block(size_t min_size);
+
+private:
+  size_t _block_size;
+  std::vector<Block> _blocks;
+  size_t _cur_block = 0;
+  size_t _cur_offset = 0;
+  size_t _used_bytes = 0;
+  size_t _reserved_bytes = 0;
+  // only touched by the owning convert worker before seal()
+  uint32_t _nof_events = 0;
+  std::atomic<uint32_t> _refs{0};
+};
+
+class EventArenaPool {
+public:
+  static EventArenaPool& instance()
+  {
+    static EventArenaPool pool_singleton;
+    return pool_singleton;
+  }
+
+  void init(size_t block_size, size_t max_idle_arenas);
+
+  EventArena* acquire();
+
+  void recycle(EventArena* arena);
+
+  size_t idle_size();
+
+  size_t total_size() const
+  {
+    return _total.load(std::memory_order_relaxed);
+  }
+
+  ~EventArenaPool();
+
+private:
+  EventArenaPool() = default;
+
+private:
+  std::mutex _mutex;
+  std::vector<EventArena*> _idle;
+  size_t _block_size = 64 * 1024;
+  size_t _max_idle_arenas = 1024;
+  std::atomic<size_t> _total{0};
+};
+
+/*!
+ * @brief Release an event regardless of where it was allocated. Arena events are destructed in place and their arena
+ * reference is dropped; heap events are deleted.
+ */
+void release_event(ObLogEvent* event);
+
+/*!
+ * @brief Release a batch of events, dropping arena references in runs so that consecutive events of the same batch
+ * cost one atomic operation.
+ */
+void release_events(std::vector<ObLogEvent*>& events);
+
+}  // namespace oceanbase::binlog
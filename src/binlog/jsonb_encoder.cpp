@@ -0,0 +1,485 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "jsonb_encoder.h"
+
+#include <cstring>
+#include <string_view>
+
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+#include "json_parser.h"
+
+using namespace oceanbase::logproxy;
+
+namespace oceanbase::binlog {
+
+// documents up to this many values keep the tape of a convert worker allocated
+static constexpr size_t MAX_IDLE_TOKENS = 64 * 1024;
+static constexpr size_t MAX_IDLE_STRING_BYTES = 1024 * 1024;
+
+// count and size of an object or array, followed by an entry per member
+static constexpr uint64_t CONTAINER_HEADER_SIZE = 2 * LARGE_OFFSET_SIZE;
+static constexpr uint64_t OBJECT_ENTRY_SIZE = KEY_ENTRY_SIZE_LARGE + VALUE_ENTRY_SIZE_LARGE;
+static constexpr uint64_t ARRAY_ENTRY_SIZE = VALUE_ENTRY_SIZE_LARGE;
+
+static inline bool is_int16(int64_t value)
+{
+  return value >= INT16_MIN && value <= INT16_MAX;
+}
+
+// bytes of the 7 bits per byte length before a string, see JsonParser::append_variable_length
+static inline uint64_t variable_length_size(uint64_t length)
+{
+  uint64_t size = 1;
+  while (length >= 0x80) {
+    length >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+static inline unsigned char* store_variable_length(unsigned char* pos, uint64_t length)
+{
+  do {
+    uint8_t ch = length & 0x7F;
+    length >>= 7;
+    if (length != 0) {
+      ch |= 0x80;
+    }
+    *pos++ = ch;
+  } while (length != 0);
+  return pos;
+}
+
+/*!
+ * @brief SAX handler appending the values to the tape, in document order with the key before each member.
+ *
+ * The numbers are classified the way rapidjson::Value classifies them for JsonParser: IsInt values are inlined into
+ * the entry of their object or array, the other IsInt64 ones are INT64 and only the ones beyond are UINT64.
+ */
+class JsonbEncoder::TapeBuilder : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, TapeBuilder> {
+public:
+  explicit TapeBuilder(JsonbEncoder& encoder) : _encoder(encoder)
+  {}
+
+  bool Null()
+  {
+    push_scalar(TokenKind::NULL_LITERAL, 1);
+    return true;
+  }
+
+  bool Bool(bool value)
+  {
+    push_scalar(value ? TokenKind::TRUE_LITERAL : TokenKind::FALSE_LITERAL, 1);
+    return true;
+  }
+
+  bool Int(int value)
+  {
+    return push_int32(value);
+  }
+
+  bool Uint(unsigned value)
+  {
+    return value <= INT32_MAX ? push_int32(value) : push_int64(value);
+  }
+
+  bool Int64(int64_t value)
+  {
+    return value >= INT32_MIN && value <= INT32_MAX ? push_int32(value) : push_int64(value);
+  }
+
+  bool Uint64(uint64_t value)
+  {
+    if (value <= INT32_MAX) {
+      return push_int32(static_cast<int64_t>(value));
+    }
+    if (value <= INT64_MAX) {
+      return push_int64(static_cast<int64_t>(value));
+    }
+    push_scalar(TokenKind::UINT64, sizeof(uint64_t)).uint_value = value;
+    return true;
+  }
+
+  bool Double(double value)
+  {
+    push_scalar(TokenKind::DOUBLE, sizeof(double)).double_value = value;
+    return true;
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    Token& token = push_scalar(TokenKind::STRING, variable_length_size(length) + length);
+    token.str = save_string(str, length);
+    return true;
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    // JsonParser stores keys up to their first NUL, leave those to it
+    if (memchr(str, '\0', length) != nullptr) {
+      return false;
+    }
+    Token& token = push_token(TokenKind::KEY);
+    token.str = save_string(str, length);
+    _encoder._frames.back().bytes += length;
+    return true;
+  }
+
+  bool StartObject()
+  {
+    return start_container(TokenKind::OBJECT);
+  }
+
+  bool EndObject(rapidjson::SizeType member_count)
+  {
+    end_container(member_count, OBJECT_ENTRY_SIZE);
+    return true;
+  }
+
+  bool StartArray()
+  {
+    return start_container(TokenKind::ARRAY);
+  }
+
+  bool EndArray(rapidjson::SizeType element_count)
+  {
+    end_container(element_count, ARRAY_ENTRY_SIZE);
+    return true;
+  }
+
+private:
+  Token& push_token(TokenKind kind)
+  {
+    auto& tokens = _encoder._tokens;
+    auto index = static_cast<uint32_t>(tokens.size());
+    Token& token = tokens.emplace_back();
+    token.kind = kind;
+    token.count = 0;
+    token.next = index + 1;
+    token.size = 0;
+    token.uint_value = 0;
+    return token;
+  }
+
+  /*!
+   * @brief Append a value, whose bytes count for the enclosing object or array unless inlined into its entry
+   */
+  Token& push_scalar(TokenKind kind, uint64_t size)
+  {
+    Token& token = push_token(kind);
+    token.size = size;
+    bool inlined = kind == TokenKind::NULL_LITERAL || kind == TokenKind::TRUE_LITERAL ||
+                   kind == TokenKind::FALSE_LITERAL || kind == TokenKind::INT32;
+    if (!inlined && !_encoder._frames.empty()) {
+      _encoder._frames.back().bytes += size;
+    }
+    return token;
+  }
+
+  bool push_int32(int64_t value)
+  {
+    push_scalar(TokenKind::INT32, is_int16(value) ? sizeof(int16_t) : sizeof(int32_t)).int_value = value;
+    return true;
+  }
+
+  bool push_int64(int64_t value)
+  {
+    push_scalar(TokenKind::INT64, sizeof(int64_t)).int_value = value;
+    return true;
+  }
+
+  StringRef save_string(const char* str, rapidjson::SizeType length)
+  {
+    StringRef ref{static_cast<uint32_t>(_encoder._strings.size()), length};
+    _encoder._strings.append(str, length);
+    return ref;
+  }
+
+  bool start_container(TokenKind kind)
+  {
+    // JsonParser cuts arrays this deep, leave such documents to it
+    if (_encoder._frames.size() + 1 >= JSON_DOCUMENT_MAX_DEPTH) {
+      return false;
+    }
+    auto index = static_cast<uint32_t>(_encoder._tokens.size());
+    push_token(kind);
+    _encoder._frames.push_back({index, 0});
+    return true;
+  }
+
+  void end_container(uint32_t count, uint64_t entry_size)
+  {
+    Frame frame = _encoder._frames.back();
+    _encoder._frames.pop_back();
+    Token& token = _encoder._tokens[frame.token];
+    token.count = count;
+    token.next = static_cast<uint32_t>(_encoder._tokens.size());
+    token.size = CONTAINER_HEADER_SIZE + count * entry_size + frame.bytes;
+    if (!_encoder._frames.empty()) {
+      _encoder._frames.back().bytes += token.size;
+    }
+  }
+
+private:
+  JsonbEncoder& _encoder;
+};
+
+bool JsonbEncoder::encode(const char* data, size_t data_len, bool is_json_diff)
+{
+  if (_tokens.capacity() > MAX_IDLE_TOKENS) {
+    std::vector<Token>().swap(_tokens);
+  }
+  if (_strings.capacity() > MAX_IDLE_STRING_BYTES) {
+    std::string().swap(_strings);
+  }
+  _tokens.clear();
+  _strings.clear();
+  _frames.clear();
+  _diffs.clear();
+  _is_json_diff = is_json_diff;
+  _size = 0;
+
+  thread_local rapidjson::Reader reader;
+  rapidjson::MemoryStream stream(data, data_len);
+  TapeBuilder builder(*this);
+  if (reader.Parse(stream, builder).IsError()) {
+    return false;
+  }
+
+  if (is_json_diff) {
+    return lay_out_diffs();
+  }
+  _size = 1 + _tokens[0].size;
+  return true;
+}
+
+uint32_t JsonbEncoder::find_member(uint32_t object, const char* key) const
+{
+  std::string_view name(key);
+  uint32_t index = object + 1;
+  for (uint32_t i = 0; i < _tokens[object].count; ++i) {
+    const StringRef& str = _tokens[index].str;
+    if (name == std::string_view(_strings.data() + str.offset, str.len)) {
+      return index + 1;
+    }
+    index = _tokens[index + 1].next;
+  }
+  return 0;
+}
+
+bool JsonbEncoder::lay_out_diffs()
+{
+  // {"diffs": [{"op": ..., "path": ..., "value": ...}, ...]}, anything else is reported by JsonParser
+  if (_tokens[0].kind != TokenKind::OBJECT) {
+    return false;
+  }
+  uint32_t diffs = find_member(0, "diffs");
+  if (diffs == 0 || _tokens[diffs].kind != TokenKind::ARRAY) {
+    return false;
+  }
+
+  uint32_t index = diffs + 1;
+  for (uint32_t i = 0; i < _tokens[diffs].count; ++i, index = _tokens[index].next) {
+    if (_tokens[index].kind != TokenKind::OBJECT) {
+      return false;
+    }
+    uint32_t op = find_member(index, "op");
+    uint32_t path = find_member(index, "path");
+    if (op == 0 || path == 0 || _tokens[op].kind != TokenKind::STRING || _tokens[path].kind != TokenKind::STRING) {
+      return false;
+    }
+    const StringRef& path_str = _tokens[path].str;
+    if (memchr(_strings.data() + path_str.offset, '\0', path_str.len) != nullptr) {
+      return false;
+    }
+
+    // the op up to its first NUL, as json_diff_op compares it
+    const StringRef& op_str = _tokens[op].str;
+    const char* op_data = _strings.data() + op_str.offset;
+    std::string_view op_name(op_data, strnlen(op_data, op_str.len));
+    Diff diff{2, path, 0};
+    if (op_name == "replace") {
+      diff.op = 0;
+    } else if (op_name == "insert") {
+      diff.op = 1;
+    }
+
+    _size += 1 + get_packed_integer(path_str.len) + path_str.len;
+    if (diff.op != 2) {
+      diff.value = find_member(index, "value");
+      if (diff.value == 0) {
+        return false;
+      }
+      uint64_t value_size = 1 + _tokens[diff.value].size;
+      _size += get_packed_integer(value_size) + value_size;
+    }
+    _diffs.push_back(diff);
+  }
+  return true;
+}
+
+uint8_t JsonbEncoder::jsonb_type(const Token& token)
+{
+  switch (token.kind) {
+    case TokenKind::NULL_LITERAL:
+    case TokenKind::TRUE_LITERAL:
+    case TokenKind::FALSE_LITERAL:
+      return JSONB_TYPE_LITERAL;
+    case TokenKind::INT32:
+      return is_int16(token.int_value) ? JSONB_TYPE_INT16 : JSONB_TYPE_INT32;
+    case TokenKind::INT64:
+      return JSONB_TYPE_INT64;
+    case TokenKind::UINT64:
+      return JSONB_TYPE_UINT64;
+    case TokenKind::DOUBLE:
+      return JSONB_TYPE_DOUBLE;
+    case TokenKind::STRING:
+      return JSONB_TYPE_STRING;
+    case TokenKind::OBJECT:
+      return JSONB_TYPE_LARGE_OBJECT;
+    case TokenKind::ARRAY:
+      return JSONB_TYPE_LARGE_ARRAY;
+    default:
+      return JSONB_TYPE_OPAQUE;
+  }
+}
+
+void JsonbEncoder::write(unsigned char* out) const
+{
+  if (!_is_json_diff) {
+    write_value(0, out);
+    return;
+  }
+
+  for (const Diff& diff : _diffs) {
+    *out++ = diff.op;
+    const StringRef& path = _tokens[diff.path].str;
+    out += write_lenenc_uint(reinterpret_cast<char*>(out), MAX_PACKET_INTEGER_LEN, path.len);
+    memcpy(out, _strings.data() + path.offset, path.len);
+    out += path.len;
+    if (diff.op != 2) {
+      out += write_lenenc_uint(reinterpret_cast<char*>(out), MAX_PACKET_INTEGER_LEN, 1 + _tokens[diff.value].size);
+      out = write_value(diff.value, out);
+    }
+  }
+}
+
+unsigned char* JsonbEncoder::write_value(uint32_t index, unsigned char* out) const
+{
+  const Token& token = _tokens[index];
+  *out = jsonb_type(token);
+  write_body(index, out + 1);
+  return out + 1 + token.size;
+}
+
+void JsonbEncoder::write_body(uint32_t index, unsigned char* out) const
+{
+  const Token& token = _tokens[index];
+  switch (token.kind) {
+    case TokenKind::NULL_LITERAL:
+      *out = JSONB_NULL_LITERAL;
+      break;
+    case TokenKind::TRUE_LITERAL:
+      *out = JSONB_TRUE_LITERAL;
+      break;
+    case TokenKind::FALSE_LITERAL:
+      *out = JSONB_FALSE_LITERAL;
+      break;
+    case TokenKind::INT32:
+      if (is_int16(token.int_value)) {
+        int2store(out, token.int_value);
+      } else {
+        int4store(out, token.int_value);
+      }
+      break;
+    case TokenKind::INT64:
+      int8store(out, token.int_value);
+      break;
+    case TokenKind::UINT64:
+      int8store(out, token.uint_value);
+      break;
+    case TokenKind::DOUBLE:
+      float8store(out, token.double_value);
+      break;
+    case TokenKind::STRING: {
+      unsigned char* pos = store_variable_length(out, token.str.len);
+      memcpy(pos, _strings.data() + token.str.offset, token.str.len);
+      break;
+    }
+    case TokenKind::OBJECT: {
+      int4store(out, token.count);
+      int4store(out + LARGE_OFFSET_SIZE, token.size);
+      unsigned char* key_entry = out + CONTAINER_HEADER_SIZE;
+      unsigned char* value_entry = key_entry + token.count * KEY_ENTRY_SIZE_LARGE;
+      uint64_t offset = CONTAINER_HEADER_SIZE + token.count * OBJECT_ENTRY_SIZE;
+
+      // the key entries and keys first, then the value entries and the values they point to
+      uint32_t member = index + 1;
+      for (uint32_t i = 0; i < token.count; ++i, key_entry += KEY_ENTRY_SIZE_LARGE) {
+        const StringRef& key = _tokens[member].str;
+        int4store(key_entry, offset);
+        int2store(key_entry + LARGE_OFFSET_SIZE, key.len);
+        memcpy(out + offset, _strings.data() + key.offset, key.len);
+        offset += key.len;
+        member = _tokens[member + 1].next;
+      }
+      member = index + 1;
+      for (uint32_t i = 0; i < token.count; ++i, value_entry += VALUE_ENTRY_SIZE_LARGE) {
+        offset += write_entry(member + 1, value_entry, out, offset);
+        member = _tokens[member + 1].next;
+      }
+      break;
+    }
+    case TokenKind::ARRAY: {
+      int4store(out, token.count);
+      int4store(out + LARGE_OFFSET_SIZE, token.size);
+      unsigned char* value_entry = out + CONTAINER_HEADER_SIZE;
+      uint64_t offset = CONTAINER_HEADER_SIZE + token.count * ARRAY_ENTRY_SIZE;
+      uint32_t element = index + 1;
+      for (uint32_t i = 0; i < token.count; ++i, value_entry += VALUE_ENTRY_SIZE_LARGE) {
+        offset += write_entry(element, value_entry, out, offset);
+        element = _tokens[element].next;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+uint64_t JsonbEncoder::write_entry(uint32_t index, unsigned char* entry, unsigned char* base, uint64_t offset) const
+{
+  const Token& token = _tokens[index];
+  entry[0] = jsonb_type(token);
+  switch (token.kind) {
+    case TokenKind::NULL_LITERAL:
+      int4store(entry + 1, JSONB_NULL_LITERAL);
+      return 0;
+    case TokenKind::TRUE_LITERAL:
+      int4store(entry + 1, JSONB_TRUE_LITERAL);
+      return 0;
+    case TokenKind::FALSE_LITERAL:
+      int4store(entry + 1, JSONB_FALSE_LITERAL);
+      return 0;
+    case TokenKind::INT32:
+      int4store(entry + 1, token.int_value);
+      return 0;
+    default:
+      int4store(entry + 1, offset);
+      write_body(index, base + offset);
+      return token.size;
+  }
+}
+
+}  // namespace oceanbase::binlog
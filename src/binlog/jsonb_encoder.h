@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief Streaming encoder of JSON text into the binary JSON (JSONB) of the binlog rows.
+ *
+ * A single SAX pass over the text records the values on a flat tape, and completes the member count and the encoded
+ * size of each object or array when it closes, so that every JSONB header with offsets is known before anything is
+ * written. A walk over the tape then writes the JSONB straight into the buffer of the caller, without the rapidjson DOM
+ * and the chunk per field of JsonParser.
+ *
+ * The bytes are those of JsonParser::parser and JsonParser::parse_json_diff, objects and arrays in the large format and
+ * keys in document order included. Malformed text and documents nested JSON_DOCUMENT_MAX_DEPTH deep or more are
+ * rejected, and left to JsonParser.
+ */
+class JsonbEncoder {
+public:
+  /*!
+   * @brief Parse a JSON document, or the diffs of a partial JSON update, and lay out its JSONB
+   * @return false if the text is left to JsonParser
+   */
+  bool encode(const char* data, size_t data_len, bool is_json_diff = false);
+
+  /*!
+   * @brief Bytes of the JSONB laid out by the last successful encode
+   */
+  size_t size() const
+  {
+    return _size;
+  }
+
+  /*!
+   * @brief Write the size() bytes of the JSONB laid out by the last successful encode
+   */
+  void write(unsigned char* out) const;
+
+private:
+  class TapeBuilder;
+
+  enum class TokenKind : uint8_t {
+    NULL_LITERAL,
+    TRUE_LITERAL,
+    FALSE_LITERAL,
+    // an integer of the int32 range, inlined in the value entry of an object or array
+    INT32,
+    INT64,
+    UINT64,
+    DOUBLE,
+    STRING,
+    KEY,
+    OBJECT,
+    ARRAY,
+  };
+
+  struct StringRef {
+    uint32_t offset;
+    uint32_t len;
+  };
+
+  struct Token {
+    TokenKind kind;
+    // members of an object or array
+    uint32_t count;
+    // index of the token behind the value, with all its members
+    uint32_t next;
+    // bytes of the value without its type byte
+    uint64_t size;
+    union {
+      int64_t int_value;
+      uint64_t uint_value;
+      double double_value;
+      StringRef str;
+    };
+  };
+
+  // an object or array still open during the parse
+  struct Frame {
+    uint32_t token;
+    // bytes of the members stored behind the value entries
+    uint64_t bytes;
+  };
+
+  struct Diff {
+    uint8_t op;
+    uint32_t path;
+    // the token of the value, or 0 for a removal
+    uint32_t value;
+  };
+
+  bool lay_out_diffs();
+
+  static uint8_t jsonb_type(const Token& token);
+
+  uint32_t find_member(uint32_t object, const char* key) const;
+
+  unsigned char* write_value(uint32_t index, unsigned char* out) const;
+
+  void write_body(uint32_t index, unsigned char* out) const;
+
+  uint64_t write_entry(uint32_t index, unsigned char* entry, unsigned char* base, uint64_t offset) const;
+
+private:
+  std::vector<Token> _tokens;
+  std::string _strings;
+  std::vector<Frame> _frames;
+  std::vector<Diff> _diffs;
+  bool _is_json_diff = false;
+  size_t _size = 0;
+};
+
+}  // namespace oceanbase::binlog
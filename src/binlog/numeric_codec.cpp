@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "numeric_codec.h"
+
+#include <cstring>
+
+#include "codec/byte_decoder.h"
+
+using namespace oceanbase::logproxy;
+
+namespace oceanbase::binlog {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the SWAR digit parsing expects little-endian words");
+
+// digits per 4-byte group of the packed decimal format, and the bytes of a group of 0 to 9 digits
+static constexpr int DIGITS_PER_GROUP = 9;
+static constexpr int GROUP_BYTES[DIGITS_PER_GROUP + 1] = {0, 1, 1, 2, 2, 3, 3, 4, 4, 4};
+
+static inline uint64_t load_8(const char* pos)
+{
+  uint64_t word;
+  memcpy(&word, pos, sizeof(word));
+  return word;
+}
+
+/*!
+ * @brief Whether all 8 bytes of the word are '0' to '9': each high nibble must be 3, also after adding 6.
+ */
+static inline bool is_8_digits(uint64_t word)
+{
+  return ((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+/*!
+ * @brief Value of 8 digits, the first one in the lowest byte: pairs, then quadruples, then the octet are combined by
+ * one multiplication each.
+ */
+static inline uint32_t parse_8_digits(uint64_t word)
+{
+  word = ((word & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+  word = ((word & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+  return static_cast<uint32_t>(((word & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+static inline bool is_digit(char c)
+{
+  return static_cast<unsigned char>(c - '0') <= 9;
+}
+
+static size_t digit_run(const char* begin, const char* end)
+{
+  const char* pos = begin;
+  while (end - pos >= 8 && is_8_digits(load_8(pos))) {
+    pos += 8;
+  }
+  while (pos < end && is_digit(*pos)) {
+    ++pos;
+  }
+  return pos - begin;
+}
+
+// value of at most 9 digits, all of them checked already
+static inline uint32_t digits_value(const char* pos, int nof_digits)
+{
+  uint32_t value = 0;
+  if (nof_digits >= 8) {
+    value = parse_8_digits(load_8(pos));
+    pos += 8;
+    nof_digits -= 8;
+  }
+  while (nof_digits-- > 0) {
+    value = value * 10 + (*pos++ - '0');
+  }
+  return value;
+}
+
+static inline unsigned char* store_group(unsigned char* pos, uint32_t value, int bytes)
+{
+  switch (bytes) {
+    case 1:
+      hf_int1store(pos, value);
+      break;
+    case 2:
+      hf_int2store(pos, value);
+      break;
+    case 3:
+      hf_int3store(pos, value);
+      break;
+    case 4:
+      hf_int4store(pos, value);
+      break;
+    default:
+      break;
+  }
+  return pos + bytes;
+}
+
+bool parse_uint64(const char* data, size_t data_len, uint64_t& value)
+{
+  if (data_len == 0 || data_len > 20 || digit_run(data, data + data_len) != data_len) {
+    return false;
+  }
+
+  // 19 digits cannot overflow, only a 20th one can
+  size_t safe_len = data_len < 19 ? data_len : 19;
+  uint64_t num = 0;
+  size_t pos = 0;
+  for (; pos + 8 <= safe_len; pos += 8) {
+    num = num * 100000000 + parse_8_digits(load_8(data + pos));
+  }
+  for (; pos < safe_len; ++pos) {
+    num = num * 10 + (data[pos] - '0');
+  }
+  if (pos < data_len &&
+      (__builtin_mul_overflow(num, 10, &num) || __builtin_add_overflow(num, data[pos] - '0', &num))) {
+    return false;
+  }
+  value = num;
+  return true;
+}
+
+bool parse_int_two_complement(const char* data, size_t data_len, uint64_t& value)
+{
+  if (data_len > 0 && data[0] == '-') {
+    uint64_t magnitude = 0;
+    if (!parse_uint64(data + 1, data_len - 1, magnitude)) {
+      return false;
+    }
+    value = 0 - magnitude;
+    return true;
+  }
+  return parse_uint64(data, data_len, value);
+}
+
+int decimal_bin_size(int precision, int scale)
+{
+  int intg = precision - scale;
+  return (intg / DIGITS_PER_GROUP) * 4 + GROUP_BYTES[intg % DIGITS_PER_GROUP] + (scale / DIGITS_PER_GROUP) * 4 +
+         GROUP_BYTES[scale % DIGITS_PER_GROUP];
+}
+
+bool decimal_to_bin(const char* data, size_t data_len, int precision, int scale, unsigned char* out)
+{
+  if (precision <= 0 || scale < 0 || scale > precision) {
+    return false;
+  }
+
+  // 1. validate [-]digits[.digits] before anything is written
+  const char* end = data + data_len;
+  const char* int_begin = data;
+  uint32_t mask = 0;
+  if (int_begin < end && *int_begin == '-') {
+    mask = ~0U;
+    ++int_begin;
+  }
+  const char* int_end = int_begin + digit_run(int_begin, end);
+  const char* frac_begin = int_end;
+  if (scale > 0) {
+    if (int_end == end || *int_end != '.') {
+      return false;
+    }
+    frac_begin = int_end + 1;
+  }
+  if (int_begin == int_end || end - frac_begin != scale || digit_run(frac_begin, end) != static_cast<size_t>(scale)) {
+    return false;
+  }
+
+  int intg_max = precision - scale;
+  int intg = static_cast<int>(int_end - int_begin);
+  if (intg > intg_max) {
+    // only the zero before the point of a decimal without integer digits, like 0.5 for DECIMAL(1,1)
+    if (intg != 1 || *int_begin != '0') {
+      return false;
+    }
+    int_begin = int_end;
+    intg = 0;
+  }
+
+  // 2. the integer digits right-aligned into groups counted from the point, the leading group being partial
+  unsigned char* pos = out;
+  int pad = intg_max - intg;
+  int group_len = intg_max % DIGITS_PER_GROUP == 0 ? DIGITS_PER_GROUP : intg_max % DIGITS_PER_GROUP;
+  for (int from = 0; from < intg_max; from += group_len, group_len = DIGITS_PER_GROUP) {
+    int first = from > pad ? from : pad;
+    int last = from + group_len;
+    uint32_t value = first < last ? digits_value(int_begin + (first - pad), last - first) : 0;
+    pos = store_group(pos, value ^ mask, GROUP_BYTES[group_len]);
+  }
+
+  // 3. the fractional digits left-aligned into groups, the trailing group being partial
+  for (int from = 0; from < scale; from += DIGITS_PER_GROUP) {
+    int nof_digits = scale - from < DIGITS_PER_GROUP ? scale - from : DIGITS_PER_GROUP;
+    pos = store_group(pos, digits_value(frac_begin + from, nof_digits) ^ mask, GROUP_BYTES[nof_digits]);
+  }
+
+  out[0] ^= 0x80;
+  return true;
+}
+
+}  // namespace oceanbase::binlog
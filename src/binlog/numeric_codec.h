@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief Text to binary kernels for the numeric columns of the binlog converter.
+ *
+ * They work on (data, len) as obcdc hands the values over, without a NUL terminated copy, and parse eight digits at a
+ * time with SWAR arithmetic on one 64-bit word. Each kernel only accepts the canonical text obcdc produces and returns
+ * false for anything else, for which the caller keeps the general conversion of data_type.cpp.
+ */
+
+/*!
+ * @brief Parse an unsigned decimal integer of at most 20 digits.
+ * @return false for an empty value, a non-digit or an overflow
+ */
+bool parse_uint64(const char* data, size_t data_len, uint64_t& value);
+
+/*!
+ * @brief Parse a signed decimal integer into its 64-bit two's complement, the way std::stoull wraps a negative value.
+ */
+bool parse_int_two_complement(const char* data, size_t data_len, uint64_t& value);
+
+/*!
+ * @brief Bytes of a DECIMAL(precision, scale) in the packed binary format of the binlog (decimal2bin).
+ */
+int decimal_bin_size(int precision, int scale);
+
+/*!
+ * @brief Encode a DECIMAL(precision, scale) value straight into its packed binary format.
+ *
+ * The value is [-]digits[.digits] with exactly scale fractional digits and at most precision - scale integer ones,
+ * as obcdc prints decimals.
+ * @param out decimal_bin_size(precision, scale) bytes, untouched if the value is rejected
+ * @return false if the value is not in the canonical form
+ */
+bool decimal_to_bin(const char* data, size_t data_len, int precision, int scale, unsigned char* out);
+
+}  // namespace oceanbase::binlog
@@ -12,12 +12,14 @@
 
 #include "ob_log_event.h"
 
+#include <algorithm>
 #include <utility>
 #include <cstring>
 #include <cassert>
-#include <zlib.h>
+#include <zstd.h>
 
 #include "env.h"
+#include "checksum.h"
 #include "str.h"
 #include "common_util.h"
 #include "guard.hpp"
@@ -161,9 +163,21 @@ void ObLogEvent::set_header(OblogEventHeader* header)
   ObLogEvent::_header = header;
 }
 
+EventArena* ObLogEvent::get_arena() const
+{
+  return _arena;
+}
+
+void ObLogEvent::set_arena(EventArena* arena)
+{
+  _arena = arena;
+}
+
 ObLogEvent::~ObLogEvent()
 {
-  delete (this->get_header());
+  if (_arena == nullptr) {
+    delete (this->get_header());
+  }
 }
 
 bool ObLogEvent::is_filter() const
@@ -206,20 +220,15 @@ void ObLogEvent::set_checksum_flag(uint8_t checksum_flag)
   this->_checksum_flag = checksum_flag;
 }
 
-/**
- *
- * @param buff
- * @param pos
- * @param checksum
- * @return
- *
- * TODO
- */
 size_t ObLogEvent::write_checksum(unsigned char* buff, size_t& pos) const
+{
+  return write_checksum(buff, pos, 0, 0);
+}
+
+size_t ObLogEvent::write_checksum(unsigned char* buff, size_t& pos, uint32_t crc, size_t checksummed) const
 {
   if (_checksum_flag == CRC32) {
-    uint64_t crc = crc32(0L, Z_NULL, 0);
-    crc = crc32(crc, buff, pos);
+    crc = crc32_update(crc, buff + checksummed, pos - checksummed);
     int4store(buff + pos, crc);
     pos += 4;
   }
@@ -267,7 +276,7 @@ FormatDescriptionEvent::FormatDescriptionEvent(std::string server_version, uint6
   this->set_header(common_header);
 }
 
-FormatDescriptionEvent::FormatDescriptionEvent(uint64_t timestamp)
+FormatDescriptionEvent::FormatDescriptionEvent(uint64_t timestamp, int event_types)
     : _header_len(COMMON_HEADER_LENGTH), _server_version(SERVER_VERSION), _version(BINLOG_VERSION)
 {
   // common _header part
@@ -314,9 +323,12 @@ FormatDescriptionEvent::FormatDescriptionEvent(uint64_t timestamp)
       TRANSACTION_CONTEXT_HEADER_LEN,
       VIEW_CHANGE_HEADER_LEN,
       XA_PREPARE_HEADER_LEN,
-      ROWS_HEADER_LEN_V2};
+      ROWS_HEADER_LEN_V2,
+      0 /* TRANSACTION_PAYLOAD_EVENT */};
+  assert(event_types == LOG_EVENT_TYPES || event_types == PAYLOAD_LOG_EVENT_TYPES);
   this->_event_type_header_len.insert(
-      _event_type_header_len.begin(), server_event_header_length, server_event_header_length + ENUM_END_EVENT - 1);
+      _event_type_header_len.begin(), server_event_header_length, server_event_header_length + event_types);
+  this->_event_type_header_len[FORMAT_DESCRIPTION_EVENT - 1] = START_V3_HEADER_LEN + 1 + event_types;
 
   // variable part,only _checksum
   //  this->set_checksum(new ObLogEventChecksumCrc(0));
@@ -455,10 +467,12 @@ void FormatDescriptionEvent::deserialize(unsigned char* buff)
   this->set_header_len(int1load(buff + pos));
   pos += 1;
 
+  // the post-header of this event type counts the entries of the table
+  int event_types = int1load(buff + pos + FORMAT_DESCRIPTION_EVENT - 1) - START_V3_HEADER_LEN - 1;
   std::vector<uint8_t> event_type_header_len;
-  assert(pos + LOG_EVENT_TYPES <= header->get_event_length());
+  assert(event_types >= LOG_EVENT_TYPES && pos + event_types < header->get_event_length());
 
-  for (int i = 0; i < LOG_EVENT_TYPES; ++i) {
+  for (int i = 0; i < event_types; ++i) {
     event_type_header_len.emplace_back(int1load(buff + pos));
     pos += 1;
   }
@@ -1359,6 +1373,11 @@ RowsEvent::RowsEvent(uint64_t table_id, uint16_t flags) : _table_id(table_id), _
 
 size_t RowsEvent::flush_to_buff(unsigned char* buff)
 {
+  // the row images are checksummed chunk by chunk as they are copied, the small sections in between just before them
+  uint32_t crc = 0;
+  uint32_t* crc_state = get_checksum_flag() == CRC32 ? &crc : nullptr;
+  size_t checksummed = 0;
+
   // common _header
   this->get_header()->flush_to_buff(buff);
   size_t pos = COMMON_HEADER_LENGTH;
@@ -1393,8 +1412,12 @@ size_t RowsEvent::flush_to_buff(unsigned char* buff)
     memcpy(buff + pos, this->get_columns_before_bitmaps(), (this->get_width() + 7) / 8);
     pos += (this->get_width() + 7) / 8;
 
-    auto before_row = this->get_before_row();
-    pos = write_rows(buff, pos, before_row, this->get_before_pos());
+    MsgBuf& before_row = this->get_before_row();
+    if (crc_state != nullptr) {
+      crc = crc32_update(crc, buff + checksummed, pos - checksummed);
+    }
+    pos = write_rows(buff, pos, before_row, this->get_before_pos(), crc_state);
+    checksummed = pos;
   }
 
   // shared_images only for PARTIAL_UPDATE_ROWS_EVENT
@@ -1414,12 +1437,16 @@ size_t RowsEvent::flush_to_buff(unsigned char* buff)
     assert(this->get_columns_after_bitmaps() != nullptr);
     memcpy(buff + pos, this->get_columns_after_bitmaps(), (this->get_width() + 7) / 8);
     pos += (this->get_width() + 7) / 8;
-    auto after_row = this->get_after_row();
-    pos = write_rows(buff, pos, after_row, this->get_after_pos());
+    MsgBuf& after_row = this->get_after_row();
+    if (crc_state != nullptr) {
+      crc = crc32_update(crc, buff + checksummed, pos - checksummed);
+    }
+    pos = write_rows(buff, pos, after_row, this->get_after_pos(), crc_state);
+    checksummed = pos;
   }
 
   // add _checksum
-  return write_checksum(buff, pos);
+  return write_checksum(buff, pos, crc, checksummed);
 }
 
 RowsEventType RowsEvent::get_rows_event_type() const
@@ -1458,12 +1485,13 @@ void RowsEvent::set_after_pos(size_t after_pos)
 
 RowsEvent::~RowsEvent()
 {
-  if (_columns_before_bitmaps != nullptr) {
+  // column bitmaps of arena events belong to the arena
+  if (_columns_before_bitmaps != nullptr && get_arena() == nullptr) {
     free(_columns_before_bitmaps);
     _columns_before_bitmaps = nullptr;
   }
 
-  if (_columns_after_bitmaps != nullptr) {
+  if (_columns_after_bitmaps != nullptr && get_arena() == nullptr) {
     free(_columns_after_bitmaps);
     _columns_after_bitmaps = nullptr;
   }
@@ -1769,7 +1797,18 @@ size_t TableMapEvent::flush_to_buff(unsigned char* buff)
 {
   this->get_header()->flush_to_buff(buff);
   size_t pos = COMMON_HEADER_LENGTH;
+  if (_definition != nullptr) {
+    memcpy(buff + pos, _definition->body.data(), _definition->body.size());
+    pos += _definition->body.size();
+  } else {
+    pos += flush_body(buff + pos);
+  }
+  return write_checksum(buff, pos);
+}
 
+size_t TableMapEvent::flush_body(unsigned char* buff)
+{
+  size_t pos = 0;
   int6store(buff + pos, this->get_table_id());
   pos += 6;
 
@@ -1801,8 +1840,47 @@ size_t TableMapEvent::flush_to_buff(unsigned char* buff)
 
   memcpy(buff + pos, this->get_null_bits(), (this->get_column_count() + 7) / 8);
   pos += (this->get_column_count() + 7) / 8;
+  return pos;
+}
 
-  return write_checksum(buff, pos);
+std::shared_ptr<const TableMapDefinition> TableMapEvent::make_definition(uint64_t schema_signature)
+{
+  auto definition = std::make_shared<TableMapDefinition>();
+  definition->table_id = _table_id;
+  definition->schema_signature = schema_signature;
+  definition->flags = _flags;
+  definition->db_name = _db_name;
+  definition->tb_name = _tb_name;
+  definition->column_count = _column_count;
+  definition->metadata_len = _metadata_len;
+
+  size_t body_len = get_header()->get_event_length() - COMMON_HEADER_LENGTH - get_checksum_len();
+  definition->body.resize(body_len);
+  size_t written = flush_body(definition->body.data());
+  assert(written == body_len);
+
+  char metadata_len_bytes[MAX_PACKET_INTEGER_LEN];
+  size_t metadata_len_size = write_lenenc_uint(metadata_len_bytes, MAX_PACKET_INTEGER_LEN, _metadata_len);
+  definition->null_bits_offset = written - (_column_count + 7) / 8;
+  definition->metadata_offset = definition->null_bits_offset - _metadata_len;
+  definition->column_type_offset = definition->metadata_offset - metadata_len_size - _column_count;
+  return definition;
+}
+
+void TableMapEvent::set_definition(std::shared_ptr<const TableMapDefinition> definition)
+{
+  _table_id = definition->table_id;
+  _flags = definition->flags;
+  _db_len = definition->db_name.size();
+  _tb_len = definition->tb_name.size();
+  _column_count = definition->column_count;
+  _metadata_len = definition->metadata_len;
+  // the body is immutable and outlives the event, so the column definitions can be read in place
+  auto* body = const_cast<unsigned char*>(definition->body.data());
+  _column_type = body + definition->column_type_offset;
+  _metadata = body + definition->metadata_offset;
+  _null_bits = body + definition->null_bits_offset;
+  _definition = std::move(definition);
 }
 
 uint64_t TableMapEvent::get_table_id() const
@@ -1827,6 +1905,9 @@ void TableMapEvent::set_flags(uint16_t flags)
 
 std::string TableMapEvent::get_db_name()
 {
+  if (_definition != nullptr) {
+    return _definition->db_name;
+  }
   return _db_name;
 }
 
@@ -1837,6 +1918,9 @@ void TableMapEvent::set_db_name(std::string db_name)
 
 std::string TableMapEvent::get_tb_name()
 {
+  if (_definition != nullptr) {
+    return _definition->tb_name;
+  }
   return _tb_name;
 }
 
@@ -1917,6 +2001,11 @@ void TableMapEvent::set_tb_len(size_t tb_len)
 
 TableMapEvent::~TableMapEvent()
 {
+  // column definitions of arena events belong to the arena, those of cached events to the definition
+  if (get_arena() != nullptr || _definition != nullptr) {
+    return;
+  }
+
   if (_column_type != nullptr) {
     free(_column_type);
   }
@@ -1981,12 +2070,25 @@ std::string TableMapEvent::print_event_info()
   return info.str();
 }
 
-size_t write_rows(unsigned char* buff, size_t pos, MsgBuf& rows, size_t len)
+size_t write_rows(unsigned char* buff, size_t pos, MsgBuf& rows, size_t len, uint32_t* crc)
 {
-  char* temp = static_cast<char*>(malloc(rows.byte_size()));
-  rows.bytes(temp);
-  memcpy(buff + pos, temp, len);
-  free(temp);
+  // copy the chunks straight into the event, a row image converted in one piece is a single memcpy
+  size_t copied = 0;
+  for (const auto& chunk : rows.get_chunks()) {
+    size_t size = std::min(chunk.size(), len - copied);
+    memcpy(buff + pos + copied, chunk.buffer(), size);
+    if (crc != nullptr) {
+      // checksum the chunk while it is still in cache
+      *crc = crc32_update(*crc, buff + pos + copied, size);
+    }
+    copied += size;
+    if (copied == len) {
+      break;
+    }
+  }
+  if (crc != nullptr && copied < len) {
+    *crc = crc32_update(*crc, buff + pos + copied, len - copied);
+  }
   return pos + len;
 }
 
@@ -2036,6 +2138,36 @@ int64_t seek_gtid_event(const std::string& binlog_file, std::vector<GtidLogEvent
         last_xid = xid_event.get_xid();
         break;
       }
+      case TRANSACTION_PAYLOAD_EVENT: {
+        // the xid event of a compressed transaction is inside its payload
+        auto* buffer = static_cast<unsigned char*>(malloc(header.get_event_length()));
+        FreeGuard<unsigned char*> free_guard(buffer);
+        ret = FsUtil::read_file(fp, buffer, pos, header.get_event_length());
+        if (ret != OMS_OK) {
+          OMS_ERROR("Failed to read TRANSACTION_PAYLOAD_EVENT from pos: {}", pos);
+          break;
+        }
+        TransactionPayloadEvent payload_event;
+        payload_event.set_checksum_flag(checksum_flag);
+        payload_event.deserialize(buffer);
+        std::vector<unsigned char> events;
+        if (payload_event.decompress(events) != OMS_OK) {
+          OMS_ERROR("Failed to decompress TRANSACTION_PAYLOAD_EVENT at pos: {}", pos);
+          break;
+        }
+        for (size_t offset = 0; offset + COMMON_HEADER_LENGTH <= events.size();) {
+          OblogEventHeader inner_header;
+          inner_header.deserialize(events.data() + offset);
+          if (inner_header.get_type_code() == XID_EVENT) {
+            XidEvent xid_event;
+            xid_event.set_checksum_flag(checksum_flag);
+            xid_event.deserialize(events.data() + offset);
+            last_xid = xid_event.get_xid();
+          }
+          offset += inner_header.get_event_length();
+        }
+        break;
+      }
       case GTID_LOG_EVENT: {
         auto* buffer = static_cast<unsigned char*>(malloc(header.get_event_length()));
         FreeGuard<unsigned char*> free_guard(buffer);
@@ -2183,6 +2315,12 @@ int seek_events(const std::string& binlog, std::vector<ObLogEvent*>& log_events,
           log_events.emplace_back(previous_gtids_log_event);
           break;
         }
+        case TRANSACTION_PAYLOAD_EVENT: {
+          auto* payload_event = new TransactionPayloadEvent();
+          payload_event->deserialize(event);
+          log_events.emplace_back(payload_event);
+          break;
+        }
         default:
           OMS_STREAM_ERROR << "Unknown event type:" << header.get_type_code();
           break;
@@ -2239,6 +2377,243 @@ std::string HeartbeatEvent::print_event_info()
   return "";
 }
 
+enum TransactionPayloadField {
+  PAYLOAD_HEADER_END_MARK = 0,
+  PAYLOAD_SIZE_FIELD = 1,
+  PAYLOAD_COMPRESSION_TYPE_FIELD = 2,
+  PAYLOAD_UNCOMPRESSED_SIZE_FIELD = 3
+};
+
+static size_t payload_field_len(uint64_t value)
+{
+  return 1 + get_packed_integer(get_packed_integer(value)) + get_packed_integer(value);
+}
+
+static size_t write_payload_field(unsigned char* buff, TransactionPayloadField field, uint64_t value)
+{
+  size_t pos = write_lenenc_uint(reinterpret_cast<char*>(buff), MAX_PACKET_INTEGER_LEN, field);
+  pos += write_lenenc_uint(reinterpret_cast<char*>(buff + pos), MAX_PACKET_INTEGER_LEN, get_packed_integer(value));
+  pos += write_lenenc_uint(reinterpret_cast<char*>(buff + pos), MAX_PACKET_INTEGER_LEN, value);
+  return pos;
+}
+
+static constexpr uint32_t ZSTD_FRAME_MAGIC = 0xFD2FB528;
+// a single segment frame with a 1 byte content size and no checksum
+static constexpr uint8_t ZSTD_RAW_FRAME_DESCRIPTOR = 0x20;
+static constexpr size_t ZSTD_RAW_FRAME_HEADER_LEN = 4 + 1 + 1 + 3;
+
+/*!
+ * @brief Store len bytes as a zstd frame of one raw block, whose content can be rewritten in place afterwards
+ */
+static size_t write_zstd_raw_frame(unsigned char* buff, const unsigned char* content, size_t len)
+{
+  assert(len <= UINT8_MAX);
+  int4store(buff, ZSTD_FRAME_MAGIC);
+  int1store(buff + 4, ZSTD_RAW_FRAME_DESCRIPTOR);
+  int1store(buff + 5, len);
+  // the last block, of type raw
+  int3store(buff + 6, 1 | (len << 3));
+  memcpy(buff + ZSTD_RAW_FRAME_HEADER_LEN, content, len);
+  return ZSTD_RAW_FRAME_HEADER_LEN + len;
+}
+
+// zstd contexts are reused by each thread, creating one costs about as much as compressing a small transaction
+struct ZstdCompressContext {
+  ZSTD_CCtx* ctx = ZSTD_createCCtx();
+
+  ~ZstdCompressContext()
+  {
+    ZSTD_freeCCtx(ctx);
+  }
+};
+
+struct ZstdDecompressContext {
+  ZSTD_DCtx* ctx = ZSTD_createDCtx();
+
+  ~ZstdDecompressContext()
+  {
+    ZSTD_freeDCtx(ctx);
+  }
+};
+
+TransactionPayloadEvent::TransactionPayloadEvent()
+{
+  this->set_header(new OblogEventHeader(TRANSACTION_PAYLOAD_EVENT, 0, 0, 0));
+}
+
+int TransactionPayloadEvent::compress(const std::vector<ObLogEvent*>& events, size_t begin, size_t end, int level)
+{
+  thread_local std::vector<unsigned char> raw;
+  thread_local ZstdCompressContext zstd;
+
+  size_t raw_len = 0;
+  for (size_t i = begin; i < end; ++i) {
+    raw_len += events[i]->get_header()->get_event_length();
+  }
+  raw.resize(raw_len);
+  size_t pos = 0;
+  for (size_t i = begin; i < end; ++i) {
+    OblogEventHeader* header = events[i]->get_header();
+    uint32_t next_position = header->get_next_position();
+    header->set_next_position(0);
+    pos += events[i]->flush_to_buff(raw.data() + pos);
+    header->set_next_position(next_position);
+  }
+  assert(pos == raw_len);
+
+  // the xid is numbered after the checkpoint filter, which runs on the compressed transaction
+  ObLogEvent* last_event = events[end - 1];
+  size_t xid_len = 0;
+  if (last_event->get_header()->get_type_code() == XID_EVENT) {
+    xid_len = last_event->get_header()->get_event_length();
+  }
+  size_t compress_len = raw_len - xid_len;
+  _payload.resize(ZSTD_compressBound(compress_len) + ZSTD_RAW_FRAME_HEADER_LEN + xid_len);
+  size_t compressed = ZSTD_compressCCtx(zstd.ctx, _payload.data(), _payload.size(), raw.data(), compress_len, level);
+  if (ZSTD_isError(compressed)) {
+    OMS_ERROR("Failed to compress transaction payload of {} bytes, error: {}", raw_len, ZSTD_getErrorName(compressed));
+    return OMS_FAILED;
+  }
+  if (xid_len > 0) {
+    _xid_offset = compressed + ZSTD_RAW_FRAME_HEADER_LEN;
+    _xid_checksummed = last_event->get_checksum_flag() == CRC32;
+    compressed += write_zstd_raw_frame(_payload.data() + compressed, raw.data() + compress_len, xid_len);
+  }
+  _payload.resize(compressed);
+  _compression_type = TRANSACTION_COMPRESSION_ZSTD;
+  _uncompressed_size = raw_len;
+
+  OblogEventHeader* header = get_header();
+  header->set_timestamp(events[begin]->get_header()->get_timestamp());
+  header->set_event_length(COMMON_HEADER_LENGTH + fields_len() + _payload.size() + get_checksum_len());
+  return OMS_OK;
+}
+
+void TransactionPayloadEvent::set_xid(uint64_t xid)
+{
+  assert(_xid_offset > 0);
+  unsigned char* xid_event = _payload.data() + _xid_offset;
+  int8store(xid_event + COMMON_HEADER_LENGTH, xid);
+  if (_xid_checksummed) {
+    int4store(xid_event + COMMON_HEADER_LENGTH + 8, crc32_of(xid_event, COMMON_HEADER_LENGTH + 8));
+  }
+}
+
+int TransactionPayloadEvent::decompress(std::vector<unsigned char>& events) const
+{
+  if (_compression_type == TRANSACTION_COMPRESSION_NONE) {
+    events.assign(_payload.begin(), _payload.end());
+    return OMS_OK;
+  }
+  if (_compression_type != TRANSACTION_COMPRESSION_ZSTD) {
+    OMS_ERROR("Unsupported compression type of transaction payload: {}", _compression_type);
+    return OMS_FAILED;
+  }
+
+  thread_local ZstdDecompressContext zstd;
+  events.resize(_uncompressed_size);
+  size_t decompressed = ZSTD_decompressDCtx(zstd.ctx, events.data(), events.size(), _payload.data(), _payload.size());
+  if (ZSTD_isError(decompressed) || decompressed != _uncompressed_size) {
+    OMS_ERROR("Failed to decompress transaction payload of {} bytes, expected: {}, error: {}",
+        _payload.size(),
+        _uncompressed_size,
+        ZSTD_isError(decompressed) ? ZSTD_getErrorName(decompressed) : "size mismatch");
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
+uint8_t TransactionPayloadEvent::get_compression_type() const
+{
+  return _compression_type;
+}
+
+uint64_t TransactionPayloadEvent::get_uncompressed_size() const
+{
+  return _uncompressed_size;
+}
+
+uint64_t TransactionPayloadEvent::get_payload_size() const
+{
+  return _payload.size();
+}
+
+size_t TransactionPayloadEvent::fields_len() const
+{
+  size_t len = payload_field_len(_compression_type) + payload_field_len(_payload.size()) + 1;
+  if (_compression_type != TRANSACTION_COMPRESSION_NONE) {
+    len += payload_field_len(_uncompressed_size);
+  }
+  return len;
+}
+
+size_t TransactionPayloadEvent::flush_to_buff(unsigned char* data)
+{
+  this->get_header()->flush_to_buff(data);
+  size_t pos = COMMON_HEADER_LENGTH;
+
+  // the same field order as MySQL
+  pos += write_payload_field(data + pos, PAYLOAD_COMPRESSION_TYPE_FIELD, _compression_type);
+  if (_compression_type != TRANSACTION_COMPRESSION_NONE) {
+    pos += write_payload_field(data + pos, PAYLOAD_UNCOMPRESSED_SIZE_FIELD, _uncompressed_size);
+  }
+  pos += write_payload_field(data + pos, PAYLOAD_SIZE_FIELD, _payload.size());
+  int1store(data + pos, PAYLOAD_HEADER_END_MARK);
+  pos += 1;
+
+  memcpy(data + pos, _payload.data(), _payload.size());
+  pos += _payload.size();
+  return write_checksum(data, pos);
+}
+
+void TransactionPayloadEvent::deserialize(unsigned char* buff)
+{
+  OblogEventHeader* header = get_header();
+  header->deserialize(buff);
+  uint64_t pos = COMMON_HEADER_LENGTH;
+  uint64_t end = header->get_event_length() - get_checksum_len();
+
+  uint64_t payload_size = 0;
+  while (pos < end) {
+    uint64_t field = get_lenenc_uint(buff, pos);
+    if (field == PAYLOAD_HEADER_END_MARK) {
+      break;
+    }
+    uint64_t value_len = get_lenenc_uint(buff, pos);
+    uint64_t value_pos = pos;
+    switch (field) {
+      case PAYLOAD_SIZE_FIELD:
+        payload_size = get_lenenc_uint(buff, value_pos);
+        break;
+      case PAYLOAD_COMPRESSION_TYPE_FIELD:
+        _compression_type = get_lenenc_uint(buff, value_pos);
+        break;
+      case PAYLOAD_UNCOMPRESSED_SIZE_FIELD:
+        _uncompressed_size = get_lenenc_uint(buff, value_pos);
+        break;
+      default:
+        // fields of later versions are skipped
+        break;
+    }
+    pos += value_len;
+  }
+
+  payload_size = std::min(payload_size, end > pos ? end - pos : 0);
+  _payload.assign(buff + pos, buff + pos + payload_size);
+  if (_compression_type == TRANSACTION_COMPRESSION_NONE) {
+    _uncompressed_size = payload_size;
+  }
+}
+
+std::string TransactionPayloadEvent::print_event_info()
+{
+  std::stringstream info;
+  info << "payload_size=" << _payload.size() << " compression_type="
+       << (_compression_type == TRANSACTION_COMPRESSION_ZSTD ? "ZSTD" : "NONE")
+       << " uncompressed_size=" << _uncompressed_size;
+  return info.str();
+}
+
 int verify_event_checksum(uint64_t start_pos, FILE* fp, bool require_event_existed)
 {
   unsigned char header_buff[COMMON_HEADER_LENGTH];
@@ -2261,8 +2636,7 @@ int verify_event_checksum(uint64_t start_pos, FILE* fp, bool require_event_exist
 
   uint32_t check_sum_pos = header.get_event_length() - 4;
   uint32_t check_sum_read = int4load(buffer + check_sum_pos);
-  uint64_t crc = crc32(0L, Z_NULL, 0);
-  uint32_t check_sum_compute = crc32(crc, buffer, check_sum_pos);
+  uint32_t check_sum_compute = crc32_of(buffer, check_sum_pos);
   if (check_sum_read != check_sum_compute) {
     OMS_ERROR(
         "The checksum [{}] carried by the binlog event from pos [{}] is different from the calculated checksum: {}",
@@ -2332,6 +2706,7 @@ int seek_and_verify_complete_trx(const std::string& binlog_file, BinlogTrxOvervi
         break;
       }
       case EventType::XID_EVENT:
+      case EventType::TRANSACTION_PAYLOAD_EVENT:
       case EventType::QUERY_EVENT: {
         bool is_trx_end = true;
         if (EventType::QUERY_EVENT == header.get_type_code()) {
@@ -14,6 +14,8 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
 #include <cstdint>
 
 #include "oblogevent_type.h"
@@ -25,6 +27,8 @@
 using namespace oceanbase::logproxy;
 
 namespace oceanbase::binlog {
+class EventArena;
+
 #define SERVER_VERSION "5.7.38"
 #define BINLOG_VERSION 4
 #define XID_LEN 8
@@ -55,7 +59,11 @@ namespace oceanbase::binlog {
 
 constexpr uint8_t binlog_magic[4] = {254, 98, 105, 110};
 
-static const int LOG_EVENT_TYPES = (ENUM_END_EVENT - 1);
+// the post-header lengths carried by format description events, which stay at 39 entries so that the start positions
+// of uncompressed binlog files do not move. Compressed binlog files declare TRANSACTION_PAYLOAD_EVENT too, as MySQL
+// rejects the events whose type is beyond the count in the format description event
+static const int LOG_EVENT_TYPES = PARTIAL_UPDATE_ROWS_EVENT;
+static const int PAYLOAD_LOG_EVENT_TYPES = TRANSACTION_PAYLOAD_EVENT;
 
 enum enum_post_header_length {
   QUERY_HEADER_MINIMAL_LEN = (4 + 4 + 1 + 2),
@@ -236,6 +244,11 @@ private:
 class ObLogEvent {
 private:
   OblogEventHeader* _header = nullptr;
+  /*!
+   * Set when the event, its header and its fixed-size buffers live in a per-batch EventArena. Such events are released
+   * by release_event() and never deleted.
+   */
+  EventArena* _arena = nullptr;
   std::string _ob_txn;
 
   uint64_t _checkpoint = 0;
@@ -268,6 +281,10 @@ public:
 
   void set_header(OblogEventHeader* header);
 
+  EventArena* get_arena() const;
+
+  void set_arena(EventArena* arena);
+
   ObLogEvent();
 
   virtual ~ObLogEvent();
@@ -282,6 +299,12 @@ public:
 
   size_t write_checksum(unsigned char* buff, size_t& pos) const;
 
+  /*!
+   * @brief Append the checksum of buff[0, pos), crc being the one of buff[0, checksummed) already computed while
+   * serializing
+   */
+  size_t write_checksum(unsigned char* buff, size_t& pos, uint32_t crc, size_t checksummed) const;
+
   virtual std::string print_event_info() = 0;
 };
 
@@ -309,7 +332,7 @@ public:
   FormatDescriptionEvent(std::string server_version, uint64_t timestamp, uint8_t header_length,
       std::vector<uint8_t> event_type_header_lengths);
 
-  FormatDescriptionEvent(uint64_t timestamp);
+  FormatDescriptionEvent(uint64_t timestamp, int event_types = LOG_EVENT_TYPES);
 
   FormatDescriptionEvent() = default;
 
@@ -777,6 +800,26 @@ private:
 
  */
 
+/*!
+ * @brief Pre-serialized post header and body of a table map event, from table_id to null_bits. It only depends on the
+ * table id and the table schema, so it is built once per schema version and shared by all following table map events
+ * of the table, which then only differ in their common header.
+ */
+struct TableMapDefinition {
+  uint64_t table_id = 0;
+  // table_schema_signature() of the table meta the definition was built from, identifies the schema version
+  uint64_t schema_signature = 0;
+  uint16_t flags = 0;
+  std::string db_name;
+  std::string tb_name;
+  size_t column_count = 0;
+  size_t metadata_len = 0;
+  size_t column_type_offset = 0;
+  size_t metadata_offset = 0;
+  size_t null_bits_offset = 0;
+  std::vector<unsigned char> body;
+};
+
 class TableMapEvent : public ObLogEvent {
 public:
   TableMapEvent() = default;
@@ -829,10 +872,23 @@ public:
 
   void set_tb_len(size_t tb_len);
 
+  /*!
+   * @brief Snapshot the serialized table map of this event, the header must already be set.
+   */
+  std::shared_ptr<const TableMapDefinition> make_definition(uint64_t schema_signature);
+
+  /*!
+   * @brief Take all fields from a cached definition, flush_to_buff then copies the pre-serialized body as is.
+   */
+  void set_definition(std::shared_ptr<const TableMapDefinition> definition);
+
   void deserialize(unsigned char* buff) override;
 
   std::string print_event_info() override;
 
+private:
+  size_t flush_body(unsigned char* buff);
+
 private:
   uint64_t _table_id{};
   uint16_t _flags{};
@@ -848,6 +904,8 @@ private:
   size_t _metadata_len{};
   unsigned char* _metadata = nullptr;
   unsigned char* _null_bits = nullptr;
+  // column definitions point into the cached definition when it is set
+  std::shared_ptr<const TableMapDefinition> _definition;
 };
 
 enum RowsEventType { INSERT, DELETE, UPDATE };
@@ -1090,7 +1148,75 @@ private:
   std::string _binlog_file_name;
 };
 
-size_t write_rows(unsigned char* buff, size_t pos, MsgBuf& rows, size_t len);
+enum TransactionCompressionType { TRANSACTION_COMPRESSION_ZSTD = 0, TRANSACTION_COMPRESSION_NONE = 255 };
+
+/*
++==========================================+
+| variable| header fields             | 每个字段为 lenenc 类型、lenenc 长度、lenenc 值
+| part    +---------------------------+
+|         | compression_type          | 2: 0(ZSTD) 或 255(NONE)
+|         +---------------------------+
+|         | uncompressed_size         | 3: 仅压缩时存在
+|         +---------------------------+
+|         | payload_size              | 1: payload 字节数
+|         +---------------------------+
+|         | end_mark                  | 0
+|         +---------------------------+
+|         | payload                   | 事务内全部事件(next_position 为 0)压缩后的内容
++==========================================+
+ */
+class TransactionPayloadEvent : public ObLogEvent {
+public:
+  TransactionPayloadEvent();
+
+  ~TransactionPayloadEvent() override = default;
+
+  /*!
+   * @brief Serialize events[begin, end) of a transaction, with their next_position set to 0 as MySQL does, and
+   * compress them with zstd. The header takes the timestamp of the first event, its next_position is left to set.
+   * A closing xid event is stored in a raw zstd frame of its own, a slot that set_xid() numbers later.
+   * @return OMS_FAILED if zstd fails
+   */
+  int compress(const std::vector<ObLogEvent*>& events, size_t begin, size_t end, int level);
+
+  /*!
+   * @brief Number the xid event wrapped by the payload, which keeps its size
+   */
+  void set_xid(uint64_t xid);
+
+  /*!
+   * @brief Restore the serialized events wrapped by the payload
+   */
+  int decompress(std::vector<unsigned char>& events) const;
+
+  uint8_t get_compression_type() const;
+
+  uint64_t get_uncompressed_size() const;
+
+  uint64_t get_payload_size() const;
+
+  size_t flush_to_buff(unsigned char* data) override;
+
+  void deserialize(unsigned char* buff) override;
+
+  std::string print_event_info() override;
+
+private:
+  size_t fields_len() const;
+
+private:
+  uint8_t _compression_type = TRANSACTION_COMPRESSION_NONE;
+  uint64_t _uncompressed_size = 0;
+  std::vector<unsigned char> _payload;
+  // the xid event in the payload, if compress() wrapped one
+  size_t _xid_offset = 0;
+  bool _xid_checksummed = false;
+};
+
+/*!
+ * @brief Copy the first len bytes of a row image into buff at pos, extending *crc with them if given
+ */
+size_t write_rows(unsigned char* buff, size_t pos, MsgBuf& rows, size_t len, uint32_t* crc = nullptr);
 
 int64_t seek_gtid_event(const std::string& binlog_file, std::vector<GtidLogEvent*>& gtid_log_events,
     bool& rotate_existed, uint8_t& checksum_flag, uint64_t& last_xid, std::vector<GtidMessage*>& previous_gtid_messages,
@@ -51,6 +51,7 @@ enum EventType {
   VIEW_CHANGE_EVENT = 37,
   XA_PREPARE_LOG_EVENT = 38,
   PARTIAL_UPDATE_ROWS_EVENT = 39,
+  TRANSACTION_PAYLOAD_EVENT = 40,
   ENUM_END_EVENT
 };
 
@@ -87,6 +88,8 @@ inline static std::string event_type_to_str(EventType type)
       return "Previous_gtids";
     case HEARTBEAT_LOG_EVENT:
       return "Heartbeat";
+    case TRANSACTION_PAYLOAD_EVENT:
+      return "Transaction_payload";
     default:
       return "Unknown";
   }
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "pipeline_latency.h"
+
+#include "common_util.h"
+#include "timer.h"
+#include "metric/constant.h"
+
+namespace oceanbase::binlog {
+
+static bool reached(uint64_t file_index, uint64_t position, uint64_t sent_file_index, uint64_t sent_position)
+{
+  return sent_file_index > file_index || (sent_file_index == file_index && sent_position >= position);
+}
+
+void PipelineLatency::mark_persisted(const std::string& file, uint64_t position, uint64_t commit_us)
+{
+  if (commit_us == 0) {
+    return;
+  }
+  uint64_t file_index = CommonUtils::get_binlog_index(file);
+  std::lock_guard<std::mutex> lock(_send_mutex);
+  // nobody is subscribing, keep the latest marks only
+  if (_send_marks.size() >= MAX_SEND_MARKS) {
+    _send_marks.pop_front();
+  }
+  _send_marks.push_back({file_index, position, commit_us});
+  _nof_send_marks.store(_send_marks.size(), std::memory_order_release);
+}
+
+void PipelineLatency::mark_sent(const std::string& file, uint64_t position)
+{
+  if (_nof_send_marks.load(std::memory_order_acquire) == 0) {
+    return;
+  }
+  // the dumper holding the lock takes the marks this one has got past too, or leaves them for the next round
+  std::unique_lock<std::mutex> lock(_send_mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
+  }
+  uint64_t file_index = CommonUtils::get_binlog_index(file);
+  uint64_t now_us = logproxy::Timer::now();
+  while (!_send_marks.empty() &&
+         reached(_send_marks.front().file_index, _send_marks.front().position, file_index, position)) {
+    record(PIPELINE_SEND, _send_marks.front().commit_us, now_us);
+    _send_marks.pop_front();
+  }
+  _nof_send_marks.store(_send_marks.size(), std::memory_order_release);
+}
+
+void PipelineLatency::report(std::vector<uint64_t>& quantiles)
+{
+  quantiles.clear();
+  std::vector<uint64_t> counts;
+  std::lock_guard<std::mutex> lock(_report_mutex);
+  for (int stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+    _histograms[stage].snapshot(counts);
+    std::vector<uint64_t>& reported = _reported[stage];
+    reported.resize(counts.size(), 0);
+    for (size_t i = 0; i < counts.size(); ++i) {
+      std::swap(counts[i], reported[i]);
+      counts[i] = reported[i] - counts[i];
+    }
+    for (const auto& quantile : logproxy::BINLOG_INSTANCE_PIPELINE_QUANTILES) {
+      quantiles.push_back(logproxy::LatencyHistogram::quantile(counts, quantile.second));
+    }
+  }
+}
+
+}  // namespace oceanbase::binlog
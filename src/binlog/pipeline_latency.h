@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "latency_histogram.h"
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief The stages of the binlog pipeline, in the order of BINLOG_INSTANCE_PIPELINE_STAGES
+ */
+enum PipelineStage {
+  // fetched from obcdc by ClogReaderRoutine
+  PIPELINE_FETCH = 0,
+  // converted into binlog events by BinlogEventConvertHandler
+  PIPELINE_CONVERT,
+  // serialized into the batch buffer by SerializeHandler
+  PIPELINE_SERIALIZE,
+  // written to the binlog file, and synced as the sync policy requires, by StorageHandler
+  PIPELINE_PERSIST,
+  // handed to the socket of a subscriber by the first BinlogDumper reaching it
+  PIPELINE_SEND,
+  PIPELINE_STAGE_COUNT
+};
+
+/*!
+ * @brief End-to-end latency of the transactions from their commit on OceanBase to each stage of the pipeline.
+ *
+ * Transactions are timed at their commit record or xid event against their commit timestamp, so a stage costs one
+ * clock read per batch and one relaxed increment per transaction. The events are released once serialized, so the
+ * storage handler leaves a mark with the binlog position of the last transaction of each batch, and the first dumper
+ * that gets past the position takes the mark to record the send latency.
+ */
+class PipelineLatency {
+  OMS_SINGLETON(PipelineLatency);
+  OMS_AVOID_COPY(PipelineLatency);
+
+public:
+  void record(PipelineStage stage, uint64_t commit_us, uint64_t now_us)
+  {
+    if (commit_us > 0) {
+      _histograms[stage].record(now_us > commit_us ? now_us - commit_us : 0);
+    }
+  }
+
+  /*!
+   * @brief Leave a mark for the transaction committed at commit_us that ends at position of the binlog file
+   */
+  void mark_persisted(const std::string& file, uint64_t position, uint64_t commit_us);
+
+  /*!
+   * @brief Record the send latency of the marks a dumper has got past, having sent up to position of the binlog file
+   */
+  void mark_sent(const std::string& file, uint64_t position);
+
+  /*!
+   * @brief The quantiles of BINLOG_INSTANCE_PIPELINE_QUANTILES of each stage in microseconds, stage by stage, over the
+   * transactions recorded since the previous call
+   */
+  void report(std::vector<uint64_t>& quantiles);
+
+  const logproxy::LatencyHistogram& histogram(PipelineStage stage) const
+  {
+    return _histograms[stage];
+  }
+
+private:
+  struct SendMark {
+    uint64_t file_index;
+    uint64_t position;
+    uint64_t commit_us;
+  };
+
+  static const size_t MAX_SEND_MARKS = 4096;
+
+  logproxy::LatencyHistogram _histograms[PIPELINE_STAGE_COUNT];
+
+  std::atomic<size_t> _nof_send_marks{0};
+  std::mutex _send_mutex;
+  std::deque<SendMark> _send_marks;
+
+  std::mutex _report_mutex;
+  std::vector<uint64_t> _reported[PIPELINE_STAGE_COUNT];
+};
+
+}  // namespace oceanbase::binlog
@@ -12,6 +12,8 @@
 
 #include "rate_limiter.h"
 
+#include <algorithm>
+
 #include "log.h"
 
 namespace oceanbase::binlog {
@@ -97,4 +99,19 @@ void EventRateLimiter::in_event_with_alarm(uint32_t event_len)
   }
 }
 
+uint64_t EventRateLimiter::reserve_event(uint32_t event_len)
+{
+  std::unique_lock<std::mutex> unique_lock(this->_mutex);
+  uint64_t micros_to_wait = 0;
+  if (nullptr != _rps_token_bucket) {
+    micros_to_wait = _rps_token_bucket->reserve(1);
+  }
+
+  // both buckets are reserved at once, their waits overlap rather than add up as the sleeps of in_event() do
+  if (nullptr != _iops_token_bucket && event_len > 0) {
+    micros_to_wait = std::max(micros_to_wait, _iops_token_bucket->reserve(event_len));
+  }
+  return micros_to_wait;
+}
+
 }  // namespace oceanbase::binlog
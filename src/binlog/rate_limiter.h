@@ -36,6 +36,12 @@ public:
 
   void in_event_with_alarm(uint32_t event_len);
 
+  /*!
+   * @brief Like in_event(), but leaves the waiting to the caller
+   * @return the microseconds to wait before the next event
+   */
+  uint64_t reserve_event(uint32_t event_len);
+
 private:
   std::mutex _mutex;
   TokenBucket* _rps_token_bucket = nullptr;
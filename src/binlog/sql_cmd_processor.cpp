@@ -367,6 +367,13 @@ IoResult ShowBinlogEventsProcessor::process(Connection* conn, const hsql::SQLSta
           info = previous_gtids_log_event.print_event_info();
           break;
         }
+        case TRANSACTION_PAYLOAD_EVENT: {
+          auto payload_event = TransactionPayloadEvent();
+          payload_event.set_checksum_flag(checksum_flag);
+          payload_event.deserialize(event.get());
+          info = payload_event.print_event_info();
+          break;
+        }
         default:
           OMS_ERROR("{}: Unknown event type: {}", conn->trace_id(), header.get_type_code());
           break;
@@ -2615,18 +2622,31 @@ IoResult ReportProcessor::process(Connection* conn, const hsql::SQLStatement* st
       0};
   ColumnPacket last_checkpoint_purged_column_packet{
       "last_checkpoint_purged", "", BINARY_CS, 8, ColumnType::ct_longlong, ColumnDefinitionFlags::binary_flag, 0};
-  if (conn->send_result_metadata({running_column_packet,
-          convert_delay_column_packet,
-          convert_rps_column_packet,
-          convert_eps_column_packet,
-          convert_iops_column_packet,
-          nof_dump_column_packet,
-          minimum_dump_point_column_packet,
-          gtid_seq_column_packet,
-          last_gtid_purged_column_packet,
-          convert_checkpoint_column_packet,
-          dump_error_count_column_packet,
-          last_checkpoint_purged_column_packet}) != IoResult::SUCCESS) {
+  std::vector<ColumnPacket> column_packets = {running_column_packet,
+      convert_delay_column_packet,
+      convert_rps_column_packet,
+      convert_eps_column_packet,
+      convert_iops_column_packet,
+      nof_dump_column_packet,
+      minimum_dump_point_column_packet,
+      gtid_seq_column_packet,
+      last_gtid_purged_column_packet,
+      convert_checkpoint_column_packet,
+      dump_error_count_column_packet,
+      last_checkpoint_purged_column_packet};
+  // the latency quantiles of each pipeline stage, such as fetch_latency_p99_us
+  for (const auto& stage : BINLOG_INSTANCE_PIPELINE_STAGES) {
+    for (const auto& quantile : BINLOG_INSTANCE_PIPELINE_QUANTILES) {
+      column_packets.emplace_back(stage + "_latency_" + quantile.first + "_us",
+          "",
+          BINARY_CS,
+          20,
+          ColumnType::ct_longlong,
+          ColumnDefinitionFlags::binary_flag | ColumnDefinitionFlags::not_null_flag,
+          0);
+    }
+  }
+  if (conn->send_result_metadata(column_packets) != IoResult::SUCCESS) {
     OMS_ERROR("[report] Failed to send metadata");
     return IoResult::FAIL;
   }
@@ -2667,6 +2687,11 @@ IoResult ReportProcessor::process(Connection* conn, const hsql::SQLStatement* st
   conn->store_uint64(convert_checkpoint);
   conn->store_uint64(g_dumper_manager->get_dump_error_count());
   conn->store_uint64(last_checkpoint_purged);
+  std::vector<uint64_t> latency_quantiles;
+  PipelineLatency::instance().report(latency_quantiles);
+  for (uint64_t latency_us : latency_quantiles) {
+    conn->store_uint64(latency_us);
+  }
   IoResult send_ret = conn->send_row();
   if (send_ret != IoResult::SUCCESS) {
     return send_ret;
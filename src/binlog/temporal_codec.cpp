@@ -0,0 +1,215 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "temporal_codec.h"
+
+#include <cstring>
+
+#include "data_type.h"
+
+namespace oceanbase::binlog {
+
+static constexpr int MAX_PRECISION = 6;
+static constexpr uint32_t POWERS_OF_TEN[MAX_PRECISION + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+// length of YYYY-MM-DD and of YYYY-MM-DD HH:MM:SS
+static constexpr size_t DATE_LEN = 10;
+static constexpr size_t DATETIME_LEN = 19;
+
+// value of exactly nof_digits digits
+static inline bool parse_fixed(const char* pos, int nof_digits, int& value)
+{
+  value = 0;
+  for (int i = 0; i < nof_digits; ++i) {
+    unsigned digit = static_cast<unsigned char>(pos[i]) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + static_cast<int>(digit);
+  }
+  return true;
+}
+
+// nothing, or a '.' with 1 to 6 digits up to the end of the value, as microseconds
+static bool parse_fraction(const char* pos, const char* end, uint32_t& micros)
+{
+  micros = 0;
+  if (pos == end) {
+    return true;
+  }
+  size_t nof_digits = end - pos - 1;
+  if (*pos != '.' || nof_digits == 0 || nof_digits > MAX_PRECISION) {
+    return false;
+  }
+  ++pos;
+  for (size_t i = 0; i < nof_digits; ++i) {
+    unsigned digit = static_cast<unsigned char>(pos[i]) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    micros = micros * 10 + digit;
+  }
+  micros *= POWERS_OF_TEN[MAX_PRECISION - nof_digits];
+  return true;
+}
+
+/*!
+ * @brief The fraction stored for a precision: 2 digits in 1 byte, 4 in 2 or 6 in 3, an odd precision taking the digits
+ * of the next even one.
+ */
+static inline void store_fraction(unsigned char* pos, int precision, uint32_t micros, int sign = 1)
+{
+  int bytes = remainder_bytes(precision);
+  uint32_t value = micros / POWERS_OF_TEN[MAX_PRECISION - 2 * bytes];
+  if (sign < 0) {
+    value = 0 - value;
+  }
+  switch (bytes) {
+    case 1:
+      int1store(pos, value);
+      break;
+    case 2:
+      be_int2store(pos, value);
+      break;
+    case 3:
+      be_int3store(pos, value);
+      break;
+    default:
+      break;
+  }
+}
+
+static inline bool parse_date(const char* pos, int& year, int& month, int& day)
+{
+  return pos[4] == '-' && pos[7] == '-' && parse_fixed(pos, 4, year) && parse_fixed(pos + 5, 2, month) &&
+         parse_fixed(pos + 8, 2, day);
+}
+
+bool date_to_bin(const char* data, size_t data_len, unsigned char* out)
+{
+  int year;
+  int month;
+  int day;
+  if (data_len != DATE_LEN || !parse_date(data, year, month, day)) {
+    return false;
+  }
+  int3store(out, day + month * 32 + year * 16 * 32);
+  return true;
+}
+
+bool datetime_to_bin(const char* data, size_t data_len, int precision, unsigned char* out)
+{
+  if (precision < 0 || precision > MAX_PRECISION) {
+    return false;
+  }
+  const char* end = data + data_len;
+  int sign = 0;
+  if (data < end && *data == '-') {
+    sign = -1;
+    ++data;
+  }
+
+  int year;
+  int month;
+  int day;
+  int hour;
+  int minute;
+  int second;
+  uint32_t micros;
+  if (static_cast<size_t>(end - data) < DATETIME_LEN || !parse_date(data, year, month, day) || data[10] != ' ' ||
+      data[13] != ':' || data[16] != ':' || !parse_fixed(data + 11, 2, hour) || !parse_fixed(data + 14, 2, minute) ||
+      !parse_fixed(data + 17, 2, second) || !parse_fraction(data + DATETIME_LEN, end, micros)) {
+    return false;
+  }
+
+  // the same packing as convert_binlog_datetime
+  uint64_t time = 0;
+  time |= sign;
+  time = ((time << 17) | (year * 13 + month)) << 5;
+  time |= day;
+  time <<= 5;
+  time |= hour;
+  time <<= 6;
+  time |= minute;
+  time <<= 6;
+  time |= second;
+  be_int5store(out, time + TIME_ZERO_FIVE);
+  store_fraction(out + 5, precision, micros);
+  return true;
+}
+
+bool time_to_bin(const char* data, size_t data_len, int precision, unsigned char* out)
+{
+  if (precision < 0 || precision > MAX_PRECISION) {
+    return false;
+  }
+  const char* end = data + data_len;
+  int sign = 1;
+  if (data < end && *data == '-') {
+    sign = -1;
+    ++data;
+  }
+
+  // HH:MM:SS or HHH:MM:SS, up to 838:59:59
+  int hour_len = end - data > 2 && data[2] == ':' ? 2 : 3;
+  int hour;
+  int minute;
+  int second;
+  uint32_t micros;
+  if (end - data < hour_len + 6 || data[hour_len] != ':' || data[hour_len + 3] != ':' ||
+      !parse_fixed(data, hour_len, hour) || !parse_fixed(data + hour_len + 1, 2, minute) ||
+      !parse_fixed(data + hour_len + 4, 2, second) || !parse_fraction(data + hour_len + 6, end, micros)) {
+    return false;
+  }
+
+  // the same packing as convert_binlog_time
+  int64_t time = (static_cast<int64_t>(hour) << 12) | (minute << 6) | second;
+  if (sign < 0) {
+    time = micros == 0 ? -time : -(time + 1);
+  }
+  be_int3store(out, TIME_ZERO_THREE + time);
+  store_fraction(out + 3, precision, micros, sign);
+  return true;
+}
+
+bool timestamp_to_bin(const char* data, size_t data_len, int precision, unsigned char* out)
+{
+  if (precision < 0 || precision > MAX_PRECISION) {
+    return false;
+  }
+  const char* end = data + data_len;
+  const char* point = static_cast<const char*>(memchr(data, '.', data_len));
+  const char* seconds_end = point == nullptr ? end : point;
+
+  // as many digits as atol reads exactly
+  uint64_t seconds = 0;
+  if (seconds_end == data || seconds_end - data > 18) {
+    return false;
+  }
+  for (const char* pos = data; pos < seconds_end; ++pos) {
+    unsigned digit = static_cast<unsigned char>(*pos) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    seconds = seconds * 10 + digit;
+  }
+  uint32_t micros;
+  if (!parse_fraction(seconds_end, end, micros)) {
+    return false;
+  }
+
+  be_int4store(out, seconds);
+  store_fraction(out + 4, precision, micros);
+  return true;
+}
+
+}  // namespace oceanbase::binlog
@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace oceanbase::binlog {
+
+/*!
+ * @brief Single pass parsers of the fixed text layouts obcdc prints temporal values in, packing them straight into
+ * the binlog formats (DATE, DATETIME2, TIME2 and TIMESTAMP2) without splitting the text into strings.
+ *
+ * The fractional seconds may have 1 to 6 digits and are cut or padded to the precision of the column, as
+ * cutout_or_pad_zero does. Each kernel returns false, leaving out untouched, for a layout it does not know or a
+ * precision outside 0 to 6, for which the caller keeps the general conversion of data_type.cpp.
+ */
+
+/*!
+ * @brief YYYY-MM-DD into the 3 bytes of a DATE.
+ */
+bool date_to_bin(const char* data, size_t data_len, unsigned char* out);
+
+/*!
+ * @brief [-]YYYY-MM-DD HH:MM:SS[.fraction] into the 5 + remainder_bytes(precision) bytes of a DATETIME2.
+ */
+bool datetime_to_bin(const char* data, size_t data_len, int precision, unsigned char* out);
+
+/*!
+ * @brief [-]HH:MM:SS[.fraction], with 2 or 3 digits of hours, into the 3 + remainder_bytes(precision) bytes of a TIME2.
+ */
+bool time_to_bin(const char* data, size_t data_len, int precision, unsigned char* out);
+
+/*!
+ * @brief The seconds since the epoch with optional fraction, like 1662034855.000000, into the
+ * 4 + remainder_bytes(precision) bytes of a TIMESTAMP2.
+ *
+ * Signed values, among them the zero date obcdc prints as -9223372022400.000000, are left to the caller.
+ */
+bool timestamp_to_bin(const char* data, size_t data_len, int precision, unsigned char* out);
+
+}  // namespace oceanbase::binlog
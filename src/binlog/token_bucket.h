@@ -34,9 +34,14 @@ public:
 
   double get_rate();
 
-private:
+  /*!
+   * @brief Take the permits without sleeping
+   * @return the microseconds acquire() would have slept
+   */
   uint64_t reserve(uint32_t permits);
 
+private:
+
   uint64_t reserve_and_get_wait_length(uint32_t permits, uint64_t now_micros);
 
 protected:
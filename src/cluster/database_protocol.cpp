@@ -3570,6 +3570,25 @@ void mark_converter_metric(const BinlogEntry& instance, MySQLResultSet& rs)
       instance.tenant_id(),
       BINLOG_INSTANCE_DUMP_ERROR_COUNT_TYPE,
       dump_error_count);
+
+  // the latency quantiles of the pipeline stages follow last_checkpoint_purged
+  size_t latency_field = 12;
+  if (row.fields().size() < latency_field + BINLOG_INSTANCE_PIPELINE_STAGES.size() *
+                                                BINLOG_INSTANCE_PIPELINE_QUANTILES.size()) {
+    return;
+  }
+  for (const auto& stage : BINLOG_INSTANCE_PIPELINE_STAGES) {
+    for (const auto& quantile : BINLOG_INSTANCE_PIPELINE_QUANTILES) {
+      PrometheusExposer::mark_binlog_instance_latency(instance.instance_name(),
+          instance.cluster(),
+          instance.tenant(),
+          instance.cluster_id(),
+          instance.tenant_id(),
+          stage,
+          quantile.first,
+          std::stod(row.fields()[latency_field++].c_str()));
+    }
+  }
 }
 
 void MetricTask::binlog_instance_exploration(ClusterConfig* cluster_config,
@@ -79,10 +79,18 @@ struct BinlogConfig : public Object {
   MODEL_DEF_INT(binlog_serialize_thread_size, 10);
   MODEL_DEF_INT(binlog_serialize_parallel_size, 8);
 
-  // 2 to the Nth power, binlog record release queue size
-  MODEL_DEF_INT(binlog_release_ring_buffer_size, 1024);
-  MODEL_DEF_INT(binlog_release_thread_size, 4);
-  MODEL_DEF_INT(binlog_release_parallel_size, 2);
+  // block size of the per-batch arena that converted events are allocated from
+  MODEL_DEF_UINT32(binlog_convert_arena_block_bytes, 64 * 1024);
+
+  // durability of binlog files: none, interval (fdatasync every binlog_storage_sync_interval_ms) or batch (group
+  // commit, fdatasync before the index is updated)
+  MODEL_DEF_STR(binlog_storage_sync_policy, "none");
+  MODEL_DEF_UINT32(binlog_storage_sync_interval_ms, 1000);
+
+  // wrap each transaction into a zstd compressed Transaction_payload event, as binlog_transaction_compression of MySQL
+  MODEL_DEF_BOOL(binlog_transaction_compression, false);
+  // [1, 22]
+  MODEL_DEF_INT(binlog_transaction_compression_level_zstd, 3);
 
   // pre_allocated_memory_for_each_event
   MODEL_DEF_UINT64(preallocated_memory_bytes, 2 * 1024 * 1024);
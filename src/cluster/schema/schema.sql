@@ -391,15 +391,23 @@ VALUES ('1', 'binlog_serialize_parallel_size', '8', 0, '');
 
 REPLACE
     INTO `config_template` (`version`, `key_name`, `value`, `granularity`, `scope`)
-VALUES ('1', 'binlog_release_ring_buffer_size', '1024', 0, '');
+VALUES ('1', 'binlog_convert_arena_block_bytes', '65536', 0, '');
 
 REPLACE
     INTO `config_template` (`version`, `key_name`, `value`, `granularity`, `scope`)
-VALUES ('1', 'binlog_release_thread_size', '4', 0, '');
+VALUES ('1', 'binlog_storage_sync_policy', 'none', 0, '');
 
 REPLACE
     INTO `config_template` (`version`, `key_name`, `value`, `granularity`, `scope`)
-VALUES ('1', 'binlog_release_parallel_size', '2', 0, '');
+VALUES ('1', 'binlog_storage_sync_interval_ms', '1000', 0, '');
+
+REPLACE
+    INTO `config_template` (`version`, `key_name`, `value`, `granularity`, `scope`)
+VALUES ('1', 'binlog_transaction_compression', 'false', 0, '');
+
+REPLACE
+    INTO `config_template` (`version`, `key_name`, `value`, `granularity`, `scope`)
+VALUES ('1', 'binlog_transaction_compression_level_zstd', '3', 0, '');
 
 REPLACE
     INTO `config_template` (`version`, `key_name`, `value`, `granularity`, `scope`)
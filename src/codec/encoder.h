@@ -58,6 +58,17 @@ public:
   int encode(const Message& msg, MsgBuf& buffer, size_t& raw_len) override;
   static int encode_message(const google::protobuf::Message& pb_msg, MessageType type, MsgBuf& buffer, bool magic);
 
+  // a tag or an int32 takes 10 bytes at most, 4 int32 fields and the tag and length of records
+  static constexpr size_t RECORD_DATA_PREFIX_MAX_SIZE = 6 * 10;
+
+  /*!
+   * @brief Write the fields of RecordData ahead of records of records_size bytes, byte for byte as
+   * RecordData::SerializeToArray does
+   * @return the size written, RECORD_DATA_PREFIX_MAX_SIZE at most
+   */
+  static size_t frame_record_data(char* buffer, int32_t compress_type, int32_t raw_len, int32_t compressed_len,
+      int32_t count, size_t records_size);
+
 private:
   static int encode_error_response(const Message& msg, MsgBuf& buffer);
 
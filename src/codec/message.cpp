@@ -13,9 +13,15 @@
 #include "message.h"
 
 #include <msg_header.h>
+#include <strings.h>
+#include <algorithm>
+#include <memory>
 #include <utility>
+#include <zstd.h>
 #include "msg_buf.h"
 #include "config.h"
+#include "counter.h"
+#include "codec_endian.h"
 #include "lz4.h"
 
 namespace oceanbase {
@@ -34,6 +40,30 @@ bool is_type_available(int8_t type_val)
   return type_val >= -1 && type_val <= 8;
 }
 
+int compress_type_from_str(const std::string& name, CompressType& type)
+{
+  static const std::pair<const char*, CompressType> compress_types[] = {{"plain", CompressType::PLAIN},
+      {"lz4", CompressType::LZ4},
+      {"zstd", CompressType::ZSTD}};
+  for (const auto& compress_type : compress_types) {
+    if (strcasecmp(name.c_str(), compress_type.first) == 0) {
+      type = compress_type.second;
+      return OMS_OK;
+    }
+  }
+  return OMS_FAILED;
+}
+
+// zstd contexts are reused by each encoder thread, as the packets are compressed one after another
+struct ZstdCompressContext {
+  ZSTD_CCtx* ctx = ZSTD_createCCtx();
+
+  ~ZstdCompressContext()
+  {
+    ZSTD_freeCCtx(ctx);
+  }
+};
+
 Message::Message(MessageType type) : _type(type)
 {}
 
@@ -111,22 +141,35 @@ RecordDataMessage::~RecordDataMessage() = default;
 
 int RecordDataMessage::encode_log_records(MsgBuf& buffer, size_t& raw_len) const
 {
+  Timer timer;
+  int ret = OMS_OK;
   switch (compress_type) {
     case CompressType::PLAIN: {
-      int ret = encode_log_records_plain(buffer);
+      ret = encode_log_records_plain(buffer);
       if (ret == OMS_OK) {
         raw_len = buffer.byte_size();
       }
       return ret;
     }
     case CompressType::LZ4: {
-      return encode_log_records_lz4(buffer, raw_len);
+      ret = encode_log_records_lz4(buffer, raw_len);
+      break;
+    }
+    case CompressType::ZSTD: {
+      ret = encode_log_records_zstd(buffer, raw_len);
+      break;
     }
     default: {
       OMS_STREAM_ERROR << "Unsupported compress type: " << (int)compress_type;
       return OMS_FAILED;
     }
   }
+
+  if (ret == OMS_OK) {
+    Counter::instance().count_key(Counter::SENDER_COMPRESS_US, timer.elapsed());
+    Counter::instance().count_compress(raw_len, buffer.byte_size());
+  }
+  return ret;
 }
 
 int RecordDataMessage::encode_log_records_plain(MsgBuf& buffer) const
@@ -234,6 +277,60 @@ int RecordDataMessage::encode_log_records_lz4(MsgBuf& buffer, size_t& raw_len) c
   return OMS_OK;
 }
 
+int RecordDataMessage::encode_log_records_zstd(MsgBuf& buffer, size_t& raw_len) const
+{
+  MsgBuf plain_buffer;
+  int ret = encode_log_records_plain(plain_buffer);
+  if (ret != OMS_OK) {
+    OMS_STREAM_ERROR << "Failed to encode log records(plain) in zstd mode";
+    return ret;
+  }
+  raw_len = plain_buffer.byte_size();
+  if (plain_buffer.count() == 0) {
+    OMS_STREAM_WARN << "No log records";
+    return OMS_OK;
+  }
+
+  const size_t compress_bound = ZSTD_compressBound(raw_len);
+  char* compressed_buffer = (char*)malloc(compress_bound);
+  if (nullptr == compressed_buffer) {
+    OMS_STREAM_ERROR << "Failed to alloc compressed buffer of size:" << compress_bound;
+    return OMS_FAILED;
+  }
+
+  thread_local ZstdCompressContext zstd;
+  ZSTD_CCtx_reset(zstd.ctx, ZSTD_reset_session_only);
+  ZSTD_CCtx_setParameter(zstd.ctx, ZSTD_c_compressionLevel, _s_config.record_compression_level_zstd.val());
+  ZSTD_CCtx_setPledgedSrcSize(zstd.ctx, raw_len);
+
+  // the records are fed as they lie, one frame per packet
+  ZSTD_outBuffer output{compressed_buffer, compress_bound, 0};
+  size_t remaining = 0;
+  for (const auto& chunk : plain_buffer) {
+    ZSTD_inBuffer input{chunk.buffer(), chunk.size(), 0};
+    while (input.pos < input.size && !ZSTD_isError(remaining)) {
+      remaining = ZSTD_compressStream2(zstd.ctx, &output, &input, ZSTD_e_continue);
+    }
+  }
+  ZSTD_inBuffer end{nullptr, 0, 0};
+  do {
+    if (ZSTD_isError(remaining)) {
+      OMS_STREAM_ERROR << "ZSTD compress failed, src size:" << raw_len << ", error:" << ZSTD_getErrorName(remaining);
+      free(compressed_buffer);
+      return OMS_FAILED;
+    }
+    remaining = ZSTD_compressStream2(zstd.ctx, &output, &end, ZSTD_e_end);
+  } while (remaining != 0);
+
+  OMS_STREAM_DEBUG << "Encode client data success with zstd, raw_len:" << raw_len
+                   << ", compressed_size:" << output.pos;
+
+  MsgBuf compressed_message_buffer;
+  compressed_message_buffer.push_back(compressed_buffer, output.pos);
+  buffer.swap(compressed_message_buffer);
+  return OMS_OK;
+}
+
 int RecordDataMessage::decode_log_records(
     CompressType in_compress_type, const char* buffer, size_t buffer_size, size_t raw_len, int expect_count)
 {
@@ -246,6 +343,9 @@ int RecordDataMessage::decode_log_records(
     case CompressType::LZ4: {
       return decode_log_records_lz4(buffer, buffer_size, raw_len, expect_count);
     }
+    case CompressType::ZSTD: {
+      return decode_log_records_zstd(buffer, buffer_size, raw_len, expect_count);
+    }
     default: {
       OMS_STREAM_ERROR << "Unsupported compress type: " << (int)compress_type;
       return OMS_FAILED;
@@ -327,6 +427,32 @@ int RecordDataMessage::decode_log_records_lz4(const char* buffer, size_t buffer_
   return ret;
 }
 
+int RecordDataMessage::decode_log_records_zstd(
+    const char* buffer, size_t buffer_size, size_t raw_size, int expect_count)
+{
+  char* decompressed_buffer = (char*)malloc(raw_size);
+  if (nullptr == decompressed_buffer) {
+    OMS_STREAM_ERROR << "Failed to alloc memory. count=" << raw_size;
+    return OMS_FAILED;
+  }
+
+  size_t decompressed_size = ZSTD_decompress(decompressed_buffer, raw_size, buffer, buffer_size);
+  if (ZSTD_isError(decompressed_size) || decompressed_size != raw_size) {
+    OMS_STREAM_ERROR << "Failed to decompress log record buffer. compressed_size=" << buffer_size
+                     << ". raw_len=" << raw_size << ". zstd decompres return="
+                     << (ZSTD_isError(decompressed_size) ? ZSTD_getErrorName(decompressed_size) : "size mismatch");
+    free(decompressed_buffer);
+    return OMS_FAILED;
+  }
+
+  int ret = decode_log_records_plain(decompressed_buffer, raw_size, expect_count);
+  if (ret != OMS_OK) {
+    OMS_STREAM_ERROR << "Failed to decode log record(plain)";
+  }
+  free(decompressed_buffer);
+  return ret;
+}
+
 GossipPingMessage::GossipPingMessage() : Message(MessageType::GOSSIP_PING_MSG)
 {}
 
@@ -64,8 +64,15 @@ bool is_type_available(int8_t type_val);
 enum class CompressType {
   PLAIN = 0,
   LZ4 = 1,
+  // a zstd frame fed record by record
+  ZSTD = 3,
 };
 
+/*!
+ * @brief Parse the compress type named by a client, one of "plain", "lz4" and "zstd"
+ */
+int compress_type_from_str(const std::string& name, CompressType& type);
+
 enum class PacketError {
   SUCCESS,
   IGNORE,
@@ -254,10 +261,14 @@ protected:
 
   int decode_log_records_lz4(const char* buffer, size_t size, size_t raw_size, int expect_count);
 
+  int decode_log_records_zstd(const char* buffer, size_t size, size_t raw_size, int expect_count);
+
   int encode_log_records_plain(MsgBuf& buffer) const;
 
   int encode_log_records_lz4(MsgBuf& buffer, size_t& raw_len) const;
 
+  int encode_log_records_zstd(MsgBuf& buffer, size_t& raw_len) const;
+
 public:
   CompressType compress_type = CompressType::PLAIN;
   std::vector<ILogRecord*>& records;
@@ -60,15 +60,8 @@ int ProtobufEncoder::encode(const Message& msg, MsgBuf& buffer, size_t& raw_len)
   }
 }
 
-static char* encode_message_header(MessageType type, int packet_size, bool magic)
+static void write_message_header(char* buffer, MessageType type, int packet_size, bool magic)
 {
-  size_t header_len = magic ? PB_PACKET_HEADER_SIZE_MAGIC : PB_PACKET_HEADER_SIZE;
-  char* buffer = (char*)malloc(header_len);
-  if (nullptr == buffer) {
-    OMS_STREAM_ERROR << "Failed to alloc memory for message _header. size=" << header_len;
-    return nullptr;
-  }
-
   int offset = 0;
   if (magic) {
     memcpy(buffer, PACKET_MAGIC, sizeof(PACKET_MAGIC));
@@ -85,6 +78,18 @@ static char* encode_message_header(MessageType type, int packet_size, bool magic
 
   uint32_t pb_packet_size = cpu_to_be((uint32_t)packet_size);
   memcpy(buffer + offset, &pb_packet_size, sizeof(pb_packet_size));
+}
+
+static char* encode_message_header(MessageType type, int packet_size, bool magic)
+{
+  size_t header_len = magic ? PB_PACKET_HEADER_SIZE_MAGIC : PB_PACKET_HEADER_SIZE;
+  char* buffer = (char*)malloc(header_len);
+  if (nullptr == buffer) {
+    OMS_STREAM_ERROR << "Failed to alloc memory for message _header. size=" << header_len;
+    return nullptr;
+  }
+
+  write_message_header(buffer, type, packet_size, magic);
   return buffer;
 }
 
@@ -165,6 +170,46 @@ int ProtobufEncoder::encode_runtime_status(const Message& msg, MsgBuf& buffer, s
   return ret;
 }
 
+// protobuf wire types of the RecordData fields
+static const uint32_t PB_WIRE_TYPE_VARINT = 0;
+static const uint32_t PB_WIRE_TYPE_LENGTH_DELIMITED = 2;
+
+static size_t write_pb_varint(char* buffer, uint64_t value)
+{
+  size_t size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  buffer[size++] = static_cast<char>(value);
+  return size;
+}
+
+static size_t write_pb_int32(char* buffer, int field_number, int32_t value)
+{
+  // proto3 leaves out the fields of default value, and sign extends negative int32 to 64 bits
+  if (value == 0) {
+    return 0;
+  }
+  size_t size = write_pb_varint(buffer, (static_cast<uint32_t>(field_number) << 3) | PB_WIRE_TYPE_VARINT);
+  return size + write_pb_varint(buffer + size, static_cast<uint64_t>(static_cast<int64_t>(value)));
+}
+
+size_t ProtobufEncoder::frame_record_data(char* buffer, int32_t compress_type, int32_t raw_len, int32_t compressed_len,
+    int32_t count, size_t records_size)
+{
+  size_t size = 0;
+  size += write_pb_int32(buffer + size, RecordData::kCompressTypeFieldNumber, compress_type);
+  size += write_pb_int32(buffer + size, RecordData::kRawLenFieldNumber, raw_len);
+  size += write_pb_int32(buffer + size, RecordData::kCompressedLenFieldNumber, compressed_len);
+  size += write_pb_int32(buffer + size, RecordData::kCountFieldNumber, count);
+  if (records_size > 0) {
+    size += write_pb_varint(buffer + size, (RecordData::kRecordsFieldNumber << 3) | PB_WIRE_TYPE_LENGTH_DELIMITED);
+    size += write_pb_varint(buffer + size, records_size);
+  }
+  return size;
+}
+
 int ProtobufEncoder::encode_data_client(const Message& msg, MsgBuf& buffer, size_t& raw_len)
 {
   RecordDataMessage& record_data_message = (RecordDataMessage&)msg;
@@ -174,25 +219,26 @@ int ProtobufEncoder::encode_data_client(const Message& msg, MsgBuf& buffer, size
     OMS_STREAM_ERROR << "Failed to encode log records. ret=" << ret;
     return ret;
   }
+  const size_t records_size = records_buffer.byte_size();
 
-  MsgBufReader records_buffer_reader(records_buffer);
-  const size_t records_size = records_buffer_reader.byte_size();
-
-  std::string pb_record_string(records_size, 0);
-  // FIXME... big data packet copy here due to perf laging
-  ret = records_buffer_reader.read((char*)pb_record_string.c_str(), records_size);
-  if (ret != OMS_OK) {
-    OMS_STREAM_ERROR << "Failed to read buffer from records buffer, size=" << records_size;
+  // RecordData is framed by hand, byte for byte as protobuf serializes it, so that the records are referenced by
+  // the chunks of the buffer rather than copied into a string and then into the serialized message
+  char* header_buffer = (char*)malloc(PB_PACKET_HEADER_SIZE + RECORD_DATA_PREFIX_MAX_SIZE);
+  if (nullptr == header_buffer) {
+    OMS_STREAM_ERROR << "Failed to alloc memory for record data message _header";
     return OMS_FAILED;
   }
+  size_t prefix_size = frame_record_data(header_buffer + PB_PACKET_HEADER_SIZE,
+      (int32_t)record_data_message.compress_type,
+      (int32_t)raw_len,
+      (int32_t)records_size,
+      (int32_t)record_data_message.count(),
+      records_size);
+  write_message_header(header_buffer, record_data_message.type(), (int)(prefix_size + records_size), false);
 
-  RecordData pb_msg;
-  pb_msg.set_records(pb_record_string);
-  pb_msg.set_compress_type((int)record_data_message.compress_type);
-  pb_msg.set_raw_len(raw_len);
-  pb_msg.set_compressed_len(records_size);
-  pb_msg.set_count(record_data_message.count());
-  return encode_message(pb_msg, record_data_message.type(), buffer, false);
+  buffer.push_back(header_buffer, PB_PACKET_HEADER_SIZE + prefix_size);
+  buffer.append(records_buffer);
+  return OMS_OK;
 }
 
 int encode_gossip_ping_msg(const Message& msg, MsgBuf& buffer, size_t& raw_len)
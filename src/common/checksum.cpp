@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "checksum.h"
+
+#include <algorithm>
+#include <zlib.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define OMS_CRC32_PCLMUL 1
+#include <immintrin.h>
+#endif
+
+namespace oceanbase {
+namespace logproxy {
+
+static uint32_t crc32_zlib(uint32_t crc, const unsigned char* data, size_t len)
+{
+  // zlib takes the length as uInt
+  while (len > 0) {
+    auto step = static_cast<uInt>(std::min<size_t>(len, 1U << 30));
+    crc = crc32(crc, data, step);
+    data += step;
+    len -= step;
+  }
+  return crc;
+}
+
+#ifdef OMS_CRC32_PCLMUL
+
+// folding by 4x128 bits needs at least 64 bytes, the kernel takes a multiple of 16 bytes
+static constexpr size_t PCLMUL_MIN_LEN = 64;
+static constexpr size_t PCLMUL_BLOCK_MASK = 15;
+
+/*!
+ * @brief Fold a multiple of 16 bytes, at least 64, with the reflected polynomial 0x1db710641 and Barrett-reduce it
+ * back to 32 bits ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction", Intel, 2009). The crc
+ * in and out is not inverted.
+ */
+__attribute__((target("pclmul,sse4.1"))) static uint32_t crc32_pclmul_fold(
+    uint32_t crc, const unsigned char* data, size_t len)
+{
+  alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+  alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+  alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+  alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+  __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+  __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+  __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+  __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  __m128i x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+  data += 64;
+  len -= 64;
+
+  // four lanes folded by 512 bits each round
+  while (len >= 64) {
+    __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    __m128i x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    __m128i x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    __m128i x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+    data += 64;
+    len -= 64;
+  }
+
+  // the four lanes into one
+  x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+  __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  // the remaining 16 byte blocks
+  while (len >= 16) {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))), x5);
+    data += 16;
+    len -= 16;
+  }
+
+  // 128 bits to 64
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, x3);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits
+  x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+  x2 = _mm_and_si128(x1, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+static uint32_t crc32_pclmul(uint32_t crc, const unsigned char* data, size_t len)
+{
+  if (len >= PCLMUL_MIN_LEN) {
+    size_t folded = len & ~PCLMUL_BLOCK_MASK;
+    crc = ~crc32_pclmul_fold(~crc, data, folded);
+    data += folded;
+    len -= folded;
+  }
+  return len > 0 ? crc32_zlib(crc, data, len) : crc;
+}
+
+#endif
+
+using Crc32Func = uint32_t (*)(uint32_t, const unsigned char*, size_t);
+
+static Crc32Func pick_crc32()
+{
+#ifdef OMS_CRC32_PCLMUL
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+    return crc32_pclmul;
+  }
+#endif
+  return crc32_zlib;
+}
+
+static Crc32Func crc32_func()
+{
+  static const Crc32Func func = pick_crc32();
+  return func;
+}
+
+uint32_t crc32_update(uint32_t crc, const unsigned char* data, size_t len)
+{
+  return crc32_func()(crc, data, len);
+}
+
+const char* crc32_implementation()
+{
+#ifdef OMS_CRC32_PCLMUL
+  if (crc32_func() == crc32_pclmul) {
+    return "pclmul";
+  }
+#endif
+  return "zlib";
+}
+
+}  // namespace logproxy
+}  // namespace oceanbase
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace oceanbase {
+namespace logproxy {
+
+/*!
+ * @brief Extend the CRC32 (the zlib and binlog one) of the bytes before data, 0 being the CRC32 of no byte at all.
+ *
+ * Large buffers are folded with carry-less multiplications when the CPU supports PCLMULQDQ, as detected at the first
+ * call, and the rest goes through zlib. Checksumming a buffer in pieces gives the same result as in one call.
+ */
+uint32_t crc32_update(uint32_t crc, const unsigned char* data, size_t len);
+
+inline uint32_t crc32_of(const unsigned char* data, size_t len)
+{
+  return crc32_update(0, data, len);
+}
+
+/*!
+ * @brief The implementation picked for this CPU, "pclmul" or "zlib"
+ */
+const char* crc32_implementation();
+
+}  // namespace logproxy
+}  // namespace oceanbase
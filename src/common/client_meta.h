@@ -19,6 +19,12 @@
 #include "communication/comm.h"
 #include "codec/message.h"
 
+// the answers of a shared oblogreader to the clients handed over by the arranger: {"event": ..., "id": client id}
+#define CLIENT_EVENT "event"
+#define CLIENT_EVENT_ATTACHED "attached"
+#define CLIENT_EVENT_REJECTED "rejected"
+#define CLIENT_EVENT_DETACHED "detached"
+
 namespace oceanbase::logproxy {
 
 struct ClientMeta : public Void {
@@ -47,6 +47,8 @@ public:
   OMS_CONFIG_UINT16(service_port, 2983);
   OMS_CONFIG_UINT32(encode_threadpool_size, 8);
   OMS_CONFIG_UINT32(encode_queue_size, 20000);
+  // [1, 22], for the clients asking for zstd compressed records
+  OMS_CONFIG_INT32(record_compression_level_zstd, 1);
   OMS_CONFIG_UINT32(max_packet_bytes, 1024 * 1024 * 64);  // 64MB
   OMS_CONFIG_UINT32(command_timeout_s, 10);
   OMS_CONFIG_UINT64(accept_interval_us, 500000);
@@ -81,6 +83,13 @@ public:
   OMS_CONFIG_UINT32(oblogreader_path_retain_hour, 168);  // 7 Days
   OMS_CONFIG_UINT32(oblogreader_lease_s, 300);           // 5 mins
   OMS_CONFIG_UINT32(oblogreader_max_count, 100);
+  // share one oblogreader among the clients of the same cluster whose tables it subscribes
+  OMS_CONFIG_BOOL(oblogreader_fanout, false);
+  // records kept by a shared oblogreader for the clients joining late, the slowest client lags no further behind
+  OMS_CONFIG_UINT32(oblogreader_fanout_log_records, 50000);
+  OMS_CONFIG_UINT32(oblogreader_fanout_attach_timeout_ms, 3000);
+  // a shared oblogreader waits so long for new clients after the last one left
+  OMS_CONFIG_UINT32(oblogreader_fanout_linger_s, 60);
 
   OMS_CONFIG_UINT32(max_cpu_ratio, 0);
   OMS_CONFIG_UINT64(max_mem_quota_mb, 0);
@@ -156,9 +165,19 @@ public:
   OMS_CONFIG_UINT16(binlog_file_name_fill_zeroes_width, 6);          // fill zeroes width for mysql binlog file name
   OMS_CONFIG_UINT64(binlog_heartbeat_interval_us, 100000);           // The interval at which heartbeat events are sent
   OMS_CONFIG_UINT16(binlog_log_heartbeat_interval_times, 10);
+  // Binlog events sent to a dump client are coalesced into writes of up to this size
+  OMS_CONFIG_UINT32(binlog_dump_output_buffer_bytes, 64 * 1024);
+  // Binlog files are read ahead in blocks of this size when dumping
+  OMS_CONFIG_UINT32(binlog_dump_read_buffer_bytes, 2 * 1024 * 1024);
+  // Binlog events of at least this size are dumped with sendfile instead of being copied, 0 means never
+  OMS_CONFIG_UINT32(binlog_dump_zero_copy_min_bytes, 64 * 1024);
+  // Number of event loops shared by all binlog dumps, 0 means a thread per dump
+  OMS_CONFIG_UINT32(binlog_dump_scheduler_threads, 0);
   OMS_CONFIG_BOOL(binlog_ddl_convert, true);
   OMS_CONFIG_BOOL(binlog_ddl_convert_ignore_unsupported_ddl,
       true);  // Ignore unsupported DDL. If set to false, unsupported DDL will also be dropped into the binlog.
+  // Number of incremental DDL conversions kept for DDLs repeating the same text, 0 means convert every DDL
+  OMS_CONFIG_UINT32(binlog_ddl_convert_cache_size, 1024);
   OMS_CONFIG_STR(binlog_memory_limit, "4G");
   OMS_CONFIG_STR(binlog_working_mode, "storage");
 
@@ -245,10 +264,18 @@ public:
   OMS_CONFIG_INT32(binlog_serialize_thread_size, 10);
   OMS_CONFIG_UINT32(binlog_serialize_parallel_size, 8);
 
-  // 2 to the Nth power, binlog record release queue size
-  OMS_CONFIG_INT32(binlog_release_ring_buffer_size, 1024);
-  OMS_CONFIG_INT32(binlog_release_thread_size, 4);
-  OMS_CONFIG_UINT32(binlog_release_parallel_size, 2);
+  // block size of the per-batch arena that converted events are allocated from
+  OMS_CONFIG_UINT32(binlog_convert_arena_block_bytes, 64 * 1024);
+
+  // durability of binlog files: none, interval (fdatasync every binlog_storage_sync_interval_ms) or batch (group
+  // commit, fdatasync before the index is updated)
+  OMS_CONFIG_STR(binlog_storage_sync_policy, "none");
+  OMS_CONFIG_UINT32(binlog_storage_sync_interval_ms, 1000);
+
+  // wrap each transaction into a zstd compressed Transaction_payload event, as binlog_transaction_compression of MySQL
+  OMS_CONFIG_BOOL(binlog_transaction_compression, false);
+  // [1, 22]
+  OMS_CONFIG_INT32(binlog_transaction_compression_level_zstd, 3);
 
   // pre_allocated_memory_for_each_event
   OMS_CONFIG_UINT32(preallocated_memory_bytes, 2 * 1024 * 1024);
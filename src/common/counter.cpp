@@ -41,6 +41,8 @@ void Counter::run()
     uint64_t rio = _read_io.load();
     uint64_t wio = _write_io.load();
     uint64_t xwio = _xwrite_io.load();
+    uint64_t craw = _compress_raw_io.load();
+    uint64_t cio = _compress_io.load();
     uint64_t avg_size = wcount == 0 ? 0 : (wio / wcount);
     uint64_t xavg_size = wcount == 0 ? 0 : (xwio / wcount);
     uint64_t rrps = interval_s == 0 ? rcount : (rcount / interval_s);
@@ -58,10 +60,14 @@ void Counter::run()
     ss << "Counter:[Span:" << interval_ms << "ms][Delay:" << delay << "," << chk_delay << "][RCNT:" << rcount
        << "][RRPS:" << rrps << "][RIOS:" << rios << "][WCNT:" << wcount << "][WRPS:" << _write_rps
        << "][WIOS:" << _write_iops << ",AVG:" << avg_size << "][XWIOS:" << xwios << ",AVG:" << xavg_size << "]";
+    if (cio > 0) {
+      // raw bytes per 100 compressed bytes
+      ss << "[CRATIO:" << craw * 100 / cio << "%]";
+    }
     for (auto& count : _counts) {
       uint64_t c = count.count.load();
       ss << "[" << count.name << ":" << c << "]";
-      count.count.fetch_sub(c);
+      count.count.sub(c);
     }
     for (auto& entry : _gauges) {
       ss << "[" << entry.first << ":" << entry.second() << "]";
@@ -69,12 +75,14 @@ void Counter::run()
     OMS_STREAM_INFO << ss.str();
 
     // sub count that logged
-    _read_count.fetch_sub(rcount);
-    _write_count.fetch_sub(wcount);
-    _convert_count.fetch_sub(ccount);
-    _read_io.fetch_sub(rio);
-    _write_io.fetch_sub(wio);
-    _xwrite_io.fetch_sub(xwio);
+    _read_count.sub(rcount);
+    _write_count.sub(wcount);
+    _convert_count.sub(ccount);
+    _read_io.sub(rio);
+    _write_io.sub(wio);
+    _xwrite_io.sub(xwio);
+    _compress_raw_io.sub(craw);
+    _compress_io.sub(cio);
   }
 
   reset();
@@ -88,32 +96,38 @@ void Counter::register_gauge(const std::string& key, const std::function<int64_t
 
 void Counter::count_read(uint64_t count)
 {
-  _read_count.fetch_add(count);
+  _read_count.add(count);
 }
 
 void Counter::count_write(uint64_t count)
 {
-  _write_count.fetch_add(count);
+  _write_count.add(count);
 }
 
 void Counter::count_read_io(uint64_t bytes)
 {
-  _read_io.fetch_add(bytes);
+  _read_io.add(bytes);
 }
 
 void Counter::count_write_io(uint64_t bytes)
 {
-  _write_io.fetch_add(bytes);
+  _write_io.add(bytes);
 }
 
 void Counter::count_xwrite_io(uint64_t bytes)
 {
-  _xwrite_io.fetch_add(bytes);
+  _xwrite_io.add(bytes);
+}
+
+void Counter::count_compress(uint64_t raw_bytes, uint64_t compressed_bytes)
+{
+  _compress_raw_io.add(raw_bytes);
+  _compress_io.add(compressed_bytes);
 }
 
 void Counter::count_key(Counter::CountKey key, uint64_t count)
 {
-  _counts[key].count.fetch_add(count);
+  _counts[key].count.add(count);
 }
 
 void Counter::mark_timestamp(uint64_t timestamp_us)
@@ -134,7 +148,7 @@ void Counter::mark_checkpoint(uint64_t checkpoint_us)
 
 void Counter::count_convert(uint64_t count)
 {
-  _convert_count.fetch_add(count);
+  _convert_count.add(count);
 }
 
 uint64_t Counter::convert_rps() const
@@ -166,12 +180,14 @@ void Counter::sleep()
 
 void Counter::reset()
 {
-  _read_count = 0;
-  _read_io = 0;
-  _write_count = 0;
-  _write_io = 0;
-  _xwrite_io = 0;
-  _convert_count = 0;
+  _read_count.reset();
+  _read_io.reset();
+  _write_count.reset();
+  _write_io.reset();
+  _xwrite_io.reset();
+  _compress_raw_io.reset();
+  _compress_io.reset();
+  _convert_count.reset();
   // delay
   _count_timestamp_us = 0;
   _checkpoint_us = 0;
@@ -193,29 +209,31 @@ void CounterStatistics::run()
 {
   OMS_INFO("#### Dumper counter thread running, tid: {}", tid());
 
-  std::stringstream ss;
   while (is_run()) {
     _timer.reset();
     this->sleep();
-    int64_t interval_ms = _timer.elapsed() / 1000;
+    report(_timer.elapsed() / 1000);
+  }
 
-    ss.str("");
-    ss << "Counter:[Span:" << interval_ms << "ms]";
+  OMS_INFO("#### Dumper counter thread stop, tid: {}", tid());
+}
 
-    for (auto& entry : _gauges) {
-      if (entry.second != nullptr) {
-        ss << "[" << entry.first << ":" << entry.second() << "]";
-      }
+void CounterStatistics::report(int64_t interval_ms)
+{
+  std::stringstream ss;
+  ss << "Counter:[Span:" << interval_ms << "ms]";
+
+  for (auto& entry : _gauges) {
+    if (entry.second != nullptr) {
+      ss << "[" << entry.first << ":" << entry.second() << "]";
     }
-    for (const auto& s_entry : _str_guages) {
-      if (s_entry.second != nullptr) {
-        ss << "[" << s_entry.first << ":" << s_entry.second() << "]";
-      }
+  }
+  for (const auto& s_entry : _str_guages) {
+    if (s_entry.second != nullptr) {
+      ss << "[" << s_entry.first << ":" << s_entry.second() << "]";
     }
-    OMS_INFO(ss.str());
   }
-
-  OMS_INFO("#### Dumper counter thread stop, tid: {}", tid());
+  OMS_INFO(ss.str());
 }
 
 void CounterStatistics::register_gauge(const std::string& key, const std::function<uint64_t()>& func)
@@ -23,6 +23,7 @@
 #include "thread.h"
 #include "timer.h"
 #include "config.h"
+#include "sharded_counter.h"
 
 namespace oceanbase::logproxy {
 class Counter : public Thread {
@@ -48,6 +49,11 @@ public:
 
   void count_xwrite_io(int bytes);
 
+  /*!
+   * @brief Count the bytes of record packets before and after compression
+   */
+  void count_compress(uint64_t raw_bytes, uint64_t compressed_bytes);
+
   // MUST BE as same order as _counts
   enum CountKey {
     READER_FETCH_US = 0,
@@ -55,6 +61,8 @@ public:
     SENDER_POLL_US = 2,
     SENDER_ENCODE_US = 3,
     SENDER_SEND_US = 4,
+    BINLOG_SYNC_US = 5,
+    SENDER_COMPRESS_US = 6,
   };
 
   void count_key(CountKey key, uint64_t count);
@@ -83,7 +91,7 @@ private:
 private:
   struct CountItem {
     const char* name;
-    std::atomic<uint64_t> count{0};
+    ShardedCounter count;
 
     CountItem(const char* n) : name(n)
     {}
@@ -91,23 +99,26 @@ private:
 
   Timer _timer;
 
-  std::atomic<uint64_t> _read_count{0};
-  std::atomic<uint64_t> _write_count{0};
-  std::atomic<uint64_t> _read_io{0};
-  std::atomic<uint64_t> _write_io{0};
-  std::atomic<uint64_t> _xwrite_io{0};
+  // counted by every reader, convert, serialize and sender thread, sharded to keep them off each other's cache lines
+  ShardedCounter _read_count;
+  ShardedCounter _write_count;
+  ShardedCounter _read_io;
+  ShardedCounter _write_io;
+  ShardedCounter _xwrite_io;
+  ShardedCounter _compress_raw_io;
+  ShardedCounter _compress_io;
   volatile uint64_t _timestamp_us = Timer::now();
   volatile uint64_t _checkpoint_us = _timestamp_us;
   volatile uint64_t _count_timestamp_us = _timestamp_us;
 
-  CountItem _counts[5]{{"RFETCH"}, {"ROFFER"}, {"SPOLL"}, {"SENCODE"}, {"SSEND"}};
+  CountItem _counts[7]{{"RFETCH"}, {"ROFFER"}, {"SPOLL"}, {"SENCODE"}, {"SSEND"}, {"BSYNC"}, {"SCOMPRESS"}};
 
   std::map<std::string, std::function<int64_t()>> _gauges;
 
   std::mutex _sleep_cv_lk;
   std::condition_variable _sleep_cv;
 
-  std::atomic<uint64_t> _convert_count{0};
+  ShardedCounter _convert_count;
   uint64_t _convert_rps = 0;
   uint64_t _write_rps = 0;
   uint64_t _write_iops = 0;
@@ -137,6 +148,12 @@ public:
    */
   void unregister_gauge(const std::string& key);
 
+  /*!
+   * @brief Log the gauges once, for owners that report from a thread of their own instead of starting this one
+   * @param interval_ms span since the previous report
+   */
+  void report(int64_t interval_ms);
+
 private:
   void sleep();
 
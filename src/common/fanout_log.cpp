@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+
+#include <fnmatch.h>
+#include <string>
+
+#include "log.h"
+#include "common.h"
+#include "fanout_log.h"
+
+namespace oceanbase::logproxy {
+
+FanoutLog::FanoutLog(ReleaseFunc release, SerializeFunc serialize)
+    : _release(std::move(release)), _serialize(std::move(serialize))
+{}
+
+FanoutLog::~FanoutLog()
+{
+  clear();
+}
+
+void FanoutLog::init(uint64_t start_us)
+{
+  _start_us = start_us;
+}
+
+void FanoutLog::append(ILogRecord* record)
+{
+  {
+    std::lock_guard<std::mutex> lock(_refs_mutex);
+    _refs[record] = 1;
+  }
+  int type = record->recordType();
+  _entries.push_back({record, record->getTimestamp() * 1000000 + record->getRecordUsec(), type, false});
+  if (type == EBEGIN) {
+    _in_trx = true;
+  } else if (type == ECOMMIT) {
+    _in_trx = false;
+  }
+}
+
+int FanoutLog::seek(Cursor& cursor) const
+{
+  // a cursor starting from now takes the records coming, the rest of the current transaction aside, another one
+  // starts at the first transaction from its timestamp
+  cursor.seq = head();
+  cursor.pending_begin = UINT64_MAX;
+  cursor.skip_trx = _in_trx;
+  if (cursor.start_us == 0) {
+    return OMS_OK;
+  }
+
+  if (_trimmed ? cursor.start_us <= _trimmed_us : cursor.start_us < _start_us) {
+    OMS_WARN("Failed to seek to {}(us), the records kept start after {}(us)",
+        cursor.start_us,
+        _trimmed ? _trimmed_us : _start_us - 1);
+    return OMS_FAILED;
+  }
+  for (uint64_t seq = _begin; seq < head(); ++seq) {
+    const Entry& entry = _entries[seq - _begin];
+    if (entry.timestamp_us >= cursor.start_us &&
+        (entry.type == EBEGIN || entry.type == EDDL || entry.type == HEARTBEAT)) {
+      cursor.seq = seq;
+      cursor.skip_trx = false;
+      break;
+    }
+  }
+  return OMS_OK;
+}
+
+int FanoutLog::take(Cursor& cursor, size_t room, std::vector<ILogRecord*>& taken)
+{
+  size_t count = taken.size();
+  int ret = OMS_OK;
+  while (cursor.seq < head() && taken.size() + 2 <= room) {
+    uint64_t seq = cursor.seq;
+    Entry& entry = _entries[seq - _begin];
+    if (!filter(cursor, seq, entry)) {
+      ++cursor.seq;
+      continue;
+    }
+    if (cursor.pending_begin != UINT64_MAX) {
+      Entry& begin = _entries[cursor.pending_begin - _begin];
+      if (!serialize(begin)) {
+        ret = OMS_FAILED;
+        break;
+      }
+      taken.push_back(begin.record);
+      cursor.pending_begin = UINT64_MAX;
+    }
+    if (!serialize(entry)) {
+      ret = OMS_FAILED;
+      break;
+    }
+    taken.push_back(entry.record);
+    ++cursor.seq;
+  }
+
+  std::lock_guard<std::mutex> lock(_refs_mutex);
+  for (size_t i = count; i < taken.size(); ++i) {
+    ++_refs[taken[i]];
+  }
+  return ret;
+}
+
+void FanoutLog::release(const std::vector<ILogRecord*>& records)
+{
+  std::vector<ILogRecord*> released;
+  {
+    std::lock_guard<std::mutex> lock(_refs_mutex);
+    for (ILogRecord* record : records) {
+      auto ref = _refs.find(record);
+      if (ref == _refs.end()) {
+        OMS_ERROR("Released record not in use: {}", (void*)record);
+        continue;
+      }
+      if (--ref->second == 0) {
+        _refs.erase(ref);
+        released.push_back(record);
+      }
+    }
+  }
+  for (ILogRecord* record : released) {
+    _release(record);
+  }
+}
+
+void FanoutLog::trim(uint64_t bound, uint64_t max_records)
+{
+  std::vector<ILogRecord*> trimmed;
+  while (_entries.size() > max_records && _begin < bound) {
+    const Entry& entry = _entries.front();
+    _trimmed_us = std::max(_trimmed_us, entry.timestamp_us);
+    _trimmed = true;
+    trimmed.push_back(entry.record);
+    _entries.pop_front();
+    ++_begin;
+  }
+  if (!trimmed.empty()) {
+    release(trimmed);
+  }
+}
+
+void FanoutLog::clear()
+{
+  if (!_entries.empty()) {
+    trim(head(), 0);
+  }
+}
+
+size_t FanoutLog::referenced()
+{
+  std::lock_guard<std::mutex> lock(_refs_mutex);
+  return _refs.size();
+}
+
+bool FanoutLog::filter(Cursor& cursor, uint64_t seq, const Entry& entry)
+{
+  switch (entry.type) {
+    case EBEGIN:
+      cursor.skip_trx = entry.timestamp_us < cursor.start_us;
+      cursor.pending_begin = cursor.skip_trx ? UINT64_MAX : seq;
+      return false;
+
+    case ECOMMIT: {
+      // a transaction without any record of the cursor is dropped as a whole
+      bool pass = !cursor.skip_trx && cursor.pending_begin == UINT64_MAX;
+      cursor.skip_trx = false;
+      cursor.pending_begin = UINT64_MAX;
+      return pass;
+    }
+
+    case HEARTBEAT:
+      return entry.timestamp_us >= cursor.start_us;
+
+    default:
+      return !cursor.skip_trx && entry.timestamp_us >= cursor.start_us && match(cursor, entry);
+  }
+}
+
+bool FanoutLog::match(const Cursor& cursor, const Entry& entry)
+{
+  // dbname is "tenant.database"
+  const char* dbname = entry.record->dbname();
+  const char* tbname = entry.record->tbname();
+  std::string tenant(dbname != nullptr ? dbname : "");
+  std::string database;
+  size_t dot = tenant.find('.');
+  if (dot != std::string::npos) {
+    database = tenant.substr(dot + 1);
+    tenant.resize(dot);
+  }
+
+  // the white list is matched as obcdc does, DDLs go to the clients of their database whatever the table
+  for (const TablePattern& white : cursor.table_whites) {
+    if (fnmatch(white.tenant.c_str(), tenant.c_str(), FNM_CASEFOLD) != 0) {
+      continue;
+    }
+    if (entry.type == EDDL && database.empty()) {
+      return true;
+    }
+    if (fnmatch(white.database.c_str(), database.c_str(), FNM_CASEFOLD) != 0) {
+      continue;
+    }
+    if (entry.type == EDDL || fnmatch(white.table.c_str(), tbname != nullptr ? tbname : "", FNM_CASEFOLD) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FanoutLog::serialize(Entry& entry)
+{
+  // serialized once for all the sessions, their senders only read the buffer
+  if (!entry.serialized) {
+    entry.serialized = _serialize(entry.record);
+  }
+  return entry.serialized;
+}
+
+}  // namespace oceanbase::logproxy
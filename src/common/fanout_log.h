@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "log_record.h"
+
+#include "table_rules.h"
+
+namespace oceanbase::logproxy {
+
+/*!
+ * @brief The records of a shared oblogreader kept in memory, read by each client session from its own cursor.
+ *
+ * A record is serialized the first time a session takes it, so that the records no session subscribes are never
+ * serialized. A transaction is passed on to a session only if it holds a record of the session, its BEGIN being held
+ * back until then.
+ *
+ * The log and every session taking a record hold a reference to it, the record is released once they all let it go.
+ * Records are appended, taken and trimmed by a single thread, and let go by any.
+ */
+class FanoutLog {
+public:
+  using ReleaseFunc = std::function<void(ILogRecord*)>;
+  using SerializeFunc = std::function<bool(ILogRecord*)>;
+
+  struct Cursor {
+    std::vector<TablePattern> table_whites;
+    // the records before are not taken, 0 to take the records coming
+    uint64_t start_us = 0;
+
+    // sequence number of the next log entry to look at
+    uint64_t seq = 0;
+    // sequence number of the BEGIN of the current transaction, held back till a record of the session comes
+    uint64_t pending_begin = UINT64_MAX;
+    bool skip_trx = false;
+
+    /*!
+     * @brief The sequence number of the first log entry the cursor is still to take
+     */
+    uint64_t bound() const
+    {
+      return std::min(seq, pending_begin);
+    }
+  };
+
+  FanoutLog(ReleaseFunc release, SerializeFunc serialize);
+
+  ~FanoutLog();
+
+  FanoutLog(const FanoutLog&) = delete;
+  FanoutLog& operator=(const FanoutLog&) = delete;
+
+  /*!
+   * @param start_us the timestamp the reader starts from, none of the records before comes
+   */
+  void init(uint64_t start_us);
+
+  void append(ILogRecord* record);
+
+  /*!
+   * @brief Place the cursor at the first transaction from its start timestamp, or at the head for the records coming,
+   * the rest of the current transaction aside
+   * @return OMS_OK, or OMS_FAILED if the records from the start timestamp are not kept anymore
+   */
+  int seek(Cursor& cursor) const;
+
+  /*!
+   * @brief Take the records of the cursor on, as far as room holds them, each referenced once more
+   * @return OMS_OK, or OMS_FAILED if a record failed to be serialized
+   */
+  int take(Cursor& cursor, size_t room, std::vector<ILogRecord*>& taken);
+
+  /*!
+   * @brief Let go of the records taken, thread safe
+   */
+  void release(const std::vector<ILogRecord*>& records);
+
+  /*!
+   * @brief Drop the entries before bound, beyond the max_records latest ones kept for the sessions joining late
+   */
+  void trim(uint64_t bound, uint64_t max_records);
+
+  /*!
+   * @brief Drop all the entries
+   */
+  void clear();
+
+  /*!
+   * @brief The sequence number of the first entry
+   */
+  uint64_t begin() const
+  {
+    return _begin;
+  }
+
+  /*!
+   * @brief The sequence number of the entry to append next
+   */
+  uint64_t head() const
+  {
+    return _begin + _entries.size();
+  }
+
+  size_t size() const
+  {
+    return _entries.size();
+  }
+
+  /*!
+   * @brief The number of records not released yet
+   */
+  size_t referenced();
+
+private:
+  struct Entry {
+    ILogRecord* record;
+    uint64_t timestamp_us;
+    int type;
+    bool serialized;
+  };
+
+  /*!
+   * @brief Whether the record of the entry goes to the cursor, with its transaction
+   */
+  static bool filter(Cursor& cursor, uint64_t seq, const Entry& entry);
+
+  static bool match(const Cursor& cursor, const Entry& entry);
+
+  bool serialize(Entry& entry);
+
+private:
+  ReleaseFunc _release;
+  SerializeFunc _serialize;
+
+  uint64_t _start_us = 0;
+  // the latest timestamp of the records trimmed
+  uint64_t _trimmed_us = 0;
+  bool _trimmed = false;
+
+  std::deque<Entry> _entries;
+  // sequence number of the first entry
+  uint64_t _begin = 0;
+  // whether the last record appended is within a transaction
+  bool _in_trx = false;
+
+  std::mutex _refs_mutex;
+  std::unordered_map<ILogRecord*, uint32_t> _refs;
+};
+
+}  // namespace oceanbase::logproxy
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace oceanbase {
+namespace logproxy {
+
+/*!
+ * @brief Lock-free histogram of latencies with log-linear buckets, as HdrHistogram lays them out.
+ *
+ * Values below 64 get a bucket each, every power of two above is split into 32 buckets, so a recorded value is
+ * known within 1/32 (3.2%) of itself up to 2^36 (19 hours in microseconds), larger values being clamped. Recording
+ * is a relaxed increment of one of 1024 counters; readers take a snapshot of the counters, and subtract an earlier
+ * snapshot to get the quantiles of an interval.
+ */
+class LatencyHistogram {
+public:
+  static constexpr int SUB_BUCKET_BITS = 5;
+  static constexpr int MAX_VALUE_BITS = 36;
+  static constexpr size_t LINEAR_BUCKETS = size_t(1) << (SUB_BUCKET_BITS + 1);
+  static constexpr size_t BUCKET_COUNT = LINEAR_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKET_BITS - 1) * (LINEAR_BUCKETS / 2);
+  static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+
+  LatencyHistogram() = default;
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void record(uint64_t value)
+  {
+    _buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void snapshot(std::vector<uint64_t>& counts) const
+  {
+    counts.resize(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+      counts[i] = _buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  static size_t bucket_of(uint64_t value)
+  {
+    if (value < LINEAR_BUCKETS) {
+      return value;
+    }
+    value = std::min(value, MAX_VALUE);
+    // the top SUB_BUCKET_BITS + 1 bits of the value, the leading one included, select the bucket within its octave
+    int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    return shift * (LINEAR_BUCKETS / 2) + (value >> shift);
+  }
+
+  /*!
+   * @brief The largest value that falls into the bucket
+   */
+  static uint64_t highest_equivalent(size_t bucket)
+  {
+    if (bucket < LINEAR_BUCKETS) {
+      return bucket;
+    }
+    size_t shift = bucket / (LINEAR_BUCKETS / 2) - 1;
+    uint64_t sub_bucket = bucket - shift * (LINEAR_BUCKETS / 2);
+    return ((sub_bucket + 1) << shift) - 1;
+  }
+
+  /*!
+   * @brief The value below which the fraction q of counts lies, 0 without any count
+   */
+  static uint64_t quantile(const std::vector<uint64_t>& counts, double q)
+  {
+    uint64_t total = 0;
+    for (uint64_t count : counts) {
+      total += count;
+    }
+    if (total == 0) {
+      return 0;
+    }
+    auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+      seen += counts[i];
+      if (seen >= rank) {
+        return highest_equivalent(i);
+      }
+    }
+    return highest_equivalent(counts.size() - 1);
+  }
+
+private:
+  std::atomic<uint64_t> _buckets[BUCKET_COUNT]{};
+};
+
+}  // namespace logproxy
+}  // namespace oceanbase
@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <deque>
+#include <utility>
 #include "log.h"
 #include "codec_endian.h"
 
@@ -117,6 +118,17 @@ public:
     _chunks.emplace_back(nbuf, size, true);
   }
 
+  /*!
+   * @brief Move the chunks of other to the back of this buffer, without copying the data
+   */
+  void append(MsgBuf& other)
+  {
+    for (auto& chunk : other._chunks) {
+      _chunks.push_back(std::move(chunk));
+    }
+    other._chunks.clear();
+  }
+
   void push_front(char* buffer, int size, bool owned = true)
   {
     _chunks.emplace_front(buffer, size, owned);
@@ -28,6 +28,8 @@ public:
   OMS_CONFIG_STR(id, "");
   OMS_CONFIG_STR_K(sys_user, "sys_user", "");
   OMS_CONFIG_STR_K(sys_password, "sys_password", "");
+  // compression of the record packets: plain, lz4 or zstd, lz4 if not given
+  OMS_CONFIG_STR_K(compress_type, "compress_type", "");
 
   // from here to beflow, params use to send to liboblog
   OMS_CONFIG_UINT64_K(start_timestamp, "first_start_timestamp", 0);
@@ -42,6 +44,9 @@ public:
   OMS_CONFIG_STR_K(user, "cluster_user", "");
   OMS_CONFIG_STR_K(password, "cluster_password", "");
   OMS_CONFIG_STR_K(table_whites, "tb_white_list", "");
+  // columns and rows to send of the tables subscribed, applied by the oblogreader, syntax see table_rules.h
+  OMS_CONFIG_STR_K(table_columns, "tb_column_list", "");
+  OMS_CONFIG_STR_K(row_filters, "tb_row_filter", "");
 
   OMS_CONFIG_STR_K(ob_version, "ob_version", "");
 
@@ -0,0 +1,298 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace oceanbase {
+namespace logproxy {
+
+/*!
+ * @brief Bounded lock-free ring with the interface of BlockingQueue, for handing records and events between stages.
+ *
+ * Each slot carries a sequence number telling whether it is free or filled for a given lap (D. Vyukov's bounded MPMC
+ * queue), so that producers and consumers only contend on their own position with a CAS, which is uncontended with a
+ * single producer and a single consumer. offer_n and poll_n claim a run of slots with one CAS.
+ *
+ * A side that finds the ring full (or empty) spins, then yields, and only then parks on a condition variable. The
+ * other side takes the mutex to notify only when somebody is parked, so the fast path never touches a lock.
+ */
+template <typename T>
+class RingQueue {
+public:
+  explicit RingQueue(size_t max_queue_size = S_DEFAULT_MAX_QUEUE_SIZE)
+      : _capacity(std::max<size_t>(max_queue_size, 1)), _cells(new Cell[_capacity])
+  {
+    for (size_t i = 0; i < _capacity; ++i) {
+      _cells[i].seq.store(free_seq(i), std::memory_order_relaxed);
+    }
+  }
+
+  RingQueue(const RingQueue&) = delete;
+  RingQueue& operator=(const RingQueue&) = delete;
+
+  bool offer(const T& element, uint64_t timeout_us)
+  {
+    return offer_n(&element, 1, timeout_us) == 1;
+  }
+
+  /*!
+   * @brief Offer up to count elements in order, waiting at most timeout_us for room for the first one
+   * @return the number of elements offered, the leading ones, 0 on timeout
+   */
+  size_t offer_n(const T* elements, size_t count, uint64_t timeout_us)
+  {
+    size_t offered = wait(_not_full, timeout_us, [&]() { return try_offer_n(elements, count); });
+    if (offered > 0) {
+      wake(_not_empty, offered);
+    }
+    return offered;
+  }
+
+  bool poll(T& element, uint64_t timeout_us)
+  {
+    return poll_n(&element, 1, timeout_us) == 1;
+  }
+
+  /*!
+   * @brief Poll up to count elements, waiting at most timeout_us for the first one
+   * @return the number of elements polled, 0 on timeout
+   */
+  size_t poll_n(T* elements, size_t count, uint64_t timeout_us)
+  {
+    size_t polled = wait(_not_empty, timeout_us, [&]() { return try_poll_n(elements, count); });
+    if (polled > 0) {
+      wake(_not_full, polled);
+    }
+    return polled;
+  }
+
+  /*!
+   * @brief Append up to the spare capacity of elements, as BlockingQueue does
+   */
+  bool poll(std::vector<T>& elements, uint64_t timeout_us)
+  {
+    size_t filled = elements.size();
+    elements.resize(filled + std::max<size_t>(elements.capacity() - filled, 1));
+    size_t polled = poll_n(elements.data() + filled, elements.size() - filled, timeout_us);
+    elements.resize(filled + polled);
+    return polled > 0;
+  }
+
+  /*!
+   * @brief The number of claimed slots, which may be off by the elements being offered or polled at that moment
+   */
+  size_t size(bool safe = true) const
+  {
+    (void)safe;
+    uint64_t dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+    uint64_t enqueue_pos = _enqueue_pos.load(std::memory_order_acquire);
+    return enqueue_pos > dequeue_pos ? std::min<uint64_t>(enqueue_pos - dequeue_pos, _capacity) : 0;
+  }
+
+  size_t capacity() const
+  {
+    return _capacity;
+  }
+
+  void clear()
+  {
+    clear([](T&) {});
+  }
+
+  void clear(std::function<void(T&)> consumer)
+  {
+    T element;
+    size_t cleared = 0;
+    while (try_poll_n(&element, 1) == 1) {
+      if (consumer) {
+        consumer(element);
+      }
+      ++cleared;
+    }
+    if (cleared > 0) {
+      wake(_not_full, cleared);
+    }
+  }
+
+private:
+  static const size_t S_DEFAULT_MAX_QUEUE_SIZE = 60000;
+  static const int S_SPIN_ROUNDS = 256;
+  static const int S_YIELD_ROUNDS = 16;
+  static const size_t S_CACHE_LINE_SIZE = 64;
+
+  struct Cell {
+    std::atomic<uint64_t> seq{0};
+    T value{};
+  };
+
+  struct alignas(S_CACHE_LINE_SIZE) Waiters {
+    std::atomic<uint32_t> count{0};
+    std::mutex mutex;
+    std::condition_variable cond;
+  };
+
+  Cell& cell(uint64_t pos)
+  {
+    return _cells[pos % _capacity];
+  }
+
+  // a slot is free for position pos, or filled with the element of pos; distinct even with a single slot
+  static uint64_t free_seq(uint64_t pos)
+  {
+    return pos << 1;
+  }
+
+  static uint64_t filled_seq(uint64_t pos)
+  {
+    return (pos << 1) | 1;
+  }
+
+  static void cpu_relax()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+  }
+
+  size_t try_offer_n(const T* elements, size_t count)
+  {
+    count = std::min(count, _capacity);
+    uint64_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      size_t claimed = 0;
+      while (claimed < count && cell(pos + claimed).seq.load(std::memory_order_acquire) == free_seq(pos + claimed)) {
+        ++claimed;
+      }
+      if (claimed == 0) {
+        auto diff = static_cast<int64_t>(cell(pos).seq.load(std::memory_order_acquire) - free_seq(pos));
+        if (diff < 0) {
+          // the slot still holds the element of the previous lap
+          return 0;
+        }
+        pos = _enqueue_pos.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (_enqueue_pos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < claimed; ++i) {
+          Cell& slot = cell(pos + i);
+          slot.value = elements[i];
+          slot.seq.store(filled_seq(pos + i), std::memory_order_release);
+        }
+        return claimed;
+      }
+    }
+  }
+
+  size_t try_poll_n(T* elements, size_t count)
+  {
+    count = std::min(count, _capacity);
+    uint64_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      size_t claimed = 0;
+      while (claimed < count && cell(pos + claimed).seq.load(std::memory_order_acquire) == filled_seq(pos + claimed)) {
+        ++claimed;
+      }
+      if (claimed == 0) {
+        auto diff = static_cast<int64_t>(cell(pos).seq.load(std::memory_order_acquire) - filled_seq(pos));
+        if (diff < 0) {
+          // not filled yet
+          return 0;
+        }
+        pos = _dequeue_pos.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (_dequeue_pos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < claimed; ++i) {
+          Cell& slot = cell(pos + i);
+          elements[i] = std::move(slot.value);
+          slot.seq.store(free_seq(pos + i + _capacity), std::memory_order_release);
+        }
+        return claimed;
+      }
+    }
+  }
+
+  template <typename Attempt>
+  size_t wait(Waiters& waiters, uint64_t timeout_us, Attempt&& attempt)
+  {
+    size_t done = attempt();
+    if (done > 0 || timeout_us == 0) {
+      return done;
+    }
+    for (int i = 0; i < S_SPIN_ROUNDS + S_YIELD_ROUNDS; ++i) {
+      if (i < S_SPIN_ROUNDS) {
+        cpu_relax();
+      } else {
+        std::this_thread::yield();
+      }
+      if ((done = attempt()) > 0) {
+        return done;
+      }
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_us);
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(waiters.mutex);
+        waiters.count.fetch_add(1, std::memory_order_relaxed);
+        // pairs with the fence in wake(): either the waker sees us parked, or we see its element
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        done = attempt();
+        if (done == 0) {
+          waiters.cond.wait_until(lock, deadline);
+        }
+        waiters.count.fetch_sub(1, std::memory_order_relaxed);
+      }
+      if (done > 0 || (done = attempt()) > 0 || std::chrono::steady_clock::now() >= deadline) {
+        return done;
+      }
+    }
+  }
+
+  static void wake(Waiters& waiters, size_t count)
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.count.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(waiters.mutex);
+    if (count == 1) {
+      waiters.cond.notify_one();
+    } else {
+      waiters.cond.notify_all();
+    }
+  }
+
+private:
+  const size_t _capacity;
+  std::unique_ptr<Cell[]> _cells;
+  alignas(S_CACHE_LINE_SIZE) std::atomic<uint64_t> _enqueue_pos{0};
+  alignas(S_CACHE_LINE_SIZE) std::atomic<uint64_t> _dequeue_pos{0};
+  Waiters _not_full;
+  Waiters _not_empty;
+};
+
+}  // namespace logproxy
+}  // namespace oceanbase
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace oceanbase {
+namespace logproxy {
+
+/*!
+ * @brief Counter split into cache-line sized shards, for counts bumped by many threads and read now and then.
+ *
+ * Threads are spread over the shards round robin at their first count, so that each one mostly increments a line
+ * nobody else writes to, and load() sums the shards up. There are as many shards as hardware threads, up to 64, so a
+ * shard is shared only when more threads count than there are cores.
+ *
+ * sub() adds the two's complement to the shard of the caller, the sum over all shards stays exact modulo 2^64.
+ */
+class ShardedCounter {
+public:
+  ShardedCounter() : _shards(new Shard[shard_count()])
+  {}
+
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  void add(uint64_t count)
+  {
+    _shards[shard_of_thread()].value.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void sub(uint64_t count)
+  {
+    add(~count + 1);
+  }
+
+  uint64_t load() const
+  {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < shard_count(); ++i) {
+      sum += _shards[i].value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  /*!
+   * @brief Zero the counter, the counts added meanwhile may or may not survive
+   */
+  void reset()
+  {
+    for (size_t i = 0; i < shard_count(); ++i) {
+      _shards[i].value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  static size_t shard_count()
+  {
+    static const size_t count = [] {
+      size_t threads = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, S_MAX_SHARDS);
+      size_t shards = 1;
+      while (shards < threads) {
+        shards <<= 1;
+      }
+      return shards;
+    }();
+    return count;
+  }
+
+private:
+  static constexpr size_t S_MAX_SHARDS = 64;
+  static constexpr size_t S_CACHE_LINE_SIZE = 64;
+
+  struct alignas(S_CACHE_LINE_SIZE) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+
+  static size_t shard_of_thread()
+  {
+    static std::atomic<size_t> next_shard{0};
+    static thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) & (shard_count() - 1);
+    return shard;
+  }
+
+  std::unique_ptr<Shard[]> _shards;
+};
+
+}  // namespace logproxy
+}  // namespace oceanbase
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "logmsg_factory.h"
+
+#include "log.h"
+#include "table_projection.h"
+
+namespace oceanbase::logproxy {
+
+static uint64_t mix_signature(uint64_t signature, uint64_t value)
+{
+  return (signature ^ value) * 0x100000001b3ULL;
+}
+
+static uint64_t mix_signature(uint64_t signature, const char* value)
+{
+  return mix_signature(signature, std::hash<std::string_view>{}(value != nullptr ? value : ""));
+}
+
+uint64_t table_meta_signature(ITableMeta* table_meta)
+{
+  int col_count = table_meta->getColCount();
+  uint64_t signature = mix_signature(0xcbf29ce484222325ULL, col_count);
+  for (int i = 0; i < col_count; ++i) {
+    IColMeta* col_meta = table_meta->getCol(i);
+    signature = mix_signature(signature, col_meta->getName());
+    signature = mix_signature(signature, col_meta->getType());
+    signature = mix_signature(signature, col_meta->isNotNull());
+    signature = mix_signature(signature, col_meta->getLength());
+    signature = mix_signature(signature, col_meta->getPrecision());
+    signature = mix_signature(signature, col_meta->getScale());
+    signature = mix_signature(signature, col_meta->getEncoding());
+  }
+  signature = mix_signature(signature, table_meta->getPKs());
+  signature = mix_signature(signature, table_meta->getUKs());
+  return signature;
+}
+
+void project_columns(ITableMeta* table_meta, const TableColumns& projection, std::vector<int>& columns)
+{
+  columns.clear();
+  int col_count = table_meta->getColCount();
+  std::vector<bool> kept(col_count, false);
+  for (const std::string& column : projection.columns) {
+    int index = table_meta->getColIndex(column.c_str());
+    if (index < 0) {
+      OMS_WARN("Ignored the column: {} not found in table: {}", column, table_meta->getName());
+      continue;
+    }
+    kept[index] = true;
+  }
+  // the keys tell the rows apart for the clients
+  for (const auto* names : {&table_meta->getPKColNames(), &table_meta->getUKColNames()}) {
+    for (const std::string& name : *names) {
+      int index = table_meta->getColIndex(name.c_str());
+      if (index >= 0) {
+        kept[index] = true;
+      }
+    }
+  }
+  for (int i = 0; i < col_count; ++i) {
+    if (kept[i]) {
+      columns.push_back(i);
+    }
+  }
+  if ((int)columns.size() == col_count) {
+    columns.clear();
+  }
+}
+
+static IColMeta* copy_col_meta(IColMeta* col_meta)
+{
+  IColMeta* copy = LogMsgFactory::createColMeta();
+  copy->setName(col_meta->getName());
+  copy->setType(col_meta->getType());
+  copy->setLength(col_meta->getLength());
+  copy->setSigned(col_meta->isSigned());
+  copy->setIsPK(col_meta->isPK());
+  copy->setIsUK(col_meta->isUK());
+  copy->setNotNull(col_meta->isNotNull());
+  copy->setDecimals(col_meta->getDecimals());
+  copy->setRequired(col_meta->getRequired());
+  copy->setPrecision(col_meta->getPrecision());
+  copy->setScale(col_meta->getScale());
+  if (col_meta->getDefault() != nullptr) {
+    copy->setDefault(col_meta->getDefault());
+  }
+  if (col_meta->getEncoding() != nullptr) {
+    copy->setEncoding(col_meta->getEncoding());
+  }
+  StrArray* values = col_meta->getValuesOfEnumSet();
+  if (values != nullptr && values->size() > 0) {
+    std::vector<std::string> copied_values;
+    for (size_t i = 0; i < values->size(); ++i) {
+      const char* value = nullptr;
+      size_t size = 0;
+      values->elementAt(i, value, size);
+      copied_values.emplace_back(value != nullptr ? value : "", value != nullptr ? size : 0);
+    }
+    copy->setValuesOfEnumSet(copied_values);
+  }
+  return copy;
+}
+
+ITableMeta* create_projected_meta(ITableMeta* table_meta, const std::vector<int>& indexes)
+{
+  ITableMeta* projected_meta = LogMsgFactory::createTableMeta();
+  projected_meta->setName(table_meta->getName());
+  projected_meta->setDBMeta(table_meta->getDBMeta());
+  projected_meta->setEncoding(table_meta->getEncoding());
+  projected_meta->setHasPK(table_meta->hasPK());
+  projected_meta->setPKs(table_meta->getPKs());
+  projected_meta->setHasUK(table_meta->hasUK());
+  projected_meta->setUKs(table_meta->getUKs());
+  std::vector<int> pk_indice;
+  for (int index : indexes) {
+    IColMeta* col_meta = table_meta->getCol(index);
+    for (const std::string& name : table_meta->getPKColNames()) {
+      if (name == col_meta->getName()) {
+        pk_indice.push_back(projected_meta->getColCount());
+        break;
+      }
+    }
+    projected_meta->append(col_meta->getName(), copy_col_meta(col_meta));
+  }
+  projected_meta->setPKIndice(pk_indice);
+  return projected_meta;
+}
+
+}  // namespace oceanbase::logproxy
@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "meta_info.h"
+
+#include "table_rules.h"
+
+namespace oceanbase::logproxy {
+
+/**
+ * signature of a table meta as the rules of its table depend on: the names, types, nullability, lengths, precisions,
+ * scales and charsets of its columns in order, and its keys. Rules are looked up by it rather than by the address of
+ * the ITableMeta, which obcdc frees and may hand out again for another table or schema version
+ */
+uint64_t table_meta_signature(ITableMeta* table_meta);
+
+/**
+ * the indexes of the columns of table_meta kept by projection in the order of the table, the primary key and unique
+ * key columns included, empty if all of them are kept
+ */
+void project_columns(ITableMeta* table_meta, const TableColumns& projection, std::vector<int>& columns);
+
+/**
+ * create a table meta of the columns of table_meta at indexes, holding copies of them as it frees the columns it holds,
+ * to be destroyed with LogMsgFactory::destroy()
+ */
+ITableMeta* create_projected_meta(ITableMeta* table_meta, const std::vector<int>& indexes);
+
+}  // namespace oceanbase::logproxy
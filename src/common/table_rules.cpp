@@ -0,0 +1,233 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <fnmatch.h>
+#include <strings.h>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#include "log.h"
+#include "str.h"
+#include "common.h"
+#include "table_rules.h"
+
+namespace oceanbase::logproxy {
+
+// numbers longer are compared as strings
+static const size_t MAX_NUMBER_SIZE = 64;
+
+static bool parse_number(const char* data, size_t size, long double& number)
+{
+  if (size == 0 || size >= MAX_NUMBER_SIZE) {
+    return false;
+  }
+  char buf[MAX_NUMBER_SIZE];
+  memcpy(buf, data, size);
+  buf[size] = '\0';
+
+  char* end = nullptr;
+  errno = 0;
+  number = strtold(buf, &end);
+  return errno == 0 && end == buf + size && !isspace((unsigned char)buf[0]) && std::isfinite(number);
+}
+
+int TablePattern::from(const std::string& str)
+{
+  std::vector<std::string> items;
+  if (split(str, '.', items) != 3 || items[0].empty() || items[1].empty() || items[2].empty()) {
+    return OMS_FAILED;
+  }
+  tenant = items[0];
+  database = items[1];
+  table = items[2];
+  return OMS_OK;
+}
+
+bool TablePattern::match(const char* dbname, const char* tbname) const
+{
+  std::string_view db(dbname != nullptr ? dbname : "");
+  size_t dot = db.find('.');
+  std::string tenant_name(db.substr(0, dot));
+  std::string database_name(dot == std::string_view::npos ? "" : db.substr(dot + 1));
+  return fnmatch(tenant.c_str(), tenant_name.c_str(), FNM_CASEFOLD) == 0 &&
+         fnmatch(database.c_str(), database_name.c_str(), FNM_CASEFOLD) == 0 &&
+         fnmatch(table.c_str(), tbname != nullptr ? tbname : "", FNM_CASEFOLD) == 0;
+}
+
+static bool name_covers(const std::string& pattern, const std::string& other)
+{
+  if (pattern == "*" || strcasecmp(pattern.c_str(), other.c_str()) == 0) {
+    return true;
+  }
+  return other.find_first_of("*?[") == std::string::npos && fnmatch(pattern.c_str(), other.c_str(), FNM_CASEFOLD) == 0;
+}
+
+bool TablePattern::covers(const TablePattern& other) const
+{
+  return name_covers(tenant, other.tenant) && name_covers(database, other.database) &&
+         name_covers(table, other.table);
+}
+
+int RowPredicate::from(const std::string& str)
+{
+  size_t op_pos = str.find_first_of("=!<>");
+  if (op_pos == std::string::npos || op_pos == 0) {
+    return OMS_FAILED;
+  }
+  column = str.substr(0, op_pos);
+
+  size_t value_pos = op_pos + 1;
+  char next = value_pos < str.size() ? str[value_pos] : '\0';
+  switch (str[op_pos]) {
+    case '=':
+      op = CompareOp::EQ;
+      break;
+    case '!':
+      if (next != '=') {
+        return OMS_FAILED;
+      }
+      op = CompareOp::NE;
+      ++value_pos;
+      break;
+    case '<':
+      op = next == '=' ? CompareOp::LE : (next == '>' ? CompareOp::NE : CompareOp::LT);
+      value_pos += next == '=' || next == '>' ? 1 : 0;
+      break;
+    case '>':
+      op = next == '=' ? CompareOp::GE : CompareOp::GT;
+      value_pos += next == '=' ? 1 : 0;
+      break;
+    default:
+      return OMS_FAILED;
+  }
+
+  value = str.substr(value_pos);
+  numeric = parse_number(value.data(), value.size(), number);
+  return OMS_OK;
+}
+
+bool RowPredicate::eval(const char* data, size_t size) const
+{
+  if (data == nullptr) {
+    return false;
+  }
+
+  int cmp;
+  long double col_number = 0;
+  if (numeric && parse_number(data, size, col_number)) {
+    cmp = col_number < number ? -1 : (col_number > number ? 1 : 0);
+  } else {
+    cmp = std::string_view(data, size).compare(value);
+  }
+
+  switch (op) {
+    case CompareOp::EQ:
+      return cmp == 0;
+    case CompareOp::NE:
+      return cmp != 0;
+    case CompareOp::LT:
+      return cmp < 0;
+    case CompareOp::LE:
+      return cmp <= 0;
+    case CompareOp::GT:
+      return cmp > 0;
+    case CompareOp::GE:
+      return cmp >= 0;
+  }
+  return false;
+}
+
+int parse_table_patterns(const std::string& str, std::vector<TablePattern>& patterns)
+{
+  patterns.clear();
+  std::vector<std::string> sections;
+  split(str, '|', sections);
+  for (const std::string& section : sections) {
+    TablePattern pattern;
+    if (pattern.from(section) != OMS_OK) {
+      OMS_STREAM_ERROR << "Failed to parse tb_white_list, invalid syntax:" << section;
+      return OMS_FAILED;
+    }
+    patterns.push_back(std::move(pattern));
+  }
+  return OMS_OK;
+}
+
+/*
+ * split a section of the rules into the tables and the rest, at the first ':'
+ */
+static int split_section(const std::string& section, TablePattern& pattern, std::string& body)
+{
+  std::vector<std::string> items;
+  if (split(section, ':', items, true) != 2 || items[1].empty() || pattern.from(items[0]) != OMS_OK) {
+    return OMS_FAILED;
+  }
+  body = items[1];
+  return OMS_OK;
+}
+
+int parse_table_columns(const std::string& str, std::vector<TableColumns>& rules)
+{
+  rules.clear();
+  std::vector<std::string> sections;
+  split(str, '|', sections);
+  for (const std::string& section : sections) {
+    TableColumns rule;
+    std::string columns;
+    if (split_section(section, rule.pattern, columns) != OMS_OK) {
+      OMS_STREAM_ERROR << "Failed to parse tb_column_list, invalid syntax:" << section;
+      return OMS_FAILED;
+    }
+    split(columns, ',', rule.columns);
+    for (const std::string& column : rule.columns) {
+      if (column.empty()) {
+        OMS_STREAM_ERROR << "Failed to parse tb_column_list, empty column name:" << section;
+        return OMS_FAILED;
+      }
+    }
+    rules.push_back(std::move(rule));
+  }
+  return OMS_OK;
+}
+
+int parse_row_filters(const std::string& str, std::vector<TableRowFilter>& rules)
+{
+  rules.clear();
+  std::vector<std::string> sections;
+  split(str, '|', sections);
+  for (const std::string& section : sections) {
+    TableRowFilter rule;
+    std::string predicates;
+    if (split_section(section, rule.pattern, predicates) != OMS_OK) {
+      OMS_STREAM_ERROR << "Failed to parse tb_row_filter, invalid syntax:" << section;
+      return OMS_FAILED;
+    }
+    std::vector<std::string> items;
+    split(predicates, '&', items);
+    for (const std::string& item : items) {
+      RowPredicate predicate;
+      if (predicate.from(item) != OMS_OK) {
+        OMS_STREAM_ERROR << "Failed to parse tb_row_filter, invalid predicate:" << item;
+        return OMS_FAILED;
+      }
+      rule.predicates.push_back(std::move(predicate));
+    }
+    rules.push_back(std::move(rule));
+  }
+  return OMS_OK;
+}
+
+}  // namespace oceanbase::logproxy
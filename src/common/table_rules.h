@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace oceanbase::logproxy {
+
+/**
+ * the tables a rule applies to, "tenant.database.table" with the wildcards of tb_white_list, case insensitive
+ */
+struct TablePattern {
+  std::string tenant;
+  std::string database;
+  std::string table;
+
+  int from(const std::string& str);
+
+  /**
+   * @param dbname the dbname of a record, "tenant.database"
+   */
+  bool match(const char* dbname, const char* tbname) const;
+
+  /**
+   * whether each table of other is one of this, told apart by the wildcards of this only, so that a pattern of other
+   * holding wildcards is covered by a "*" or by the same pattern
+   */
+  bool covers(const TablePattern& other) const;
+};
+
+/**
+ * parse tb_white_list
+ * @param str syntax: "tenant.db.table|tenant.db.table"
+ */
+int parse_table_patterns(const std::string& str, std::vector<TablePattern>& patterns);
+
+/**
+ * the columns to send of the tables of pattern, the primary key and unique key columns are sent anyway
+ */
+struct TableColumns {
+  TablePattern pattern;
+  std::vector<std::string> columns;
+};
+
+enum class CompareOp { EQ, NE, LT, LE, GT, GE };
+
+struct RowPredicate {
+  std::string column;
+  CompareOp op = CompareOp::EQ;
+  std::string value;
+  // the value compares as a number to the column values that are numbers too, as a string otherwise
+  bool numeric = false;
+  long double number = 0;
+
+  int from(const std::string& str);
+
+  /**
+   * @param data the column value, nullptr for NULL, which satisfies no predicate
+   */
+  bool eval(const char* data, size_t size) const;
+};
+
+/**
+ * the rows to send of the tables of pattern, those satisfying all the predicates
+ */
+struct TableRowFilter {
+  TablePattern pattern;
+  std::vector<RowPredicate> predicates;
+};
+
+/**
+ * parse tb_column_list
+ * @param str syntax: "tenant.db.table:col1,col2|tenant.db.table:col3"
+ */
+int parse_table_columns(const std::string& str, std::vector<TableColumns>& rules);
+
+/**
+ * parse tb_row_filter, the operators are = != <> < <= > >=, the values can not hold blanks
+ * @param str syntax: "tenant.db.table:col1=v1&col2>=v2|tenant.db.table:col3!=v3"
+ */
+int parse_row_filters(const std::string& str, std::vector<TableRowFilter>& rules);
+
+}  // namespace oceanbase::logproxy
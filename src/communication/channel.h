@@ -14,6 +14,7 @@
 
 #include <string>
 #include <atomic>
+#include <sys/uio.h>
 
 #include <openssl/ssl.h>
 #include <event2/event_struct.h>
@@ -82,6 +83,21 @@ public:
    */
   virtual int writen(const char* buf, int size) = 0;
 
+  /**
+   * write all the buffers of iov into the channel, which may advance iov past the bytes written
+   * @return OMS_OK all the bytes have been written into the channel
+   *         OMS_FAILED some errors occurs
+   */
+  virtual int writevn(struct iovec* iov, int iovcnt)
+  {
+    for (int i = 0; i < iovcnt; ++i) {
+      if (OMS_OK != writen(static_cast<const char*>(iov[i].iov_base), (int)iov[i].iov_len)) {
+        return OMS_FAILED;
+      }
+    }
+    return OMS_OK;
+  }
+
   /**
    * Get the last error message.
    * It will use the errno internal.
@@ -142,6 +158,7 @@ public:
   int readn(char* buf, int size) override;
   int write(const char* buf, int size) override;
   int writen(const char* buf, int size) override;
+  int writevn(struct iovec* iov, int iovcnt) override;
 
   const char* last_error() override;
 };
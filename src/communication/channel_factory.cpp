@@ -65,6 +65,7 @@ int ChannelFactory::init(const Config& config)
 
 Channel& ChannelFactory::fetch(uint64_t id)
 {
+  const std::lock_guard<std::mutex> lock_guard(_lock);
   auto iter = _channels.find(id);
   if (iter == _channels.end()) {
     return _dummy;
@@ -74,12 +75,12 @@ Channel& ChannelFactory::fetch(uint64_t id)
 
 Channel& ChannelFactory::add(uint64_t id, const Peer& peer)
 {
-  //  const std::lock_guard<std::mutex> lock_guard(_lock);
-
-  auto iter = _channels.find(id);
-  if (iter != _channels.end()) {
-    OMS_STREAM_ERROR << "Duplicate channel with id: " << id;
-    return _dummy;
+  {
+    const std::lock_guard<std::mutex> lock_guard(_lock);
+    if (_channels.find(id) != _channels.end()) {
+      OMS_STREAM_ERROR << "Duplicate channel with id: " << id;
+      return _dummy;
+    }
   }
 
   Channel* ch = _s_creator(peer);
@@ -87,12 +88,20 @@ Channel& ChannelFactory::add(uint64_t id, const Peer& peer)
     OMS_STREAM_ERROR << "Failed to allocate Channel memory";
     return _dummy;
   }
-  _channels.emplace(id, ch);
 
+  // the tls handshake may take a while, the other threads go on with their channels meanwhile
   int ret = _is_server_mode ? ch->after_accept() : ch->after_connect();
   if (ret != OMS_OK) {
     delete ch;
-    _channels.erase(id);
+    return _dummy;
+  }
+
+  const std::lock_guard<std::mutex> lock_guard(_lock);
+  if (!_channels.emplace(id, ch).second) {
+    OMS_STREAM_ERROR << "Duplicate channel with id: " << id;
+    // the fd is the one of the channel added meanwhile
+    ch->disable_owned_fd();
+    delete ch;
     return _dummy;
   }
   return *ch;
@@ -100,6 +109,7 @@ Channel& ChannelFactory::add(uint64_t id, const Peer& peer)
 
 void ChannelFactory::del(const Channel& channel)
 {
+  const std::lock_guard<std::mutex> lock_guard(_lock);
   auto iter = _channels.find(channel.peer().id());
   if (iter != _channels.end()) {
     delete iter->second;
@@ -107,15 +117,21 @@ void ChannelFactory::del(const Channel& channel)
   }
 }
 
-void ChannelFactory::clear(int reserved_fd)
+void ChannelFactory::clear(int reserved_fd, const Comm* communicator)
 {
-  for (auto& channel : _channels) {
-    if (reserved_fd != 0 && channel.second != nullptr && channel.second->peer().fd == reserved_fd) {
-      channel.second->disable_owned_fd();
+  const std::lock_guard<std::mutex> lock_guard(_lock);
+  for (auto iter = _channels.begin(); iter != _channels.end();) {
+    Channel* channel = iter->second;
+    if (communicator != nullptr && channel != nullptr && channel->communicator() != communicator) {
+      ++iter;
+      continue;
+    }
+    if (reserved_fd != 0 && channel != nullptr && channel->peer().fd == reserved_fd) {
+      channel->disable_owned_fd();
     }
-    delete channel.second;
+    delete channel;
+    iter = _channels.erase(iter);
   }
-  _channels.clear();
 }
 
 }  // namespace logproxy
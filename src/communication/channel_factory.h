@@ -38,16 +38,23 @@ public:
 
   void del(const Channel&);
 
-  void clear(int reserved_fd = 0);
+  /**
+   * delete the channels added by communicator, or all of them if it is null
+   * @param reserved_fd the fd of the channel to delete without closing it
+   */
+  void clear(int reserved_fd = 0, const Comm* communicator = nullptr);
 
   inline size_t size()
   {
+    const std::lock_guard<std::mutex> lock_guard(_lock);
     return _channels.size();
   }
 
 private:
   bool _is_server_mode = true;
 
+  // the senders of a shared oblogreader add and delete the channels of their clients each from its own thread
+  std::mutex _lock;
   std::unordered_map<uint64_t, Channel*> _channels;
 
   static std::string _s_channel_type;
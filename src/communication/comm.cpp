@@ -15,6 +15,8 @@
 #include <arpa/inet.h>
 #include <deque>
 #include <fcntl.h>
+#include <climits>
+#include <sys/uio.h>
 
 #include "communication/comm.h"
 #include "communication/io.h"
@@ -53,7 +55,8 @@ Comm::~Comm()
 int Comm::stop(int reserved_fd)
 {
   close_listen();
-  _channel_factory.clear(reserved_fd);
+  // leave alone the channels of the other communicators of the process, if any
+  _channel_factory.clear(reserved_fd, this);
 
   if (_event_base == nullptr) {
     OMS_STREAM_INFO << "communication not started";
@@ -381,24 +384,63 @@ int Comm::write_message(Channel& ch, const Message& msg)
                     << ", msg type: " << (int)msg.type();
   }
 
-  _stage_timer.reset();
   size_t raw_len = 0;
   MsgBuf buffer;
+  int ret = encode_message(msg, buffer, raw_len);
+  if (ret != OMS_OK) {
+    return ret;
+  }
+  return write_encoded(ch, buffer, raw_len);
+}
+
+int Comm::encode_message(const Message& msg, MsgBuf& buffer, size_t& raw_len)
+{
+  Timer timer;
   int ret = _s_encoders[(uint16_t)msg.version()]->encode(msg, buffer, raw_len);
   if (ret != OMS_OK) {
     OMS_STREAM_ERROR << "Encoding message failed";
     return ret;
   }
 
-  Counter::instance().count_key(Counter::SENDER_ENCODE_US, _stage_timer.stopwatch());
+  Counter::instance().count_key(Counter::SENDER_ENCODE_US, timer.elapsed());
+  return OMS_OK;
+}
 
+int Comm::send_encoded(const Peer& peer, const MsgBuf& buffer, size_t raw_len)
+{
+  Channel& ch = _channel_factory.fetch(peer.id());
+  if (!ch.ok()) {
+    OMS_STREAM_ERROR << "Not found channel of peer:" << peer.to_string() << ", just close it";
+    return OMS_FAILED;
+  }
+  return write_encoded(ch, buffer, raw_len);
+}
+
+int Comm::write_encoded(Channel& ch, const MsgBuf& buffer, size_t raw_len)
+{
+  _stage_timer.reset();
+  // the chunks go out by a single writev, or one per IOV_MAX chunks of plain records
+  struct iovec iov[IOV_MAX];
+  int iovcnt = 0;
   size_t wsize = 0;
   for (const auto& chunk : buffer) {
-    if (OMS_OK != ch.writen(chunk.buffer(), chunk.size())) {
-      OMS_STREAM_ERROR << "Failed to send message through channel:" << ch.peer().id() << ", error:" << ch.last_error();
-      return OMS_FAILED;
+    if (chunk.size() == 0) {
+      continue;
     }
+    iov[iovcnt++] = {chunk.buffer(), chunk.size()};
     wsize += chunk.size();
+    if (iovcnt == IOV_MAX) {
+      if (OMS_OK != ch.writevn(iov, iovcnt)) {
+        OMS_STREAM_ERROR << "Failed to send message through channel:" << ch.peer().id()
+                         << ", error:" << ch.last_error();
+        return OMS_FAILED;
+      }
+      iovcnt = 0;
+    }
+  }
+  if (iovcnt > 0 && OMS_OK != ch.writevn(iov, iovcnt)) {
+    OMS_STREAM_ERROR << "Failed to send message through channel:" << ch.peer().id() << ", error:" << ch.last_error();
+    return OMS_FAILED;
   }
 
   Counter::instance().count_key(Counter::SENDER_SEND_US, _stage_timer.elapsed());
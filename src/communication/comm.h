@@ -60,6 +60,18 @@ public:
 
   int write_message(Channel& ch, const Message&);
 
+  /*!
+   * @brief Encode msg into buffer without touching any channel, so that it may run on any thread
+   */
+  static int encode_message(const Message& msg, MsgBuf& buffer, size_t& raw_len);
+
+  /*!
+   * @brief Write a message encoded by encode_message() to the channel of peer
+   */
+  int send_encoded(const Peer& peer, const MsgBuf& buffer, size_t raw_len);
+
+  int write_encoded(Channel& ch, const MsgBuf& buffer, size_t raw_len);
+
   void debug_events();
 
   inline size_t channel_count()
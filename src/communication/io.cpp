@@ -16,6 +16,7 @@
 #include <fcntl.h>
 #include <netdb.h>
 #include <poll.h>
+#include <sys/sendfile.h>
 
 #include "communication/io.h"
 #include "log.h"
@@ -50,6 +51,58 @@ int writen(int fd, const void* buf, int size)
   return OMS_OK;
 }
 
+int writevn(int fd, struct iovec* iov, int iovcnt)
+{
+  while (iovcnt > 0) {
+    const ssize_t ret = ::writev(fd, iov, iovcnt);
+    if (ret >= 0) {
+      size_t written = ret;
+      // skip the fully written buffers and advance into the partially written one
+      while (iovcnt > 0 && written >= iov->iov_len) {
+        written -= iov->iov_len;
+        ++iov;
+        --iovcnt;
+      }
+      if (iovcnt > 0) {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+        iov->iov_len -= written;
+      }
+      continue;
+    }
+
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err) {
+      return OMS_FAILED;
+    }
+    // same as writen, back off a little on network accumulation
+    usleep(1000);
+  }
+  return OMS_OK;
+}
+
+int sendfilen(int out_fd, int in_fd, uint64_t offset, size_t count)
+{
+  off_t file_offset = static_cast<off_t>(offset);
+  while (count > 0) {
+    const ssize_t ret = ::sendfile(out_fd, in_fd, &file_offset, count);
+    if (ret > 0) {
+      count -= ret;
+      continue;
+    }
+    if (0 == ret) {
+      // the file is shorter than expected
+      return OMS_FAILED;
+    }
+
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err) {
+      return OMS_FAILED;
+    }
+    usleep(1000);
+  }
+  return OMS_OK;
+}
+
 int readn(int fd, void* buf, int size)
 {
   char* tmp = (char*)buf;
@@ -76,6 +129,108 @@ int readn(int fd, void* buf, int size)
   return OMS_OK;
 }
 
+// the messages passed along with descriptors are small control messages
+static const size_t MAX_FD_MESSAGE_SIZE = 64 * 1024;
+
+int send_with_fd(int sock, const std::string& payload, int fd)
+{
+  if (payload.size() > MAX_FD_MESSAGE_SIZE) {
+    OMS_ERROR("Too large message to send along with fd: {}", payload.size());
+    return OMS_FAILED;
+  }
+
+  struct iovec iov {};
+  iov.iov_base = const_cast<char*>(payload.data());
+  iov.iov_len = payload.size();
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  if (fd >= 0) {
+    memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+  }
+
+  while (::sendmsg(sock, &msg, MSG_NOSIGNAL) < 0) {
+    if (errno != EINTR) {
+      OMS_ERROR("Failed to send message along with fd: {} over socket: {}, error: {}", fd, sock, strerror(errno));
+      return OMS_FAILED;
+    }
+  }
+  return OMS_OK;
+}
+
+int recv_with_fd(int sock, std::string& payload, int& fd, int timeout_ms)
+{
+  fd = -1;
+  struct pollfd pfd {};
+  pfd.fd = sock;
+  pfd.events = POLLIN;
+  int ready = ::poll(&pfd, 1, timeout_ms);
+  while (ready < 0 && errno == EINTR) {
+    ready = ::poll(&pfd, 1, timeout_ms);
+  }
+  if (ready < 0) {
+    OMS_ERROR("Failed to poll socket: {}, error: {}", sock, strerror(errno));
+    return OMS_FAILED;
+  }
+  if (ready == 0) {
+    return OMS_TIMEOUT;
+  }
+
+  payload.resize(MAX_FD_MESSAGE_SIZE);
+  struct iovec iov {};
+  iov.iov_base = payload.data();
+  iov.iov_len = payload.size();
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t ret = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+  while (ret < 0 && errno == EINTR) {
+    ret = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+  }
+  if (ret < 0) {
+    payload.clear();
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return OMS_TIMEOUT;
+    }
+    OMS_ERROR("Failed to receive message over socket: {}, error: {}", sock, strerror(errno));
+    return OMS_FAILED;
+  }
+
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+    }
+  }
+  // an empty message is never sent, so it tells the other end is closed
+  if (ret == 0 && fd < 0) {
+    payload.clear();
+    return OMS_CLIENT_CLOSED;
+  }
+  payload.resize(ret);
+  if ((msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+    OMS_ERROR("Truncated message received over socket: {}, flags: {}", sock, msg.msg_flags);
+    if (fd >= 0) {
+      ::close(fd);
+      fd = -1;
+    }
+    return OMS_FAILED;
+  }
+  return OMS_OK;
+}
+
 int connect(const char* host, int port, bool block_mode, int timeout, int& sockfd)
 {
   if (nullptr == host || 0 == host[0] || port < 0 || port >= 65536) {
@@ -13,14 +13,46 @@
 #pragma once
 #include <netinet/in.h>
 
+#include <cstdint>
 #include <string>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 namespace oceanbase::logproxy {
 int writen(int fd, const void* buf, int size);
 
+/**
+ * write all the buffers described by iov, in order, with as few writev calls as possible
+ * @param iov the buffers to write, it is consumed (advanced) in place as data is written
+ * @param iovcnt the number of buffers, no more than IOV_MAX
+ * @return OMS_OK if all the data has been written
+ */
+int writevn(int fd, struct iovec* iov, int iovcnt);
+
+/**
+ * send count bytes of in_fd starting at offset to out_fd through sendfile, the data is not copied to user space
+ * @return OMS_OK if all the data has been sent
+ */
+int sendfilen(int out_fd, int in_fd, uint64_t offset, size_t count);
+
 int readn(int fd, void* buf, int size);
 
+/**
+ * send payload as one message over the unix socket sock, SOCK_SEQPACKET or SOCK_DGRAM, along with the descriptor fd
+ * @param fd the descriptor to pass, or -1 to send the payload alone
+ * @return OMS_OK if the message has been sent
+ */
+int send_with_fd(int sock, const std::string& payload, int fd);
+
+/**
+ * receive one message sent by send_with_fd, the descriptor received is close-on-exec
+ * @param fd[out] the descriptor passed along, -1 if none
+ * @param timeout_ms -1 means infinite, 0 means no wait, others means the time to wait, in millisecond
+ * @return OMS_OK if a message has been received, OMS_TIMEOUT if none came in time, OMS_CLIENT_CLOSED if the other end
+ *         has been closed
+ */
+int recv_with_fd(int sock, std::string& payload, int& fd, int timeout_ms);
+
 /**
  * create a socket and connect to remote server
  * @param host the hostname of remote server
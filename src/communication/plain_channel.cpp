@@ -49,6 +49,11 @@ int PlainChannel::writen(const char* buf, int size)
   return ::oceanbase::logproxy::writen(_peer.fd, buf, size);
 }
 
+int PlainChannel::writevn(struct iovec* iov, int iovcnt)
+{
+  return ::oceanbase::logproxy::writevn(_peer.fd, iov, iovcnt);
+}
+
 const char* PlainChannel::last_error()
 {
   return strerror(errno);
@@ -17,6 +17,7 @@
 #include "ob_aes256.h"
 #include "arranger.h"
 #include "binlog/binlog_manager.h"
+#include "binlog/binlog_index.h"
 #include "environmental.h"
 #include <metric/prometheus.h>
 
@@ -88,6 +89,17 @@ int main(int argc, char** argv)
     free(plain);
     exit(0);
   }));
+  options.add(OmsOption('I', "dump_binlog_index", true, "print binlog index as text", [&](const std::string& optarg) {
+    std::vector<oceanbase::binlog::BinlogIndexRecord> records;
+    if (oceanbase::binlog::BinlogIndexManager::read_index_file(optarg, records) != OMS_OK) {
+      printf("Failed to read binlog index file: %s\n", optarg.c_str());
+      exit(-1);
+    }
+    for (const auto& record : records) {
+      printf("%s", record.to_string().c_str());
+    }
+    exit(0);
+  }));
 
   std::string file = "./conf/conf.json";
 
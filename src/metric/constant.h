@@ -13,6 +13,8 @@
 #pragma once
 
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace oceanbase {
 namespace logproxy {
@@ -96,6 +98,17 @@ const static std::pair<std::string, std::string> BINLOG_INSTANCE_CONVERT_IOPS =
 const static std::pair<std::string, std::string> BINLOG_INSTANCE_CONVERT_STORAGE_RPS = {
     "binlog_instance_convert_storage_rps", ""};
 
+/*!
+ * End-to-end latency from the commit on OceanBase to each stage of the binlog pipeline, in microseconds, labelled with
+ * the stage and the quantile. The instance reports the quantiles of each stage in this order.
+ */
+const static std::pair<std::string, std::string> BINLOG_INSTANCE_PIPELINE_LATENCY = {
+    "binlog_instance_pipeline_latency_us", ""};
+const static std::vector<std::string> BINLOG_INSTANCE_PIPELINE_STAGES = {
+    "fetch", "convert", "serialize", "persist", "send"};
+const static std::vector<std::pair<std::string, double>> BINLOG_INSTANCE_PIPELINE_QUANTILES = {
+    {"p50", 0.5}, {"p99", 0.99}, {"p999", 0.999}};
+
 /*!
  * OBCDC log conversion metric
  */
@@ -98,6 +98,29 @@ int PrometheusExposer::mark_binlog_instance_metric(const std::string& instance_i
   return OMS_OK;
 }
 
+int PrometheusExposer::mark_binlog_instance_latency(const std::string& instance_id, const std::string& cluster,
+    const std::string& tenant, const std::string& cluster_id, const std::string& tenant_id, const std::string& stage,
+    const std::string& quantile, double value)
+{
+  prometheus::Labels labels;
+  labels["instance_id"] = instance_id;
+  labels["ob_cluster_name"] = cluster;
+  labels["tenant_name"] = tenant;
+  labels["stage"] = stage;
+  labels["quantile"] = quantile;
+  if (!cluster_id.empty()) {
+    labels[OB_CLUSTER_ID] = cluster_id;
+  }
+
+  if (!tenant_id.empty()) {
+    labels[OB_TENANT_ID] = tenant_id;
+  }
+  auto& gauge = get_gauge_metric_entry(BINLOG_INSTANCE_PIPELINE_LATENCY_TYPE).Add(labels);
+  gauge.Set(value);
+  update_guage_modify_ts(BINLOG_INSTANCE_PIPELINE_LATENCY_TYPE, labels, gauge);
+  return OMS_OK;
+}
+
 int PrometheusExposer::mark_binlog_dump_metric(const std::string& node_id, const std::string& instance_id,
     const std::string& cluster, const std::string& tenant, const std::string& trace_id, const std::string& dump_user,
     const std::string& dump_host, const std::string& cluster_id, const std::string& tenant_id, double value,
@@ -58,6 +58,7 @@ enum PrometheusMetricType {
   BINLOG_INSTANCE_CONVERT_FETCH_RPS_TYPE,
   BINLOG_INSTANCE_CONVERT_IOPS_TYPE,
   BINLOG_INSTANCE_CONVERT_STORAGE_RPS_TYPE,
+  BINLOG_INSTANCE_PIPELINE_LATENCY_TYPE,
 
   // OBCDC log conversion metric
   BINLOG_INSTANCE_OBCDC_CHECKPOINT_TYPE,
@@ -292,6 +293,11 @@ static std::unordered_map<PrometheusMetricType, prometheus::Family<prometheus::G
             .Name(BINLOG_INSTANCE_CONVERT_STORAGE_RPS.first)
             .Help(BINLOG_INSTANCE_CONVERT_STORAGE_RPS.second)
             .Register(*g_registry)},
+    {BINLOG_INSTANCE_PIPELINE_LATENCY_TYPE,
+        prometheus::BuildGauge()
+            .Name(BINLOG_INSTANCE_PIPELINE_LATENCY.first)
+            .Help(BINLOG_INSTANCE_PIPELINE_LATENCY.second)
+            .Register(*g_registry)},
     {BINLOG_INSTANCE_OBCDC_CHECKPOINT_TYPE,
         prometheus::BuildGauge()
             .Name(BINLOG_INSTANCE_OBCDC_CHECKPOINT.first)
@@ -511,6 +517,22 @@ public:
       const std::string& tenant, const std::string& cluster_id, const std::string& tenant_id, double value,
       PrometheusMetricType type);
 
+  /*!
+   * Latency quantile of a stage of the binlog pipeline of OBI
+   * @param instance_id
+   * @param cluster
+   * @param tenant
+   * @param cluster_id
+   * @param tenant_id
+   * @param stage one of BINLOG_INSTANCE_PIPELINE_STAGES
+   * @param quantile one of BINLOG_INSTANCE_PIPELINE_QUANTILES
+   * @param value
+   * @return
+   */
+  static int mark_binlog_instance_latency(const std::string& instance_id, const std::string& cluster,
+      const std::string& tenant, const std::string& cluster_id, const std::string& tenant_id, const std::string& stage,
+      const std::string& quantile, double value);
+
   /*!
    * Subscription indicators used to count OBI
    * @param node_id
@@ -564,7 +564,7 @@ int write_lenenc_uint(char* buf, size_t capacity, uint64_t integer)
     if (capacity >= 4) {
       buf[0] = 0xFD;
       uint32_t num = cpu_to_le((uint32_t)integer);
-      memcpy(buf + 1, (char*)&num + 1, 3);
+      memcpy(buf + 1, &num, 3);
       return 4;
     } else {
       return OMS_FAILED;
@@ -655,10 +655,10 @@ uint64_t get_lenenc_uint(unsigned char* buf, uint64_t& pos)
     return (uint64_t)tmp;
   }
 
-  memcpy(&tmp, buf + pos + 1, 4);
-  tmp = le_to_cpu(tmp);
+  uint64_t num8 = 0;
+  memcpy(&num8, buf + pos + 1, 8);
   pos += 9;
-  return (uint64_t)tmp;
+  return le_to_cpu(num8);
 }
 
 int get_packed_integer(size_t val)
@@ -666,10 +666,10 @@ int get_packed_integer(size_t val)
   if (val < 251) {
     return 1;
   }
-  if (val < (2 << 16)) {
+  if (val < (1 << 16)) {
     return 3;
   }
-  if (val < (2 << 24)) {
+  if (val < (1 << 24)) {
     return 4;
   }
   return 9;
@@ -0,0 +1,339 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <cstring>
+
+#include "log.h"
+#include "config.h"
+#include "timer.h"
+#include "communication/io.h"
+#include "communication/channel_factory.h"
+#include "oblogreader/oblogreader.h"
+#include "oblogreader/fanout_routine.h"
+
+namespace oceanbase::logproxy {
+
+static Config& _s_config = Config::instance();
+
+// wait for the reader so long at most at a time, for the clients handed over and the ones gone to be seen to soon
+static const uint64_t FANOUT_POLL_TIMEOUT_US = 100000;
+
+static uint64_t start_us_of(const ObcdcConfig& config)
+{
+  if (config.start_timestamp_us.val() != 0) {
+    return config.start_timestamp_us.val();
+  }
+  return config.start_timestamp.val() * 1000000;
+}
+
+FanoutRoutine::FanoutRoutine(ObLogReader& reader, RingQueue<ILogRecord*>& rqueue)
+    : Thread("FanoutRoutine"),
+      _reader(reader),
+      _rqueue(rqueue),
+      _log([this](ILogRecord* record) { _obcdc->release(record); },
+          [this](ILogRecord* record) {
+            size_t size = 0;
+            if (_reader.filter().to_string(record, &size, &_lmb) == nullptr) {
+              OMS_ERROR("Failed to parse logmsg Record, !!!EXIT!!!");
+              return false;
+            }
+            return true;
+          })
+{}
+
+int FanoutRoutine::init(int control_fd, const ObcdcConfig& config, IObCdcAccess* obcdc)
+{
+  _control_fd = control_fd;
+  _obcdc = obcdc;
+  // obcdc starts from now without a start timestamp
+  uint64_t start_us = start_us_of(config);
+  _log.init(start_us != 0 ? start_us : Timer::now());
+
+  if (!_s_config.readonly.val() && ChannelFactory::instance().init(_s_config) != OMS_OK) {
+    OMS_ERROR("Failed to init channel factory");
+    return OMS_FAILED;
+  }
+  _encoder_pool = std::make_shared<ThreadPoolExecutor>(std::max<size_t>(_s_config.encode_threadpool_size.val(), 1));
+  return OMS_OK;
+}
+
+int FanoutRoutine::attach(const ClientMeta& client)
+{
+  ObcdcConfig client_config(client.configuration);
+  auto session = std::make_unique<Session>();
+  session->client = client;
+  session->cursor.start_us = start_us_of(client_config);
+
+  // refused before the sender takes the fd, which is closed then, the arranger keeps its own
+  auto refuse = [&client]() {
+    close(client.peer.fd);
+    return OMS_FAILED;
+  };
+
+  if (parse_table_patterns(client_config.table_whites.val(), session->cursor.table_whites) != OMS_OK) {
+    OMS_ERROR("Failed to parse table white list of client: {}", client.id);
+    return refuse();
+  }
+
+  CompressType compress_type = CompressType::LZ4;
+  if (ObLogReader::compress_type_of(client.packet_version, client_config, compress_type) != OMS_OK) {
+    return refuse();
+  }
+
+  if (_log.seek(session->cursor) != OMS_OK) {
+    OMS_WARN("Refused client: {} starting from {}(us)", client.id, session->cursor.start_us);
+    return refuse();
+  }
+
+  session->queue = std::make_unique<RingQueue<ILogRecord*>>(_s_config.record_queue_size.val());
+  session->sender = std::make_unique<SenderRoutine>(_reader, *session->queue);
+  session->sender->set_fanout(this, _encoder_pool);
+  if (session->sender->init(client.packet_version, compress_type, client.peer, _obcdc) != OMS_OK) {
+    OMS_ERROR("Failed to init sender of client: {}", client.id);
+    return OMS_FAILED;
+  }
+  session->sender->start();
+
+  OMS_INFO("Attached client: {} of peer: {} at log entry: {} of [{}, {})",
+      client.id,
+      client.peer.to_string(),
+      session->cursor.seq,
+      _log.begin(),
+      _log.head());
+  _sessions.push_back(std::move(session));
+  return OMS_OK;
+}
+
+void FanoutRoutine::release(const std::vector<ILogRecord*>& records)
+{
+  _log.release(records);
+}
+
+void FanoutRoutine::run()
+{
+  uint64_t max_records = std::max<uint64_t>(_s_config.oblogreader_fanout_log_records.val(), 1);
+  std::vector<ILogRecord*> records;
+  records.reserve(std::min<uint64_t>(_s_config.read_wait_num.val(), max_records));
+  Timer idle_timer;
+  bool lagging = false;
+
+  while (is_run()) {
+    accept_clients();
+
+    // the reader waits while the slowest session is as far behind as the log holds
+    size_t polled = 0;
+    if (_log.head() - min_cursor() < max_records) {
+      records.clear();
+      if (_rqueue.poll(records, lagging ? 0 : FANOUT_POLL_TIMEOUT_US)) {
+        append(records);
+        polled = records.size();
+      }
+    }
+
+    size_t dispatched = 0;
+    bool failed = false;
+    lagging = false;
+    for (auto& session : _sessions) {
+      int ret = dispatch(*session);
+      if (ret < 0) {
+        failed = true;
+        break;
+      }
+      dispatched += ret;
+      lagging = lagging || session->cursor.seq < _log.head() || !session->staged.empty();
+    }
+    if (failed) {
+      break;
+    }
+    reap();
+    trim();
+
+    if (!_sessions.empty()) {
+      idle_timer.reset();
+    } else if (idle_timer.elapsed() >= _s_config.oblogreader_fanout_linger_s.val() * 1000000L) {
+      OMS_INFO("No client left for {}s, stopping shared oblogreader", _s_config.oblogreader_fanout_linger_s.val());
+      break;
+    }
+    // the sessions behind have their queues full, let them drain
+    if (lagging && polled == 0 && dispatched == 0) {
+      usleep(1000);
+    }
+  }
+
+  // no client is taken from now on
+  if (_control_fd >= 0) {
+    close(_control_fd);
+    _control_fd = -1;
+  }
+  for (auto& session : _sessions) {
+    close_session(*session);
+  }
+  _sessions.clear();
+  _log.clear();
+
+  _reader.stop();
+}
+
+void FanoutRoutine::accept_clients()
+{
+  while (_control_fd >= 0) {
+    std::string payload;
+    int fd = -1;
+    int ret = recv_with_fd(_control_fd, payload, fd, 0);
+    if (ret == OMS_TIMEOUT) {
+      return;
+    }
+    if (ret != OMS_OK) {
+      // serve the clients attached till they leave
+      OMS_WARN("Lost the control socket to arranger, ret: {}, no client is taken anymore", ret);
+      close(_control_fd);
+      _control_fd = -1;
+      if (fd >= 0) {
+        close(fd);
+      }
+      return;
+    }
+
+    rapidjson::Document doc;
+    doc.Parse(payload.c_str());
+    ClientMeta client;
+    if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember(CLIENT_META) || !doc[CLIENT_META].IsObject() ||
+        client.init_from_json(doc[CLIENT_META]) != OMS_OK) {
+      OMS_ERROR("Invalid client handed over by arranger: {}", payload);
+      if (fd >= 0) {
+        close(fd);
+      }
+      continue;
+    }
+
+    struct sockaddr_in peer_addr {};
+    socklen_t len = sizeof(peer_addr);
+    if (fd < 0 || getpeername(fd, (struct sockaddr*)&peer_addr, &len) != 0) {
+      OMS_ERROR("Failed to fetch peer of client: {}, fd: {}, error: {}", client.id, fd, strerror(errno));
+      if (fd >= 0) {
+        close(fd);
+      }
+      notify(CLIENT_EVENT_REJECTED, client.id);
+      continue;
+    }
+    client.peer = Peer(peer_addr.sin_addr.s_addr, ntohs(peer_addr.sin_port), fd);
+
+    ret = attach(client);
+    notify(ret == OMS_OK ? CLIENT_EVENT_ATTACHED : CLIENT_EVENT_REJECTED, client.id);
+  }
+}
+
+void FanoutRoutine::append(const std::vector<ILogRecord*>& polled)
+{
+  // the rules of the columns and rows to send are the same for all the sessions, part of the key of the oblogreader
+  RecordFilter& record_filter = _reader.filter();
+  for (ILogRecord* record : polled) {
+    if (record_filter.pass(record)) {
+      _log.append(record);
+    } else {
+      _obcdc->release(record);
+    }
+  }
+}
+
+int FanoutRoutine::dispatch(Session& session)
+{
+  // take the records from the log as far as the queue has room, they are referenced once staged
+  if (session.staged.empty() && session.cursor.seq < _log.head()) {
+    size_t room = session.queue->capacity() - std::min(session.queue->capacity(), session.queue->size());
+    if (_log.take(session.cursor, room, session.staged) != OMS_OK) {
+      return -1;
+    }
+  }
+
+  if (session.staged.empty()) {
+    return 0;
+  }
+  size_t offered = session.queue->offer_n(session.staged.data(), session.staged.size(), 0);
+  session.staged.erase(session.staged.begin(), session.staged.begin() + offered);
+  return offered;
+}
+
+void FanoutRoutine::reap()
+{
+  for (auto iter = _sessions.begin(); iter != _sessions.end();) {
+    Session& session = **iter;
+    if (session.sender->is_run()) {
+      ++iter;
+      continue;
+    }
+
+    close_session(session);
+    OMS_INFO("Detached client: {} of peer: {}, {} clients left",
+        session.client.id,
+        session.client.peer.to_string(),
+        _sessions.size() - 1);
+    notify(CLIENT_EVENT_DETACHED, session.client.id);
+    iter = _sessions.erase(iter);
+  }
+}
+
+void FanoutRoutine::close_session(Session& session)
+{
+  if (session.sender->is_run()) {
+    session.sender->stop();
+  }
+  session.sender->join();
+
+  std::vector<ILogRecord*> records;
+  session.queue->clear([&records](ILogRecord*& record) { records.push_back(record); });
+  records.insert(records.end(), session.staged.begin(), session.staged.end());
+  session.staged.clear();
+  release(records);
+}
+
+void FanoutRoutine::trim()
+{
+  uint64_t max_records = std::max<uint64_t>(_s_config.oblogreader_fanout_log_records.val(), 1);
+  _log.trim(min_cursor(), max_records);
+}
+
+uint64_t FanoutRoutine::min_cursor() const
+{
+  uint64_t cursor = _log.head();
+  for (const auto& session : _sessions) {
+    // the BEGIN held back is still to be passed on
+    cursor = std::min(cursor, session->cursor.bound());
+  }
+  return cursor;
+}
+
+void FanoutRoutine::notify(const char* event, const std::string& client_id)
+{
+  if (_control_fd < 0) {
+    return;
+  }
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key(CLIENT_EVENT);
+  writer.String(event);
+  writer.Key("id");
+  writer.String(client_id.c_str());
+  writer.EndObject();
+  if (send_with_fd(_control_fd, buffer.GetString(), -1) != OMS_OK) {
+    OMS_WARN("Failed to tell arranger client: {} {}, no client is taken anymore", client_id, event);
+    close(_control_fd);
+    _control_fd = -1;
+  }
+}
+
+}  // namespace oceanbase::logproxy
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logmsg_buf.h"
+#include "log_record.h"
+
+#include "thread.h"
+#include "ring_queue.hpp"
+#include "client_meta.h"
+#include "fanout_log.h"
+#include "obcdc_config.h"
+#include "thread_pool_executor.h"
+#include "obcdcaccess/obcdc_factory.h"
+#include "oblogreader/sender_routine.h"
+
+namespace oceanbase::logproxy {
+
+class ObLogReader;
+
+/*!
+ * @brief Feed the records of a shared oblogreader to each of its clients.
+ *
+ * The records polled from the reader are appended to a FanoutLog kept in memory, from which every client session
+ * takes the records of its own table white list into the queue of its SenderRoutine, from its own cursor. A record is
+ * serialized once, when the first session takes it.
+ *
+ * The records are shared by the sessions and released once the log and every session queue are done with them. The
+ * log keeps up to oblogreader_fanout_log_records records, so that a client joining late is served from the log if it
+ * starts at a timestamp still there, and the reader waits while the slowest session is that far behind.
+ *
+ * The arranger hands the new clients over through the control socket, and is told of the clients gone, see
+ * SourceInvoke::attach().
+ */
+class FanoutRoutine : public Thread {
+public:
+  FanoutRoutine(ObLogReader& reader, RingQueue<ILogRecord*>& rqueue);
+
+  /*!
+   * @param control_fd the socket to the arranger, or -1 to serve nobody but the clients attached here
+   * @param config configs of the reader, telling where it starts from
+   */
+  int init(int control_fd, const ObcdcConfig& config, IObCdcAccess* obcdc);
+
+  /*!
+   * @brief Start to serve the client on client.peer, from the start timestamp in its configuration
+   * @return OMS_OK, or OMS_FAILED if the records the client asks for are not kept anymore
+   */
+  int attach(const ClientMeta& client);
+
+  /*!
+   * @brief Release the records a session is done with, called by the senders
+   */
+  void release(const std::vector<ILogRecord*>& records);
+
+private:
+  void run() override;
+
+  struct Session {
+    ClientMeta client;
+    FanoutLog::Cursor cursor;
+
+    // records taken from the log, waiting for room in the queue
+    std::vector<ILogRecord*> staged;
+    std::unique_ptr<RingQueue<ILogRecord*>> queue;
+    std::unique_ptr<SenderRoutine> sender;
+  };
+
+  /*!
+   * @brief Attach the clients handed over by the arranger, and answer it
+   */
+  void accept_clients();
+
+  /*!
+   * @brief Append the records polled whose rows are to be sent to the log
+   */
+  void append(const std::vector<ILogRecord*>& polled);
+
+  /*!
+   * @brief Pass the records of the session from its cursor on to its queue, as far as there is room
+   * @return the number of records passed on, or -1 if a record failed to be serialized
+   */
+  int dispatch(Session& session);
+
+  /*!
+   * @brief Release the sessions whose senders stopped, and tell the arranger
+   */
+  void reap();
+
+  void close_session(Session& session);
+
+  /*!
+   * @brief Drop the log entries every session has got past, beyond the records kept for the clients joining late
+   */
+  void trim();
+
+  uint64_t min_cursor() const;
+
+  void notify(const char* event, const std::string& client_id);
+
+private:
+  ObLogReader& _reader;
+  IObCdcAccess* _obcdc = nullptr;
+  RingQueue<ILogRecord*>& _rqueue;
+
+  int _control_fd = -1;
+
+  FanoutLog _log;
+  LogMsgBuf _lmb;
+
+  std::vector<std::unique_ptr<Session>> _sessions;
+  std::shared_ptr<ThreadPoolExecutor> _encoder_pool;
+};
+
+}  // namespace oceanbase::logproxy
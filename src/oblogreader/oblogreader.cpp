@@ -23,28 +23,65 @@ ObLogReader::~ObLogReader()
   //  join();
 }
 
-int ObLogReader::init(
-    const std::string& id, MessageVersion packet_version, const ClientMeta& meta, const ObcdcConfig& config)
+int ObLogReader::init(const std::string& id, MessageVersion packet_version, const ClientMeta& meta,
+    const ObcdcConfig& config, int control_fd)
 {
   Counter::instance().register_gauge("NRecordQ", [this]() { return _queue.size(); });
 
+  int ret = _filter.init(config);
+  if (ret != OMS_OK) {
+    return ret;
+  }
+
   // load different so library according to ob version
-  int ret = ObCdcAccessFactory::load(config, _obcdc);
+  ret = ObCdcAccessFactory::load(config, _obcdc);
   if (ret != OMS_OK) {
     return ret;
   }
 
-  ret = _sender.init(packet_version, meta.peer, _obcdc);
+  if (control_fd >= 0) {
+    // the table white list of config covers the whole tenants, each client has its own in the meta
+    _shared = true;
+    ret = _fanout.init(control_fd, config, _obcdc);
+    if (ret == OMS_OK) {
+      ret = _fanout.attach(meta);
+    }
+  } else {
+    CompressType compress_type = CompressType::LZ4;
+    ret = compress_type_of(packet_version, config, compress_type);
+    if (ret == OMS_OK) {
+      ret = _sender.init(packet_version, compress_type, meta.peer, _obcdc);
+    }
+  }
   if (ret != OMS_OK) {
     return ret;
   }
   return _reader.init(config, _obcdc);
 }
 
+int ObLogReader::compress_type_of(MessageVersion packet_version, const ObcdcConfig& config, CompressType& compress_type)
+{
+  compress_type = CompressType::LZ4;
+  const std::string& compress_name = config.compress_type.val();
+  if (!compress_name.empty() && compress_type_from_str(compress_name, compress_type) != OMS_OK) {
+    OMS_ERROR("Unsupported compress type: {}", compress_name);
+    return OMS_FAILED;
+  }
+  // the legacy packets know nothing but plain and lz4
+  if (packet_version != MessageVersion::V2 && compress_type != CompressType::PLAIN) {
+    compress_type = CompressType::LZ4;
+  }
+  return OMS_OK;
+}
+
 int ObLogReader::stop()
 {
   _reader.stop();
-  _sender.stop();
+  if (_shared) {
+    _fanout.stop();
+  } else {
+    _sender.stop();
+  }
   ObCdcAccessFactory::unload(_obcdc);
   Counter::instance().stop();
   return OMS_OK;
@@ -54,7 +91,11 @@ void ObLogReader::join()
 {
   OMS_DEBUG("<<< Joining ObLogReader");
   _reader.join();
-  _sender.join();
+  if (_shared) {
+    _fanout.join();
+  } else {
+    _sender.join();
+  }
   Counter::instance().join();
   OMS_DEBUG(">>> Joined ObLogReader");
 }
@@ -62,7 +103,11 @@ void ObLogReader::join()
 int ObLogReader::start()
 {
   Counter::instance().start();
-  _sender.start();
+  if (_shared) {
+    _fanout.start();
+  } else {
+    _sender.start();
+  }
   _reader.start();
   return OMS_OK;
 }
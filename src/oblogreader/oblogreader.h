@@ -16,8 +16,10 @@
 #include "communication/comm.h"
 #include "common/obcdc_config.h"
 #include "obcdcaccess/obcdc_factory.h"
+#include "oblogreader/record_filter.h"
 #include "oblogreader/reader_routine.h"
 #include "oblogreader/sender_routine.h"
+#include "oblogreader/fanout_routine.h"
 
 namespace oceanbase::logproxy {
 
@@ -27,7 +29,11 @@ class ObLogReader {
 public:
   virtual ~ObLogReader();
 
-  int init(const std::string& id, MessageVersion packet_version, const ClientMeta&, const ObcdcConfig& config);
+  /*!
+   * @param control_fd the socket the arranger hands more clients over through, to run as a shared oblogreader, or -1
+   */
+  int init(const std::string& id, MessageVersion packet_version, const ClientMeta&, const ObcdcConfig& config,
+      int control_fd = -1);
 
   int stop();
 
@@ -35,12 +41,29 @@ public:
 
   int start();
 
+  /*!
+   * @brief The compression of the record packets a client asks for in its config
+   */
+  static int compress_type_of(MessageVersion packet_version, const ObcdcConfig& config, CompressType& compress_type);
+
+  /*!
+   * @brief The columns and rows of the tables to send, applied before the records are serialized
+   */
+  RecordFilter& filter()
+  {
+    return _filter;
+  }
+
 private:
   IObCdcAccess* _obcdc = nullptr;
+  RecordFilter _filter;
 
-  BlockingQueue<ILogRecord*> _queue{Config::instance().record_queue_size.val()};
+  RingQueue<ILogRecord*> _queue{Config::instance().record_queue_size.val()};
   ReaderRoutine _reader{*this, _queue};
   SenderRoutine _sender{*this, _queue};
+
+  bool _shared = false;
+  FanoutRoutine _fanout{*this, _queue};
 };
 
 }  // namespace oceanbase::logproxy
@@ -57,8 +57,10 @@ int main(int argc, char** argv)
 
   // we create new thread for fork() acting as children process's main thread
   // child never return as exit internal if error
+  // a shared oblogreader takes more clients from the arranger through the control socket
+  int control_fd = argc > 3 ? atoi(argv[3]) : -1;
   ObLogReader reader;
-  int ret = reader.init(client.id, client.packet_version, client, config);
+  int ret = reader.init(client.id, client.packet_version, client, config, control_fd);
   if (ret == OMS_OK) {
     reader.start();
     reader.join();
@@ -21,7 +21,7 @@ namespace oceanbase::logproxy {
 
 static Config& _s_config = Config::instance();
 
-ReaderRoutine::ReaderRoutine(ObLogReader& reader, BlockingQueue<ILogRecord*>& q)
+ReaderRoutine::ReaderRoutine(ObLogReader& reader, RingQueue<ILogRecord*>& q)
     : Thread("ReaderRoutine"), _reader(reader), _obcdc(nullptr), _queue(q)
 {}
 
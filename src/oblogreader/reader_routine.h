@@ -13,7 +13,7 @@
 #pragma once
 
 #include "thread.h"
-#include "blocking_queue.hpp"
+#include "ring_queue.hpp"
 #include "obcdc_config.h"
 #include "obaccess/clog_meta_routine.h"
 
@@ -24,7 +24,7 @@ class ObLogReader;
 
 class ReaderRoutine : public Thread {
 public:
-  ReaderRoutine(ObLogReader&, BlockingQueue<ILogRecord*>&);
+  ReaderRoutine(ObLogReader&, RingQueue<ILogRecord*>&);
 
   int init(const ObcdcConfig& config, IObCdcAccess* obcdc);
 
@@ -39,7 +39,7 @@ private:
 
   ClogMetaRoutine _clog_meta;
 
-  BlockingQueue<ILogRecord*>& _queue;
+  RingQueue<ILogRecord*>& _queue;
 };
 
 }  // namespace oceanbase::logproxy
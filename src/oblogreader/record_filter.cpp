@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <cstring>
+#include <type_traits>
+
+#include "logmsg_factory.h"
+
+#include "log.h"
+#include "common.h"
+#include "oblogreader/record_filter.h"
+
+namespace oceanbase::logproxy {
+
+// the values of the columns projected of a record, bitwise copies of its own, never destroyed as the record owns
+// them still
+using BinLogBufStorage = std::aligned_storage_t<sizeof(BinLogBuf), alignof(BinLogBuf)>;
+static thread_local std::vector<BinLogBufStorage> _t_s_projected_cols;
+
+static bool is_dml(int record_type)
+{
+  return record_type == EINSERT || record_type == EUPDATE || record_type == EDELETE || record_type == EREPLACE;
+}
+
+std::atomic<uint64_t> RecordFilter::_s_next_id{1};
+thread_local RecordFilter::LocalRules RecordFilter::_t_s_rules;
+
+RecordFilter::TableRules::~TableRules()
+{
+  if (projected_meta != nullptr) {
+    LogMsgFactory::destroy(projected_meta);
+  }
+}
+
+int RecordFilter::init(const ObcdcConfig& config)
+{
+  if (parse_table_columns(config.table_columns.val(), _table_columns) != OMS_OK ||
+      parse_row_filters(config.row_filters.val(), _row_filters) != OMS_OK) {
+    return OMS_FAILED;
+  }
+  if (!empty()) {
+    OMS_INFO("Records filtered with tb_column_list: {}, tb_row_filter: {}",
+        config.table_columns.val(),
+        config.row_filters.val());
+  }
+  return OMS_OK;
+}
+
+bool RecordFilter::pass(ILogRecord* record)
+{
+  int type = record->recordType();
+  if (type == EDDL) {
+    // the table metas may be rebuilt, and their addresses taken by others
+    _generation.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+  if (_row_filters.empty() || !is_dml(type) || record->isParsedRecord()) {
+    return true;
+  }
+  const TableRules* rules = rules_of(record);
+  if (rules == nullptr || rules->predicates.empty()) {
+    return true;
+  }
+
+  unsigned int count = 0;
+  if (type == EUPDATE || type == EDELETE) {
+    const BinLogBuf* old_cols = record->oldCols(count);
+    if (satisfy(*rules, old_cols, count)) {
+      return true;
+    }
+  }
+  if (type != EDELETE) {
+    const BinLogBuf* new_cols = record->newCols(count);
+    if (satisfy(*rules, new_cols, count)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* RecordFilter::to_string(ILogRecord* record, size_t* size, LogMsgBuf* lmb)
+{
+  if (_table_columns.empty() || !is_dml(record->recordType()) || record->isParsedRecord()) {
+    return record->toString(size, lmb, true);
+  }
+  const TableRules* rules = rules_of(record);
+  if (rules == nullptr || rules->projected_meta == nullptr) {
+    return record->toString(size, lmb, true);
+  }
+
+  // each image holds a value per column of the table, or none
+  unsigned int new_count = 0;
+  unsigned int old_count = 0;
+  BinLogBuf* new_cols = record->newCols(new_count);
+  BinLogBuf* old_cols = record->oldCols(old_count);
+  unsigned int col_count = rules->col_count;
+  if ((new_count != 0 && new_count != col_count) || (old_count != 0 && old_count != col_count)) {
+    return record->toString(size, lmb, true);
+  }
+
+  size_t projected_count = rules->columns.size();
+  _t_s_projected_cols.resize(projected_count * 2);
+  BinLogBuf* projected_new = reinterpret_cast<BinLogBuf*>(_t_s_projected_cols.data());
+  BinLogBuf* projected_old = projected_new + projected_count;
+  for (size_t i = 0; i < projected_count; ++i) {
+    int index = rules->columns[i];
+    if (new_count != 0) {
+      memcpy((void*)&projected_new[i], &new_cols[index], sizeof(BinLogBuf));
+    }
+    if (old_count != 0) {
+      memcpy((void*)&projected_old[i], &old_cols[index], sizeof(BinLogBuf));
+    }
+  }
+
+  ITableMeta* table_meta = record->getTableMeta();
+  record->setTableMeta(rules->projected_meta);
+  if (new_count != 0) {
+    record->setNewColumn(projected_new, projected_count);
+  }
+  if (old_count != 0) {
+    record->setOldColumn(projected_old, projected_count);
+  }
+
+  const char* rbuf = record->toString(size, lmb, true);
+
+  record->setTableMeta(table_meta);
+  if (new_count != 0) {
+    record->setNewColumn(new_cols, new_count);
+  }
+  if (old_count != 0) {
+    record->setOldColumn(old_cols, old_count);
+  }
+  return rbuf;
+}
+
+const RecordFilter::TableRules* RecordFilter::rules_of(ILogRecord* record)
+{
+  ITableMeta* table_meta = record->getTableMeta();
+  if (table_meta == nullptr) {
+    return nullptr;
+  }
+  uint64_t generation = _generation.load(std::memory_order_acquire);
+  if (_t_s_rules.filter_id != _id || _t_s_rules.generation != generation) {
+    _t_s_rules.tables.clear();
+    _t_s_rules.filter_id = _id;
+    _t_s_rules.generation = generation;
+  }
+  // obcdc frees table metas, and may hand their addresses out again for other tables
+  const char* dbname = record->dbname() != nullptr ? record->dbname() : "";
+  const char* tbname = record->tbname() != nullptr ? record->tbname() : "";
+  int col_count = table_meta->getColCount();
+  LocalEntry& entry = _t_s_rules.tables[table_meta];
+  if (entry.rules == nullptr || entry.col_count != col_count || entry.tbname != tbname || entry.dbname != dbname) {
+    entry.rules = shared_rules_of(record, table_meta);
+    entry.dbname = dbname;
+    entry.tbname = tbname;
+    entry.col_count = col_count;
+  }
+  return entry.rules.get();
+}
+
+std::shared_ptr<RecordFilter::TableRules> RecordFilter::shared_rules_of(ILogRecord* record, ITableMeta* table_meta)
+{
+  const char* dbname = record->dbname();
+  const char* tbname = record->tbname();
+  std::string table;
+  table.append(dbname != nullptr ? dbname : "").append(".").append(tbname != nullptr ? tbname : "");
+  uint64_t signature = table_meta_signature(table_meta);
+
+  // the rules of the former schema of the table are dropped
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::shared_ptr<TableRules>& rules = _tables[table];
+  if (rules == nullptr || rules->signature != signature) {
+    rules = resolve(record, table_meta);
+    rules->signature = signature;
+  }
+  return rules;
+}
+
+std::shared_ptr<RecordFilter::TableRules> RecordFilter::resolve(ILogRecord* record, ITableMeta* table_meta)
+{
+  auto rules = std::make_shared<TableRules>();
+  rules->col_count = table_meta->getColCount();
+
+  // the first rule matching the table applies
+  const char* dbname = record->dbname();
+  const char* tbname = record->tbname();
+  for (const TableRowFilter& filter : _row_filters) {
+    if (!filter.pattern.match(dbname, tbname)) {
+      continue;
+    }
+    for (const RowPredicate& predicate : filter.predicates) {
+      int index = table_meta->getColIndex(predicate.column.c_str());
+      if (index < 0) {
+        OMS_WARN("Ignored the predicate on column: {} not found in table: {}.{}", predicate.column, dbname, tbname);
+        continue;
+      }
+      rules->predicates.push_back({index, &predicate});
+    }
+    break;
+  }
+
+  for (const TableColumns& projection : _table_columns) {
+    if (projection.pattern.match(dbname, tbname)) {
+      project_columns(table_meta, projection, rules->columns);
+      break;
+    }
+  }
+  if (rules->columns.empty()) {
+    return rules;
+  }
+  rules->projected_meta = create_projected_meta(table_meta, rules->columns);
+
+  OMS_INFO("Projected {} of {} columns of table: {}.{}", rules->columns.size(), rules->col_count, dbname, tbname);
+  return rules;
+}
+
+bool RecordFilter::satisfy(const TableRules& rules, const BinLogBuf* cols, unsigned int count)
+{
+  if (cols == nullptr) {
+    return false;
+  }
+  for (const Predicate& predicate : rules.predicates) {
+    if ((unsigned int)predicate.index >= count) {
+      return false;
+    }
+    const BinLogBuf& col = cols[predicate.index];
+    if (!predicate.predicate->eval(col.buf, col.buf_used_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace oceanbase::logproxy
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binlog_buf.h"
+#include "logmsg_buf.h"
+#include "log_record.h"
+#include "meta_info.h"
+
+#include "table_rules.h"
+#include "table_projection.h"
+#include "obcdc_config.h"
+
+namespace oceanbase::logproxy {
+
+/*!
+ * @brief Apply the column projection (tb_column_list) and the row predicates (tb_row_filter) of the client to the
+ * DML records, before they are serialized and compressed.
+ *
+ * The rules of a table are resolved once per table and table_meta_signature(), that is per schema version, those of
+ * the former schema being dropped. Each thread then finds them by the address of the table meta without a lock, as
+ * long as the meta is of the same table and column count, until the next DDL. A record projected is serialized
+ * against a table meta holding copies of the columns kept only, with the values of those columns, the record being
+ * restored right after.
+ */
+class RecordFilter {
+public:
+  RecordFilter() = default;
+
+  RecordFilter(const RecordFilter&) = delete;
+  RecordFilter& operator=(const RecordFilter&) = delete;
+
+  int init(const ObcdcConfig& config);
+
+  bool empty() const
+  {
+    return _table_columns.empty() && _row_filters.empty();
+  }
+
+  /*!
+   * @brief Whether the row of the record satisfies the predicates of its table, the records but DML always do.
+   * An UPDATE does if either of its images does, for the clients to see the rows coming in and out. Called on every
+   * record before to_string(), DDLs included.
+   */
+  bool pass(ILogRecord* record);
+
+  /*!
+   * @brief Serialize the record as ILogRecord::toString() does, with the columns of its table projected
+   */
+  const char* to_string(ILogRecord* record, size_t* size, LogMsgBuf* lmb);
+
+private:
+  struct Predicate {
+    int index;
+    const RowPredicate* predicate;
+  };
+
+  struct TableRules {
+    ~TableRules();
+
+    // table_meta_signature() of the table meta the rules are resolved from
+    uint64_t signature = 0;
+    int col_count = 0;
+
+    // the indexes of the columns kept, in the order of the table, and the meta of them, nullptr if all are kept
+    std::vector<int> columns;
+    ITableMeta* projected_meta = nullptr;
+
+    std::vector<Predicate> predicates;
+  };
+
+  // rules found by the address of a table meta, as long as the meta still belongs to the same table
+  struct LocalEntry {
+    std::string dbname;
+    std::string tbname;
+    int col_count = 0;
+    std::shared_ptr<TableRules> rules;
+  };
+
+  // the rules a thread has looked up, by the address of the table meta, valid for one filter and generation
+  struct LocalRules {
+    uint64_t filter_id = 0;
+    uint64_t generation = 0;
+    std::unordered_map<const ITableMeta*, LocalEntry> tables;
+  };
+
+  /*!
+   * @return the rules of the table of the record, held by the calling thread till its next call, or nullptr
+   */
+  const TableRules* rules_of(ILogRecord* record);
+
+  std::shared_ptr<TableRules> shared_rules_of(ILogRecord* record, ITableMeta* table_meta);
+
+  std::shared_ptr<TableRules> resolve(ILogRecord* record, ITableMeta* table_meta);
+
+  static bool satisfy(const TableRules& rules, const BinLogBuf* cols, unsigned int count);
+
+private:
+  std::vector<TableColumns> _table_columns;
+  std::vector<TableRowFilter> _row_filters;
+
+  // tells the thread local rules of this filter from those of a former one
+  const uint64_t _id = _s_next_id.fetch_add(1, std::memory_order_relaxed);
+  // bumped on every DDL, dropping the thread local rules
+  std::atomic<uint64_t> _generation{0};
+
+  // rules resolved by the senders and the encoder threads, <"tenant.database.table", rules>
+  std::mutex _mutex;
+  std::unordered_map<std::string, std::shared_ptr<TableRules>> _tables;
+
+  static std::atomic<uint64_t> _s_next_id;
+  static thread_local LocalRules _t_s_rules;
+};
+
+}  // namespace oceanbase::logproxy
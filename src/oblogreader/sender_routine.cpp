@@ -10,7 +10,9 @@
  * See the Mulan PubL v2 for more details.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 
 #include "logmsg_buf.h"
 #include "log_record.h"
@@ -21,38 +23,45 @@
 #include "codec/encoder.h"
 #include "communication/comm.h"
 #include "oblogreader/oblogreader.h"
+#include "oblogreader/fanout_routine.h"
 
 namespace oceanbase::logproxy {
 
 static Config& _s_config = Config::instance();
 
+// the slices of the polled records handed to the encoders hold at least so many records, for the packets to
+// compress well
+static const size_t MIN_ENCODE_SLICE_RECORDS = 64;
+
+// how long to poll for records while batches are at the encoders, which are sent once the poll is over
+static const uint64_t ENCODING_POLL_TIMEOUT_US = 1000;
+
 // #ifndef COMMUNITY_BUILD
-static __thread LogMsgBuf* _t_s_lmb = nullptr;
-#define LogMsgLocalInit                                         \
-  if ((_t_s_lmb = new (std::nothrow) LogMsgBuf()) == nullptr) { \
-    OMS_ERROR("Failed to alloc LogMsgBuf");                     \
-    stop();                                                     \
-    return;                                                     \
-  }
-#define LogMsgLocalDestroy delete _t_s_lmb
+// serialization buffer of each encoder thread
+static thread_local LogMsgBuf _t_s_lmb;
 // #endif
 
-SenderRoutine::SenderRoutine(ObLogReader& reader, BlockingQueue<ILogRecord*>& rqueue)
+SenderRoutine::SenderRoutine(ObLogReader& reader, RingQueue<ILogRecord*>& rqueue)
     : Thread("SenderRoutine"), _reader(reader), _obcdc(nullptr), _rqueue(rqueue)
 {}
 
-int SenderRoutine::init(MessageVersion packet_version, const Peer& peer, IObCdcAccess* obcdc)
+int SenderRoutine::init(
+    MessageVersion packet_version, CompressType compress_type, const Peer& peer, IObCdcAccess* obcdc)
 {
   _obcdc = obcdc;
   _packet_version = packet_version;
+  _compress_type = compress_type;
   _client_peer = peer;
 
   if (_s_config.readonly.val()) {
     return OMS_OK;
   }
 
-  // init comm
-  int ret = ChannelFactory::instance().init(Config::instance());
+  // init comm, once for all the senders of a shared oblogreader
+  int ret = OMS_OK;
+  if (_fanout == nullptr) {
+    ret = ChannelFactory::instance().init(Config::instance());
+  }
   if (OMS_OK != ret) {
     OMS_ERROR("Failed to init channel factory");
     return OMS_FAILED;
@@ -64,6 +73,11 @@ int SenderRoutine::init(MessageVersion packet_version, const Peer& peer, IObCdcA
     return ret;
   }
 
+  _nof_encoders = std::max<size_t>(_s_config.encode_threadpool_size.val(), 1);
+  if (_encoder_pool == nullptr) {
+    _encoder_pool = std::make_shared<ThreadPoolExecutor>(_nof_encoders);
+  }
+
   //  _comm.set_write_callback();
   ret = _comm.add(peer);
   if (ret == OMS_FAILED) {
@@ -75,11 +89,18 @@ int SenderRoutine::init(MessageVersion packet_version, const Peer& peer, IObCdcA
   return OMS_OK;
 }
 
+void SenderRoutine::set_fanout(FanoutRoutine* fanout, std::shared_ptr<ThreadPoolExecutor> encoder_pool)
+{
+  _fanout = fanout;
+  _encoder_pool = std::move(encoder_pool);
+}
+
 void SenderRoutine::stop()
 {
   if (is_run()) {
     Thread::stop();
-    if (_s_config.readonly.val()) {
+    // the channel of a client of a shared oblogreader is closed by its own sender, at the end of run()
+    if (_s_config.readonly.val() || _fanout != nullptr) {
       return;
     }
     _comm.stop();
@@ -88,8 +109,6 @@ void SenderRoutine::stop()
 
 void SenderRoutine::run()
 {
-  LogMsgLocalInit;
-
   std::vector<ILogRecord*> records;
   records.reserve(_s_config.read_wait_num.val());
 
@@ -105,105 +124,216 @@ void SenderRoutine::run()
 
     _stage_timer.reset();
     records.clear();
-    while (!_rqueue.poll(records, _s_config.read_timeout_us.val()) || records.empty()) {
-      OMS_INFO("Send transfer queue empty, retry...");
+    // the batches at the encoders may not wait for a poll of read_timeout_us at low traffic
+    bool encoding = !_encoding.empty();
+    uint64_t poll_timeout_us = encoding ? ENCODING_POLL_TIMEOUT_US : _s_config.read_timeout_us.val();
+    if (!_rqueue.poll(records, poll_timeout_us) || records.empty()) {
+      // nothing more to encode for now, flush what the encoders have in hand
+      if (send_encoded(0) != OMS_OK) {
+        OMS_ERROR("Failed to write LogMessage to client: {}", _client_peer.to_string());
+        stop();
+        break;
+      }
+      if (!encoding) {
+        OMS_INFO("Send transfer queue empty, retry...");
+      }
+      continue;
     }
     int64_t poll_us = _stage_timer.elapsed();
     Counter::instance().count_key(Counter::SENDER_POLL_US, poll_us);
 
+    // the rows of a shared oblogreader are filtered by the FanoutRoutine
+    if (_fanout == nullptr && filter_rows(records) == 0) {
+      continue;
+    }
+
     if (_s_config.readonly.val()) {
       for (auto record : records) {
         assert(record != nullptr);
         Counter::instance().count_write(1);
         Counter::instance().mark_timestamp(record->getTimestamp() * 1000000 + record->getRecordUsec());
         Counter::instance().mark_checkpoint(record->getCheckpoint1() * 1000000 + record->getCheckpoint2());
-        _obcdc->release(record);
       }
+      release(records);
       continue;
     }
 
-    size_t packet_size = 0;
-    size_t offset = 0;
-    size_t i = 0;
-    for (i = 0; i < records.size(); ++i) {
-      ILogRecord* r = records[i];
-      size_t size = 0;
-      // #ifdef COMMUNITY_BUILD
-      const char* rbuf = r->toString(&size, _t_s_lmb, true);
-      // #else
-      //       const char* rbuf = r->toString(&size, true);
-      // #endif
-      if (rbuf == nullptr) {
-        OMS_ERROR("Failed to parse logmsg Record, !!!EXIT!!!");
-        stop();
-        break;
-      }
+    submit_encode(records);
+    if (send_encoded(_s_config.encode_queue_size.val()) != OMS_OK) {
+      OMS_ERROR("Failed to write LogMessage to client: {}", _client_peer.to_string());
+      stop();
+      break;
+    }
+  }
 
-      if (packet_size + size > _s_config.max_packet_bytes.val()) {
-        if (packet_size == 0) {
-          OMS_WARN("Huge package occurred with size of: {}, exceed max_packet_bytes: {}, try to send directly.",
-              size,
-              _s_config.max_packet_bytes.val());
-          if (do_send(records, i, 1) != OMS_OK) {
-            OMS_ERROR("Failed to write LogMessage to client: {}", _client_peer.to_string());
-            stop();
-            break;
-          }
-          offset = i + 1;
-        } else {
-          if (do_send(records, offset, i - offset) != OMS_OK) {
-            OMS_ERROR("Failed to write LogMessage to client: {}", _client_peer.to_string());
-            stop();
-            break;
-          }
-
-          offset = i;
-        }
-        packet_size = 0;
-        continue;
-      }
-      packet_size += size;
+  release_encoding();
+  if (_fanout != nullptr) {
+    // the other clients of the shared oblogreader go on
+    _comm.stop();
+    return;
+  }
+  _reader.stop();
+}
+
+void SenderRoutine::submit_encode(std::vector<ILogRecord*>& records)
+{
+  size_t slice = std::max((records.size() + _nof_encoders - 1) / _nof_encoders, MIN_ENCODE_SLICE_RECORDS);
+  for (size_t offset = 0; offset < records.size(); offset += slice) {
+    size_t count = std::min(slice, records.size() - offset);
+    auto batch = std::make_unique<EncodeBatch>();
+    batch->records.assign(records.begin() + offset, records.begin() + offset + count);
+    batch->seq = _msg_seq;
+    _msg_seq += count;
+
+    EncodeBatch* p_batch = batch.get();
+    batch->encoded = _encoder_pool->submit([this, p_batch]() { return encode(*p_batch); });
+    _nof_encoding_records += count;
+    _encoding.push_back(std::move(batch));
+  }
+}
+
+int SenderRoutine::encode(EncodeBatch& batch)
+{
+  std::vector<ILogRecord*>& records = batch.records;
+  size_t packet_size = 0;
+  size_t offset = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t size = 0;
+    // the records of a shared oblogreader are serialized once by the FanoutRoutine, for all the clients
+    // #ifdef COMMUNITY_BUILD
+    const char* rbuf = _fanout != nullptr ? records[i]->getFormatedString(&size)
+                                          : _reader.filter().to_string(records[i], &size, &_t_s_lmb);
+    // #else
+    //       const char* rbuf = records[i]->toString(&size, true);
+    // #endif
+    if (rbuf == nullptr) {
+      OMS_ERROR("Failed to parse logmsg Record, !!!EXIT!!!");
+      return OMS_FAILED;
     }
 
-    if (is_run() && packet_size > 0) {
-      if (do_send(records, offset, i - offset) != OMS_OK) {
-        OMS_ERROR("Failed to write LogMessage to client: {}", _client_peer.to_string());
-        stop();
+    if (packet_size > 0 && packet_size + size > _s_config.max_packet_bytes.val()) {
+      if (encode_packet(batch, offset, i - offset) != OMS_OK) {
+        return OMS_FAILED;
       }
+      offset = i;
+      packet_size = 0;
     }
-
-    for (ILogRecord* r : records) {
-      _obcdc->release(r);
+    if (packet_size == 0 && size > _s_config.max_packet_bytes.val()) {
+      OMS_WARN("Huge package occurred with size of: {}, exceed max_packet_bytes: {}, try to send directly.",
+          size,
+          _s_config.max_packet_bytes.val());
     }
+    packet_size += size;
   }
+  if (offset < records.size()) {
+    return encode_packet(batch, offset, records.size() - offset);
+  }
+  return OMS_OK;
+}
 
-  LogMsgLocalDestroy;
-  _reader.stop();
+int SenderRoutine::encode_packet(EncodeBatch& batch, size_t offset, size_t count)
+{
+  RecordDataMessage msg(batch.records, offset, count);
+  msg.set_version(_packet_version);
+  msg.compress_type = _compress_type;
+  msg.idx = batch.seq + offset;
+
+  EncodedPacket& packet = batch.packets.emplace_back();
+  packet.offset = offset;
+  packet.count = count;
+  int ret = Comm::encode_message(msg, packet.buffer, packet.raw_len);
+  if (ret != OMS_OK) {
+    OMS_ERROR("Failed to encode record range[{}, {}] of message seq: {}", offset, offset + count, batch.seq);
+  }
+  return ret;
 }
 
-int SenderRoutine::do_send(std::vector<ILogRecord*>& records, size_t offset, size_t count)
+int SenderRoutine::send_encoded(size_t max_encoding)
 {
-  if (_s_config.verbose.val()) {
-    OMS_DEBUG("send record range[{}, {}]", offset, offset + count);
+  while (!_encoding.empty()) {
+    EncodeBatch& front = *_encoding.front();
+    if (_nof_encoding_records <= max_encoding &&
+        front.encoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return OMS_OK;
+    }
+
+    int ret = send_batch(front);
+    _nof_encoding_records -= front.records.size();
+    release(front.records);
+    _encoding.pop_front();
+    if (ret != OMS_OK) {
+      return ret;
+    }
   }
+  return OMS_OK;
+}
 
-  RecordDataMessage msg(records, offset, count);
-  msg.set_version(_packet_version);
-  msg.compress_type = CompressType::LZ4;
-  msg.idx = _msg_seq;
-  int ret = _comm.send_message(_client_peer, msg, true);
+int SenderRoutine::send_batch(EncodeBatch& batch)
+{
+  int ret = batch.encoded.get();
+  if (ret != OMS_OK) {
+    return ret;
+  }
+
+  for (const EncodedPacket& packet : batch.packets) {
+    if (_s_config.verbose.val()) {
+      OMS_DEBUG("send record range[{}, {}]", batch.seq + packet.offset, batch.seq + packet.offset + packet.count);
+    }
 
-  _msg_seq += count;
+    ret = _comm.send_encoded(_client_peer, packet.buffer, packet.raw_len);
+    if (ret != OMS_OK) {
+      OMS_WARN("Failed to send record data message to client, peer: {}", _client_peer.id());
+      return ret;
+    }
 
-  if (ret == OMS_OK) {
-    ILogRecord* last = records[offset + count - 1];
-    Counter::instance().count_write(count);
+    ILogRecord* last = batch.records[packet.offset + packet.count - 1];
+    Counter::instance().count_write(packet.count);
     Counter::instance().mark_timestamp(last->getTimestamp() * 1000000 + last->getRecordUsec());
     Counter::instance().mark_checkpoint(last->getCheckpoint1() * 1000000 + last->getCheckpoint2());
-  } else {
-    OMS_WARN("Failed to send record data message to client, peer: {}", _client_peer.id());
   }
-  return ret;
+  return OMS_OK;
+}
+
+void SenderRoutine::release_encoding()
+{
+  // the encoders may still be at the records, wait for them before releasing
+  for (auto& batch : _encoding) {
+    batch->encoded.wait();
+    release(batch->records);
+  }
+  _encoding.clear();
+  _nof_encoding_records = 0;
+}
+
+size_t SenderRoutine::filter_rows(std::vector<ILogRecord*>& records)
+{
+  RecordFilter& filter = _reader.filter();
+  if (filter.empty()) {
+    return records.size();
+  }
+  std::vector<ILogRecord*> filtered;
+  size_t kept = 0;
+  for (ILogRecord* record : records) {
+    if (filter.pass(record)) {
+      records[kept++] = record;
+    } else {
+      filtered.push_back(record);
+    }
+  }
+  records.resize(kept);
+  release(filtered);
+  return kept;
+}
+
+void SenderRoutine::release(const std::vector<ILogRecord*>& records)
+{
+  if (_fanout != nullptr) {
+    _fanout->release(records);
+    return;
+  }
+  for (ILogRecord* r : records) {
+    _obcdc->release(r);
+  }
 }
 
 }  // namespace oceanbase::logproxy
@@ -12,41 +12,114 @@
 
 #pragma once
 
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
 #include "thread.h"
 #include "timer.h"
-#include "blocking_queue.hpp"
+#include "ring_queue.hpp"
+#include "thread_pool_executor.h"
 
 namespace oceanbase::logproxy {
 
 class ObLogReader;
-
+class FanoutRoutine;
+
+/*!
+ * @brief Send the records polled from the reader to the client.
+ *
+ * The records are serialized, packed into packets up to max_packet_bytes and compressed by a pool of
+ * encode_threadpool_size threads, a slice of the polled records at a time, while this thread writes the packets
+ * encoded in the order the records were polled. At most about encode_queue_size records are encoded ahead of the
+ * socket, the records being released once their packets are written.
+ *
+ * A sender of a shared oblogreader serves one of its clients: the records come serialized already and are released
+ * through the FanoutRoutine, the encoder pool is shared with the other senders, and the client leaving stops nothing
+ * but this sender.
+ */
 class SenderRoutine : public Thread {
 public:
-  SenderRoutine(ObLogReader& reader, BlockingQueue<ILogRecord*>& rqueue);
+  SenderRoutine(ObLogReader& reader, RingQueue<ILogRecord*>& rqueue);
+
+  int init(MessageVersion packet_version, CompressType compress_type, const Peer& peer, IObCdcAccess* obcdc);
 
-  int init(MessageVersion packet_version, const Peer& peer, IObCdcAccess* obcdc);
+  /*!
+   * @brief Serve a client of the shared oblogreader of fanout, to be set before init()
+   */
+  void set_fanout(FanoutRoutine* fanout, std::shared_ptr<ThreadPoolExecutor> encoder_pool);
 
   void stop() override;
 
 private:
   void run() override;
 
-  int do_send(std::vector<ILogRecord*>& records, size_t offset, size_t count);
+  struct EncodedPacket {
+    MsgBuf buffer;
+    size_t raw_len = 0;
+    size_t offset = 0;
+    size_t count = 0;
+  };
+
+  struct EncodeBatch {
+    std::vector<ILogRecord*> records;
+    // message seq of the first record, each packet is numbered after its first record
+    uint32_t seq = 0;
+    // a deque as MsgBuf is copied rather than moved
+    std::deque<EncodedPacket> packets;
+    std::future<int> encoded;
+  };
+
+  void submit_encode(std::vector<ILogRecord*>& records);
+
+  /*!
+   * @brief Run on the encoder pool, serialize the records of batch and encode them packet by packet
+   */
+  int encode(EncodeBatch& batch);
+
+  int encode_packet(EncodeBatch& batch, size_t offset, size_t count);
+
+  /*!
+   * @brief Write the batches encoded in order, waiting for the encoders while more than max_encoding records are
+   * not written yet
+   */
+  int send_encoded(size_t max_encoding);
+
+  int send_batch(EncodeBatch& batch);
+
+  void release_encoding();
+
+  /*!
+   * @brief Release the records whose rows the client filters out, keeping the others in order
+   * @return the number of records kept
+   */
+  size_t filter_rows(std::vector<ILogRecord*>& records);
+
+  void release(const std::vector<ILogRecord*>& records);
 
 private:
   ObLogReader& _reader;
   IObCdcAccess* _obcdc;
 
-  BlockingQueue<ILogRecord*>& _rqueue;
+  RingQueue<ILogRecord*>& _rqueue;
 
   Comm _comm;
 
   MessageVersion _packet_version;
+  CompressType _compress_type = CompressType::LZ4;
   Peer _client_peer;
 
   Timer _stage_timer;
 
   uint32_t _msg_seq = 0;
+
+  FanoutRoutine* _fanout = nullptr;
+
+  std::shared_ptr<ThreadPoolExecutor> _encoder_pool;
+  size_t _nof_encoders = 1;
+  std::deque<std::unique_ptr<EncodeBatch>> _encoding;
+  size_t _nof_encoding_records = 0;
 };
 
 }  // namespace oceanbase::logproxy
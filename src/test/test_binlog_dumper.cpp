@@ -10,11 +10,15 @@
  * See the Mulan PubL v2 for more details.
  */
 
+#include <cstdio>
+#include <unistd.h>
+
 #include "gtest/gtest.h"
 #include "common.h"
 #include "log.h"
 #include "binlog/ob_log_event.h"
 #include "codec/byte_decoder.h"
+#include "binlog/binlog-instance/event_block_reader.h"
 
 using namespace oceanbase::binlog;
 TEST(BinlogDumper, fake_rotate_event)
@@ -38,3 +42,52 @@ TEST(BinlogDumper, fake_rotate_event)
 
   free(buff);
 }
+
+TEST(BinlogDumper, event_block_reader)
+{
+  FILE* fp = tmpfile();
+  ASSERT_NE(fp, nullptr);
+  std::vector<uint32_t> lengths;
+  std::vector<unsigned char> buff(64 * 1024);
+  // rotate events with growing file names, some of them larger than a read block
+  for (int i = 0; i < 200; ++i) {
+    std::string file_name(static_cast<size_t>(i * 97 % 6000) + 1, 'a' + i % 26);
+    RotateEvent rotate_event(0, file_name, 0, 0);
+    size_t len = rotate_event.flush_to_buff(buff.data());
+    ASSERT_EQ(fwrite(buff.data(), 1, len, fp), len);
+    lengths.push_back(len);
+  }
+  fflush(fp);
+  uint64_t end_pos = ftell(fp);
+
+  EventBlockReader reader(4096);
+  reader.reset(fileno(fp));
+  uint64_t offset = 0;
+  for (size_t i = 0; i < lengths.size(); ++i) {
+    unsigned char* event = nullptr;
+    uint32_t event_len = 0;
+    ASSERT_EQ(reader.read_event(offset, end_pos, event, event_len), OMS_OK);
+    ASSERT_EQ(event_len, lengths[i]);
+    OblogEventHeader header = OblogEventHeader();
+    header.deserialize(event);
+    ASSERT_EQ(header.get_type_code(), ROTATE_EVENT);
+    ASSERT_EQ(event[COMMON_HEADER_LENGTH + 8], 'a' + i % 26);
+    offset += event_len;
+  }
+  ASSERT_EQ(offset, end_pos);
+
+  // an event cut by end_pos is not complete yet
+  unsigned char* event = nullptr;
+  uint32_t event_len = 0;
+  ASSERT_EQ(reader.read_event(0, lengths[0] - 1, event, event_len), OMS_AGAIN);
+  ASSERT_EQ(reader.read_event(end_pos, end_pos, event, event_len), OMS_AGAIN);
+
+  // headers are served from the read-ahead buffer, or read on their own
+  uint64_t last = end_pos - lengths.back();
+  ASSERT_EQ(reader.read_header(last, end_pos, event, event_len), OMS_OK);
+  ASSERT_EQ(event_len, lengths.back());
+  ASSERT_EQ(reader.read_header(0, end_pos, event, event_len), OMS_OK);
+  ASSERT_EQ(event_len, lengths[0]);
+  ASSERT_EQ(reader.read_header(0, lengths[0] - 1, event, event_len), OMS_AGAIN);
+  fclose(fp);
+}
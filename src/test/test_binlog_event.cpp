@@ -10,16 +10,21 @@
  * See the Mulan PubL v2 for more details.
  */
 
+#include <algorithm>
 #include <bitset>
 #include "gtest/gtest.h"
 #include "common.h"
 #include "log.h"
 #include "binlog/binlog-instance/binlog_convert.h"
 #include "binlog/data_type.h"
+#include "binlog/binlog-instance/table_cache.h"
+#include "obaccess/ob_mysql_packet.h"
+#include "guard.hpp"
 
 #include <common_util.h>
 
 using namespace oceanbase::binlog;
+using namespace oceanbase::logproxy;
 
 TEST(WriteRowsEvent, deserialize)
 {
@@ -207,4 +212,258 @@ TEST(Converter, get_dbname_without_tenant)
     OMS_INFO(dbname);
     ASSERT_EQ(dbname, "cluster.t_xxx11.2.2.3&^%$#@!.db&&^^%%$$##..123&&^^");
   }
-}
\ No newline at end of file
+}
+TEST(TableMapEvent, definition)
+{
+  TableMapEvent event;
+  event.set_table_id(108);
+  event.set_flags(1);
+  event.set_db_name("test");
+  event.set_db_len(4);
+  event.set_tb_name("t1");
+  event.set_tb_len(2);
+  event.set_column_count(3);
+  auto* col_type = static_cast<unsigned char*>(malloc(3));
+  col_type[0] = OB_TYPE_LONG;
+  col_type[1] = OB_TYPE_VARCHAR;
+  col_type[2] = OB_TYPE_DATETIME2;
+  event.set_column_type(col_type);
+  auto* metadata = static_cast<unsigned char*>(malloc(3));
+  metadata[0] = 0xff;
+  metadata[1] = 0x00;
+  metadata[2] = 0x00;
+  event.set_metadata(metadata);
+  event.set_metadata_len(3);
+  auto* null_bits = static_cast<unsigned char*>(malloc(1));
+  null_bits[0] = 0x06;
+  event.set_null_bits(null_bits);
+  uint32_t event_len = COMMON_HEADER_LENGTH + TABLE_MAP_HEADER_LEN + (4 + 2) + (2 + 2) + (1 + 3) + (1 + 3) + 1 +
+                       event.get_checksum_len();
+  event.set_header(new OblogEventHeader(TABLE_MAP_EVENT, 1700000000, event_len, 0));
+
+  auto definition = event.make_definition(1);
+  ASSERT_EQ(event_len - COMMON_HEADER_LENGTH - event.get_checksum_len(), definition->body.size());
+
+  TableMapEvent cached_event;
+  cached_event.set_definition(definition);
+  cached_event.set_header(new OblogEventHeader(TABLE_MAP_EVENT, 1700000000, event_len, 0));
+  ASSERT_EQ(event.get_table_id(), cached_event.get_table_id());
+  ASSERT_EQ("test", cached_event.get_db_name());
+  ASSERT_EQ("t1", cached_event.get_tb_name());
+  ASSERT_EQ(0, memcmp(col_type, cached_event.get_column_type(), 3));
+  ASSERT_EQ(0, memcmp(metadata, cached_event.get_metadata(), 3));
+  ASSERT_EQ(null_bits[0], cached_event.get_null_bits()[0]);
+
+  std::vector<unsigned char> expected(event_len);
+  std::vector<unsigned char> actual(event_len);
+  ASSERT_EQ(event_len, event.flush_to_buff(expected.data()));
+  ASSERT_EQ(event_len, cached_event.flush_to_buff(actual.data()));
+  ASSERT_EQ(expected, actual);
+}
+
+TEST(TableCache, table_map)
+{
+  TableCache table_cache;
+  uint64_t signature = 1;
+  uint64_t new_signature = 2;
+  uint64_t table_id = table_cache.get_table_id("test", "t1");
+  ASSERT_EQ(nullptr, table_cache.get_table_map("test", "t1", signature));
+
+  auto definition = std::make_shared<TableMapDefinition>();
+  definition->table_id = table_id;
+  definition->schema_signature = signature;
+  table_cache.put_table_map("test", "t1", definition);
+  ASSERT_EQ(definition, table_cache.get_table_map("test", "t1", signature));
+  // schema changed
+  ASSERT_EQ(nullptr, table_cache.get_table_map("test", "t1", new_signature));
+
+  // ddl
+  table_cache.refresh_table_id("test", "t1");
+  ASSERT_NE(table_id, table_cache.get_table_id("test", "t1"));
+  ASSERT_EQ(nullptr, table_cache.get_table_map("test", "t1", signature));
+  // stale definitions are not cached
+  table_cache.put_table_map("test", "t1", definition);
+  ASSERT_EQ(nullptr, table_cache.get_table_map("test", "t1", signature));
+}
+
+static IColMeta* make_col_meta(const char* name, int type, long length, const char* encoding)
+{
+  auto* col_meta = new IColMeta();
+  col_meta->setName(name);
+  col_meta->setType(type);
+  col_meta->setLength(length);
+  col_meta->setEncoding(encoding);
+  return col_meta;
+}
+
+TEST(TableCache, schema_signature)
+{
+  // the table metas own the columns appended to them
+  ITableMeta table_meta;
+  table_meta.append("id", make_col_meta("id", OB_TYPE_LONGLONG, 20, "binary"));
+  table_meta.append("name", make_col_meta("name", OB_TYPE_VARCHAR, 64, "utf8mb4"));
+  ITableMeta same_meta;
+  same_meta.append("id", make_col_meta("id", OB_TYPE_LONGLONG, 20, "binary"));
+  same_meta.append("name", make_col_meta("name", OB_TYPE_VARCHAR, 64, "utf8mb4"));
+  ASSERT_EQ(table_schema_signature(&table_meta), table_schema_signature(&same_meta));
+
+  // a column widened, its charset changed, or a column added: another schema version
+  ITableMeta widened_meta;
+  widened_meta.append("id", make_col_meta("id", OB_TYPE_LONGLONG, 20, "binary"));
+  widened_meta.append("name", make_col_meta("name", OB_TYPE_VARCHAR, 128, "utf8mb4"));
+  ASSERT_NE(table_schema_signature(&table_meta), table_schema_signature(&widened_meta));
+  ITableMeta charset_meta;
+  charset_meta.append("id", make_col_meta("id", OB_TYPE_LONGLONG, 20, "binary"));
+  charset_meta.append("name", make_col_meta("name", OB_TYPE_VARCHAR, 64, "latin1"));
+  ASSERT_NE(table_schema_signature(&table_meta), table_schema_signature(&charset_meta));
+  same_meta.append("age", make_col_meta("age", OB_TYPE_LONG, 11, "binary"));
+  ASSERT_NE(table_schema_signature(&table_meta), table_schema_signature(&same_meta));
+}
+
+TEST(TransactionPayloadEvent, compress)
+{
+  std::vector<ObLogEvent*> events;
+  for (uint64_t xid = 1; xid <= 64; ++xid) {
+    auto* xid_event = new XidEvent();
+    uint32_t xid_event_len = COMMON_HEADER_LENGTH + XID_HEADER_LEN + XID_LEN + xid_event->get_checksum_len();
+    xid_event->set_header(new OblogEventHeader(XID_EVENT, 1700000000, xid_event_len, 1000 + xid * xid_event_len));
+    xid_event->set_xid(xid);
+    events.push_back(xid_event);
+  }
+  defer(release_vector(events));
+
+  std::vector<unsigned char> expected;
+  for (auto event : events) {
+    std::vector<unsigned char> buff(event->get_header()->get_event_length());
+    uint32_t next_position = event->get_header()->get_next_position();
+    event->get_header()->set_next_position(0);
+    event->flush_to_buff(buff.data());
+    event->get_header()->set_next_position(next_position);
+    expected.insert(expected.end(), buff.begin(), buff.end());
+  }
+
+  TransactionPayloadEvent payload_event;
+  ASSERT_EQ(OMS_OK, payload_event.compress(events, 0, events.size(), 3));
+  ASSERT_EQ(TRANSACTION_COMPRESSION_ZSTD, payload_event.get_compression_type());
+  ASSERT_EQ(expected.size(), payload_event.get_uncompressed_size());
+  ASSERT_LT(payload_event.get_header()->get_event_length(), expected.size());
+  // the events keep their own positions
+  ASSERT_EQ(1000 + events[0]->get_header()->get_event_length(), events[0]->get_header()->get_next_position());
+
+  std::vector<unsigned char> buff(payload_event.get_header()->get_event_length());
+  ASSERT_EQ(buff.size(), payload_event.flush_to_buff(buff.data()));
+
+  TransactionPayloadEvent deserialized;
+  deserialized.deserialize(buff.data());
+  ASSERT_EQ(TRANSACTION_PAYLOAD_EVENT, deserialized.get_header()->get_type_code());
+  ASSERT_EQ(payload_event.get_payload_size(), deserialized.get_payload_size());
+  ASSERT_EQ(expected.size(), deserialized.get_uncompressed_size());
+  std::vector<unsigned char> decompressed;
+  ASSERT_EQ(OMS_OK, deserialized.decompress(decompressed));
+  ASSERT_EQ(expected, decompressed);
+}
+
+TEST(TransactionPayloadEvent, xid_slot)
+{
+  std::vector<ObLogEvent*> events;
+  for (uint64_t i = 1; i <= 16; ++i) {
+    auto* xid_event = new XidEvent();
+    uint32_t xid_event_len = COMMON_HEADER_LENGTH + XID_HEADER_LEN + XID_LEN + xid_event->get_checksum_len();
+    xid_event->set_header(new OblogEventHeader(XID_EVENT, 1700000000, xid_event_len, 1000 + i * xid_event_len));
+    events.push_back(xid_event);
+  }
+  defer(release_vector(events));
+
+  // compressed before the checkpoint filter, so the closing xid is not numbered yet
+  TransactionPayloadEvent payload_event;
+  ASSERT_EQ(OMS_OK, payload_event.compress(events, 0, events.size(), 3));
+  uint32_t event_len = payload_event.get_header()->get_event_length();
+  payload_event.set_xid(42);
+  ASSERT_EQ(event_len, payload_event.get_header()->get_event_length());
+
+  std::vector<unsigned char> buff(event_len);
+  ASSERT_EQ(buff.size(), payload_event.flush_to_buff(buff.data()));
+  TransactionPayloadEvent deserialized;
+  deserialized.deserialize(buff.data());
+  std::vector<unsigned char> decompressed;
+  ASSERT_EQ(OMS_OK, deserialized.decompress(decompressed));
+
+  // numbered in the payload, the xid event is the one numbered without compression
+  auto* xid_event = dynamic_cast<XidEvent*>(events.back());
+  xid_event->set_xid(42);
+  xid_event->get_header()->set_next_position(0);
+  std::vector<unsigned char> expected(xid_event->get_header()->get_event_length());
+  xid_event->flush_to_buff(expected.data());
+  ASSERT_TRUE(std::equal(expected.begin(), expected.end(), decompressed.end() - expected.size()));
+
+  XidEvent wrapped;
+  wrapped.deserialize(decompressed.data() + decompressed.size() - expected.size());
+  ASSERT_EQ(42U, wrapped.get_xid());
+}
+
+TEST(FormatDescriptionEvent, transaction_payload)
+{
+  FormatDescriptionEvent plain_event(1700000000);
+  FormatDescriptionEvent compressed_event(1700000000, PAYLOAD_LOG_EVENT_TYPES);
+  ASSERT_EQ(static_cast<size_t>(LOG_EVENT_TYPES), plain_event.get_event_type_header_len().size());
+  ASSERT_EQ(plain_event.get_header()->get_event_length() + 1, compressed_event.get_header()->get_event_length());
+
+  // a compressed binlog file: the format description event followed by a transaction payload
+  std::vector<ObLogEvent*> events;
+  auto* xid_event = new XidEvent();
+  uint32_t xid_event_len = COMMON_HEADER_LENGTH + XID_HEADER_LEN + XID_LEN + xid_event->get_checksum_len();
+  xid_event->set_header(new OblogEventHeader(XID_EVENT, 1700000000, xid_event_len, 0));
+  xid_event->set_xid(1);
+  events.push_back(xid_event);
+  defer(release_vector(events));
+  TransactionPayloadEvent payload_event;
+  ASSERT_EQ(OMS_OK, payload_event.compress(events, 0, events.size(), 3));
+
+  std::vector<unsigned char> file(BINLOG_MAGIC_SIZE + compressed_event.get_header()->get_event_length() +
+                                  payload_event.get_header()->get_event_length());
+  memcpy(file.data(), binlog_magic, BINLOG_MAGIC_SIZE);
+  size_t pos = BINLOG_MAGIC_SIZE;
+  pos += compressed_event.flush_to_buff(file.data() + pos);
+  ASSERT_EQ(compressed_event.get_header()->get_next_position(), pos);
+  pos += payload_event.flush_to_buff(file.data() + pos);
+  ASSERT_EQ(file.size(), pos);
+
+  // as a reader parses it: each event type must be declared by the format description event
+  FormatDescriptionEvent fd_event;
+  fd_event.deserialize(file.data() + BINLOG_MAGIC_SIZE);
+  ASSERT_EQ(compressed_event.get_checksum_flag(), fd_event.get_checksum_flag());
+  std::vector<uint8_t> header_lengths = fd_event.get_event_type_header_len();
+  ASSERT_EQ(static_cast<size_t>(PAYLOAD_LOG_EVENT_TYPES), header_lengths.size());
+  ASSERT_EQ(0, header_lengths[TRANSACTION_PAYLOAD_EVENT - 1]);
+  ASSERT_EQ(START_V3_HEADER_LEN + 1 + PAYLOAD_LOG_EVENT_TYPES, header_lengths[FORMAT_DESCRIPTION_EVENT - 1]);
+
+  pos = fd_event.get_header()->get_next_position();
+  OblogEventHeader header;
+  header.deserialize(file.data() + pos);
+  ASSERT_LE(static_cast<size_t>(header.get_type_code()), header_lengths.size());
+  TransactionPayloadEvent deserialized;
+  deserialized.deserialize(file.data() + pos);
+  ASSERT_EQ(TRANSACTION_PAYLOAD_EVENT, deserialized.get_header()->get_type_code());
+  std::vector<unsigned char> decompressed;
+  ASSERT_EQ(OMS_OK, deserialized.decompress(decompressed));
+  ASSERT_EQ(xid_event_len, decompressed.size());
+
+  // the files written without compression keep their table
+  std::vector<unsigned char> plain_buff(plain_event.get_header()->get_event_length());
+  plain_event.flush_to_buff(plain_buff.data());
+  FormatDescriptionEvent plain_deserialized;
+  plain_deserialized.deserialize(plain_buff.data());
+  ASSERT_EQ(static_cast<size_t>(LOG_EVENT_TYPES), plain_deserialized.get_event_type_header_len().size());
+}
+
+TEST(LengthEncodedInteger, round_trip)
+{
+  char buff[MAX_PACKET_INTEGER_LEN];
+  for (uint64_t value : {0UL, 250UL, 251UL, 65535UL, 65536UL, 70000UL, 16777215UL, 16777216UL, 1UL << 40}) {
+    int len = write_lenenc_uint(buff, sizeof(buff), value);
+    ASSERT_EQ(get_packed_integer(value), len);
+    uint64_t pos = 0;
+    ASSERT_EQ(value, get_lenenc_uint(reinterpret_cast<unsigned char*>(buff), pos));
+    ASSERT_EQ(static_cast<uint64_t>(len), pos);
+  }
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <random>
+#include <vector>
+#include <zlib.h>
+
+#include "gtest/gtest.h"
+#include "log.h"
+#include "timer.h"
+#include "checksum.h"
+
+using namespace oceanbase::logproxy;
+
+static std::vector<unsigned char> random_bytes(size_t len, uint32_t seed)
+{
+  std::mt19937 gen(seed);
+  std::vector<unsigned char> bytes(len);
+  for (auto& byte : bytes) {
+    byte = static_cast<unsigned char>(gen());
+  }
+  return bytes;
+}
+
+TEST(Checksum, same_as_zlib)
+{
+  ASSERT_EQ(0, crc32_of(nullptr, 0));
+  ASSERT_EQ(0xcbf43926, crc32_of(reinterpret_cast<const unsigned char*>("123456789"), 9));
+
+  std::vector<unsigned char> bytes = random_bytes(8192 + 64, 2024);
+  // every length around the folding thresholds, at unaligned offsets too
+  for (size_t offset = 0; offset < 17; ++offset) {
+    for (size_t len = 0; len < 600; ++len) {
+      ASSERT_EQ(crc32(0L, bytes.data() + offset, len), crc32_of(bytes.data() + offset, len))
+          << "offset: " << offset << ", len: " << len;
+    }
+  }
+  ASSERT_EQ(crc32(0L, bytes.data(), 8192), crc32_of(bytes.data(), 8192));
+}
+
+TEST(Checksum, incremental)
+{
+  std::vector<unsigned char> bytes = random_bytes(4096, 16);
+  uint32_t expected = crc32(0L, bytes.data(), bytes.size());
+
+  std::mt19937 gen(7);
+  for (int round = 0; round < 200; ++round) {
+    uint32_t crc = 0;
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+      size_t len = std::min<size_t>(gen() % 300, bytes.size() - pos);
+      crc = crc32_update(crc, bytes.data() + pos, len);
+      pos += len;
+    }
+    ASSERT_EQ(expected, crc);
+  }
+}
+
+TEST(Checksum, DISABLED_benchmark)
+{
+  // the sizes of a small event, an ordinary rows event and a large transaction chunk
+  for (size_t len : {64, 1024, 64 * 1024}) {
+    std::vector<unsigned char> bytes = random_bytes(len, len);
+    const size_t total = 256 * 1024 * 1024;
+    const size_t rounds = total / len;
+
+    Timer timer;
+    uLong zlib_crc = 0;
+    for (size_t i = 0; i < rounds; ++i) {
+      zlib_crc = crc32(zlib_crc, bytes.data(), len);
+    }
+    int64_t zlib_elapsed = std::max<int64_t>(timer.elapsed(), 1);
+
+    timer.reset();
+    uint32_t crc = 0;
+    for (size_t i = 0; i < rounds; ++i) {
+      crc = crc32_update(crc, bytes.data(), len);
+    }
+    int64_t elapsed = std::max<int64_t>(timer.elapsed(), 1);
+
+    ASSERT_EQ(zlib_crc, crc);
+    OMS_INFO("[checksum] {} bytes: zlib {} MB/s, {} {} MB/s",
+        len,
+        total / zlib_elapsed,
+        crc32_implementation(),
+        total / elapsed);
+  }
+}
@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "log.h"
+#include "timer.h"
+#include "binlog/binlog-instance/column_encoder.h"
+#include "binlog/binlog-instance/table_cache.h"
+
+using namespace oceanbase::binlog;
+using namespace oceanbase::logproxy;
+
+struct TestColumn {
+  int type;
+  long length;
+  long precision;
+  long scale;
+  const char* encoding;
+  std::vector<std::string> values;
+};
+
+/*
+ * A representative wide table: every kind of column, with values that take the compiled encoders as well as values
+ * they leave to get_column_val_bytes.
+ */
+static std::vector<TestColumn> wide_table_columns()
+{
+  std::string long_text(300, 'x');
+  std::string blob(2000, 'b');
+  return {
+      {OB_TYPE_TINY, 0, 0, 0, "", {"0", "127", "-128", "-1", "255"}},
+      {OB_TYPE_SHORT, 0, 0, 0, "", {"32767", "-32768", "12", "-0", "65535"}},
+      {OB_TYPE_INT24, 0, 0, 0, "", {"8388607", "-8388608", "1", "0", "16777215"}},
+      {OB_TYPE_LONG, 0, 0, 0, "", {"2147483647", "-2147483648", "42", " 7", "+7"}},
+      {OB_TYPE_LONGLONG, 0, 0, 0, "", {"9223372036854775807", "-9223372036854775808", "18446744073709551615", "1"}},
+      {OB_TYPE_LONGLONG, 0, 0, 0, "", {"123456789012", "-1", "0", "000123"}},
+      {OB_TYPE_FLOAT, 0, 12, 0, "", {"2.9", "-1.17549e-38", "3.4028234e38", "0", "1e-3"}},
+      {OB_TYPE_FLOAT, 0, 53, 0, "", {"2.9", "-123.456", "1e300", " 5.5", "7abc"}},
+      {OB_TYPE_DOUBLE, 0, 0, 0, "", {"10", "-0.000001", "1.7976931348623157e308", "nan", "inf"}},
+      {OB_TYPE_VARCHAR, 500, 0, 0, "utf8", {"", "abcdefg", "张三", long_text}},
+      {OB_TYPE_VARCHAR, 20, 0, 0, "latin1", {"a", "hello world", ""}},
+      {OB_TYPE_VARCHAR, 80, 0, 0, "utf8mb4", {"utf8mb4 text", "x"}},
+      {OB_TYPE_STRING, 255, 0, 0, "binary", {"1", "abc"}},
+      {OB_TYPE_VAR_STRING, 100, 0, 0, "gbk", {"gbk", ""}},
+      {OB_TYPE_TINY_BLOB, 0, 0, 0, "", {"15", ""}},
+      {OB_TYPE_BLOB, 0, 0, 0, "", {"26", blob}},
+      {OB_TYPE_MEDIUM_BLOB, 0, 0, 0, "", {"medium", blob}},
+      {OB_TYPE_LONG_BLOB, 0, 0, 0, "", {"long", blob}},
+      {OB_TYPE_YEAR, 0, 0, 0, "", {"2017", "0000", "1901", "2155", "0"}},
+      {OB_TYPE_DATE, 0, 0, 0, "", {"2017-12-14", "0000-00-00", "2024-02-29", "9999-12-31"}},
+      {OB_TYPE_BIT, 0, 12, 0, "", {"0", "4095", "1"}},
+      {OB_TYPE_BIT, 0, 64, 0, "", {"18446744073709551615", "9", "0"}},
+      {OB_TYPE_NEWDECIMAL, 0, 25, 10, "", {"123123123123.1122330000", "-1.5", "0.13"}},
+      {OB_TYPE_NEWDECIMAL, 0, 10, 5, "", {"0.13000", "-12345.00001"}},
+      {OB_TYPE_DATETIME, 0, 0, 3, "", {"2017-12-14 09:54:00.112", "-2017-12-14 09:54:00.112", "2017-12-14 09:54:00"}},
+      {OB_TYPE_DATETIME, 0, 0, 0, "", {"0000-00-00 00:00:00", "9999-12-31 23:59:59"}},
+      {OB_TYPE_TIMESTAMP, 0, 0, 6, "", {"1513216440.111300", "1700000000.000001", "-9223372022400.000000"}},
+      {OB_TYPE_TIMESTAMP, 0, 0, 3, "", {"1513216440.111300", "0.000000"}},
+      {OB_TYPE_TIME, 0, 0, 6, "", {"09:54:00.000001", "12:00:00.500000", "-838:59:59.000000", "-00:00:00.000001"}},
+      {OB_TYPE_TIME, 0, 0, 1, "", {"09:54:00.100000", "-12:00:00.500000", "800:00:00"}},
+  };
+}
+
+struct TestTable {
+  std::deque<IColMeta> col_metas;
+  std::vector<TestColumn> columns;
+  ColumnEncoderPlan plan;
+};
+
+static void build_table(TestTable& table, int repeat)
+{
+  std::vector<TestColumn> columns = wide_table_columns();
+  for (int r = 0; r < repeat; ++r) {
+    for (const TestColumn& column : columns) {
+      IColMeta& col_meta = table.col_metas.emplace_back();
+      col_meta.setType(column.type);
+      col_meta.setLength(column.length);
+      col_meta.setPrecision(column.precision);
+      col_meta.setScale(column.scale);
+      col_meta.setEncoding(column.encoding);
+      table.columns.push_back(column);
+      table.plan.add_column(col_meta);
+    }
+  }
+}
+
+// the conversion of a column value as serialize_before/serialize_after do it
+static size_t encode_reference(IColMeta& col_meta, const std::string& value, MsgBuf& row)
+{
+  std::string str(value.data(), value.size());
+  return get_column_val_bytes(col_meta, value.size(), str.data(), row, std::string());
+}
+
+TEST(ColumnEncoder, same_bytes_as_get_column_val_bytes)
+{
+  TestTable table;
+  build_table(table, 1);
+  ASSERT_EQ(table.plan.col_count(), static_cast<int>(table.columns.size()));
+
+  RowImageBuffer row;
+  for (int i = 0; i < table.plan.col_count(); ++i) {
+    for (const std::string& value : table.columns[i].values) {
+      MsgBuf expected;
+      size_t expected_len = encode_reference(table.col_metas[i], value, expected);
+      std::string expected_bytes(expected.byte_size(), '\0');
+      expected.bytes(expected_bytes.data());
+
+      row.clear();
+      size_t len = table.plan.encode(i, table.col_metas[i], value.data(), value.size(), row);
+      std::string where = "column " + std::to_string(i) + " value '" + value + "'";
+      ASSERT_EQ(expected_len, len) << where;
+      ASSERT_EQ(expected_bytes, std::string(reinterpret_cast<const char*>(row.data()), row.size())) << where;
+    }
+  }
+}
+
+TEST(ColumnEncoder, values_without_terminator)
+{
+  IColMeta col_meta;
+  col_meta.setType(OB_TYPE_LONG);
+  ColumnEncoderPlan plan;
+  plan.add_column(col_meta);
+
+  // only the first two characters belong to the value
+  std::string data = "1234";
+  RowImageBuffer row;
+  ASSERT_EQ(4U, plan.encode(0, col_meta, data.data(), 2, row));
+  uint8_t result[4] = {12, 0, 0, 0};
+  ASSERT_EQ(0, memcmp(result, row.data(), sizeof(result)));
+}
+
+/*
+ * Rows of a wide table encoded the way col_val_bytes does it, into a malloc'ed chunk per column, against the compiled
+ * plan writing each row into the scratch image and copying it into the event arena once. Each row pays for the
+ * memoized schema signature and the plan lookup as the convert workers do.
+ */
+TEST(ColumnEncoder, DISABLED_benchmark_wide_table)
+{
+  TestTable table;
+  build_table(table, 4);
+  const int col_count = table.plan.col_count();
+  const int nof_rows = 20000;
+
+  // the table meta owns the columns appended to it
+  ITableMeta table_meta;
+  for (int i = 0; i < col_count; ++i) {
+    auto* col_meta = new IColMeta();
+    std::string name = "c" + std::to_string(i);
+    col_meta->setName(name.c_str());
+    col_meta->setType(table.col_metas[i].getType());
+    col_meta->setLength(table.col_metas[i].getLength());
+    col_meta->setPrecision(table.col_metas[i].getPrecision());
+    col_meta->setScale(table.col_metas[i].getScale());
+    col_meta->setEncoding(table.col_metas[i].getEncoding());
+    table_meta.append(name.c_str(), col_meta);
+  }
+  TableCache table_cache;
+  LocalTableCache local(table_cache);
+
+  // values that the compiled encoders take verbatim, as the bulk of the rows in production
+  std::vector<const std::string*> values(col_count);
+  for (int i = 0; i < col_count; ++i) {
+    values[i] = &table.columns[i].values.front();
+  }
+
+  Timer timer;
+  size_t reference_bytes = 0;
+  for (int r = 0; r < nof_rows; ++r) {
+    MsgBuf row;
+    for (int i = 0; i < col_count; ++i) {
+      reference_bytes += encode_reference(table.col_metas[i], *values[i], row);
+    }
+  }
+  int64_t reference_elapsed = std::max<int64_t>(timer.elapsed(), 1);
+
+  timer.reset();
+  size_t plan_bytes = 0;
+  RowImageBuffer row;
+  EventArena arena(64 * 1024);
+  for (int r = 0; r < nof_rows; ++r) {
+    const ColumnEncoderPlan& plan =
+        local.get_encoder_plan("test", "wide", &table_meta, local.get_schema_signature("test", "wide", &table_meta));
+    row.clear();
+    for (int i = 0; i < col_count; ++i) {
+      plan_bytes += plan.encode(i, *table_meta.getCol(i), values[i]->data(), values[i]->size(), row);
+    }
+    memcpy(arena.alloc_bytes(row.size()), row.data(), row.size());
+    if (arena.used_bytes() > 16 * 1024 * 1024) {
+      arena.reset();
+    }
+  }
+  int64_t plan_elapsed = std::max<int64_t>(timer.elapsed(), 1);
+
+  ASSERT_EQ(reference_bytes, plan_bytes);
+  OMS_INFO("[column encoder] {} columns: get_column_val_bytes {} rows/s, compiled plan {} rows/s",
+      col_count,
+      nof_rows * 1000000L / reference_elapsed,
+      nof_rows * 1000000L / plan_elapsed);
+}
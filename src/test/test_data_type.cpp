@@ -11,11 +11,14 @@
  */
 
 #include <bitset>
+#include <random>
 
 #include "gtest/gtest.h"
 #include "common.h"
 #include "binlog/binlog-instance/binlog_convert.h"
 #include "binlog/data_type.h"
+#include "binlog/numeric_codec.h"
+#include "binlog/temporal_codec.h"
 
 using namespace oceanbase::binlog;
 
@@ -79,6 +82,90 @@ TEST(DataType, decimal_type_bug)
   }
 }
 
+TEST(DataType, parse_int_two_complement)
+{
+  std::vector<std::string> values = {"0", "-0", "1", "-1", "127", "-128", "99999999", "100000000", "12345678901234567",
+      "9223372036854775807", "-9223372036854775808", "18446744073709551615", "-18446744073709551615", "000123"};
+  std::mt19937_64 rng(20240101);
+  for (int i = 0; i < 10000; ++i) {
+    uint64_t num = rng() >> (rng() % 64);
+    values.push_back(std::to_string(num));
+    values.push_back(std::to_string(static_cast<int64_t>(num)));
+  }
+  for (const std::string& value : values) {
+    uint64_t num = 0;
+    ASSERT_TRUE(parse_int_two_complement(value.data(), value.size(), num)) << value;
+    ASSERT_EQ(std::stoull(value), num) << value;
+  }
+
+  // left to std::stoull
+  std::vector<std::string> others = {
+      "", "-", " 7", "+7", "7 ", "1a", "0x10", "18446744073709551616", "123456789012345678901"};
+  for (const std::string& value : others) {
+    uint64_t num = 0;
+    ASSERT_FALSE(parse_int_two_complement(value.data(), value.size(), num)) << value;
+  }
+}
+
+TEST(DataType, decimal_to_bin)
+{
+  std::string val = "123123123123.1122330000";
+  uint8_t result[12] = {128, 0, 123, 7, 86, 181, 179, 6, 176, 138, 40, 0};
+  ASSERT_EQ(12, decimal_bin_size(25, 10));
+  unsigned char bin[12];
+  ASSERT_TRUE(decimal_to_bin(val.data(), val.size(), 25, 10, bin));
+  ASSERT_EQ(0, memcmp(result, bin, sizeof(result)));
+
+  // not canonical, left to the general conversion
+  std::vector<std::string> others = {"", "-", ".5", "0.13", "1.1234567", "12345678901.00000", "1e5", "1,5", " 1.00000"};
+  for (const std::string& value : others) {
+    ASSERT_FALSE(decimal_to_bin(value.data(), value.size(), 10, 5, bin)) << value;
+  }
+  ASSERT_FALSE(decimal_to_bin("1.5", 3, 1, 0, bin));
+}
+
+/*
+ * Random canonical decimals of every precision and scale, encoded by the kernel and by the general conversion.
+ */
+TEST(DataType, decimal_to_bin_differential)
+{
+  std::mt19937 rng(20240101);
+  auto digits = [&rng](int count, bool leading_zero) {
+    std::string str;
+    for (int i = 0; i < count; ++i) {
+      str.push_back(static_cast<char>('0' + ((i == 0 && !leading_zero) ? 1 + rng() % 9 : rng() % 10)));
+    }
+    return str;
+  };
+
+  for (int i = 0; i < 20000; ++i) {
+    int precision = 1 + rng() % 65;
+    int scale = rng() % (std::min(30, precision) + 1);
+    int intg = rng() % (precision - scale + 1);
+    std::string value = rng() % 2 == 0 ? "-" : "";
+    value += intg == 0 ? "0" : digits(intg, false);
+    if (scale > 0) {
+      value += "." + digits(scale, true);
+    }
+
+    IColMeta col_meta;
+    col_meta.setType(OB_TYPE_NEWDECIMAL);
+    col_meta.setPrecision(precision);
+    col_meta.setScale(scale);
+    MsgBuf expected;
+    size_t expected_len = convert_binlog_decimal_fallback(col_meta, value.size(), value.c_str(), expected);
+    std::string expected_bytes(expected.byte_size(), '\0');
+    expected.bytes(expected_bytes.data());
+
+    std::string bin(decimal_bin_size(precision, scale), '\0');
+    std::string where = value + " DECIMAL(" + std::to_string(precision) + "," + std::to_string(scale) + ")";
+    ASSERT_EQ(expected_len, bin.size()) << where;
+    auto* out = reinterpret_cast<unsigned char*>(bin.data());
+    ASSERT_TRUE(decimal_to_bin(value.data(), value.size(), precision, scale, out)) << where;
+    ASSERT_EQ(expected_bytes, bin) << where;
+  }
+}
+
 TEST(DataType, double_type)
 {
   IColMeta col_meta;
@@ -312,6 +399,41 @@ TEST(DataType, timestamp_zero)
   }
 }
 
+TEST(DataType, temporal_to_bin)
+{
+  unsigned char bin[8];
+  std::string date = "2017-12-14";
+  uint8_t date_result[3] = {142, 195, 15};
+  ASSERT_TRUE(date_to_bin(date.data(), date.size(), bin));
+  ASSERT_EQ(0, memcmp(date_result, bin, sizeof(date_result)));
+
+  std::string datetime = "-2017-12-14 09:54:00.112";
+  uint8_t datetime_result[7] = {0x19, 0x9e, 0x5c, 0x9d, 0x80, 0x04, 0x60};
+  ASSERT_TRUE(datetime_to_bin(datetime.data(), datetime.size(), 3, bin));
+  ASSERT_EQ(0, memcmp(datetime_result, bin, sizeof(datetime_result)));
+
+  std::string timestamp = "1513216440.111300";
+  uint8_t timestamp_result[6] = {0x5a, 0x31, 0xd9, 0xb8, 0x04, 0x59};
+  ASSERT_TRUE(timestamp_to_bin(timestamp.data(), timestamp.size(), 4, bin));
+  ASSERT_EQ(0, memcmp(timestamp_result, bin, sizeof(timestamp_result)));
+
+  std::string time = "09:54:00.000001";
+  uint8_t time_result[6] = {128, 157, 128, 0, 0, 1};
+  ASSERT_TRUE(time_to_bin(time.data(), time.size(), 6, bin));
+  ASSERT_EQ(0, memcmp(time_result, bin, sizeof(time_result)));
+
+  // left to the general conversions
+  std::vector<std::string> others = {"", "2017-1-5", "2017-12-14 9:54:00", "1:00:00", "12:00:00.", "12:00:00.1234567",
+      "-9223372022400.000000", "1.5e3", "12:0a:00"};
+  for (const std::string& value : others) {
+    ASSERT_FALSE(date_to_bin(value.data(), value.size(), bin)) << value;
+    ASSERT_FALSE(datetime_to_bin(value.data(), value.size(), 6, bin)) << value;
+    ASSERT_FALSE(time_to_bin(value.data(), value.size(), 6, bin)) << value;
+    ASSERT_FALSE(timestamp_to_bin(value.data(), value.size(), 6, bin)) << value;
+  }
+  ASSERT_FALSE(timestamp_to_bin(timestamp.data(), timestamp.size(), 7, bin));
+}
+
 TEST(DataType, time_type)
 {
   {
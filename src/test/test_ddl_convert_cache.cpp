@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "binlog/ddl-parser/ddl_convert_cache.h"
+
+using namespace oceanbase::binlog;
+
+TEST(DdlConvertCache, normalize)
+{
+  ASSERT_EQ("ALTER TABLE t1 ADD COLUMN c1 int",
+      DdlConvertCache::normalize("  ALTER  TABLE\tt1\n  ADD COLUMN c1   int \n"));
+  // whitespace is collapsed, never removed
+  ASSERT_NE(DdlConvertCache::normalize("create table t (c int)"), DdlConvertCache::normalize("create table t(c int)"));
+
+  // quoted names, literals and comments keep their whitespace
+  ASSERT_EQ("ALTER TABLE `a  b` COMMENT 'x   y'", DdlConvertCache::normalize("ALTER TABLE  `a  b`  COMMENT 'x   y'"));
+  ASSERT_EQ("SET c = 'it\\'s  ok' , d = \"a  b\"", DdlConvertCache::normalize("SET c = 'it\\'s  ok' ,  d = \"a  b\""));
+  ASSERT_EQ("DROP /*  keep   */ TABLE t", DdlConvertCache::normalize("DROP /*  keep   */   TABLE t"));
+  ASSERT_EQ("DROP TABLE t --  keep  \n t2", DdlConvertCache::normalize("DROP TABLE t --  keep  \n   t2"));
+  ASSERT_EQ("COMMENT 'unterminated  ", DdlConvertCache::normalize("COMMENT   'unterminated  "));
+  ASSERT_EQ("", DdlConvertCache::normalize(" \n\t "));
+}
+
+TEST(DdlConvertCache, lru)
+{
+  DdlConvertCache cache(2);
+  int ret = 0;
+  std::string result;
+  ASSERT_FALSE(cache.get("a", ret, result));
+
+  cache.put("a", 0, "A");
+  cache.put("b", -1, "");
+  ASSERT_TRUE(cache.get("a", ret, result));
+  ASSERT_EQ(0, ret);
+  ASSERT_EQ("A", result);
+
+  // b is the least recently used one
+  cache.put("c", 0, "C");
+  ASSERT_EQ(2, cache.size());
+  ASSERT_FALSE(cache.get("b", ret, result));
+  ASSERT_TRUE(cache.get("a", ret, result));
+  ASSERT_TRUE(cache.get("c", ret, result));
+  ASSERT_EQ("C", result);
+
+  cache.put("c", -1, "");
+  ASSERT_TRUE(cache.get("c", ret, result));
+  ASSERT_EQ(-1, ret);
+  ASSERT_EQ("", result);
+
+  cache.set_capacity(1);
+  ASSERT_EQ(1, cache.size());
+  ASSERT_TRUE(cache.get("c", ret, result));
+
+  cache.set_capacity(0);
+  cache.put("d", 0, "D");
+  ASSERT_EQ(0, cache.size());
+  ASSERT_FALSE(cache.get("d", ret, result));
+}
+
+TEST(DdlConvertCache, concurrent)
+{
+  DdlConvertCache cache(64);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t]() {
+      int ret = 0;
+      std::string result;
+      for (int i = 0; i < 10000; ++i) {
+        std::string key = "ALTER TABLE t" + std::to_string((i * 7 + t) % 100) + " ADD PARTITION";
+        if (cache.get(key, ret, result)) {
+          ASSERT_EQ(key + " converted", result);
+        } else {
+          cache.put(key, 0, key + " converted");
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(64, cache.size());
+}
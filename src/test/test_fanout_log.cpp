@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "logmsg_factory.h"
+#include "common.h"
+#include "fanout_log.h"
+
+using namespace oceanbase::logproxy;
+
+static const uint64_t SECOND_US = 1000000;
+
+class FanoutLogTest : public testing::Test {
+protected:
+  FanoutLogTest()
+      : log(
+            [this](ILogRecord* record) {
+              ++released;
+              DRCMessageFactory::destroy(record);
+            },
+            [this](ILogRecord* record) {
+              serialized.insert(record);
+              return record != unserializable;
+            })
+  {
+    log.init(100 * SECOND_US);
+  }
+
+  ILogRecord* append(int type, const char* dbname = "", const char* tbname = "", long timestamp = 100)
+  {
+    ILogRecord* record = LogMsgFactory::createLogRecord();
+    record->setRecordType(type);
+    record->setDbname(dbname);
+    record->setTbname(tbname);
+    record->setTimestamp(timestamp);
+    log.append(record);
+    ++created;
+    return record;
+  }
+
+  static FanoutLog::Cursor cursor_of(const std::string& table_whites, uint64_t start_us = 0)
+  {
+    FanoutLog::Cursor cursor;
+    EXPECT_EQ(OMS_OK, parse_table_patterns(table_whites, cursor.table_whites));
+    cursor.start_us = start_us;
+    return cursor;
+  }
+
+  size_t created = 0;
+  size_t released = 0;
+  std::set<ILogRecord*> serialized;
+  ILogRecord* unserializable = nullptr;
+  FanoutLog log;
+};
+
+TEST_F(FanoutLogTest, seek)
+{
+  append(EBEGIN);
+  append(EINSERT, "t1.db1", "orders");
+  append(ECOMMIT);
+  append(HEARTBEAT, "", "", 101);
+  append(EBEGIN, "", "", 102);
+  append(EINSERT, "t1.db1", "orders", 102);
+
+  // from now on, the rest of the transaction in progress aside
+  FanoutLog::Cursor cursor = cursor_of("t1.db1.*");
+  ASSERT_EQ(OMS_OK, log.seek(cursor));
+  ASSERT_EQ(6, cursor.seq);
+  ASSERT_TRUE(cursor.skip_trx);
+
+  cursor = cursor_of("t1.db1.*", 100 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(cursor));
+  ASSERT_EQ(0, cursor.seq);
+  ASSERT_FALSE(cursor.skip_trx);
+
+  cursor = cursor_of("t1.db1.*", 101 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(cursor));
+  ASSERT_EQ(3, cursor.seq);
+
+  // before the reader started
+  cursor = cursor_of("t1.db1.*", 99 * SECOND_US);
+  ASSERT_EQ(OMS_FAILED, log.seek(cursor));
+
+  // trimmed
+  log.trim(log.head(), 3);
+  cursor = cursor_of("t1.db1.*", 100 * SECOND_US);
+  ASSERT_EQ(OMS_FAILED, log.seek(cursor));
+  cursor = cursor_of("t1.db1.*", 101 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(cursor));
+  ASSERT_EQ(3, cursor.seq);
+}
+
+TEST_F(FanoutLogTest, take)
+{
+  append(EBEGIN);
+  append(EINSERT, "t1.db1", "users");
+  append(ECOMMIT);
+  ILogRecord* begin = append(EBEGIN);
+  ILogRecord* users = append(EINSERT, "t1.db1", "users");
+  ILogRecord* orders = append(EINSERT, "t1.db1", "orders");
+  ILogRecord* commit = append(ECOMMIT);
+  ILogRecord* ddl = append(EDDL, "t1.db1", "");
+  append(EDDL, "t1.db2", "");
+  ILogRecord* heartbeat = append(HEARTBEAT);
+
+  // a transaction without a record of the cursor is left out, the BEGIN comes with the first record
+  FanoutLog::Cursor cursor = cursor_of("T1.db1.orders", 100 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(cursor));
+  std::vector<ILogRecord*> taken;
+  ASSERT_EQ(OMS_OK, log.take(cursor, 3, taken));
+  ASSERT_EQ((std::vector<ILogRecord*>{begin, orders}), taken);
+  ASSERT_EQ(6, cursor.seq);
+  ASSERT_EQ(6, cursor.bound());
+
+  ASSERT_EQ(OMS_OK, log.take(cursor, 100, taken));
+  ASSERT_EQ((std::vector<ILogRecord*>{begin, orders, commit, ddl, heartbeat}), taken);
+  ASSERT_EQ(log.head(), cursor.seq);
+
+  // serialized when taken only
+  ASSERT_EQ((std::set<ILogRecord*>(taken.begin(), taken.end())), serialized);
+
+  FanoutLog::Cursor all = cursor_of("t1.*.*", 100 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(all));
+  std::vector<ILogRecord*> all_taken;
+  ASSERT_EQ(OMS_OK, log.take(all, 100, all_taken));
+  ASSERT_EQ(log.size(), all_taken.size());
+  ASSERT_EQ(all_taken.size(), serialized.size());
+  ASSERT_EQ(1, serialized.count(users));
+
+  log.release(taken);
+  log.release(all_taken);
+}
+
+TEST_F(FanoutLogTest, take_unserializable)
+{
+  ILogRecord* begin = append(EBEGIN);
+  unserializable = append(EINSERT, "t1.db1", "orders");
+  append(ECOMMIT);
+
+  FanoutLog::Cursor cursor = cursor_of("t1.db1.orders", 100 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(cursor));
+  std::vector<ILogRecord*> taken;
+  ASSERT_EQ(OMS_FAILED, log.take(cursor, 100, taken));
+  ASSERT_EQ((std::vector<ILogRecord*>{begin}), taken);
+  log.release(taken);
+}
+
+TEST_F(FanoutLogTest, trim_and_release)
+{
+  for (int i = 0; i < 4; ++i) {
+    append(EBEGIN);
+    append(EINSERT, "t1.db1", "orders");
+    append(ECOMMIT);
+  }
+
+  FanoutLog::Cursor cursor = cursor_of("t1.db1.orders", 100 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(cursor));
+  std::vector<ILogRecord*> taken;
+  ASSERT_EQ(OMS_OK, log.take(cursor, 7, taken));
+  ASSERT_EQ(6, taken.size());
+  ASSERT_EQ(6, cursor.bound());
+
+  // the entries from the bound on stay, and so do the max_records latest ones
+  log.trim(cursor.bound(), 8);
+  ASSERT_EQ(4, log.begin());
+  log.trim(cursor.bound(), 0);
+  ASSERT_EQ(6, log.begin());
+  ASSERT_EQ(6, log.size());
+
+  // the records trimmed are released once the cursor lets them go too
+  ASSERT_EQ(0, released);
+  ASSERT_EQ(12, log.referenced());
+  log.release(taken);
+  ASSERT_EQ(6, released);
+  ASSERT_EQ(6, log.referenced());
+
+  // released once only
+  log.release({taken[0]});
+  ASSERT_EQ(6, released);
+
+  log.clear();
+  ASSERT_EQ(created, released);
+  ASSERT_EQ(0, log.referenced());
+}
+
+TEST_F(FanoutLogTest, attach_and_detach)
+{
+  append(EBEGIN);
+  append(EINSERT, "t1.db1", "orders");
+  append(ECOMMIT);
+
+  // sessions attach and detach with the records in their queues
+  FanoutLog::Cursor first = cursor_of("t1.db1.*", 100 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(first));
+  std::vector<ILogRecord*> first_taken;
+  ASSERT_EQ(OMS_OK, log.take(first, 100, first_taken));
+  ASSERT_EQ(3, first_taken.size());
+
+  FanoutLog::Cursor second = cursor_of("t1.db1.orders", 100 * SECOND_US);
+  ASSERT_EQ(OMS_OK, log.seek(second));
+  std::vector<ILogRecord*> second_taken;
+  ASSERT_EQ(OMS_OK, log.take(second, 100, second_taken));
+  ASSERT_EQ(first_taken, second_taken);
+
+  log.trim(log.head(), 0);
+  ASSERT_EQ(0, log.size());
+  log.release(first_taken);
+  ASSERT_EQ(0, released);
+  ASSERT_EQ(3, log.referenced());
+
+  // a session attaching from now on is not given the records gone from the log
+  append(EBEGIN, "", "", 101);
+  append(EINSERT, "t1.db1", "orders", 101);
+  FanoutLog::Cursor third = cursor_of("t1.db1.*");
+  ASSERT_EQ(OMS_OK, log.seek(third));
+  ASSERT_TRUE(third.skip_trx);
+  append(ECOMMIT, "", "", 101);
+  std::vector<ILogRecord*> third_taken;
+  ASSERT_EQ(OMS_OK, log.take(third, 100, third_taken));
+  ASSERT_TRUE(third_taken.empty());
+
+  log.release(second_taken);
+  ASSERT_EQ(3, released);
+  log.clear();
+  ASSERT_EQ(created, released);
+}
@@ -10,6 +10,9 @@
  * See the Mulan PubL v2 for more details.
  */
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include "gtest/gtest.h"
 #include "common.h"
 #include "binlog/binlog_index.h"
@@ -39,6 +42,96 @@ TEST(IndexFile, add_index)
   ASSERT_EQ(true, FsUtil::remove(path + BINLOG_INDEX_NAME, false));
 }
 
+TEST(IndexFile, migrate_and_update)
+{
+  std::string index_file = fs::current_path().string() + "/mysql-bin-migrate.index";
+  FsUtil::remove(index_file, false);
+  FsUtil::remove(index_file + ".text", false);
+  std::string text_index;
+  for (int i = 1; i <= 3; ++i) {
+    BinlogIndexRecord record(CommonUtils::fill_binlog_file_name(i), i);
+    record.set_position(i * 100);
+    record.set_current_mapping(std::make_pair("1_" + std::to_string(i), i));
+    text_index += record.to_string();
+  }
+  ASSERT_EQ(OMS_OK, FsUtil::write_file(index_file, text_index));
+
+  {
+    // the text index is migrated on first access
+    BinlogIndexManager index_manager(index_file);
+    BinlogIndexRecord record;
+    ASSERT_EQ(OMS_OK, index_manager.get_index(CommonUtils::fill_binlog_file_name(2), record));
+    ASSERT_EQ(200, record.get_position());
+    ASSERT_EQ("1_2", record.get_current_mapping().first);
+    ASSERT_EQ(OMS_OK, index_manager.get_latest_index(record));
+    for (int i = 1; i <= 11; ++i) {
+      record.set_position(1000 + i);
+      ASSERT_EQ(OMS_OK, index_manager.update_index(record));
+    }
+  }
+  ASSERT_TRUE(fs::exists(index_file + ".text"));
+
+  BinlogIndexManager index_manager(index_file);
+  std::vector<BinlogIndexRecord*> index_records;
+  defer(release_vector(index_records));
+  ASSERT_EQ(OMS_OK, index_manager.fetch_index_vector(index_records));
+  ASSERT_EQ(3, index_records.size());
+  ASSERT_EQ(CommonUtils::fill_binlog_file_name(1), index_records.front()->get_file_name());
+  ASSERT_EQ(1011, index_records.back()->get_position());
+
+  // a torn update of the latest copy falls back to the previous one
+  int fd = open(index_file.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  char garbage[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_EQ(8, pwrite(fd, garbage, sizeof(garbage), 3 * 2048 + 1024 + 32));
+  close(fd);
+  BinlogIndexRecord record;
+  BinlogIndexManager recovered_manager(index_file);
+  ASSERT_EQ(OMS_OK, recovered_manager.get_latest_index(record));
+  ASSERT_EQ(1010, record.get_position());
+
+  FsUtil::remove(index_file, false);
+  FsUtil::remove(index_file + ".text", false);
+}
+
+TEST(IndexFile, export_text)
+{
+  std::string index_file = fs::current_path().string() + "/mysql-bin-export.index";
+  std::string text_file = index_file + ".export";
+  FsUtil::remove(index_file, false);
+  std::string text_index;
+  {
+    BinlogIndexManager index_manager(index_file);
+    for (int i = 1; i <= 3; ++i) {
+      BinlogIndexRecord record(CommonUtils::fill_binlog_file_name(i), i);
+      record.set_checkpoint(1700000000 + i);
+      record.set_position(i * 100);
+      record.set_current_mapping(std::make_pair("1_" + std::to_string(i), i));
+      record.set_before_mapping(std::make_pair("1_" + std::to_string(i - 1), i - 1));
+      ASSERT_EQ(OMS_OK, index_manager.add_index(record));
+      text_index += record.to_string();
+    }
+  }
+
+  // the slotted index reads back as the text index of earlier versions
+  std::vector<BinlogIndexRecord> records;
+  ASSERT_EQ(OMS_OK, BinlogIndexManager::read_index_file(index_file, records));
+  ASSERT_EQ(3, records.size());
+  ASSERT_EQ(OMS_OK, BinlogIndexManager::write_text_index_file(text_file, records));
+  std::string exported;
+  ASSERT_TRUE(FsUtil::read_file(text_file, exported, false));
+  ASSERT_EQ(text_index, exported);
+
+  // a text index is read as is, without being migrated
+  ASSERT_EQ(OMS_OK, BinlogIndexManager::read_index_file(text_file, records));
+  ASSERT_EQ(3, records.size());
+  ASSERT_EQ(300, records.back().get_position());
+  ASSERT_FALSE(fs::exists(text_file + ".text"));
+
+  FsUtil::remove(index_file, false);
+  FsUtil::remove(text_file, false);
+}
+
 TEST(IndexFile, release_vector)
 {
   std::vector<BinlogIndexRecord*> vector_ptr;
@@ -169,3 +262,36 @@ TEST(IndexFile, multi_thread_access)
   ASSERT_EQ(500, dumper.get_wake_times());
   FsUtil::remove("mysql-bin.index");
 }
+
+TEST(IndexFile, commit_listener)
+{
+  CommittedPosition committed;
+  int event_fd = eventfd(0, EFD_NONBLOCK);
+  ASSERT_GE(event_fd, 0);
+  int listener_id = committed.add_listener(event_fd);
+  ASSERT_GE(listener_id, 0);
+  uint64_t count = 0;
+
+  // not armed, nothing is signaled
+  committed.publish(1, 100);
+  ASSERT_EQ(-1, read(event_fd, &count, sizeof(count)));
+
+  // armed, the next publish signals once
+  committed.arm_listener(listener_id);
+  committed.publish(1, 200);
+  committed.publish(1, 300);
+  ASSERT_EQ(sizeof(count), read(event_fd, &count, sizeof(count)));
+  ASSERT_EQ(1, count);
+
+  uint64_t file_index = 0;
+  uint64_t position = 0;
+  ASSERT_TRUE(committed.load(file_index, position));
+  ASSERT_EQ(1, file_index);
+  ASSERT_EQ(300, position);
+
+  committed.remove_listener(listener_id);
+  committed.arm_listener(listener_id);
+  committed.publish(2, 4);
+  ASSERT_EQ(-1, read(event_fd, &count, sizeof(count)));
+  close(event_fd);
+}
@@ -15,6 +15,7 @@
 #include "common.h"
 #include "log.h"
 #include "binlog/json_parser.h"
+#include "binlog/jsonb_encoder.h"
 
 TEST(JSON, json_parser)
 {
@@ -317,3 +318,81 @@ TEST(JSON, json_empty_object)
   ASSERT_EQ(true, memcmp(result, result_bytes, sizeof(result)) == 0);
   free(result_bytes);
 }
+
+static std::string legacy_jsonb(const std::string& json_str, bool is_json_diff)
+{
+  oceanbase::logproxy::MsgBuf msg_buf;
+  if (is_json_diff) {
+    oceanbase::binlog::JsonParser::parse_json_diff(json_str.c_str(), msg_buf);
+  } else {
+    oceanbase::binlog::JsonParser::parser(json_str.c_str(), msg_buf);
+  }
+  std::string bytes(msg_buf.byte_size(), '\0');
+  msg_buf.bytes(bytes.data());
+  return bytes;
+}
+
+static std::string streaming_jsonb(const std::string& json_str, bool is_json_diff)
+{
+  oceanbase::binlog::JsonbEncoder encoder;
+  EXPECT_TRUE(encoder.encode(json_str.data(), json_str.size(), is_json_diff)) << json_str;
+  std::string bytes(encoder.size(), '\0');
+  encoder.write(reinterpret_cast<unsigned char*>(bytes.data()));
+  return bytes;
+}
+
+TEST(JSON, jsonb_encoder)
+{
+  std::vector<std::string> documents = {
+      R"([{"abs": 123}, "123@#$%^&*()_+", [0]])",
+      R"({"obj": {}, "arr": [], "dup": 1, "dup": "2"})",
+      R"({"null": null, "true": true, "false": false, "str": "a\"b\\cé\u0000d"})",
+      R"([0, -0, 32767, 32768, -32768, -32769, 2147483647, 2147483648, -2147483648, -2147483649])",
+      R"([4294967295, 4294967296, 9223372036854775807, 9223372036854775808, 18446744073709551615])",
+      R"([18446744073709551616, -9223372036854775808, 1.5, -2.25e10, 0.1])",
+      R"({"a": {"b": {"c": [1, {"d": [null, "e", 70000]}]}}})",
+      R"(  "scalar"  )",
+      "-7",
+      "4294967296",
+      "false",
+      "null",
+  };
+  documents.emplace_back("[\"" + std::string(300, 'x') + "\", {\"" + std::string(200, 'k') + "\": 1}]");
+  std::string nested(JSON_DOCUMENT_MAX_DEPTH - 1, '[');
+  nested += "1" + std::string(JSON_DOCUMENT_MAX_DEPTH - 1, ']');
+  documents.emplace_back(nested);
+  for (const auto& document : documents) {
+    ASSERT_EQ(legacy_jsonb(document, false), streaming_jsonb(document, false)) << document;
+  }
+}
+
+TEST(JSON, jsonb_encoder_diff)
+{
+  std::vector<std::string> diffs = {
+      R"({"diffs": []})",
+      R"({"diffs": [{"op": "replace", "path": "$.a", "value": {"b": [1, 2]}}]})",
+      R"({"diffs": [{"op": "insert", "path": "$.a[1]", "value": 7}, {"op": "remove", "path": "$.c"}]})",
+      R"({"x": 1, "diffs": [{"path": "$.a", "value": "v", "op": "replace"}]})",
+  };
+  diffs.emplace_back(R"({"diffs": [{"op": "replace", "path": "$.)" + std::string(300, 'p') + R"(", "value": null}]})");
+  for (const auto& diff : diffs) {
+    ASSERT_EQ(legacy_jsonb(diff, true), streaming_jsonb(diff, true)) << diff;
+  }
+}
+
+TEST(JSON, jsonb_encoder_rejects)
+{
+  oceanbase::binlog::JsonbEncoder encoder;
+  std::string too_deep(JSON_DOCUMENT_MAX_DEPTH, '[');
+  too_deep += std::string(JSON_DOCUMENT_MAX_DEPTH, ']');
+  std::vector<std::string> documents = {"", "{", R"({"a": 1,})", "1 2", R"({"a\u0000b": 1})", too_deep};
+  for (const auto& document : documents) {
+    ASSERT_FALSE(encoder.encode(document.data(), document.size())) << document;
+  }
+
+  std::vector<std::string> diffs = {
+      "[]", R"({"diffs": {}})", R"({"diffs": [1]})", R"({"diffs": [{"op": "replace", "path": "$.a"}]})"};
+  for (const auto& diff : diffs) {
+    ASSERT_FALSE(encoder.encode(diff.data(), diff.size(), true)) << diff;
+  }
+}
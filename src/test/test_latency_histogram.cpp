@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "log.h"
+#include "timer.h"
+#include "latency_histogram.h"
+#include "pipeline_latency.h"
+#include "metric/constant.h"
+
+using namespace oceanbase::logproxy;
+using oceanbase::binlog::PipelineLatency;
+
+static uint64_t total_count(const LatencyHistogram& histogram)
+{
+  std::vector<uint64_t> counts;
+  histogram.snapshot(counts);
+  uint64_t total = 0;
+  for (uint64_t count : counts) {
+    total += count;
+  }
+  return total;
+}
+
+TEST(LatencyHistogram, buckets)
+{
+  ASSERT_EQ(1024, LatencyHistogram::BUCKET_COUNT);
+  ASSERT_EQ(LatencyHistogram::BUCKET_COUNT - 1, LatencyHistogram::bucket_of(UINT64_MAX));
+  ASSERT_EQ(LatencyHistogram::MAX_VALUE, LatencyHistogram::highest_equivalent(LatencyHistogram::BUCKET_COUNT - 1));
+
+  // every bucket follows the previous one and holds values within 1/32 of each other
+  uint64_t lowest = 0;
+  for (size_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+    uint64_t highest = LatencyHistogram::highest_equivalent(bucket);
+    ASSERT_EQ(bucket, LatencyHistogram::bucket_of(lowest));
+    ASSERT_EQ(bucket, LatencyHistogram::bucket_of(highest));
+    ASSERT_LE(highest - lowest, lowest / 32);
+    lowest = highest + 1;
+  }
+}
+
+TEST(LatencyHistogram, quantile)
+{
+  LatencyHistogram histogram;
+  std::vector<uint64_t> counts;
+  histogram.snapshot(counts);
+  ASSERT_EQ(0, LatencyHistogram::quantile(counts, 0.99));
+
+  for (uint64_t value = 1; value <= 10000; ++value) {
+    histogram.record(value);
+  }
+  histogram.snapshot(counts);
+  for (double q : {0.5, 0.99, 0.999}) {
+    auto expected = static_cast<uint64_t>(q * 10000);
+    uint64_t value = LatencyHistogram::quantile(counts, q);
+    ASSERT_GE(value, expected);
+    ASSERT_LE(value, expected + expected / 32);
+  }
+}
+
+TEST(PipelineLatency, report_interval)
+{
+  PipelineLatency& latency = PipelineLatency::instance();
+  std::vector<uint64_t> quantiles;
+  latency.report(quantiles);
+  size_t nof_quantiles = BINLOG_INSTANCE_PIPELINE_QUANTILES.size();
+  ASSERT_EQ(BINLOG_INSTANCE_PIPELINE_STAGES.size() * nof_quantiles, quantiles.size());
+
+  uint64_t commit_us = 1000000;
+  for (int i = 0; i < 1000; ++i) {
+    latency.record(oceanbase::binlog::PIPELINE_CONVERT, commit_us, commit_us + 500);
+  }
+  // nothing is recorded without a commit timestamp
+  latency.record(oceanbase::binlog::PIPELINE_FETCH, 0, commit_us);
+  latency.report(quantiles);
+  ASSERT_EQ(0, quantiles[oceanbase::binlog::PIPELINE_FETCH * nof_quantiles]);
+  ASSERT_EQ(503, quantiles[oceanbase::binlog::PIPELINE_CONVERT * nof_quantiles]);
+
+  // the marks are taken by the first dumper getting past them, once
+  latency.mark_persisted("mysql-bin.000001", 1000, commit_us);
+  latency.mark_persisted("mysql-bin.000002", 200, commit_us);
+  latency.mark_sent("mysql-bin.000001", 999);
+  latency.mark_sent("mysql-bin.000002", 100);
+  latency.mark_sent("mysql-bin.000002", 100);
+  ASSERT_EQ(1, total_count(latency.histogram(oceanbase::binlog::PIPELINE_SEND)));
+
+  // quantiles only cover what was recorded since the previous report
+  latency.report(quantiles);
+  ASSERT_EQ(0, quantiles[oceanbase::binlog::PIPELINE_CONVERT * nof_quantiles]);
+  ASSERT_GT(quantiles[oceanbase::binlog::PIPELINE_SEND * nof_quantiles], 0);
+}
+
+TEST(LatencyHistogram, DISABLED_benchmark_record)
+{
+  const uint64_t per_thread = 10000000;
+  std::vector<uint64_t> values(4096);
+  std::mt19937_64 gen(19);
+  std::lognormal_distribution<double> latency(8, 1.5);
+  for (auto& value : values) {
+    value = static_cast<uint64_t>(latency(gen));
+  }
+
+  for (int threads : {1, 4}) {
+    LatencyHistogram histogram;
+    Timer timer;
+    std::vector<std::thread> recorders;
+    for (int t = 0; t < threads; ++t) {
+      recorders.emplace_back([&histogram, &values, per_thread]() {
+        for (uint64_t i = 0; i < per_thread; ++i) {
+          histogram.record(values[i & 4095]);
+        }
+      });
+    }
+    for (auto& recorder : recorders) {
+      recorder.join();
+    }
+    int64_t elapsed = std::max<int64_t>(timer.elapsed(), 1);
+
+    std::vector<uint64_t> counts;
+    histogram.snapshot(counts);
+    OMS_INFO("[latency histogram] {} threads: {} ns per record, p50 {} us, p99 {} us, p999 {} us",
+        threads,
+        elapsed * 1000 / per_thread,
+        LatencyHistogram::quantile(counts, 0.5),
+        LatencyHistogram::quantile(counts, 0.99),
+        LatencyHistogram::quantile(counts, 0.999));
+  }
+}
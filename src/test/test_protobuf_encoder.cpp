@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "logmsg_factory.h"
+#include "common.h"
+#include "msg_buf.h"
+#include "codec/encoder.h"
+#include "logproxy.pb.h"
+
+using namespace oceanbase::logproxy;
+
+static void assert_framed_as_protobuf(
+    int32_t compress_type, int32_t raw_len, int32_t compressed_len, int32_t count, size_t records_size)
+{
+  RecordData pb_record_data;
+  pb_record_data.set_compress_type(compress_type);
+  pb_record_data.set_raw_len(raw_len);
+  pb_record_data.set_compressed_len(compressed_len);
+  pb_record_data.set_count(count);
+  pb_record_data.set_records(std::string(records_size, 'r'));
+  std::string serialized(pb_record_data.ByteSizeLong(), '\0');
+  ASSERT_TRUE(pb_record_data.SerializeToArray(&serialized[0], (int)serialized.size()));
+
+  char prefix[ProtobufEncoder::RECORD_DATA_PREFIX_MAX_SIZE];
+  size_t prefix_size =
+      ProtobufEncoder::frame_record_data(prefix, compress_type, raw_len, compressed_len, count, records_size);
+  ASSERT_EQ(serialized.size(), prefix_size + records_size);
+  ASSERT_EQ(serialized.substr(0, prefix_size), std::string(prefix, prefix_size));
+}
+
+TEST(ProtobufEncoder, frame_record_data)
+{
+  // fields of default value are left out, up to the whole message
+  assert_framed_as_protobuf(0, 0, 0, 0, 0);
+  assert_framed_as_protobuf(0, 0, 0, 0, 1);
+  assert_framed_as_protobuf(0, 100, 100, 1, 100);
+  assert_framed_as_protobuf(3, 1 << 20, 300, 5, 300);
+  assert_framed_as_protobuf(2, INT32_MAX, 1 << 21, INT32_MAX, 1 << 21);
+  // negative int32 take the 10 bytes of their 64 bits sign extended
+  assert_framed_as_protobuf(-1, INT32_MIN, -5, -128, 127);
+  assert_framed_as_protobuf(1, -1, 0, 0, 128);
+}
+
+TEST(ProtobufEncoder, encode_record_data)
+{
+  std::vector<std::string> names = {"orders", "users", std::string(300, 't')};
+  std::vector<ILogRecord*> records;
+  std::string formatted;
+  LogMsgBuf lmb;
+  for (const std::string& name : names) {
+    ILogRecord* record = LogMsgFactory::createLogRecord();
+    record->setRecordType(EINSERT);
+    record->setDbname("db");
+    record->setTbname(name.c_str());
+    size_t size = 0;
+    ASSERT_NE(nullptr, record->toString(&size, &lmb, true));
+    const char* buf = record->getFormatedString(&size);
+    formatted.append(buf, size);
+    records.push_back(record);
+  }
+
+  RecordDataMessage message(records);
+  message.compress_type = CompressType::PLAIN;
+  MsgBuf buffer;
+  size_t raw_len = 0;
+  ASSERT_EQ(OMS_OK, ProtobufEncoder::instance().encode(message, buffer, raw_len));
+  std::string packet(buffer.byte_size(), '\0');
+  MsgBufReader reader(buffer);
+  ASSERT_EQ(OMS_OK, reader.read(&packet[0], packet.size()));
+
+  // version, type and size of the packet ahead of RecordData
+  size_t header_size = PACKET_VERSION_SIZE + 1 + 4;
+  ASSERT_EQ((int8_t)MessageType::DATA_CLIENT, (int8_t)packet[PACKET_VERSION_SIZE]);
+  RecordData pb_record_data;
+  ASSERT_TRUE(pb_record_data.ParseFromArray(packet.data() + header_size, (int)(packet.size() - header_size)));
+  ASSERT_EQ((int)CompressType::PLAIN, pb_record_data.compress_type());
+  ASSERT_EQ(formatted.size(), raw_len);
+  ASSERT_EQ((int32_t)formatted.size(), pb_record_data.raw_len());
+  ASSERT_EQ((int32_t)formatted.size(), pb_record_data.compressed_len());
+  ASSERT_EQ(3, pb_record_data.count());
+  ASSERT_EQ(formatted, pb_record_data.records());
+
+  for (ILogRecord* record : records) {
+    DRCMessageFactory::destroy(record);
+  }
+}
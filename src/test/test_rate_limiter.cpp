@@ -81,4 +81,22 @@ TEST(EventRateLimiter, rate_limiter)
     }
     ASSERT_GE(timer.elapsed(), 7900000);
   }
-}
\ No newline at end of file
+}
+
+TEST(EventRateLimiter, reserve_event)
+{
+  EventRateLimiter limiter;
+  ASSERT_EQ(0, limiter.reserve_event(100));
+
+  // nothing sleeps, the wait grows with the events reserved ahead of their rate
+  limiter.update_throttle_rps(100);
+  limiter.update_throttle_iops(20000000);
+  Timer timer;
+  uint64_t micros_to_wait = 0;
+  for (int i = 0; i < 200; i++) {
+    micros_to_wait = limiter.reserve_event(200000);
+  }
+  ASSERT_LT(timer.elapsed(), 500000);
+  ASSERT_GE(micros_to_wait, 1900000);
+  ASSERT_LT(micros_to_wait, 2100000);
+}
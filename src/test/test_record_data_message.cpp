@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "logmsg_factory.h"
+#include "common.h"
+#include "msg_buf.h"
+#include "codec/message.h"
+
+using namespace oceanbase::logproxy;
+
+static void destroy_records(std::vector<ILogRecord*>& records)
+{
+  for (ILogRecord* record : records) {
+    DRCMessageFactory::destroy(record);
+  }
+  records.clear();
+}
+
+TEST(RecordDataMessage, compressed_round_trip)
+{
+  // many small records, and a record larger than the rest together
+  std::vector<std::string> names;
+  for (int i = 0; i < 2000; ++i) {
+    names.push_back("table_" + std::to_string(i) + std::string(i % 97, 'x'));
+  }
+  names.emplace_back(150 * 1024, 'y');
+
+  std::vector<ILogRecord*> records;
+  LogMsgBuf lmb;
+  for (size_t i = 0; i < names.size(); ++i) {
+    ILogRecord* record = LogMsgFactory::createLogRecord();
+    record->setRecordType(EINSERT);
+    record->setDbname("db");
+    record->setTbname(names[i].c_str());
+    record->setTimestamp((long)i);
+    size_t size = 0;
+    ASSERT_NE(nullptr, record->toString(&size, &lmb, true));
+    records.push_back(record);
+  }
+
+  for (CompressType compress_type : {CompressType::LZ4, CompressType::ZSTD}) {
+    RecordDataMessage message(records);
+    message.compress_type = compress_type;
+    MsgBuf buffer;
+    size_t raw_len = 0;
+    ASSERT_EQ(OMS_OK, message.encode_log_records(buffer, raw_len));
+    ASSERT_GT(raw_len, 4 * 64 * 1024);
+    ASSERT_EQ(1, buffer.count());
+    const char* compressed = buffer.begin()->buffer();
+    size_t compressed_size = buffer.byte_size();
+
+    std::vector<ILogRecord*> decoded;
+    RecordDataMessage decoded_message(decoded);
+    ASSERT_EQ(OMS_OK,
+        decoded_message.decode_log_records(compress_type, compressed, compressed_size, raw_len, (int)records.size()));
+    ASSERT_EQ(records.size(), decoded.size());
+    for (size_t i = 0; i < decoded.size(); ++i) {
+      ASSERT_EQ(EINSERT, decoded[i]->recordType());
+      ASSERT_STREQ("db", decoded[i]->dbname());
+      ASSERT_STREQ(names[i].c_str(), decoded[i]->tbname());
+      ASSERT_EQ((long)i, decoded[i]->getTimestamp());
+    }
+    destroy_records(decoded);
+
+    // a packet cut short or announcing another raw size is rejected
+    RecordDataMessage truncated_message(decoded);
+    ASSERT_EQ(OMS_FAILED,
+        truncated_message.decode_log_records(
+            compress_type, compressed, compressed_size - 1, raw_len, (int)records.size()));
+    ASSERT_EQ(OMS_FAILED,
+        truncated_message.decode_log_records(
+            compress_type, compressed, compressed_size, raw_len + 1, (int)records.size()));
+    destroy_records(decoded);
+  }
+  destroy_records(records);
+}
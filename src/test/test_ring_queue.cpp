@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "log.h"
+#include "timer.h"
+#include "blocking_queue.hpp"
+#include "ring_queue.hpp"
+
+using oceanbase::logproxy::BlockingQueue;
+using oceanbase::logproxy::RingQueue;
+using oceanbase::logproxy::Timer;
+
+TEST(RingQueue, offer_poll)
+{
+  RingQueue<int> rq(1);
+
+  uint64_t timeout_us = 1000;
+
+  ASSERT_TRUE(rq.offer(1, timeout_us));
+  ASSERT_FALSE(rq.offer(2, timeout_us));
+  ASSERT_EQ(1, rq.size());
+
+  int element = -1;
+  ASSERT_TRUE(rq.poll(element, timeout_us));
+  ASSERT_EQ(1, element);
+  ASSERT_FALSE(rq.poll(element, timeout_us));
+  ASSERT_EQ(0, rq.size());
+
+  // the slot is reused on the next lap
+  ASSERT_TRUE(rq.offer(3, timeout_us));
+  ASSERT_TRUE(rq.poll(element, timeout_us));
+  ASSERT_EQ(3, element);
+}
+
+TEST(RingQueue, batch)
+{
+  RingQueue<int> rq(5);
+  int in[] = {1, 2, 3, 4, 5, 6, 7};
+  ASSERT_EQ(3, rq.offer_n(in, 3, 0));
+  ASSERT_EQ(2, rq.offer_n(in + 3, 4, 0));
+  ASSERT_EQ(0, rq.offer_n(in + 5, 2, 1000));
+  ASSERT_EQ(5, rq.size());
+
+  std::vector<int> out;
+  out.reserve(4);
+  ASSERT_TRUE(rq.poll(out, 1000));
+  ASSERT_EQ(std::vector<int>({1, 2, 3, 4}), out);
+  ASSERT_EQ(2, rq.offer_n(in + 5, 2, 0));
+
+  int rest[5] = {0};
+  ASSERT_EQ(3, rq.poll_n(rest, 5, 1000));
+  ASSERT_EQ(5, rest[0]);
+  ASSERT_EQ(6, rest[1]);
+  ASSERT_EQ(7, rest[2]);
+
+  ASSERT_EQ(2, rq.offer_n(in, 2, 0));
+  int sum = 0;
+  rq.clear([&sum](int& element) { sum += element; });
+  ASSERT_EQ(3, sum);
+  ASSERT_EQ(0, rq.size());
+}
+
+TEST(RingQueue, parked_consumer_is_woken)
+{
+  RingQueue<int> rq(4);
+  std::thread consumer([&rq]() {
+    int element = 0;
+    ASSERT_TRUE(rq.poll(element, 10 * 1000 * 1000));
+    ASSERT_EQ(42, element);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_TRUE(rq.offer(42, 0));
+  consumer.join();
+}
+
+template <typename Queue>
+static int64_t contend(Queue& queue, int producers, int consumers, uint64_t per_producer, bool& ordered)
+{
+  std::atomic<uint64_t> sum{0};
+  std::atomic<uint64_t> polled{0};
+  std::atomic<bool> in_order{true};
+  const uint64_t total = per_producer * producers;
+
+  Timer timer;
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&queue, p, per_producer]() {
+      for (uint64_t i = 1; i <= per_producer; ++i) {
+        while (!queue.offer((static_cast<uint64_t>(p) << 40) | i, 1000)) {}
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&]() {
+      std::vector<uint64_t> last(producers, 0);
+      std::vector<uint64_t> batch;
+      batch.reserve(64);
+      while (polled.load() < total) {
+        batch.clear();
+        if (!queue.poll(batch, 1000)) {
+          continue;
+        }
+        for (uint64_t value : batch) {
+          uint64_t producer = value >> 40;
+          uint64_t seq = value & ((1UL << 40) - 1);
+          // each consumer sees the elements of a producer in the order they were offered
+          if (seq <= last[producer]) {
+            in_order = false;
+          }
+          last[producer] = seq;
+          sum += seq;
+        }
+        polled += batch.size();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t elapsed = std::max<int64_t>(timer.elapsed(), 1);
+
+  ordered = in_order && sum == producers * per_producer * (per_producer + 1) / 2 && queue.size() == 0;
+  return elapsed;
+}
+
+TEST(RingQueue, DISABLED_benchmark_contention)
+{
+  const uint64_t per_producer = 200000;
+  for (auto shape : std::vector<std::pair<int, int>>{{1, 1}, {4, 1}, {4, 4}}) {
+    int producers = shape.first;
+    int consumers = shape.second;
+    uint64_t total = per_producer * producers;
+    bool ordered = false;
+
+    BlockingQueue<uint64_t> blocking_queue(4096);
+    int64_t blocking_elapsed = contend(blocking_queue, producers, consumers, per_producer, ordered);
+    ASSERT_TRUE(ordered);
+
+    RingQueue<uint64_t> ring_queue(4096);
+    int64_t ring_elapsed = contend(ring_queue, producers, consumers, per_producer, ordered);
+    ASSERT_TRUE(ordered);
+
+    OMS_INFO("[ring queue] {} producers, {} consumers: BlockingQueue {} ops/s, RingQueue {} ops/s",
+        producers,
+        consumers,
+        total * 1000000 / blocking_elapsed,
+        total * 1000000 / ring_elapsed);
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "log.h"
+#include "timer.h"
+#include "sharded_counter.h"
+
+using namespace oceanbase::logproxy;
+
+TEST(ShardedCounter, add_sub)
+{
+  ShardedCounter counter;
+  ASSERT_EQ(0, counter.load());
+  counter.add(10);
+  counter.sub(3);
+  ASSERT_EQ(7, counter.load());
+
+  // what one thread adds another may take off, as Counter does when logging
+  std::thread([&counter]() { counter.sub(7); }).join();
+  ASSERT_EQ(0, counter.load());
+
+  counter.add(5);
+  counter.reset();
+  ASSERT_EQ(0, counter.load());
+}
+
+template <typename Add>
+static int64_t count_concurrently(int threads, uint64_t per_thread, Add&& add)
+{
+  Timer timer;
+  std::vector<std::thread> counters;
+  for (int t = 0; t < threads; ++t) {
+    counters.emplace_back([&add, per_thread]() {
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        add();
+      }
+    });
+  }
+  for (auto& counter : counters) {
+    counter.join();
+  }
+  return std::max<int64_t>(timer.elapsed(), 1);
+}
+
+TEST(ShardedCounter, DISABLED_benchmark_contention)
+{
+  const uint64_t per_thread = 20000000;
+  for (int threads : {1, 4, 8}) {
+    uint64_t total = per_thread * threads;
+
+    std::atomic<uint64_t> atomic_count{0};
+    int64_t atomic_elapsed = count_concurrently(threads, per_thread, [&atomic_count]() { atomic_count.fetch_add(1); });
+    ASSERT_EQ(total, atomic_count.load());
+
+    ShardedCounter sharded_count;
+    int64_t sharded_elapsed = count_concurrently(threads, per_thread, [&sharded_count]() { sharded_count.add(1); });
+    ASSERT_EQ(total, sharded_count.load());
+
+    OMS_INFO("[sharded counter] {} threads, {} shards: atomic {} M/s, sharded {} M/s",
+        threads,
+        ShardedCounter::shard_count(),
+        total / atomic_elapsed,
+        total / sharded_elapsed);
+  }
+}
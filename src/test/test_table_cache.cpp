@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "log.h"
+#include "timer.h"
+#include "binlog/binlog-instance/table_cache.h"
+
+using namespace oceanbase::binlog;
+using namespace oceanbase::logproxy;
+
+TEST(LocalTableCache, refresh)
+{
+  TableCache table_cache;
+  LocalTableCache local(table_cache);
+  LocalTableCache other(table_cache);
+
+  uint64_t table_id = local.get_table_id("test", "t1");
+  ASSERT_EQ(table_id, other.get_table_id("test", "t1"));
+  ASSERT_NE(table_id, local.get_table_id("test", "t2"));
+
+  // a ddl seen by one worker is seen by all of them
+  other.refresh_table_id("test", "t1");
+  uint64_t new_table_id = table_cache.get_table_id("test", "t1");
+  ASSERT_NE(table_id, new_table_id);
+  ASSERT_EQ(new_table_id, local.get_table_id("test", "t1"));
+  ASSERT_EQ(new_table_id, other.get_table_id("test", "t1"));
+
+  uint64_t signature = 1;
+  auto definition = std::make_shared<TableMapDefinition>();
+  definition->table_id = new_table_id;
+  definition->schema_signature = signature;
+  local.put_table_map("test", "t1", definition);
+  ASSERT_EQ(definition, local.get_table_map("test", "t1", signature));
+  ASSERT_EQ(definition, other.get_table_map("test", "t1", signature));
+
+  other.refresh_table_id("test", "t1");
+  ASSERT_EQ(nullptr, local.get_table_map("test", "t1", signature));
+}
+
+TEST(LocalTableCache, encoder_plan)
+{
+  TableCache table_cache;
+  LocalTableCache local(table_cache);
+
+  ITableMeta table_meta;
+  auto* id_meta = new IColMeta();
+  id_meta->setName("id");
+  id_meta->setType(OB_TYPE_LONGLONG);
+  table_meta.append("id", id_meta);
+  const ColumnEncoderPlan* plan =
+      &local.get_encoder_plan("test", "t1", &table_meta, table_schema_signature(&table_meta));
+  ASSERT_EQ(1, plan->col_count());
+  ASSERT_EQ(plan, &local.get_encoder_plan("test", "t1", &table_meta, table_schema_signature(&table_meta)));
+
+  // the schema changed under the same table meta, as when DDLs are not converted
+  auto* name_meta = new IColMeta();
+  name_meta->setName("name");
+  name_meta->setType(OB_TYPE_VARCHAR);
+  name_meta->setEncoding("utf8mb4");
+  table_meta.append("name", name_meta);
+  ASSERT_EQ(2, local.get_encoder_plan("test", "t1", &table_meta, table_schema_signature(&table_meta)).col_count());
+}
+
+TEST(LocalTableCache, schema_signature)
+{
+  TableCache table_cache;
+  LocalTableCache local(table_cache);
+
+  ITableMeta table_meta;
+  auto* id_meta = new IColMeta();
+  id_meta->setName("id");
+  id_meta->setType(OB_TYPE_LONG);
+  table_meta.append("id", id_meta);
+  uint64_t signature = local.get_schema_signature("test", "t1", &table_meta);
+  ASSERT_EQ(table_schema_signature(&table_meta), signature);
+
+  // a column modified under the same table meta is only seen after a DDL
+  id_meta->setType(OB_TYPE_LONGLONG);
+  ASSERT_EQ(signature, local.get_schema_signature("test", "t1", &table_meta));
+  local.forget_schemas();
+  signature = local.get_schema_signature("test", "t1", &table_meta);
+  ASSERT_EQ(table_schema_signature(&table_meta), signature);
+
+  // a column added, or the table meta taken by another table
+  auto* name_meta = new IColMeta();
+  name_meta->setName("name");
+  name_meta->setType(OB_TYPE_VARCHAR);
+  table_meta.append("name", name_meta);
+  ASSERT_EQ(table_schema_signature(&table_meta), local.get_schema_signature("test", "t1", &table_meta));
+  ASSERT_NE(signature, local.get_schema_signature("test", "t1", &table_meta));
+  ASSERT_EQ(table_schema_signature(&table_meta), local.get_schema_signature("test", "t2", &table_meta));
+}
+
+/*
+ * Table id lookups as done by the convert workers, two per row record, with every worker thread hitting a small set of
+ * hot tables. Compares the lock-free per-worker view with going to the shared (sharded, locked) cache every time.
+ */
+static int64_t bench_table_cache(TableCache& table_cache, int nof_threads, bool local_view, int nof_lookups)
+{
+  std::vector<std::string> db_names;
+  std::vector<std::string> tb_names;
+  for (int i = 0; i < 64; ++i) {
+    db_names.emplace_back("db_" + std::to_string(i % 4));
+    tb_names.emplace_back("table_with_a_reasonably_long_name_" + std::to_string(i));
+  }
+
+  Timer timer;
+  std::vector<std::thread> threads;
+  std::atomic<uint64_t> checksum{0};
+  for (int t = 0; t < nof_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      LocalTableCache local(table_cache);
+      uint64_t sum = 0;
+      for (int i = 0; i < nof_lookups; ++i) {
+        size_t index = (i + t) % db_names.size();
+        sum += local_view ? local.get_table_id(db_names[index], tb_names[index])
+                          : table_cache.get_table_id(db_names[index], tb_names[index]);
+      }
+      checksum.fetch_add(sum);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t elapsed = std::max<int64_t>(timer.elapsed(), 1);
+  OMS_INFO("[table cache] {} threads, {}: {} lookups/s per thread (checksum {})",
+      nof_threads,
+      local_view ? "local view" : "shared",
+      nof_lookups * 1000000L / elapsed,
+      checksum.load());
+  return elapsed;
+}
+
+TEST(TableCache, DISABLED_benchmark_lookup)
+{
+  const int nof_lookups = 200000;
+  for (int nof_threads : {1, 2, 4, 8, 16, 32}) {
+    TableCache table_cache;
+    bench_table_cache(table_cache, nof_threads, false, nof_lookups);
+    bench_table_cache(table_cache, nof_threads, true, nof_lookups);
+  }
+}
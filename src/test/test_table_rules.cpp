@@ -0,0 +1,279 @@
+/**
+ * Copyright (c) 2024 OceanBase
+ * OceanBase Migration Service LogProxy is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "logmsg_factory.h"
+#include "common.h"
+#include "obcdc_config.h"
+#include "table_rules.h"
+#include "table_projection.h"
+
+using namespace oceanbase::logproxy;
+
+// mysql type codes
+static const int LONGLONG_TYPE = 8;
+static const int VARCHAR_TYPE = 15;
+
+static bool eval(const RowPredicate& predicate, const char* value)
+{
+  return predicate.eval(value, value != nullptr ? strlen(value) : 0);
+}
+
+static void append_col(ITableMeta* table_meta, const char* name, int type, long length, const char* encoding)
+{
+  IColMeta* col_meta = LogMsgFactory::createColMeta();
+  col_meta->setName(name);
+  col_meta->setType(type);
+  col_meta->setLength(length);
+  col_meta->setEncoding(encoding);
+  // owned by the table meta
+  table_meta->append(name, col_meta);
+}
+
+static ITableMeta* create_orders_meta(long status_length = 16)
+{
+  ITableMeta* table_meta = LogMsgFactory::createTableMeta();
+  table_meta->setName("orders");
+  append_col(table_meta, "id", LONGLONG_TYPE, 20, "binary");
+  append_col(table_meta, "status", VARCHAR_TYPE, status_length, "utf8mb4");
+  append_col(table_meta, "amount", LONGLONG_TYPE, 20, "binary");
+  append_col(table_meta, "note", VARCHAR_TYPE, 256, "utf8mb4");
+  return table_meta;
+}
+
+TEST(TableRules, table_pattern)
+{
+  TablePattern pattern;
+  ASSERT_EQ(OMS_OK, pattern.from("t1.db*.orders"));
+  ASSERT_TRUE(pattern.match("t1.db1", "orders"));
+  ASSERT_TRUE(pattern.match("T1.DB2", "ORDERS"));
+  ASSERT_FALSE(pattern.match("t1.test", "orders"));
+  ASSERT_FALSE(pattern.match("t2.db1", "orders"));
+  ASSERT_FALSE(pattern.match("t1.db1", "order_items"));
+  ASSERT_FALSE(pattern.match(nullptr, nullptr));
+
+  ASSERT_EQ(OMS_FAILED, pattern.from("t1.db1"));
+  ASSERT_EQ(OMS_FAILED, pattern.from("t1..orders"));
+}
+
+TEST(TableRules, table_pattern_covers)
+{
+  std::vector<TablePattern> patterns;
+  ASSERT_EQ(OMS_OK, parse_table_patterns("t1.*.*|t2.db*.orders|t3.db1.users", patterns));
+  ASSERT_EQ(3, patterns.size());
+
+  TablePattern other;
+  ASSERT_EQ(OMS_OK, other.from("T1.db1.*"));
+  ASSERT_TRUE(patterns[0].covers(other));
+  ASSERT_FALSE(patterns[1].covers(other));
+  ASSERT_EQ(OMS_OK, other.from("t2.db1.orders"));
+  ASSERT_TRUE(patterns[1].covers(other));
+  // the wildcards of other are not told apart by the ones of the pattern
+  ASSERT_EQ(OMS_OK, other.from("t2.db1*.orders"));
+  ASSERT_FALSE(patterns[1].covers(other));
+  ASSERT_EQ(OMS_OK, other.from("t2.db*.orders"));
+  ASSERT_TRUE(patterns[1].covers(other));
+  ASSERT_EQ(OMS_OK, other.from("t3.db1.*"));
+  ASSERT_FALSE(patterns[2].covers(other));
+
+  ASSERT_EQ(OMS_OK, parse_table_patterns("", patterns));
+  ASSERT_TRUE(patterns.empty());
+  ASSERT_EQ(OMS_FAILED, parse_table_patterns("t1.*.*|t2.db1", patterns));
+}
+
+TEST(TableRules, parse_table_columns)
+{
+  std::vector<TableColumns> rules;
+  ASSERT_EQ(OMS_OK, parse_table_columns("", rules));
+  ASSERT_TRUE(rules.empty());
+
+  ASSERT_EQ(OMS_OK, parse_table_columns("t1.db1.orders:id,status,amount|t1.*.*:id", rules));
+  ASSERT_EQ(2, rules.size());
+  ASSERT_EQ("orders", rules[0].pattern.table);
+  ASSERT_EQ((std::vector<std::string>{"id", "status", "amount"}), rules[0].columns);
+  ASSERT_EQ("*", rules[1].pattern.database);
+  ASSERT_EQ((std::vector<std::string>{"id"}), rules[1].columns);
+
+  ASSERT_EQ(OMS_FAILED, parse_table_columns("t1.db1.orders", rules));
+  ASSERT_EQ(OMS_FAILED, parse_table_columns("t1.db1.orders:", rules));
+  ASSERT_EQ(OMS_FAILED, parse_table_columns("t1.db1.orders:id,,status", rules));
+  ASSERT_EQ(OMS_FAILED, parse_table_columns("db1.orders:id", rules));
+}
+
+TEST(TableRules, parse_row_filters)
+{
+  std::vector<TableRowFilter> rules;
+  ASSERT_EQ(OMS_OK, parse_row_filters("t1.db1.orders:id>=100&id<200&region!=eu|t1.db1.users:tag=a:b", rules));
+  ASSERT_EQ(2, rules.size());
+  ASSERT_EQ(3, rules[0].predicates.size());
+  ASSERT_EQ("id", rules[0].predicates[0].column);
+  ASSERT_EQ(CompareOp::GE, rules[0].predicates[0].op);
+  ASSERT_TRUE(rules[0].predicates[0].numeric);
+  ASSERT_EQ(CompareOp::LT, rules[0].predicates[1].op);
+  ASSERT_EQ(CompareOp::NE, rules[0].predicates[2].op);
+  ASSERT_EQ("eu", rules[0].predicates[2].value);
+  ASSERT_FALSE(rules[0].predicates[2].numeric);
+  // the table and the predicates are split at the first ':'
+  ASSERT_EQ("a:b", rules[1].predicates[0].value);
+
+  ASSERT_EQ(OMS_FAILED, parse_row_filters("t1.db1.orders:id", rules));
+  ASSERT_EQ(OMS_FAILED, parse_row_filters("t1.db1.orders:=1", rules));
+  ASSERT_EQ(OMS_FAILED, parse_row_filters("t1.db1.orders:id!1", rules));
+  ASSERT_EQ(OMS_FAILED, parse_row_filters("t1.db1.orders:id>1&", rules));
+}
+
+TEST(TableRules, parse_predicate)
+{
+  RowPredicate predicate;
+  std::vector<std::pair<std::string, CompareOp>> ops = {{"=", CompareOp::EQ},
+      {"!=", CompareOp::NE},
+      {"<>", CompareOp::NE},
+      {"<", CompareOp::LT},
+      {"<=", CompareOp::LE},
+      {">", CompareOp::GT},
+      {">=", CompareOp::GE}};
+  for (const auto& op : ops) {
+    ASSERT_EQ(OMS_OK, predicate.from("id" + op.first + "10")) << op.first;
+    ASSERT_EQ("id", predicate.column) << op.first;
+    ASSERT_EQ(op.second, predicate.op) << op.first;
+    ASSERT_EQ("10", predicate.value) << op.first;
+    ASSERT_TRUE(predicate.numeric) << op.first;
+  }
+
+  // the operator is the longest one, the rest is the value
+  ASSERT_EQ(OMS_OK, predicate.from("tag<>>a"));
+  ASSERT_EQ(CompareOp::NE, predicate.op);
+  ASSERT_EQ(">a", predicate.value);
+  ASSERT_EQ(OMS_OK, predicate.from("tag=<a"));
+  ASSERT_EQ(CompareOp::EQ, predicate.op);
+  ASSERT_EQ("<a", predicate.value);
+  ASSERT_TRUE(eval(predicate, "<a"));
+
+  ASSERT_EQ(OMS_OK, predicate.from("code<>10"));
+  ASSERT_TRUE(eval(predicate, "11"));
+  ASSERT_FALSE(eval(predicate, "10.0"));
+  ASSERT_FALSE(eval(predicate, nullptr));
+
+  ASSERT_EQ(OMS_FAILED, predicate.from("<>10"));
+  ASSERT_EQ(OMS_FAILED, predicate.from("id"));
+}
+
+TEST(TableRules, project_columns)
+{
+  ITableMeta* table_meta = create_orders_meta();
+  TableColumns projection;
+  std::vector<int> columns;
+
+  // in the order of the table, the columns not found ignored
+  projection.columns = {"amount", "missing", "id"};
+  project_columns(table_meta, projection, columns);
+  ASSERT_EQ((std::vector<int>{0, 2}), columns);
+
+  // none left out
+  projection.columns = {"note", "amount", "status", "id"};
+  project_columns(table_meta, projection, columns);
+  ASSERT_TRUE(columns.empty());
+
+  projection.columns = {"status", "note"};
+  project_columns(table_meta, projection, columns);
+  ASSERT_EQ((std::vector<int>{1, 3}), columns);
+  ITableMeta* projected_meta = create_projected_meta(table_meta, columns);
+  ASSERT_STREQ("orders", projected_meta->getName());
+  ASSERT_EQ(2, projected_meta->getColCount());
+  ASSERT_EQ(0, projected_meta->getColIndex("status"));
+  ASSERT_EQ(1, projected_meta->getColIndex("note"));
+  ASSERT_EQ(-1, projected_meta->getColIndex("id"));
+  for (int i = 0; i < projected_meta->getColCount(); ++i) {
+    IColMeta* col_meta = projected_meta->getCol(i);
+    IColMeta* origin_meta = table_meta->getCol(columns[i]);
+    // copies, each table meta frees its own columns
+    ASSERT_NE(origin_meta, col_meta);
+    ASSERT_STREQ(origin_meta->getName(), col_meta->getName());
+    ASSERT_EQ(origin_meta->getType(), col_meta->getType());
+    ASSERT_EQ(origin_meta->getLength(), col_meta->getLength());
+    ASSERT_STREQ(origin_meta->getEncoding(), col_meta->getEncoding());
+  }
+
+  LogMsgFactory::destroy(projected_meta);
+  ASSERT_STREQ("status", table_meta->getCol(1)->getName());
+  LogMsgFactory::destroy(table_meta);
+}
+
+TEST(TableRules, table_meta_signature)
+{
+  ITableMeta* table_meta = create_orders_meta();
+  ITableMeta* same_meta = create_orders_meta();
+  ITableMeta* widened_meta = create_orders_meta(32);
+  ASSERT_EQ(table_meta_signature(table_meta), table_meta_signature(same_meta));
+  ASSERT_NE(table_meta_signature(table_meta), table_meta_signature(widened_meta));
+  append_col(same_meta, "region", VARCHAR_TYPE, 16, "utf8mb4");
+  ASSERT_NE(table_meta_signature(table_meta), table_meta_signature(same_meta));
+
+  // the columns renamed shift the indexes the rules are resolved to
+  ITableMeta* renamed_meta = LogMsgFactory::createTableMeta();
+  append_col(renamed_meta, "id", LONGLONG_TYPE, 20, "binary");
+  append_col(renamed_meta, "state", VARCHAR_TYPE, 16, "utf8mb4");
+  append_col(renamed_meta, "amount", LONGLONG_TYPE, 20, "binary");
+  append_col(renamed_meta, "note", VARCHAR_TYPE, 256, "utf8mb4");
+  ASSERT_NE(table_meta_signature(table_meta), table_meta_signature(renamed_meta));
+
+  for (ITableMeta* meta : {table_meta, same_meta, widened_meta, renamed_meta}) {
+    LogMsgFactory::destroy(meta);
+  }
+}
+
+TEST(TableRules, predicate_eval)
+{
+  RowPredicate predicate;
+  ASSERT_EQ(OMS_OK, predicate.from("id>=100"));
+  ASSERT_TRUE(eval(predicate, "100"));
+  ASSERT_TRUE(eval(predicate, "1000"));
+  ASSERT_TRUE(eval(predicate, "100.5"));
+  ASSERT_FALSE(eval(predicate, "99"));
+  ASSERT_FALSE(eval(predicate, "-100"));
+  ASSERT_FALSE(eval(predicate, nullptr));
+
+  // compared as numbers, whatever the digits
+  ASSERT_EQ(OMS_OK, predicate.from("amount=1.50"));
+  ASSERT_TRUE(eval(predicate, "1.5"));
+  ASSERT_TRUE(eval(predicate, "1.500"));
+  ASSERT_FALSE(eval(predicate, "1.51"));
+
+  // bigint values keep their precision
+  ASSERT_EQ(OMS_OK, predicate.from("id=9223372036854775807"));
+  ASSERT_TRUE(eval(predicate, "9223372036854775807"));
+  ASSERT_FALSE(eval(predicate, "9223372036854775806"));
+
+  // strings, and the values not numbers compared to a number
+  ASSERT_EQ(OMS_OK, predicate.from("region<m"));
+  ASSERT_TRUE(eval(predicate, "eu"));
+  ASSERT_FALSE(eval(predicate, "us"));
+  ASSERT_EQ(OMS_OK, predicate.from("code!=10"));
+  ASSERT_TRUE(eval(predicate, "10a"));
+  ASSERT_TRUE(eval(predicate, ""));
+  ASSERT_FALSE(eval(predicate, "10"));
+  ASSERT_FALSE(eval(predicate, nullptr));
+
+  ASSERT_EQ(OMS_OK, predicate.from("name="));
+  ASSERT_TRUE(eval(predicate, ""));
+  ASSERT_FALSE(eval(predicate, "a"));
+}
+
+TEST(TableRules, obcdc_config)
+{
+  ObcdcConfig config(
+      "tb_white_list=t1.db1.* tb_column_list=t1.db1.orders:id,status tb_row_filter=t1.db1.orders:id>=10");
+  ASSERT_EQ("t1.db1.orders:id,status", config.table_columns.val());
+  ASSERT_EQ("t1.db1.orders:id>=10", config.row_filters.val());
+}